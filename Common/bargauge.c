@@ -0,0 +1,117 @@
+//*****************************************************************************
+//
+// bargauge.c - Incremental bar gauge widget.
+//
+// Drawing a bar as a filled part plus a blank remainder repaints the whole
+// row every time, even when the value has not moved.  The gauge instead
+// keeps the length it last drew and paints only the strip between that and
+// the new length: in the bar color when it grows, in the background color
+// when it shrinks.  A draw with an unchanged length paints nothing, so the
+// cost follows how far the value moves rather than how often it is drawn.
+//
+// Anything else that paints over the gauge's area must call
+// BarGaugeInvalidate() so the next draw repaints it whole.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "grlib/grlib.h"
+
+#include "bargauge.h"
+
+//*****************************************************************************
+//
+// Fills columns i32From to i32To - 1 of the gauge in one color.
+//
+//*****************************************************************************
+static void
+BarGaugeSpan(tBarGauge *psGauge, tContext *psContext, int32_t i32From,
+             int32_t i32To, uint32_t ui32Color)
+{
+  tRectangle sRect;
+
+  sRect.i16XMin = psGauge->sRect.i16XMin + i32From;
+  sRect.i16XMax = psGauge->sRect.i16XMin + i32To - 1;
+  sRect.i16YMin = psGauge->sRect.i16YMin;
+  sRect.i16YMax = psGauge->sRect.i16YMax;
+  GrContextForegroundSet(psContext, ui32Color);
+  GrRectFill(psContext, &sRect);
+  psGauge->ui32Pixels += (i32To - i32From) *
+                         (psGauge->sRect.i16YMax - psGauge->sRect.i16YMin + 1);
+}
+
+//*****************************************************************************
+//
+// Sets up a gauge over a rectangle.  Nothing is drawn until BarGaugeDraw(),
+// which then paints the whole area.
+//
+//*****************************************************************************
+void
+BarGaugeInit(tBarGauge *psGauge, const tRectangle *psRect, uint32_t ui32Fill,
+             uint32_t ui32Back)
+{
+  psGauge->sRect = *psRect;
+  psGauge->ui32Fill = ui32Fill;
+  psGauge->ui32Back = ui32Back;
+  psGauge->i32Shown = -1;
+  psGauge->ui32Pixels = 0;
+}
+
+//*****************************************************************************
+//
+// Forgets what is on the screen, so the next draw repaints the whole gauge.
+//
+//*****************************************************************************
+void
+BarGaugeInvalidate(tBarGauge *psGauge)
+{
+  psGauge->i32Shown = -1;
+}
+
+//*****************************************************************************
+//
+// Shows a bar i32Length pixels long, clamped to the gauge's width.  Returns
+// true if anything was painted.  Leaves the context's foreground changed
+// when it paints.
+//
+//*****************************************************************************
+bool
+BarGaugeDraw(tBarGauge *psGauge, tContext *psContext, int32_t i32Length)
+{
+  int32_t i32Width;
+
+  i32Width = psGauge->sRect.i16XMax - psGauge->sRect.i16XMin + 1;
+  if(i32Length < 0) {
+    i32Length = 0;
+  }
+  if(i32Length > i32Width) {
+    i32Length = i32Width;
+  }
+
+  psGauge->ui32Pixels = 0;
+  if(i32Length == psGauge->i32Shown) {
+    return(false);
+  }
+
+  if(psGauge->i32Shown < 0) {
+    if(i32Length > 0) {
+      BarGaugeSpan(psGauge, psContext, 0, i32Length, psGauge->ui32Fill);
+    }
+    if(i32Length < i32Width) {
+      BarGaugeSpan(psGauge, psContext, i32Length, i32Width, psGauge->ui32Back);
+    }
+  }
+  else if(i32Length > psGauge->i32Shown) {
+    BarGaugeSpan(psGauge, psContext, psGauge->i32Shown, i32Length,
+                 psGauge->ui32Fill);
+  }
+  else {
+    BarGaugeSpan(psGauge, psContext, i32Length, psGauge->i32Shown,
+                 psGauge->ui32Back);
+  }
+  psGauge->i32Shown = i32Length;
+
+  return(true);
+}
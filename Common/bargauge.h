@@ -0,0 +1,51 @@
+//*****************************************************************************
+//
+// bargauge.h - Prototypes for the incremental bar gauge widget.
+//
+//*****************************************************************************
+
+#ifndef __BARGAUGE_H__
+#define __BARGAUGE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "grlib/grlib.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// A horizontal bar filling a rectangle from the left.  The gauge remembers
+// the length on the screen so each draw only paints the strip between the
+// old and new lengths.
+//
+//*****************************************************************************
+typedef struct
+{
+  tRectangle sRect;             // Area the gauge covers, inclusive
+  uint32_t ui32Fill;            // 24-bit RGB color of the bar
+  uint32_t ui32Back;            // 24-bit RGB color of the rest
+  int32_t i32Shown;             // Length on the screen, -1 if unknown
+  uint32_t ui32Pixels;          // Pixels painted by the last draw
+} tBarGauge;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void BarGaugeInit(tBarGauge *psGauge, const tRectangle *psRect,
+                         uint32_t ui32Fill, uint32_t ui32Back);
+extern void BarGaugeInvalidate(tBarGauge *psGauge);
+extern bool BarGaugeDraw(tBarGauge *psGauge, tContext *psContext,
+                         int32_t i32Length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BARGAUGE_H__
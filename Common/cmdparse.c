@@ -0,0 +1,258 @@
+//*****************************************************************************
+//
+// cmdparse.c - Table-driven command line parser.
+//
+// A line holds one or more commands separated by ';', each a name followed
+// by up to CMD_MAX_ARGS integer arguments separated by spaces or commas:
+//
+//     S 1200; + 50; B 921600
+//
+// Commands are looked up by indexing a table with their first character, so
+// dispatch costs the same however many commands a program defines, and a
+// host script can configure the board with a single write.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cmdparse.h"
+
+//*****************************************************************************
+//
+// Returns the upper case form of a lower case letter, anything else as is.
+//
+//*****************************************************************************
+static char
+CmdUpper(char cChar)
+{
+  return(((cChar >= 'a') && (cChar <= 'z')) ? (cChar - 'a' + 'A') : cChar);
+}
+
+//*****************************************************************************
+//
+// Returns true for a letter.
+//
+//*****************************************************************************
+static bool
+CmdIsAlpha(char cChar)
+{
+  cChar = CmdUpper(cChar);
+  return((cChar >= 'A') && (cChar <= 'Z'));
+}
+
+//*****************************************************************************
+//
+// Returns true for an argument separator.
+//
+//*****************************************************************************
+static bool
+CmdIsSpace(char cChar)
+{
+  return((cChar == ' ') || (cChar == '\t') || (cChar == ','));
+}
+
+//*****************************************************************************
+//
+// Parses a signed decimal, or 0x-prefixed hex, integer at *ppcStr and
+// advances past it.  Returns false if there is no well-formed number there.
+//
+//*****************************************************************************
+static bool
+CmdParseInt(const char **ppcStr, int32_t *pi32Value)
+{
+  const char *pcStr = *ppcStr;
+  uint32_t ui32Value = 0;
+  uint32_t ui32Base = 10;
+  uint32_t ui32Digit;
+  bool bNegative = false;
+  bool bDigits = false;
+
+  if((*pcStr == '-') || (*pcStr == '+')) {
+    bNegative = (*pcStr == '-');
+    pcStr++;
+  }
+  if((pcStr[0] == '0') && (CmdUpper(pcStr[1]) == 'X')) {
+    ui32Base = 16;
+    pcStr += 2;
+  }
+
+  for(;;) {
+    if((*pcStr >= '0') && (*pcStr <= '9')) {
+      ui32Digit = *pcStr - '0';
+    }
+    else if((ui32Base == 16) && (CmdUpper(*pcStr) >= 'A') &&
+            (CmdUpper(*pcStr) <= 'F')) {
+      ui32Digit = CmdUpper(*pcStr) - 'A' + 10;
+    }
+    else {
+      break;
+    }
+    ui32Value = (ui32Value * ui32Base) + ui32Digit;
+    bDigits = true;
+    pcStr++;
+  }
+
+  // A number must end at a separator, not run into other text.
+  if(!bDigits || ((*pcStr != '\0') && !CmdIsSpace(*pcStr))) {
+    return(false);
+  }
+
+  *pi32Value = bNegative ? -(int32_t)ui32Value : (int32_t)ui32Value;
+  *ppcStr = pcStr;
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Runs a single command, pcCmd, which holds no ';'.  Returns the handler's
+// status, or a parse error.  An empty command is CMD_OK.
+//
+//*****************************************************************************
+static int32_t
+CmdRunOne(const tCmdEntry *const *ppsTable, const char *pcCmd)
+{
+  const tCmdEntry *psEntry;
+  const char *pcName;
+  int32_t pi32Argv[CMD_MAX_ARGS];
+  uint32_t ui32Argc = 0;
+  uint8_t ui8Key;
+
+  while(CmdIsSpace(*pcCmd)) {
+    pcCmd++;
+  }
+  if(*pcCmd == '\0') {
+    return(CMD_OK);
+  }
+
+  ui8Key = (uint8_t)CmdUpper(*pcCmd);
+  if((ui8Key >= CMD_TABLE_SIZE) || ((psEntry = ppsTable[ui8Key]) == 0)) {
+    return(CMD_BAD_CMD);
+  }
+
+  // Any letters after the key must continue the command's full name.
+  pcName = psEntry->pcName + 1;
+  pcCmd++;
+  if(CmdIsAlpha(ui8Key)) {
+    while(CmdIsAlpha(*pcCmd)) {
+      if(CmdUpper(*pcCmd) != CmdUpper(*pcName)) {
+        return(CMD_BAD_CMD);
+      }
+      pcCmd++;
+      pcName++;
+    }
+  }
+
+  for(;;) {
+    while(CmdIsSpace(*pcCmd)) {
+      pcCmd++;
+    }
+    if(*pcCmd == '\0') {
+      break;
+    }
+    if(ui32Argc == psEntry->ui8MaxArgs) {
+      return(CMD_TOO_MANY_ARGS);
+    }
+    if(!CmdParseInt(&pcCmd, &pi32Argv[ui32Argc])) {
+      return(CMD_INVALID_ARG);
+    }
+    ui32Argc++;
+  }
+  if(ui32Argc < psEntry->ui8MinArgs) {
+    return(CMD_TOO_FEW_ARGS);
+  }
+
+  return(psEntry->pfnCmd(ui32Argc, pi32Argv));
+}
+
+//*****************************************************************************
+//
+// Runs every ';'-separated command in pcLine, which is modified in place.
+// Stops at the first command that fails, reporting it through pfnError if
+// given, or that returns CMD_STOP.  Returns the status of the last command
+// run.
+//
+//*****************************************************************************
+int32_t
+CmdLineExecute(const tCmdEntry *const *ppsTable, tCmdErrorFn pfnError,
+               char *pcLine)
+{
+  char *pcEnd;
+  bool bLast;
+  int32_t i32Status = CMD_OK;
+
+  do {
+    for(pcEnd = pcLine; (*pcEnd != ';') && (*pcEnd != '\0'); pcEnd++) {
+    }
+    bLast = (*pcEnd == '\0');
+    *pcEnd = '\0';
+
+    i32Status = CmdRunOne(ppsTable, pcLine);
+    if(i32Status < 0) {
+      if(pfnError) {
+        pfnError(pcLine, i32Status);
+      }
+      break;
+    }
+    pcLine = pcEnd + 1;
+  } while(!bLast && (i32Status != CMD_STOP));
+
+  return(i32Status);
+}
+
+//*****************************************************************************
+//
+// Sets up a parser to dispatch through ppsTable, a CMD_TABLE_SIZE array of
+// entries indexed by each command's first character.
+//
+//*****************************************************************************
+void
+CmdParserInit(tCmdParser *psParser, const tCmdEntry *const *ppsTable,
+              tCmdErrorFn pfnError)
+{
+  psParser->ppsTable = ppsTable;
+  psParser->pfnError = pfnError;
+  psParser->ui32Len = 0;
+  psParser->bOverflow = false;
+}
+
+//*****************************************************************************
+//
+// Feeds one received character to the parser.  Backspace and delete remove
+// the last character; carriage return or line feed runs the line.  Returns
+// true when a line was ended, whether or not it held any commands.
+//
+//*****************************************************************************
+bool
+CmdParserInput(tCmdParser *psParser, uint8_t ui8Char)
+{
+  if((ui8Char == '\r') || (ui8Char == '\n')) {
+    if(psParser->bOverflow) {
+      if(psParser->pfnError) {
+        psParser->pfnError("", CMD_LINE_TOO_LONG);
+      }
+    }
+    else if(psParser->ui32Len) {
+      psParser->pcLine[psParser->ui32Len] = '\0';
+      CmdLineExecute(psParser->ppsTable, psParser->pfnError,
+                     psParser->pcLine);
+    }
+    psParser->ui32Len = 0;
+    psParser->bOverflow = false;
+    return(true);
+  }
+
+  if((ui8Char == '\b') || (ui8Char == 0x7F)) {
+    if(psParser->ui32Len) {
+      psParser->ui32Len--;
+    }
+  }
+  else if(psParser->ui32Len < (CMD_LINE_SIZE - 1)) {
+    psParser->pcLine[psParser->ui32Len++] = ui8Char;
+  }
+  else {
+    psParser->bOverflow = true;
+  }
+
+  return(false);
+}
@@ -0,0 +1,103 @@
+//*****************************************************************************
+//
+// cmdparse.h - Prototypes for the table-driven command line parser.
+//
+//*****************************************************************************
+
+#ifndef __CMDPARSE_H__
+#define __CMDPARSE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Sizes.  Commands are dispatched on their first character, so the table has
+// one slot per 7-bit ASCII code.
+//
+//*****************************************************************************
+#define CMD_TABLE_SIZE          128
+#define CMD_LINE_SIZE           80
+#define CMD_MAX_ARGS            4
+
+//*****************************************************************************
+//
+// Values returned by command handlers and passed to the error callback.
+// CMD_STOP ends the rest of the line without it counting as an error, for
+// commands such as quit after which nothing more should run.
+//
+//*****************************************************************************
+#define CMD_OK                  0
+#define CMD_STOP                1
+#define CMD_BAD_CMD             (-1)
+#define CMD_TOO_MANY_ARGS       (-2)
+#define CMD_TOO_FEW_ARGS        (-3)
+#define CMD_INVALID_ARG         (-4)
+#define CMD_LINE_TOO_LONG       (-5)
+
+//*****************************************************************************
+//
+// A command handler, given its numeric arguments.
+//
+//*****************************************************************************
+typedef int32_t (*tCmdFn)(uint32_t ui32Argc, const int32_t *pi32Argv);
+
+//*****************************************************************************
+//
+// Called for each command that fails, with the command text and status.
+//
+//*****************************************************************************
+typedef void (*tCmdErrorFn)(const char *pcCmd, int32_t i32Status);
+
+//*****************************************************************************
+//
+// One command.  pcName is the full name; it may be typed as its first
+// character alone or as any longer prefix of itself, so "S", "SP" and
+// "SPEED" all reach the same entry.  Entries are placed in the dispatch
+// table at the index of their first character, upper case for letters.
+//
+//*****************************************************************************
+typedef struct
+{
+  const char *pcName;           // Full name, first character is the key
+  uint8_t ui8MinArgs;           // Fewest numeric arguments accepted
+  uint8_t ui8MaxArgs;           // Most numeric arguments accepted
+  tCmdFn pfnCmd;                // Handler
+} tCmdEntry;
+
+//*****************************************************************************
+//
+// Line assembly state for one input stream.
+//
+//*****************************************************************************
+typedef struct
+{
+  const tCmdEntry *const *ppsTable;     // CMD_TABLE_SIZE entries, or NULL
+  tCmdErrorFn pfnError;                 // Error report, may be NULL
+  char pcLine[CMD_LINE_SIZE];           // Line being typed
+  uint32_t ui32Len;                     // Characters in pcLine
+  bool bOverflow;                       // Line outgrew pcLine
+} tCmdParser;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void CmdParserInit(tCmdParser *psParser,
+                          const tCmdEntry *const *ppsTable,
+                          tCmdErrorFn pfnError);
+extern bool CmdParserInput(tCmdParser *psParser, uint8_t ui8Char);
+extern int32_t CmdLineExecute(const tCmdEntry *const *ppsTable,
+                              tCmdErrorFn pfnError, char *pcLine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __CMDPARSE_H__
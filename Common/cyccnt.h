@@ -0,0 +1,61 @@
+//*****************************************************************************
+//
+// cyccnt.h - Access to the Cortex-M4 DWT cycle counter.
+//
+// A free-running 32-bit count of core clocks, used to timestamp telemetry
+// and to measure how long code paths take.  It wraps after 2^32 clocks
+// (about 53 s at 80 MHz), so compare readings by unsigned subtraction.
+//
+//*****************************************************************************
+
+#ifndef __CYCCNT_H__
+#define __CYCCNT_H__
+
+#include <stdint.h>
+
+#include "inc/hw_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Debug and trace registers that hold the cycle counter.
+//
+//*****************************************************************************
+#define CYCCNT_DEMCR            0xE000EDFC  // Debug Exception and Monitor Ctl
+#define CYCCNT_DEMCR_TRCENA     0x01000000  // Enable DWT and ITM
+#define CYCCNT_DWT_CTRL         0xE0001000  // DWT Control
+#define CYCCNT_DWT_CTRL_CYCEN   0x00000001  // Enable the cycle counter
+#define CYCCNT_DWT_CYCCNT       0xE0001004  // DWT Cycle Count
+
+//*****************************************************************************
+//
+// Starts the cycle counter.  Harmless to call more than once.
+//
+//*****************************************************************************
+static inline void
+CycleCounterInit(void)
+{
+  HWREG(CYCCNT_DEMCR) |= CYCCNT_DEMCR_TRCENA;
+  HWREG(CYCCNT_DWT_CTRL) |= CYCCNT_DWT_CTRL_CYCEN;
+}
+
+//*****************************************************************************
+//
+// Returns the current cycle count.
+//
+//*****************************************************************************
+static inline uint32_t
+CycleCounterGet(void)
+{
+  return(HWREG(CYCCNT_DWT_CYCCNT));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __CYCCNT_H__
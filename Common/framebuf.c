@@ -0,0 +1,1129 @@
+//*****************************************************************************
+//
+// framebuf.c - Off-screen framebuffer for the 96x64 OLED.
+//
+// The CFAL96x64x16 driver sends every pixel grlib draws straight to the
+// panel, so a screen that is redrawn each pass of the main loop keeps the
+// SSI busy with pixels that have not changed.  This driver sits behind the
+// same grlib tDisplay interface but draws into a copy of the screen in RAM.
+// Each primitive compares what it writes with what is already there and
+// records only the area that really changed.  FrameBufFlush(), which is
+// also what GrFlush() calls, then opens a panel window over each dirty
+// region and sends just those pixels.
+//
+// A full color copy takes 12 KB of the 32 KB SRAM.  The labs only draw in a
+// handful of colors, so FrameBufInitIndexed() instead keeps a 4-bit index
+// per pixel, 3 KB in all, and a 16 entry palette that grlib colors are
+// mapped into as they are set.  Indices are expanded through the palette a
+// row at a time as they are sent.  Changing a palette entry recolors every
+// pixel drawn with it at the next flush without drawing anything again.
+//
+// FrameBufFlush() keeps the CPU busy for as long as the pixels take to
+// shift out.  Once FrameBufDMAInit() has attached a uDMA channel,
+// FrameBufFlushAsync() instead hands the dirty regions to the uDMA and
+// returns at once; the SSI interrupt opens each region's window in turn and
+// reports the end of the flush through a callback.  Pixels still queued are
+// guarded: a primitive that would overwrite them waits until they are out,
+// while drawing anywhere else carries on during the transfer.
+//
+// The panel must first be set up with CFAL96x64x16Init(); its SSI and D/C
+// pin are then written directly here.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "inc/hw_memmap.h"
+#include "inc/hw_ssi.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/ssi.h"
+#include "driverlib/udma.h"
+#include "grlib/grlib.h"
+
+#include "udmactl.h"
+#include "framebuf.h"
+
+//*****************************************************************************
+//
+// The panel's SSI port and data/command select, as set up by
+// CFAL96x64x16Init() on the DK-TM4C123G.
+//
+//*****************************************************************************
+#define FRAMEBUF_SSI_BASE       SSI2_BASE
+#define FRAMEBUF_DC_BASE        GPIO_PORTH_BASE
+#define FRAMEBUF_DC_PIN         GPIO_PIN_6
+
+//*****************************************************************************
+//
+// SSD1332 commands that set the window written by the following data.
+//
+//*****************************************************************************
+#define SSD1332_SET_COLUMN      0x15
+#define SSD1332_SET_ROW         0x75
+
+//*****************************************************************************
+//
+// Reads the pixel at (i32X, i32Y): a panel ready color, or a palette index.
+//
+//*****************************************************************************
+static uint32_t
+FrameBufGet(const tFrameBuf *psFB, int32_t i32X, int32_t i32Y)
+{
+  uint32_t ui32Pos;
+
+  ui32Pos = (i32Y * FRAMEBUF_WIDTH) + i32X;
+  if(psFB->pui8Indices) {
+    return((psFB->pui8Indices[ui32Pos >> 1] >> ((ui32Pos & 1) ? 0 : 4)) & 15);
+  }
+
+  return(psFB->pui16Pixels[ui32Pos]);
+}
+
+//*****************************************************************************
+//
+// Grows a rectangle to take in the pixel at (i32X, i32Y).  A rectangle with
+// i16XMax below i16XMin is empty and becomes just that pixel.
+//
+//*****************************************************************************
+static void
+FrameBufGrow(tRectangle *psRect, int32_t i32X, int32_t i32Y)
+{
+  if(psRect->i16XMax < psRect->i16XMin) {
+    psRect->i16XMin = i32X;
+    psRect->i16YMin = i32Y;
+    psRect->i16XMax = i32X;
+    psRect->i16YMax = i32Y;
+    return;
+  }
+  if(i32X < psRect->i16XMin) {
+    psRect->i16XMin = i32X;
+  }
+  if(i32X > psRect->i16XMax) {
+    psRect->i16XMax = i32X;
+  }
+  if(i32Y < psRect->i16YMin) {
+    psRect->i16YMin = i32Y;
+  }
+  if(i32Y > psRect->i16YMax) {
+    psRect->i16YMax = i32Y;
+  }
+}
+
+//*****************************************************************************
+//
+// Writes the pixel at (i32X, i32Y).  Returns true if its value changed.
+// Indexed pixels are packed two to a byte, the left one in the top half.
+// A pixel given a fixed palette index grows that index's area, so
+// FrameBufPaletteSet() knows what to resend without searching the screen.
+//
+//*****************************************************************************
+static bool
+FrameBufPut(tFrameBuf *psFB, int32_t i32X, int32_t i32Y, uint32_t ui32Value)
+{
+  uint32_t ui32Pos, ui32Shift;
+  uint8_t *pui8Byte;
+
+  ui32Pos = (i32Y * FRAMEBUF_WIDTH) + i32X;
+  if(psFB->pui8Indices) {
+    pui8Byte = &psFB->pui8Indices[ui32Pos >> 1];
+    ui32Shift = (ui32Pos & 1) ? 0 : 4;
+    if(((*pui8Byte >> ui32Shift) & 15) == ui32Value) {
+      return(false);
+    }
+    *pui8Byte = (*pui8Byte & ~(15 << ui32Shift)) | (ui32Value << ui32Shift);
+    if(psFB->ui32PaletteFixed & (1 << ui32Value)) {
+      FrameBufGrow(&psFB->psFixedArea[ui32Value], i32X, i32Y);
+    }
+    return(true);
+  }
+  if(psFB->pui16Pixels[ui32Pos] == ui32Value) {
+    return(false);
+  }
+  psFB->pui16Pixels[ui32Pos] = ui32Value;
+
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Number of pixels in a rectangle.
+//
+//*****************************************************************************
+static uint32_t
+FrameBufArea(const tRectangle *psRect)
+{
+  return((psRect->i16XMax - psRect->i16XMin + 1) *
+         (psRect->i16YMax - psRect->i16YMin + 1));
+}
+
+//*****************************************************************************
+//
+// Grows psRect to cover psOther as well.
+//
+//*****************************************************************************
+static void
+FrameBufUnion(tRectangle *psRect, const tRectangle *psOther)
+{
+  if(psOther->i16XMin < psRect->i16XMin) {
+    psRect->i16XMin = psOther->i16XMin;
+  }
+  if(psOther->i16YMin < psRect->i16YMin) {
+    psRect->i16YMin = psOther->i16YMin;
+  }
+  if(psOther->i16XMax > psRect->i16XMax) {
+    psRect->i16XMax = psOther->i16XMax;
+  }
+  if(psOther->i16YMax > psRect->i16YMax) {
+    psRect->i16YMax = psOther->i16YMax;
+  }
+}
+
+//*****************************************************************************
+//
+// Returns true if two rectangles overlap or share an edge, so that their
+// union covers no pixels outside them.
+//
+//*****************************************************************************
+static bool
+FrameBufTouch(const tRectangle *psA, const tRectangle *psB)
+{
+  return((psA->i16XMin <= (psB->i16XMax + 1)) &&
+         (psB->i16XMin <= (psA->i16XMax + 1)) &&
+         (psA->i16YMin <= (psB->i16YMax + 1)) &&
+         (psB->i16YMin <= (psA->i16YMax + 1)));
+}
+
+//*****************************************************************************
+//
+// Returns true if two rectangles have at least one pixel in common.
+//
+//*****************************************************************************
+static bool
+FrameBufOverlap(const tRectangle *psA, const tRectangle *psB)
+{
+  return((psA->i16XMin <= psB->i16XMax) && (psB->i16XMin <= psA->i16XMax) &&
+         (psA->i16YMin <= psB->i16YMax) && (psB->i16YMin <= psA->i16YMax));
+}
+
+//*****************************************************************************
+//
+// Returns true if any pixel of psRect belongs to a region the uDMA has not
+// finished reading.
+//
+//*****************************************************************************
+static bool
+FrameBufPending(tFrameBuf *psFB, const tRectangle *psRect)
+{
+  uint32_t ui32Idx;
+
+  if(!psFB->bBusy) {
+    return(false);
+  }
+  for(ui32Idx = psFB->ui32Sent; ui32Idx < psFB->ui32NumSending; ui32Idx++) {
+    if(FrameBufOverlap(&psFB->psSending[ui32Idx], psRect)) {
+      return(true);
+    }
+  }
+
+  return(false);
+}
+
+//*****************************************************************************
+//
+// Runs the completion service by hand.  Polling rather than waiting for the
+// interrupt lets a flush finish even with interrupts masked.
+//
+//*****************************************************************************
+static void
+FrameBufPoll(tFrameBuf *psFB)
+{
+  bool bWasDisabled;
+
+  bWasDisabled = IntMasterDisable();
+  FrameBufIntHandler(psFB);
+  if(!bWasDisabled) {
+    IntMasterEnable();
+  }
+}
+
+//*****************************************************************************
+//
+// Called before a primitive writes psRect.  Waits while any of its pixels
+// are still queued, so a flush in flight sends the screen as it was when it
+// was queued.
+//
+//*****************************************************************************
+static void
+FrameBufGuard(tFrameBuf *psFB, const tRectangle *psRect)
+{
+  if(FrameBufPending(psFB, psRect)) {
+    psFB->ui32Stalls++;
+    do {
+      FrameBufPoll(psFB);
+    } while(FrameBufPending(psFB, psRect));
+  }
+}
+
+//*****************************************************************************
+//
+// Adds a changed region to the dirty list, merging it with any region it
+// touches.  With the list full it is merged into the region that grows
+// least, which may in turn make that region touch others.
+//
+//*****************************************************************************
+static void
+FrameBufDamage(tFrameBuf *psFB, const tRectangle *psRect)
+{
+  tRectangle sRect, sGrown;
+  uint32_t ui32Idx, ui32Best, ui32Growth, ui32BestGrowth;
+
+  sRect = *psRect;
+  while(1) {
+    for(ui32Idx = 0; ui32Idx < psFB->ui32NumDirty; ) {
+      if(FrameBufTouch(&psFB->psDirty[ui32Idx], &sRect)) {
+        FrameBufUnion(&sRect, &psFB->psDirty[ui32Idx]);
+        psFB->psDirty[ui32Idx] = psFB->psDirty[--psFB->ui32NumDirty];
+        ui32Idx = 0;
+      }
+      else {
+        ui32Idx++;
+      }
+    }
+    if(psFB->ui32NumDirty < FRAMEBUF_MAX_DIRTY) {
+      psFB->psDirty[psFB->ui32NumDirty++] = sRect;
+      return;
+    }
+
+    ui32Best = 0;
+    ui32BestGrowth = 0xFFFFFFFF;
+    for(ui32Idx = 0; ui32Idx < psFB->ui32NumDirty; ui32Idx++) {
+      sGrown = psFB->psDirty[ui32Idx];
+      FrameBufUnion(&sGrown, &sRect);
+      ui32Growth = FrameBufArea(&sGrown) - FrameBufArea(&psFB->psDirty[ui32Idx]);
+      if(ui32Growth < ui32BestGrowth) {
+        ui32Best = ui32Idx;
+        ui32BestGrowth = ui32Growth;
+      }
+    }
+    FrameBufUnion(&sRect, &psFB->psDirty[ui32Best]);
+    psFB->psDirty[ui32Best] = psFB->psDirty[--psFB->ui32NumDirty];
+  }
+}
+
+//*****************************************************************************
+//
+// Fills a rectangle, given by inclusive corners already clipped to the
+// screen, and marks dirty only the part of it whose pixels changed.
+//
+//*****************************************************************************
+static void
+FrameBufFill(tFrameBuf *psFB, int32_t i32X1, int32_t i32Y1, int32_t i32X2,
+             int32_t i32Y2, uint16_t ui16Value)
+{
+  tRectangle sChanged;
+  int32_t i32X, i32Y;
+
+  sChanged.i16XMin = i32X1;
+  sChanged.i16YMin = i32Y1;
+  sChanged.i16XMax = i32X2;
+  sChanged.i16YMax = i32Y2;
+  FrameBufGuard(psFB, &sChanged);
+
+  sChanged.i16XMin = FRAMEBUF_WIDTH;
+  sChanged.i16YMin = FRAMEBUF_HEIGHT;
+  sChanged.i16XMax = -1;
+  sChanged.i16YMax = -1;
+  for(i32Y = i32Y1; i32Y <= i32Y2; i32Y++) {
+    for(i32X = i32X1; i32X <= i32X2; i32X++) {
+      if(FrameBufPut(psFB, i32X, i32Y, ui16Value)) {
+        if(i32X < sChanged.i16XMin) {
+          sChanged.i16XMin = i32X;
+        }
+        if(i32X > sChanged.i16XMax) {
+          sChanged.i16XMax = i32X;
+        }
+        if(i32Y < sChanged.i16YMin) {
+          sChanged.i16YMin = i32Y;
+        }
+        sChanged.i16YMax = i32Y;
+      }
+    }
+  }
+  if(sChanged.i16XMax >= 0) {
+    FrameBufDamage(psFB, &sChanged);
+  }
+}
+
+//*****************************************************************************
+//
+// grlib display driver entry points.
+//
+//*****************************************************************************
+static void
+FrameBufPixelDraw(void *pvDisplayData, int32_t i32X, int32_t i32Y,
+                  uint32_t ui32Value)
+{
+  FrameBufFill((tFrameBuf *)pvDisplayData, i32X, i32Y, i32X, i32Y, ui32Value);
+}
+
+static void
+FrameBufLineDrawH(void *pvDisplayData, int32_t i32X1, int32_t i32X2,
+                  int32_t i32Y, uint32_t ui32Value)
+{
+  FrameBufFill((tFrameBuf *)pvDisplayData, i32X1, i32Y, i32X2, i32Y,
+               ui32Value);
+}
+
+static void
+FrameBufLineDrawV(void *pvDisplayData, int32_t i32X, int32_t i32Y1,
+                  int32_t i32Y2, uint32_t ui32Value)
+{
+  FrameBufFill((tFrameBuf *)pvDisplayData, i32X, i32Y1, i32X, i32Y2,
+               ui32Value);
+}
+
+static void
+FrameBufRectFill(void *pvDisplayData, const tRectangle *psRect,
+                 uint32_t ui32Value)
+{
+  FrameBufFill((tFrameBuf *)pvDisplayData, psRect->i16XMin, psRect->i16YMin,
+               psRect->i16XMax, psRect->i16YMax, ui32Value);
+}
+
+//*****************************************************************************
+//
+// Translates a 24-bit RGB color with the panel driver and swaps the bytes,
+// giving the pixel in the order it is sent.
+//
+//*****************************************************************************
+static uint32_t
+FrameBufPanelColor(tFrameBuf *psFB, uint32_t ui32Color)
+{
+  const tDisplay *psPanel = psFB->psPanel;
+
+  ui32Color = psPanel->pfnColorTranslate(psPanel->pvDisplayData, ui32Color);
+  return(((ui32Color >> 8) & 0xFF) | ((ui32Color & 0xFF) << 8));
+}
+
+//*****************************************************************************
+//
+// Puts a color in a palette entry.
+//
+//*****************************************************************************
+static void
+FrameBufPaletteStore(tFrameBuf *psFB, uint32_t ui32Index, uint32_t ui32Color)
+{
+  psFB->pui32Palette[ui32Index] = ui32Color;
+  psFB->pui16Expand[ui32Index] = FrameBufPanelColor(psFB, ui32Color);
+  psFB->ui32PaletteUsed |= 1 << ui32Index;
+}
+
+//*****************************************************************************
+//
+// Finds the palette index for a 24-bit RGB color.  A color not held yet
+// takes a free entry; once none is left it is drawn as the nearest color
+// held.  Entries the application set itself are only used when asked for
+// by FRAMEBUF_INDEX().
+//
+//*****************************************************************************
+static uint32_t
+FrameBufPaletteFind(tFrameBuf *psFB, uint32_t ui32Color)
+{
+  uint32_t ui32Index, ui32Best, ui32Dist, ui32BestDist, ui32Shift;
+  int32_t i32Diff;
+
+  if(ui32Color & FRAMEBUF_INDEX_FLAG) {
+    return(ui32Color & (FRAMEBUF_PALETTE_SIZE - 1));
+  }
+  ui32Color &= 0x00FFFFFF;
+
+  for(ui32Index = 0; ui32Index < FRAMEBUF_PALETTE_SIZE; ui32Index++) {
+    if(((psFB->ui32PaletteUsed & ~psFB->ui32PaletteFixed) &
+        (1 << ui32Index)) && (psFB->pui32Palette[ui32Index] == ui32Color)) {
+      return(ui32Index);
+    }
+  }
+  for(ui32Index = 0; ui32Index < FRAMEBUF_PALETTE_SIZE; ui32Index++) {
+    if(!(psFB->ui32PaletteUsed & (1 << ui32Index))) {
+      FrameBufPaletteStore(psFB, ui32Index, ui32Color);
+      return(ui32Index);
+    }
+  }
+
+  psFB->ui32PaletteMisses++;
+  ui32Best = 0;
+  ui32BestDist = 0xFFFFFFFF;
+  for(ui32Index = 0; ui32Index < FRAMEBUF_PALETTE_SIZE; ui32Index++) {
+    if(psFB->ui32PaletteFixed & (1 << ui32Index)) {
+      continue;
+    }
+    ui32Dist = 0;
+    for(ui32Shift = 0; ui32Shift < 24; ui32Shift += 8) {
+      i32Diff = ((ui32Color >> ui32Shift) & 0xFF) -
+                ((psFB->pui32Palette[ui32Index] >> ui32Shift) & 0xFF);
+      ui32Dist += i32Diff * i32Diff;
+    }
+    if(ui32Dist < ui32BestDist) {
+      ui32Best = ui32Index;
+      ui32BestDist = ui32Dist;
+    }
+  }
+
+  return(ui32Best);
+}
+
+//*****************************************************************************
+//
+// Translates a 24-bit RGB color into a pixel value: the color as it is sent
+// to the panel, or its palette index.
+//
+//*****************************************************************************
+static uint32_t
+FrameBufColorTranslate(void *pvDisplayData, uint32_t ui32Value)
+{
+  tFrameBuf *psFB = (tFrameBuf *)pvDisplayData;
+
+  if(psFB->pui8Indices) {
+    return(FrameBufPaletteFind(psFB, ui32Value));
+  }
+
+  return(FrameBufPanelColor(psFB, ui32Value));
+}
+
+//*****************************************************************************
+//
+// Draws a row of pixels from a 1, 4 or 8 bit per pixel image.  1 bpp
+// palettes hold translated colors; the others hold 24-bit RGB triplets.
+// i32X0 is the first pixel's position within the first byte of pui8Data.
+//
+//*****************************************************************************
+static void
+FrameBufPixelDrawMultiple(void *pvDisplayData, int32_t i32X, int32_t i32Y,
+                          int32_t i32X0, int32_t i32Count, int32_t i32BPP,
+                          const uint8_t *pui8Data, const uint8_t *pui8Palette)
+{
+  tFrameBuf *psFB = (tFrameBuf *)pvDisplayData;
+  tRectangle sChanged;
+  uint32_t ui32Pos, ui32Index, ui32Value;
+  int32_t i32Idx;
+
+  sChanged.i16XMin = i32X;
+  sChanged.i16YMin = i32Y;
+  sChanged.i16XMax = i32X + i32Count - 1;
+  sChanged.i16YMax = i32Y;
+  FrameBufGuard(psFB, &sChanged);
+
+  sChanged.i16XMin = FRAMEBUF_WIDTH;
+  sChanged.i16XMax = -1;
+  for(i32Idx = 0; i32Idx < i32Count; i32Idx++) {
+    ui32Pos = i32X0 + i32Idx;
+    switch(i32BPP & 0xFF) {
+    case 1:
+      ui32Index = (pui8Data[ui32Pos >> 3] >> (7 - (ui32Pos & 7))) & 1;
+      ui32Value = ((const uint32_t *)pui8Palette)[ui32Index];
+      break;
+    case 4:
+      ui32Index = (pui8Data[ui32Pos >> 1] >> ((ui32Pos & 1) ? 0 : 4)) & 15;
+      ui32Value = FrameBufColorTranslate(psFB,
+                                         pui8Palette[ui32Index * 3] |
+                                         (pui8Palette[ui32Index * 3 + 1] << 8) |
+                                         (pui8Palette[ui32Index * 3 + 2] << 16));
+      break;
+    case 8:
+      ui32Index = pui8Data[ui32Pos];
+      ui32Value = FrameBufColorTranslate(psFB,
+                                         pui8Palette[ui32Index * 3] |
+                                         (pui8Palette[ui32Index * 3 + 1] << 8) |
+                                         (pui8Palette[ui32Index * 3 + 2] << 16));
+      break;
+    default:
+      return;
+    }
+    if(FrameBufPut(psFB, i32X + i32Idx, i32Y, ui32Value)) {
+      if(sChanged.i16XMax < 0) {
+        sChanged.i16XMin = i32X + i32Idx;
+      }
+      sChanged.i16XMax = i32X + i32Idx;
+    }
+  }
+  if(sChanged.i16XMax >= 0) {
+    sChanged.i16YMin = i32Y;
+    sChanged.i16YMax = i32Y;
+    FrameBufDamage(psFB, &sChanged);
+  }
+}
+
+static void
+FrameBufFlushDisplay(void *pvDisplayData)
+{
+  FrameBufFlush((tFrameBuf *)pvDisplayData);
+}
+
+//*****************************************************************************
+//
+// Returns the pixels of row i32Y from i32X1 to i32X2 as they are sent.
+// Indexed pixels are expanded through the palette into pui16Line, which
+// holds them until the next call.
+//
+//*****************************************************************************
+static const uint8_t *
+FrameBufRow(tFrameBuf *psFB, int32_t i32Y, int32_t i32X1, int32_t i32X2)
+{
+  int32_t i32X;
+
+  if(!psFB->pui8Indices) {
+    return((const uint8_t *)&psFB->pui16Pixels[(i32Y * FRAMEBUF_WIDTH) +
+                                                i32X1]);
+  }
+  for(i32X = i32X1; i32X <= i32X2; i32X++) {
+    psFB->pui16Line[i32X - i32X1] =
+      psFB->pui16Expand[FrameBufGet(psFB, i32X, i32Y)];
+  }
+
+  return((const uint8_t *)psFB->pui16Line);
+}
+
+//*****************************************************************************
+//
+// Opens a panel window over a rectangle and leaves the panel taking pixel
+// data, which then fills the window row by row.
+//
+//*****************************************************************************
+static void
+FrameBufPanelWindow(const tRectangle *psRect)
+{
+  uint8_t pui8Cmd[6];
+  uint32_t ui32Idx;
+
+  pui8Cmd[0] = SSD1332_SET_COLUMN;
+  pui8Cmd[1] = psRect->i16XMin;
+  pui8Cmd[2] = psRect->i16XMax;
+  pui8Cmd[3] = SSD1332_SET_ROW;
+  pui8Cmd[4] = psRect->i16YMin;
+  pui8Cmd[5] = psRect->i16YMax;
+
+  // D/C may only change once the bytes before it are out of the shifter.
+  while(SSIBusy(FRAMEBUF_SSI_BASE)) {
+  }
+  GPIOPinWrite(FRAMEBUF_DC_BASE, FRAMEBUF_DC_PIN, 0);
+  for(ui32Idx = 0; ui32Idx < sizeof(pui8Cmd); ui32Idx++) {
+    SSIDataPut(FRAMEBUF_SSI_BASE, pui8Cmd[ui32Idx]);
+  }
+  while(SSIBusy(FRAMEBUF_SSI_BASE)) {
+  }
+  GPIOPinWrite(FRAMEBUF_DC_BASE, FRAMEBUF_DC_PIN, FRAMEBUF_DC_PIN);
+}
+
+//*****************************************************************************
+//
+// Records a flush of ui32Pixels pixels over ui32Windows windows.
+//
+//*****************************************************************************
+static void
+FrameBufTally(tFrameBuf *psFB, uint32_t ui32Windows, uint32_t ui32Pixels)
+{
+  psFB->ui32Windows = ui32Windows;
+  psFB->ui32Pixels = ui32Pixels;
+  if(ui32Pixels) {
+    psFB->ui32Frames++;
+    psFB->ui32Total += ui32Pixels;
+  }
+}
+
+//*****************************************************************************
+//
+// Queues the next uDMA transfer of the flush in flight, opening each
+// region's window as its first row comes up.  Returns false once every
+// region has been handed to the SSI.
+//
+//*****************************************************************************
+static bool
+FrameBufDMANext(tFrameBuf *psFB)
+{
+  const tRectangle *psRect;
+  uint32_t ui32Bytes, ui32Rows;
+
+  while(psFB->ui32Sent < psFB->ui32NumSending) {
+    psRect = &psFB->psSending[psFB->ui32Sent];
+    if(psFB->i32Row > psRect->i16YMax) {
+      if(++psFB->ui32Sent < psFB->ui32NumSending) {
+        psFB->i32Row = psFB->psSending[psFB->ui32Sent].i16YMin;
+      }
+      continue;
+    }
+
+    // The window command is written by the CPU, so the SSI must not be
+    // asking the uDMA for data meanwhile.
+    if(psFB->i32Row == psRect->i16YMin) {
+      SSIDMADisable(FRAMEBUF_SSI_BASE, SSI_DMA_TX);
+      FrameBufPanelWindow(psRect);
+    }
+
+    // Full width rows follow one another in RAM, so several fit in one
+    // transfer.  Anything narrower, and any indexed row, which has to be
+    // expanded first, goes a row at a time.  The uDMA has read the whole of
+    // a transfer by the time it ends, so one row buffer is enough.
+    ui32Bytes = (psRect->i16XMax - psRect->i16XMin + 1) * 2;
+    ui32Rows = 1;
+    if((ui32Bytes == (FRAMEBUF_WIDTH * 2)) && !psFB->pui8Indices) {
+      ui32Rows = psRect->i16YMax - psFB->i32Row + 1;
+      if(ui32Rows > (FRAMEBUF_DMA_MAX_XFER / ui32Bytes)) {
+        ui32Rows = FRAMEBUF_DMA_MAX_XFER / ui32Bytes;
+      }
+    }
+    uDMAChannelTransferSet(psFB->ui32Channel | UDMA_PRI_SELECT,
+                           UDMA_MODE_BASIC,
+                           (void *)FrameBufRow(psFB, psFB->i32Row,
+                                               psRect->i16XMin,
+                                               psRect->i16XMax),
+                           (void *)(FRAMEBUF_SSI_BASE + SSI_O_DR),
+                           ui32Rows * ui32Bytes);
+    psFB->i32Row += ui32Rows;
+    uDMAChannelEnable(psFB->ui32Channel);
+    SSIDMAEnable(FRAMEBUF_SSI_BASE, SSI_DMA_TX);
+    return(true);
+  }
+
+  return(false);
+}
+
+//*****************************************************************************
+//
+// Retires a finished flush and runs its callback.  Called with the SSI
+// interrupt unable to preempt.
+//
+//*****************************************************************************
+static void
+FrameBufDMAComplete(tFrameBuf *psFB)
+{
+  tFrameBufCallback pfnCallback = psFB->pfnCallback;
+  void *pvCBData = psFB->pvCBData;
+
+  SSIDMADisable(FRAMEBUF_SSI_BASE, SSI_DMA_TX);
+  psFB->bBusy = false;
+
+  if(pfnCallback) {
+    pfnCallback(pvCBData);
+  }
+}
+
+//*****************************************************************************
+//
+// Sets up the parts common to both pixel formats.  The framebuffer starts
+// black with the whole screen dirty, so the first flush brings the panel
+// into step with it.
+//
+//*****************************************************************************
+static void
+FrameBufSetup(tFrameBuf *psFB, const tDisplay *psPanel)
+{
+  psFB->sDisplay.i32Size = sizeof(tDisplay);
+  psFB->sDisplay.pvDisplayData = psFB;
+  psFB->sDisplay.ui16Width = FRAMEBUF_WIDTH;
+  psFB->sDisplay.ui16Height = FRAMEBUF_HEIGHT;
+  psFB->sDisplay.pfnPixelDraw = FrameBufPixelDraw;
+  psFB->sDisplay.pfnPixelDrawMultiple = FrameBufPixelDrawMultiple;
+  psFB->sDisplay.pfnLineDrawH = FrameBufLineDrawH;
+  psFB->sDisplay.pfnLineDrawV = FrameBufLineDrawV;
+  psFB->sDisplay.pfnRectFill = FrameBufRectFill;
+  psFB->sDisplay.pfnColorTranslate = FrameBufColorTranslate;
+  psFB->sDisplay.pfnFlush = FrameBufFlushDisplay;
+  psFB->psPanel = psPanel;
+  psFB->ui32Pixels = 0;
+  psFB->ui32Windows = 0;
+  psFB->ui32Frames = 0;
+  psFB->ui32Total = 0;
+  psFB->bDMA = false;
+  psFB->bBusy = false;
+  psFB->ui32NumSending = 0;
+  psFB->ui32Sent = 0;
+  psFB->pfnCallback = 0;
+  psFB->ui32Stalls = 0;
+  psFB->ui32PaletteUsed = 0;
+  psFB->ui32PaletteFixed = 0;
+  psFB->ui32PaletteMisses = 0;
+  FrameBufInvalidate(psFB);
+}
+
+//*****************************************************************************
+//
+// Sets up a full color framebuffer in front of a panel driver, drawing into
+// FRAMEBUF_PIXELS pixels at pui16Pixels.
+//
+//*****************************************************************************
+void
+FrameBufInit(tFrameBuf *psFB, const tDisplay *psPanel, uint16_t *pui16Pixels)
+{
+  uint32_t ui32Idx;
+
+  psFB->pui16Pixels = pui16Pixels;
+  psFB->pui8Indices = 0;
+  FrameBufSetup(psFB, psPanel);
+  for(ui32Idx = 0; ui32Idx < FRAMEBUF_PIXELS; ui32Idx++) {
+    psFB->pui16Pixels[ui32Idx] = 0;
+  }
+}
+
+//*****************************************************************************
+//
+// Sets up an indexed framebuffer in front of a panel driver, drawing into
+// FRAMEBUF_INDEXED_BYTES bytes at pui8Indices.  Palette entry 0 starts as
+// black; the others are filled as new colors are set.
+//
+//*****************************************************************************
+void
+FrameBufInitIndexed(tFrameBuf *psFB, const tDisplay *psPanel,
+                    uint8_t *pui8Indices)
+{
+  uint32_t ui32Idx;
+
+  psFB->pui16Pixels = 0;
+  psFB->pui8Indices = pui8Indices;
+  FrameBufSetup(psFB, psPanel);
+  FrameBufPaletteStore(psFB, 0, ClrBlack);
+  for(ui32Idx = 0; ui32Idx < FRAMEBUF_INDEXED_BYTES; ui32Idx++) {
+    psFB->pui8Indices[ui32Idx] = 0;
+  }
+}
+
+//*****************************************************************************
+//
+// Sets palette entry ui32Index of an indexed framebuffer to a 24-bit RGB
+// color.  Every pixel drawn with the entry is marked dirty, so the next
+// flush shows it in the new color with nothing drawn again.  The entry then
+// belongs to the application: it is drawn with only as FRAMEBUF_INDEX(),
+// never given out for another color.  Does nothing to a full color
+// framebuffer.
+//
+// The first call for an entry searches the screen for its pixels.  From
+// then on the area they cover is kept up as they are drawn, so changing
+// the color again costs only the flush.  The area only grows: pixels drawn
+// over in another index are still resent.
+//
+//*****************************************************************************
+void
+FrameBufPaletteSet(tFrameBuf *psFB, uint32_t ui32Index, uint32_t ui32Color)
+{
+  tRectangle *psArea;
+  int32_t i32X, i32Y;
+
+  if(!psFB->pui8Indices || (ui32Index >= FRAMEBUF_PALETTE_SIZE)) {
+    return;
+  }
+  ui32Color &= 0x00FFFFFF;
+  psArea = &psFB->psFixedArea[ui32Index];
+
+  if(psFB->ui32PaletteFixed & (1 << ui32Index)) {
+    if(psFB->pui32Palette[ui32Index] == ui32Color) {
+      return;
+    }
+  }
+  else {
+    psFB->ui32PaletteFixed |= 1 << ui32Index;
+    psArea->i16XMin = 0;
+    psArea->i16XMax = -1;
+    for(i32Y = 0; i32Y < FRAMEBUF_HEIGHT; i32Y++) {
+      for(i32X = 0; i32X < FRAMEBUF_WIDTH; i32X++) {
+        if(FrameBufGet(psFB, i32X, i32Y) == ui32Index) {
+          FrameBufGrow(psArea, i32X, i32Y);
+        }
+      }
+    }
+  }
+  FrameBufPaletteStore(psFB, ui32Index, ui32Color);
+
+  if(psArea->i16XMax >= psArea->i16XMin) {
+    FrameBufDamage(psFB, psArea);
+  }
+}
+
+//*****************************************************************************
+//
+// Marks the whole screen dirty, e.g. after something else has drawn on the
+// panel directly.
+//
+//*****************************************************************************
+void
+FrameBufInvalidate(tFrameBuf *psFB)
+{
+  psFB->psDirty[0].i16XMin = 0;
+  psFB->psDirty[0].i16YMin = 0;
+  psFB->psDirty[0].i16XMax = FRAMEBUF_WIDTH - 1;
+  psFB->psDirty[0].i16YMax = FRAMEBUF_HEIGHT - 1;
+  psFB->ui32NumDirty = 1;
+}
+
+//*****************************************************************************
+//
+// Sends each dirty region to the panel through its own window and clears
+// the dirty list.  Returns the number of pixels sent, which is also kept
+// in ui32Pixels so the saving over a full redraw can be watched.  Any
+// flush the uDMA is still sending is finished first.
+//
+//*****************************************************************************
+uint32_t
+FrameBufFlush(tFrameBuf *psFB)
+{
+  const tRectangle *psRect;
+  const uint8_t *pui8Row;
+  uint32_t ui32Idx, ui32Byte, ui32Bytes, ui32Pixels;
+  int32_t i32Y;
+
+  FrameBufWait(psFB);
+
+  ui32Pixels = 0;
+  for(ui32Idx = 0; ui32Idx < psFB->ui32NumDirty; ui32Idx++) {
+    psRect = &psFB->psDirty[ui32Idx];
+    FrameBufPanelWindow(psRect);
+    ui32Bytes = (psRect->i16XMax - psRect->i16XMin + 1) * 2;
+    for(i32Y = psRect->i16YMin; i32Y <= psRect->i16YMax; i32Y++) {
+      pui8Row = FrameBufRow(psFB, i32Y, psRect->i16XMin, psRect->i16XMax);
+      for(ui32Byte = 0; ui32Byte < ui32Bytes; ui32Byte++) {
+        SSIDataPut(FRAMEBUF_SSI_BASE, pui8Row[ui32Byte]);
+      }
+    }
+    ui32Pixels += FrameBufArea(psRect);
+  }
+
+  FrameBufTally(psFB, psFB->ui32NumDirty, ui32Pixels);
+  psFB->ui32NumDirty = 0;
+
+  return(ui32Pixels);
+}
+
+//*****************************************************************************
+//
+// Clips psRect to the screen into psClip.  Returns false if nothing is left.
+//
+//*****************************************************************************
+static bool
+FrameBufClip(const tRectangle *psRect, tRectangle *psClip)
+{
+  *psClip = *psRect;
+  if(psClip->i16XMin < 0) {
+    psClip->i16XMin = 0;
+  }
+  if(psClip->i16YMin < 0) {
+    psClip->i16YMin = 0;
+  }
+  if(psClip->i16XMax > (FRAMEBUF_WIDTH - 1)) {
+    psClip->i16XMax = FRAMEBUF_WIDTH - 1;
+  }
+  if(psClip->i16YMax > (FRAMEBUF_HEIGHT - 1)) {
+    psClip->i16YMax = FRAMEBUF_HEIGHT - 1;
+  }
+
+  return((psClip->i16XMin <= psClip->i16XMax) &&
+         (psClip->i16YMin <= psClip->i16YMax));
+}
+
+//*****************************************************************************
+//
+// Copies the pixels under psRect into pui16Dst, which is laid out row by
+// row with the width of psRect.  Pixels off the screen are left untouched.
+// Pixels are in the framebuffer's own format, for FrameBufBlit().
+//
+//*****************************************************************************
+void
+FrameBufRead(tFrameBuf *psFB, const tRectangle *psRect, uint16_t *pui16Dst)
+{
+  tRectangle sClip;
+  uint32_t ui32Stride;
+  int32_t i32X, i32Y;
+
+  if(!FrameBufClip(psRect, &sClip)) {
+    return;
+  }
+  ui32Stride = psRect->i16XMax - psRect->i16XMin + 1;
+  for(i32Y = sClip.i16YMin; i32Y <= sClip.i16YMax; i32Y++) {
+    for(i32X = sClip.i16XMin; i32X <= sClip.i16XMax; i32X++) {
+      pui16Dst[((i32Y - psRect->i16YMin) * ui32Stride) +
+               (i32X - psRect->i16XMin)] = FrameBufGet(psFB, i32X, i32Y);
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// Writes a block of pixels, laid out as for FrameBufRead(), over psRect.
+// If pui8Mask is given, only pixels whose bit is set are written; each row
+// of the mask starts on a byte and the first pixel is the top bit.  Parts
+// off the screen are clipped, and only pixels that change are marked dirty.
+//
+//*****************************************************************************
+void
+FrameBufBlit(tFrameBuf *psFB, const tRectangle *psRect,
+             const uint16_t *pui16Src, const uint8_t *pui8Mask)
+{
+  tRectangle sClip, sChanged;
+  uint32_t ui32Stride, ui32MaskStride, ui32Col, ui32Row;
+  int32_t i32X, i32Y;
+
+  if(!FrameBufClip(psRect, &sClip)) {
+    return;
+  }
+  FrameBufGuard(psFB, &sClip);
+
+  ui32Stride = psRect->i16XMax - psRect->i16XMin + 1;
+  ui32MaskStride = (ui32Stride + 7) / 8;
+  sChanged.i16XMin = FRAMEBUF_WIDTH;
+  sChanged.i16YMin = FRAMEBUF_HEIGHT;
+  sChanged.i16XMax = -1;
+  sChanged.i16YMax = -1;
+  for(i32Y = sClip.i16YMin; i32Y <= sClip.i16YMax; i32Y++) {
+    ui32Row = i32Y - psRect->i16YMin;
+    for(i32X = sClip.i16XMin; i32X <= sClip.i16XMax; i32X++) {
+      ui32Col = i32X - psRect->i16XMin;
+      if(pui8Mask &&
+         !(pui8Mask[(ui32Row * ui32MaskStride) + (ui32Col / 8)] &
+           (0x80 >> (ui32Col & 7)))) {
+        continue;
+      }
+      if(FrameBufPut(psFB, i32X, i32Y,
+                     pui16Src[(ui32Row * ui32Stride) + ui32Col])) {
+        if(i32X < sChanged.i16XMin) {
+          sChanged.i16XMin = i32X;
+        }
+        if(i32X > sChanged.i16XMax) {
+          sChanged.i16XMax = i32X;
+        }
+        if(i32Y < sChanged.i16YMin) {
+          sChanged.i16YMin = i32Y;
+        }
+        sChanged.i16YMax = i32Y;
+      }
+    }
+  }
+  if(sChanged.i16XMax >= 0) {
+    FrameBufDamage(psFB, &sChanged);
+  }
+}
+
+//*****************************************************************************
+//
+// Attaches a uDMA channel for FrameBufFlushAsync(), after FrameBufInit().
+// ui32Channel is the channel mapping for the panel's SSI TX request,
+// UDMA_CH13_SSI2TX on the DK-TM4C123G.  The uDMA reports completion on the
+// SSI's interrupt, whose handler must call FrameBufIntHandler().
+//
+//*****************************************************************************
+void
+FrameBufDMAInit(tFrameBuf *psFB, uint32_t ui32Channel)
+{
+  psFB->ui32Channel = ui32Channel & 0xff;
+  psFB->bDMA = true;
+
+  uDMAControlInit();
+  uDMAChannelAssign(ui32Channel);
+  uDMAChannelAttributeDisable(psFB->ui32Channel,
+                              UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST |
+                              UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+
+  // Byte writes to the fixed data register.  The SSI raises a burst request
+  // once half of its eight entry TX FIFO is free.
+  uDMAChannelControlSet(psFB->ui32Channel | UDMA_PRI_SELECT,
+                        UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE |
+                        UDMA_ARB_4);
+}
+
+//*****************************************************************************
+//
+// Hands the dirty regions to the uDMA and returns while they are sent.
+// pfnCallback, if given, runs from the SSI interrupt when the last pixel has
+// gone to the SSI.  Returns false if nothing was queued, either because
+// nothing changed or because a flush is still in flight; the damage is then
+// kept for the next call.  Without a uDMA channel the flush is done at once
+// and the callback run before returning.
+//
+// Drawing and queueing must happen in the same context: a callback may
+// signal the main loop, but should not queue the next flush itself.
+//
+//*****************************************************************************
+bool
+FrameBufFlushAsync(tFrameBuf *psFB, tFrameBufCallback pfnCallback,
+                   void *pvCBData)
+{
+  uint32_t ui32Idx, ui32Pixels;
+  bool bWasDisabled;
+
+  if(!psFB->bDMA) {
+    if(FrameBufFlush(psFB) == 0) {
+      return(false);
+    }
+    if(pfnCallback) {
+      pfnCallback(pvCBData);
+    }
+    return(true);
+  }
+  if(psFB->bBusy || (psFB->ui32NumDirty == 0)) {
+    return(false);
+  }
+
+  // The dirty list moves to the sending list, so new damage collects for
+  // the next flush while this one is out.
+  ui32Pixels = 0;
+  for(ui32Idx = 0; ui32Idx < psFB->ui32NumDirty; ui32Idx++) {
+    psFB->psSending[ui32Idx] = psFB->psDirty[ui32Idx];
+    ui32Pixels += FrameBufArea(&psFB->psDirty[ui32Idx]);
+  }
+  psFB->ui32NumSending = psFB->ui32NumDirty;
+  FrameBufTally(psFB, psFB->ui32NumDirty, ui32Pixels);
+  psFB->ui32NumDirty = 0;
+  psFB->ui32Sent = 0;
+  psFB->i32Row = psFB->psSending[0].i16YMin;
+  psFB->pfnCallback = pfnCallback;
+  psFB->pvCBData = pvCBData;
+
+  bWasDisabled = IntMasterDisable();
+  psFB->bBusy = true;
+  FrameBufDMANext(psFB);
+  if(!bWasDisabled) {
+    IntMasterEnable();
+  }
+
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Returns true while a flush queued by FrameBufFlushAsync() is being sent.
+//
+//*****************************************************************************
+bool
+FrameBufBusy(tFrameBuf *psFB)
+{
+  return(psFB->bBusy);
+}
+
+//*****************************************************************************
+//
+// Blocks until any flush in flight has been sent.  Polls the channel, so it
+// also works with interrupts masked.
+//
+//*****************************************************************************
+void
+FrameBufWait(tFrameBuf *psFB)
+{
+  while(psFB->bBusy) {
+    FrameBufPoll(psFB);
+  }
+}
+
+//*****************************************************************************
+//
+// Completion service.  The uDMA signals the end of each transfer on the
+// SSI's own interrupt vector, so the panel's SSI interrupt handler calls
+// this.  It queues the next transfer, or retires the flush after the last.
+//
+//*****************************************************************************
+void
+FrameBufIntHandler(tFrameBuf *psFB)
+{
+  if(psFB->bBusy && !uDMAChannelIsEnabled(psFB->ui32Channel)) {
+    if(!FrameBufDMANext(psFB)) {
+      FrameBufDMAComplete(psFB);
+    }
+  }
+}
@@ -0,0 +1,151 @@
+//*****************************************************************************
+//
+// framebuf.h - Prototypes for the off-screen OLED framebuffer.
+//
+//*****************************************************************************
+
+#ifndef __FRAMEBUF_H__
+#define __FRAMEBUF_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "grlib/grlib.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Size of the CFAL96x64x16 panel the framebuffer mirrors.
+//
+//*****************************************************************************
+#define FRAMEBUF_WIDTH          96
+#define FRAMEBUF_HEIGHT         64
+
+//*****************************************************************************
+//
+// Storage the application provides for the pixels: FRAMEBUF_PIXELS 16-bit
+// pixels for FrameBufInit(), or FRAMEBUF_INDEXED_BYTES bytes of 4-bit
+// palette indices for FrameBufInitIndexed().
+//
+//*****************************************************************************
+#define FRAMEBUF_PIXELS         (FRAMEBUF_WIDTH * FRAMEBUF_HEIGHT)
+#define FRAMEBUF_INDEXED_BYTES  (FRAMEBUF_PIXELS / 2)
+
+//*****************************************************************************
+//
+// Colors an indexed framebuffer can hold at once.  A color passed to grlib
+// as FRAMEBUF_INDEX(n) draws with palette entry n itself, whatever color it
+// currently holds, so the entry can later be changed with
+// FrameBufPaletteSet() without drawing anything again.
+//
+//*****************************************************************************
+#define FRAMEBUF_PALETTE_SIZE   16
+#define FRAMEBUF_INDEX_FLAG     0x80000000
+#define FRAMEBUF_INDEX(n)       (FRAMEBUF_INDEX_FLAG | (n))
+
+//*****************************************************************************
+//
+// Most separate dirty rectangles tracked between flushes.  Damage that
+// touches a tracked rectangle is merged into it; once all are in use, new
+// damage is merged into whichever one grows least.
+//
+//*****************************************************************************
+#define FRAMEBUF_MAX_DIRTY      4
+
+//*****************************************************************************
+//
+// The largest block a single basic-mode uDMA transfer can move.  Regions
+// that span the full width are contiguous in RAM and go out several rows per
+// transfer; narrower ones go out a row at a time.
+//
+//*****************************************************************************
+#define FRAMEBUF_DMA_MAX_XFER   1024
+
+//*****************************************************************************
+//
+// Called from the SSI interrupt once the last pixel of a queued flush has
+// been handed to the SSI.
+//
+//*****************************************************************************
+typedef void (*tFrameBufCallback)(void *pvCBData);
+
+//*****************************************************************************
+//
+// Framebuffer state.  Drawing goes to RAM through sDisplay, and only the
+// pixels that really changed are marked dirty, so redrawing an unchanged
+// bar or string costs nothing at the next flush.  Full color pixels are held
+// in the byte order the panel expects, ready to be shifted out as they are.
+// Indexed pixels take a quarter of the RAM and are looked up in the palette
+// a row at a time as they are sent.
+//
+// With a uDMA channel attached, FrameBufFlushAsync() moves the dirty list to
+// psSending and returns while the uDMA feeds the panel.  Drawing may go on
+// meanwhile; only a primitive that would write pixels still waiting to be
+// sent stops until they are out.
+//
+//*****************************************************************************
+typedef struct
+{
+  tDisplay sDisplay;            // Pass to GrContextInit() to draw in RAM
+  const tDisplay *psPanel;      // Panel driver, for its color translation
+  uint16_t *pui16Pixels;        // 16-bit pixels, or 0 if indexed
+  uint8_t *pui8Indices;         // 4-bit indices, two a byte, or 0
+  uint32_t pui32Palette[FRAMEBUF_PALETTE_SIZE]; // 24-bit RGB of each index
+  uint16_t pui16Expand[FRAMEBUF_PALETTE_SIZE];  // Same, as sent to the panel
+  uint32_t ui32PaletteUsed;     // Bit mask of indices holding a color
+  uint32_t ui32PaletteFixed;    // Indices set by FrameBufPaletteSet()
+  tRectangle psFixedArea[FRAMEBUF_PALETTE_SIZE];        // Area drawn with
+                                                        // each fixed index
+  uint32_t ui32PaletteMisses;   // Colors drawn as the nearest one held
+  tRectangle psDirty[FRAMEBUF_MAX_DIRTY];       // Regions to send next flush
+  uint32_t ui32NumDirty;        // Entries in use in psDirty
+  uint32_t ui32Pixels;          // Pixels sent by the last flush
+  uint32_t ui32Windows;         // Panel windows written by the last flush
+  uint32_t ui32Frames;          // Flushes that sent anything
+  uint32_t ui32Total;           // Pixels sent since FrameBufInit()
+  bool bDMA;                    // FrameBufDMAInit() has attached a channel
+  uint32_t ui32Channel;         // uDMA channel mapped to the SSI TX request
+  volatile bool bBusy;          // A flush is being sent by the uDMA
+  tRectangle psSending[FRAMEBUF_MAX_DIRTY];     // Regions of that flush
+  uint32_t ui32NumSending;      // Entries in use in psSending
+  volatile uint32_t ui32Sent;   // psSending entries already sent
+  int32_t i32Row;               // Next row of psSending[ui32Sent] to queue
+  tFrameBufCallback pfnCallback;        // Completion callback, may be 0
+  void *pvCBData;               // Argument passed to pfnCallback
+  uint32_t ui32Stalls;          // Draws that waited for pixels being sent
+  uint16_t pui16Line[FRAMEBUF_WIDTH];   // Indexed row expanded for sending
+} tFrameBuf;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void FrameBufInit(tFrameBuf *psFB, const tDisplay *psPanel,
+                         uint16_t *pui16Pixels);
+extern void FrameBufInitIndexed(tFrameBuf *psFB, const tDisplay *psPanel,
+                                uint8_t *pui8Indices);
+extern void FrameBufPaletteSet(tFrameBuf *psFB, uint32_t ui32Index,
+                               uint32_t ui32Color);
+extern void FrameBufInvalidate(tFrameBuf *psFB);
+extern uint32_t FrameBufFlush(tFrameBuf *psFB);
+extern void FrameBufRead(tFrameBuf *psFB, const tRectangle *psRect,
+                         uint16_t *pui16Dst);
+extern void FrameBufBlit(tFrameBuf *psFB, const tRectangle *psRect,
+                         const uint16_t *pui16Src, const uint8_t *pui8Mask);
+extern void FrameBufDMAInit(tFrameBuf *psFB, uint32_t ui32Channel);
+extern bool FrameBufFlushAsync(tFrameBuf *psFB, tFrameBufCallback pfnCallback,
+                               void *pvCBData);
+extern bool FrameBufBusy(tFrameBuf *psFB);
+extern void FrameBufWait(tFrameBuf *psFB);
+extern void FrameBufIntHandler(tFrameBuf *psFB);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FRAMEBUF_H__
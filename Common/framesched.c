@@ -0,0 +1,125 @@
+//*****************************************************************************
+//
+// framesched.c - Timer-paced frame scheduler.
+//
+// An animation paced by an empty delay loop runs at whatever speed the clock
+// and the drawing allow.  Here a periodic timer marks each frame deadline
+// and the frame loop waits for it, so frames start at the target rate at
+// any clock speed.  FrameSchedWait() returns the time that really passed
+// since the previous frame, so motion can be advanced by time rather than
+// by frame and looks the same even when a frame runs late.
+//
+// Each frame's drawing time is measured with the cycle counter, which must
+// already be running.  A frame that is still drawing when its deadline
+// passes counts as a missed deadline; the next frame then starts at once.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "inc/hw_memmap.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/timer.h"
+
+#include "cyccnt.h"
+#include "framesched.h"
+
+//*****************************************************************************
+//
+// Sets a timer running at ui32FPS and clears the statistics.  ui32SysClk is
+// the clock the timer runs from, normally SysCtlClockGet().  The timer must
+// be enabled, and its interrupt enabled in the NVIC and routed to a handler
+// that calls FrameSchedIntHandler().
+//
+//*****************************************************************************
+void
+FrameSchedInit(tFrameSched *psSched, uint32_t ui32Base, uint32_t ui32SysClk,
+               uint32_t ui32FPS)
+{
+  psSched->ui32Base = ui32Base;
+  psSched->ui32FPS = ui32FPS;
+  psSched->ui32CyclesPerUs = ui32SysClk / 1000000;
+  psSched->ui32Due = 0;
+  psSched->ui32Frames = 0;
+  psSched->ui32Missed = 0;
+  psSched->ui32MinUs = 0xFFFFFFFF;
+  psSched->ui32MaxUs = 0;
+  psSched->ui32TotalUs = 0;
+  psSched->ui32Start = CycleCounterGet();
+
+  TimerConfigure(ui32Base, TIMER_CFG_PERIODIC);
+  TimerLoadSet(ui32Base, TIMER_A, (ui32SysClk / ui32FPS) - 1);
+  TimerIntEnable(ui32Base, TIMER_TIMA_TIMEOUT);
+  TimerEnable(ui32Base, TIMER_A);
+}
+
+//*****************************************************************************
+//
+// Stops the timer once the animation is over.  The statistics are kept.
+//
+//*****************************************************************************
+void
+FrameSchedStop(tFrameSched *psSched)
+{
+  TimerDisable(psSched->ui32Base, TIMER_A);
+  TimerIntDisable(psSched->ui32Base, TIMER_TIMA_TIMEOUT);
+  TimerIntClear(psSched->ui32Base, TIMER_TIMA_TIMEOUT);
+}
+
+//*****************************************************************************
+//
+// Ends the current frame: records how long it took, waits for the next
+// deadline and starts the next frame.  Returns the microseconds since the
+// previous frame began, at most FRAME_SCHED_MAX_LAG frame periods.
+//
+//*****************************************************************************
+uint32_t
+FrameSchedWait(tFrameSched *psSched)
+{
+  uint32_t ui32Now, ui32Us, ui32MaxUs;
+  bool bWasDisabled;
+
+  ui32Now = CycleCounterGet();
+  ui32Us = (ui32Now - psSched->ui32Start) / psSched->ui32CyclesPerUs;
+  if(ui32Us < psSched->ui32MinUs) {
+    psSched->ui32MinUs = ui32Us;
+  }
+  if(ui32Us > psSched->ui32MaxUs) {
+    psSched->ui32MaxUs = ui32Us;
+  }
+  psSched->ui32TotalUs += ui32Us;
+  psSched->ui32Frames++;
+
+  // Deadlines that have already passed were missed by this frame.
+  psSched->ui32Missed += psSched->ui32Due;
+  while(psSched->ui32Due == 0) {
+  }
+  bWasDisabled = IntMasterDisable();
+  psSched->ui32Due = 0;
+  if(!bWasDisabled) {
+    IntMasterEnable();
+  }
+
+  ui32Now = CycleCounterGet();
+  ui32Us = (ui32Now - psSched->ui32Start) / psSched->ui32CyclesPerUs;
+  psSched->ui32Start = ui32Now;
+  ui32MaxUs = (FRAME_SCHED_MAX_LAG * 1000000) / psSched->ui32FPS;
+  if(ui32Us > ui32MaxUs) {
+    ui32Us = ui32MaxUs;
+  }
+
+  return(ui32Us);
+}
+
+//*****************************************************************************
+//
+// Timer interrupt service.  The timer's interrupt handler calls this.
+//
+//*****************************************************************************
+void
+FrameSchedIntHandler(tFrameSched *psSched)
+{
+  TimerIntClear(psSched->ui32Base, TIMER_TIMA_TIMEOUT);
+  psSched->ui32Due++;
+}
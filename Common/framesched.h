@@ -0,0 +1,63 @@
+//*****************************************************************************
+//
+// framesched.h - Prototypes for the timer-paced frame scheduler.
+//
+//*****************************************************************************
+
+#ifndef __FRAMESCHED_H__
+#define __FRAMESCHED_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Longest step, in frame periods, reported by FrameSchedWait().  After a
+// longer stall an animation resumes where it was instead of jumping ahead.
+//
+//*****************************************************************************
+#define FRAME_SCHED_MAX_LAG     4
+
+//*****************************************************************************
+//
+// Scheduler state.  The timer interrupt counts frame deadlines; the frame
+// loop waits for one in FrameSchedWait() and is told how much time passed
+// since the previous frame.  Frame times are the time from one wait
+// returning to the next wait being called, i.e. the work done per frame.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint32_t ui32Base;            // Timer whose A half sets the pace
+  uint32_t ui32FPS;             // Target frames per second
+  uint32_t ui32CyclesPerUs;     // System clocks per microsecond
+  volatile uint32_t ui32Due;    // Deadlines passed and not yet waited for
+  uint32_t ui32Start;           // Cycle count when the current frame began
+  uint32_t ui32Frames;          // Frames completed
+  uint32_t ui32Missed;          // Deadlines that passed while still drawing
+  uint32_t ui32MinUs;           // Shortest frame time
+  uint32_t ui32MaxUs;           // Longest frame time
+  uint32_t ui32TotalUs;         // Sum of frame times, for the average
+} tFrameSched;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void FrameSchedInit(tFrameSched *psSched, uint32_t ui32Base,
+                           uint32_t ui32SysClk, uint32_t ui32FPS);
+extern void FrameSchedStop(tFrameSched *psSched);
+extern uint32_t FrameSchedWait(tFrameSched *psSched);
+extern void FrameSchedIntHandler(tFrameSched *psSched);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FRAMESCHED_H__
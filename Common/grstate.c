@@ -0,0 +1,102 @@
+//*****************************************************************************
+//
+// grstate.c - Graphics context color cache.
+//
+// grlib keeps no drawing state beyond the fields of the tContext, and every
+// draw reads them afresh, so there is nothing to batch between draws and
+// setting a field costs no more than comparing it.  What a color set does
+// cost is the call through the display driver's translation, which the labs
+// make before nearly every draw for the same handful of colors.  These
+// wrappers translate each color once, remember the result, and store the
+// remembered value on later sets.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "grlib/grlib.h"
+
+#include "grstate.h"
+
+//*****************************************************************************
+//
+// Returns a 24-bit RGB color translated for the context's display, from the
+// recent colors if possible.
+//
+//*****************************************************************************
+static uint32_t
+GrStateTranslate(tGrState *psState, uint32_t ui32Color)
+{
+  const tDisplay *psDisplay = psState->psContext->psDisplay;
+  uint32_t ui32Idx, ui32Value;
+
+  for(ui32Idx = 0; ui32Idx < psState->ui32NumColors; ui32Idx++) {
+    if(psState->pui32RGB[ui32Idx] == ui32Color) {
+      psState->ui32Hits++;
+      return(psState->pui32Value[ui32Idx]);
+    }
+  }
+
+  ui32Value = psDisplay->pfnColorTranslate(psDisplay->pvDisplayData,
+                                           ui32Color);
+  psState->ui32Translated++;
+
+  psState->pui32RGB[psState->ui32Next] = ui32Color;
+  psState->pui32Value[psState->ui32Next] = ui32Value;
+  if(psState->ui32NumColors < GRSTATE_COLORS) {
+    psState->ui32NumColors++;
+  }
+  psState->ui32Next = (psState->ui32Next + 1) % GRSTATE_COLORS;
+
+  return(ui32Value);
+}
+
+//*****************************************************************************
+//
+// Binds a color cache to an initialized context.
+//
+//*****************************************************************************
+void
+GrStateInit(tGrState *psState, tContext *psContext)
+{
+  psState->psContext = psContext;
+  psState->ui32NumColors = 0;
+  psState->ui32Next = 0;
+  psState->ui32Hits = 0;
+  psState->ui32Translated = 0;
+}
+
+//*****************************************************************************
+//
+// Sets the foreground color, given as 24-bit RGB.
+//
+//*****************************************************************************
+void
+GrStateForegroundSet(tGrState *psState, uint32_t ui32Color)
+{
+  psState->psContext->ui32Foreground = GrStateTranslate(psState, ui32Color);
+}
+
+//*****************************************************************************
+//
+// Sets the background color, given as 24-bit RGB.
+//
+//*****************************************************************************
+void
+GrStateBackgroundSet(tGrState *psState, uint32_t ui32Color)
+{
+  psState->psContext->ui32Background = GrStateTranslate(psState, ui32Color);
+}
+
+//*****************************************************************************
+//
+// Sets the font.  Only a store, like grlib's own setter; it is here so all
+// of a draw's state can be set through the one wrapper.
+//
+//*****************************************************************************
+void
+GrStateFontSet(tGrState *psState, const tFont *psFont)
+{
+  GrContextFontSet(psState->psContext, psFont);
+}
@@ -0,0 +1,59 @@
+//*****************************************************************************
+//
+// grstate.h - Prototypes for the graphics context state cache.
+//
+//*****************************************************************************
+
+#ifndef __GRSTATE_H__
+#define __GRSTATE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "grlib/grlib.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Number of recently used colors whose translation is remembered.  The labs
+// cycle through fewer colors than this.
+//
+//*****************************************************************************
+#define GRSTATE_COLORS          8
+
+//*****************************************************************************
+//
+// Color cache for one context.  A color already in the table is stored in
+// the context without going back through the display's translation.
+//
+//*****************************************************************************
+typedef struct
+{
+  tContext *psContext;          // Context the state is pushed to
+  uint32_t pui32RGB[GRSTATE_COLORS];    // Recent colors, 24-bit RGB
+  uint32_t pui32Value[GRSTATE_COLORS];  // The same, translated for the display
+  uint32_t ui32NumColors;       // Entries in use
+  uint32_t ui32Next;            // Entry replaced by the next new color
+  uint32_t ui32Hits;            // Colors found in the table, not translated
+  uint32_t ui32Translated;      // Colors passed to the display's translation
+} tGrState;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void GrStateInit(tGrState *psState, tContext *psContext);
+extern void GrStateForegroundSet(tGrState *psState, uint32_t ui32Color);
+extern void GrStateBackgroundSet(tGrState *psState, uint32_t ui32Color);
+extern void GrStateFontSet(tGrState *psState, const tFont *psFont);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __GRSTATE_H__
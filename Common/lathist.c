@@ -0,0 +1,85 @@
+//*****************************************************************************
+//
+// lathist.c - Log2 latency histogram.
+//
+// Cheap enough to update from an interrupt handler: a sample costs a
+// five-step bit search and an increment, and the whole histogram is 144
+// bytes however long the run.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "lathist.h"
+
+//*****************************************************************************
+//
+// Empties a histogram.
+//
+//*****************************************************************************
+void
+LatHistInit(tLatHist *psHist)
+{
+  uint32_t ui32Idx;
+
+  for(ui32Idx = 0; ui32Idx < LAT_HIST_BUCKETS; ui32Idx++) {
+    psHist->pui32Count[ui32Idx] = 0;
+  }
+  psHist->ui32Samples = 0;
+  psHist->ui32Min = 0xFFFFFFFF;
+  psHist->ui32Max = 0;
+}
+
+//*****************************************************************************
+//
+// Returns the bucket a sample falls in: the number of significant bits in
+// ui32Cycles.
+//
+//*****************************************************************************
+uint32_t
+LatHistBucket(uint32_t ui32Cycles)
+{
+  uint32_t ui32Bits = 0;
+
+  if(ui32Cycles >= 0x10000) {
+    ui32Cycles >>= 16;
+    ui32Bits += 16;
+  }
+  if(ui32Cycles >= 0x100) {
+    ui32Cycles >>= 8;
+    ui32Bits += 8;
+  }
+  if(ui32Cycles >= 0x10) {
+    ui32Cycles >>= 4;
+    ui32Bits += 4;
+  }
+  if(ui32Cycles >= 0x4) {
+    ui32Cycles >>= 2;
+    ui32Bits += 2;
+  }
+  if(ui32Cycles >= 0x2) {
+    ui32Cycles >>= 1;
+    ui32Bits += 1;
+  }
+
+  return(ui32Bits + ui32Cycles);
+}
+
+//*****************************************************************************
+//
+// Records one sample.
+//
+//*****************************************************************************
+void
+LatHistAdd(tLatHist *psHist, uint32_t ui32Cycles)
+{
+  psHist->pui32Count[LatHistBucket(ui32Cycles)]++;
+  psHist->ui32Samples++;
+  if(ui32Cycles < psHist->ui32Min) {
+    psHist->ui32Min = ui32Cycles;
+  }
+  if(ui32Cycles > psHist->ui32Max) {
+    psHist->ui32Max = ui32Cycles;
+  }
+}
@@ -0,0 +1,52 @@
+//*****************************************************************************
+//
+// lathist.h - Prototypes for the log2 latency histogram.
+//
+//*****************************************************************************
+
+#ifndef __LATHIST_H__
+#define __LATHIST_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Bucket 0 holds zero-length samples and bucket n holds samples from
+// 2^(n-1) up to 2^n - 1 cycles, so 33 buckets cover every 32-bit value.
+//
+//*****************************************************************************
+#define LAT_HIST_BUCKETS        33
+
+//*****************************************************************************
+//
+// A histogram of latencies measured in cycles.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint32_t pui32Count[LAT_HIST_BUCKETS];        // Samples in each bucket
+  uint32_t ui32Samples;                         // Samples recorded
+  uint32_t ui32Min;                             // Shortest sample
+  uint32_t ui32Max;                             // Longest sample
+} tLatHist;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void LatHistInit(tLatHist *psHist);
+extern uint32_t LatHistBucket(uint32_t ui32Cycles);
+extern void LatHistAdd(tLatHist *psHist, uint32_t ui32Cycles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LATHIST_H__
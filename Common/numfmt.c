@@ -0,0 +1,172 @@
+//*****************************************************************************
+//
+// numfmt.c - Allocation-free number formatter.
+//
+// A small replacement for sprintf() on paths that run every loop or inside
+// interrupt handlers.  Each call formats one item into the caller's buffer,
+// NUL terminates it and returns a pointer to the terminator, so a line is
+// built by chaining calls:
+//
+//     pcEnd = NumFmtStr(pcBuf, "Loop: ");
+//     pcEnd = NumFmtDec(pcEnd, i32Loop, 0, ' ');
+//
+// Nothing is static and nothing is allocated, so the functions are
+// reentrant and use a few dozen bytes of stack, where newlib's sprintf()
+// can use over a kilobyte.  The caller must make sure the buffer is big
+// enough.
+//
+// Widths are minimums: shorter output is padded on the left with cPad,
+// normally ' ' or '0'.  With '0' padding a minus sign goes before the
+// zeros, as printf's "%05d" does.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "numfmt.h"
+
+//*****************************************************************************
+//
+// Writes the ui32Len characters at pcDigits, most significant last, after
+// the sign and padding that make the field ui32Width wide.
+//
+//*****************************************************************************
+static char *
+NumFmtEmit(char *pcBuf, const char *pcDigits, uint32_t ui32Len,
+           bool bNegative, uint32_t ui32Width, char cPad)
+{
+  uint32_t ui32Field = ui32Len + (bNegative ? 1 : 0);
+
+  if(bNegative && (cPad == '0')) {
+    *pcBuf++ = '-';
+  }
+  while(ui32Width > ui32Field) {
+    *pcBuf++ = cPad;
+    ui32Width--;
+  }
+  if(bNegative && (cPad != '0')) {
+    *pcBuf++ = '-';
+  }
+  while(ui32Len) {
+    *pcBuf++ = pcDigits[--ui32Len];
+  }
+  *pcBuf = '\0';
+
+  return(pcBuf);
+}
+
+//*****************************************************************************
+//
+// Copies a string.  Returns a pointer to the terminating NUL.
+//
+//*****************************************************************************
+char *
+NumFmtStr(char *pcBuf, const char *pcStr)
+{
+  while(*pcStr) {
+    *pcBuf++ = *pcStr++;
+  }
+  *pcBuf = '\0';
+
+  return(pcBuf);
+}
+
+//*****************************************************************************
+//
+// Formats an unsigned decimal, as "%*u".  Returns a pointer to the
+// terminating NUL.
+//
+//*****************************************************************************
+char *
+NumFmtUDec(char *pcBuf, uint32_t ui32Value, uint32_t ui32Width, char cPad)
+{
+  char pcDigits[NUMFMT_MAX_DIGITS];
+  uint32_t ui32Len = 0;
+
+  do {
+    pcDigits[ui32Len++] = '0' + (ui32Value % 10);
+    ui32Value /= 10;
+  } while(ui32Value);
+
+  return(NumFmtEmit(pcBuf, pcDigits, ui32Len, false, ui32Width, cPad));
+}
+
+//*****************************************************************************
+//
+// Formats a signed decimal, as "%*d".  Returns a pointer to the terminating
+// NUL.
+//
+//*****************************************************************************
+char *
+NumFmtDec(char *pcBuf, int32_t i32Value, uint32_t ui32Width, char cPad)
+{
+  char pcDigits[NUMFMT_MAX_DIGITS];
+  uint32_t ui32Value, ui32Len = 0;
+
+  // Negate as unsigned so INT32_MIN does not overflow.
+  ui32Value = (i32Value < 0) ? (0 - (uint32_t)i32Value) : (uint32_t)i32Value;
+  do {
+    pcDigits[ui32Len++] = '0' + (ui32Value % 10);
+    ui32Value /= 10;
+  } while(ui32Value);
+
+  return(NumFmtEmit(pcBuf, pcDigits, ui32Len, i32Value < 0, ui32Width,
+                    cPad));
+}
+
+//*****************************************************************************
+//
+// Formats upper case hexadecimal, as "%*X".  Returns a pointer to the
+// terminating NUL.
+//
+//*****************************************************************************
+char *
+NumFmtHex(char *pcBuf, uint32_t ui32Value, uint32_t ui32Width, char cPad)
+{
+  static const char pcHex[] = "0123456789ABCDEF";
+  char pcDigits[NUMFMT_MAX_DIGITS];
+  uint32_t ui32Len = 0;
+
+  do {
+    pcDigits[ui32Len++] = pcHex[ui32Value & 0xF];
+    ui32Value >>= 4;
+  } while(ui32Value);
+
+  return(NumFmtEmit(pcBuf, pcDigits, ui32Len, false, ui32Width, cPad));
+}
+
+//*****************************************************************************
+//
+// Formats a fixed-point value held as an integer count of 10^-ui32Decimals
+// units, so NumFmtFixed(pcBuf, 3300, 3, 0, ' ') gives "3.300".  Returns a
+// pointer to the terminating NUL.
+//
+//*****************************************************************************
+char *
+NumFmtFixed(char *pcBuf, int32_t i32Value, uint32_t ui32Decimals,
+            uint32_t ui32Width, char cPad)
+{
+  char pcDigits[NUMFMT_MAX_DIGITS];
+  uint32_t ui32Value, ui32Len = 0;
+
+  if(ui32Decimals > 9) {
+    ui32Decimals = 9;
+  }
+
+  ui32Value = (i32Value < 0) ? (0 - (uint32_t)i32Value) : (uint32_t)i32Value;
+  while(ui32Len < ui32Decimals) {
+    pcDigits[ui32Len++] = '0' + (ui32Value % 10);
+    ui32Value /= 10;
+  }
+  if(ui32Decimals) {
+    pcDigits[ui32Len++] = '.';
+  }
+  do {
+    pcDigits[ui32Len++] = '0' + (ui32Value % 10);
+    ui32Value /= 10;
+  } while(ui32Value);
+
+  return(NumFmtEmit(pcBuf, pcDigits, ui32Len, i32Value < 0, ui32Width,
+                    cPad));
+}
@@ -0,0 +1,45 @@
+//*****************************************************************************
+//
+// numfmt.h - Prototypes for the allocation-free number formatter.
+//
+//*****************************************************************************
+
+#ifndef __NUMFMT_H__
+#define __NUMFMT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Longest output of a single call, not counting padding: a sign, ten digits,
+// a decimal point and a leading "0." for fixed point.
+//
+//*****************************************************************************
+#define NUMFMT_MAX_DIGITS       14
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern char *NumFmtStr(char *pcBuf, const char *pcStr);
+extern char *NumFmtUDec(char *pcBuf, uint32_t ui32Value, uint32_t ui32Width,
+                        char cPad);
+extern char *NumFmtDec(char *pcBuf, int32_t i32Value, uint32_t ui32Width,
+                       char cPad);
+extern char *NumFmtHex(char *pcBuf, uint32_t ui32Value, uint32_t ui32Width,
+                       char cPad);
+extern char *NumFmtFixed(char *pcBuf, int32_t i32Value, uint32_t ui32Decimals,
+                         uint32_t ui32Width, char cPad);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __NUMFMT_H__
@@ -0,0 +1,199 @@
+//*****************************************************************************
+//
+// readout.c - Digit tile numeric readout.
+//
+// Printing a changing number with sprintf() and GrStringDraw() formats the
+// whole string and sends every glyph through the font engine again, with
+// trailing spaces to paint out digits left over from a longer value.  A
+// readout instead keeps the character shown in each of its cells and
+// compares the new value digit by digit.  Only cells that differ are drawn,
+// straight from a table of ready-made 6x8 tiles, so a counter going from
+// 999 to 1000 draws four cells and a value that did not change draws none.
+//
+// Cells are drawn with the display's own multiple pixel routine and are not
+// clipped, so a readout must lie wholly on the screen.  Anything else that
+// paints over it must call ReadoutInvalidate().
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "grlib/grlib.h"
+
+#include "readout.h"
+
+//*****************************************************************************
+//
+// Tile numbers besides the digits, and the mark for a cell not yet drawn.
+//
+//*****************************************************************************
+#define READOUT_TILE_MINUS      10
+#define READOUT_TILE_BLANK      11
+#define READOUT_TILE_UNKNOWN    0xFF
+
+//*****************************************************************************
+//
+// 1 bpp tiles, one byte per row with the leftmost pixel in the top bit.
+// The glyphs are the 5x7 digits of g_psFontFixed6x8 with a blank column
+// on the right and a blank row below.
+//
+//*****************************************************************************
+static const uint8_t g_ppui8Tiles[12][READOUT_CELL_HEIGHT] =
+{
+  {0x70, 0x88, 0x98, 0xA8, 0xC8, 0x88, 0x70, 0x00},     // '0'
+  {0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00},     // '1'
+  {0x70, 0x88, 0x08, 0x10, 0x20, 0x40, 0xF8, 0x00},     // '2'
+  {0xF8, 0x10, 0x20, 0x10, 0x08, 0x88, 0x70, 0x00},     // '3'
+  {0x10, 0x30, 0x50, 0x90, 0xF8, 0x10, 0x10, 0x00},     // '4'
+  {0xF8, 0x80, 0xF0, 0x08, 0x08, 0x88, 0x70, 0x00},     // '5'
+  {0x30, 0x40, 0x80, 0xF0, 0x88, 0x88, 0x70, 0x00},     // '6'
+  {0xF8, 0x08, 0x10, 0x20, 0x40, 0x40, 0x40, 0x00},     // '7'
+  {0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70, 0x00},     // '8'
+  {0x70, 0x88, 0x88, 0x78, 0x08, 0x10, 0x60, 0x00},     // '9'
+  {0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0x00, 0x00},     // '-'
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},     // ' '
+};
+
+//*****************************************************************************
+//
+// Brings the readout in line with the tiles in pui8Tiles, one per cell,
+// drawing only the cells that differ.  Returns the number drawn.
+//
+//*****************************************************************************
+static uint32_t
+ReadoutShow(tReadout *psReadout, const uint8_t *pui8Tiles)
+{
+  const tDisplay *psDisplay = psReadout->psDisplay;
+  uint32_t ui32Cell, ui32Row, ui32Cells;
+  int32_t i32X;
+
+  ui32Cells = 0;
+  for(ui32Cell = 0; ui32Cell < psReadout->ui32NumCells; ui32Cell++) {
+    if(psReadout->pui8Shown[ui32Cell] == pui8Tiles[ui32Cell]) {
+      continue;
+    }
+    i32X = psReadout->i16X + (ui32Cell * READOUT_CELL_WIDTH);
+    for(ui32Row = 0; ui32Row < READOUT_CELL_HEIGHT; ui32Row++) {
+      psDisplay->pfnPixelDrawMultiple(psDisplay->pvDisplayData, i32X,
+                                      psReadout->i16Y + ui32Row, 0,
+                                      READOUT_CELL_WIDTH, 1,
+                                      &g_ppui8Tiles[pui8Tiles[ui32Cell]][ui32Row],
+                                      (const uint8_t *)psReadout->pui32Palette);
+    }
+    psReadout->pui8Shown[ui32Cell] = pui8Tiles[ui32Cell];
+    ui32Cells++;
+  }
+
+  psReadout->ui32Cells = ui32Cells;
+  psReadout->ui32Total += ui32Cells;
+
+  return(ui32Cells);
+}
+
+//*****************************************************************************
+//
+// Shows ui32Magnitude right-aligned, after a minus sign if bNegative.
+//
+//*****************************************************************************
+static uint32_t
+ReadoutNumber(tReadout *psReadout, uint32_t ui32Magnitude, bool bNegative)
+{
+  uint8_t pui8Tiles[READOUT_MAX_CELLS];
+  uint32_t ui32Cell;
+
+  // Digits fill from the right; the first cell left of them takes the sign.
+  ui32Cell = psReadout->ui32NumCells;
+  do {
+    if(ui32Cell == 0) {
+      break;
+    }
+    pui8Tiles[--ui32Cell] = ui32Magnitude % 10;
+    ui32Magnitude /= 10;
+  } while(ui32Magnitude != 0);
+  if(bNegative && (ui32Cell != 0)) {
+    pui8Tiles[--ui32Cell] = READOUT_TILE_MINUS;
+    bNegative = false;
+  }
+
+  // Out of cells with digits or the sign still to show: too wide.
+  if((ui32Magnitude != 0) || bNegative) {
+    for(ui32Cell = 0; ui32Cell < psReadout->ui32NumCells; ui32Cell++) {
+      pui8Tiles[ui32Cell] = READOUT_TILE_MINUS;
+    }
+  }
+  else {
+    while(ui32Cell != 0) {
+      pui8Tiles[--ui32Cell] = READOUT_TILE_BLANK;
+    }
+  }
+
+  return(ReadoutShow(psReadout, pui8Tiles));
+}
+
+//*****************************************************************************
+//
+// Sets up a readout of ui32NumCells cells with its top left corner at
+// (i32X, i32Y), in 24-bit RGB colors.  Nothing is drawn until the first
+// value is set.
+//
+//*****************************************************************************
+void
+ReadoutInit(tReadout *psReadout, const tDisplay *psDisplay, int32_t i32X,
+            int32_t i32Y, uint32_t ui32NumCells, uint32_t ui32Foreground,
+            uint32_t ui32Background)
+{
+  psReadout->psDisplay = psDisplay;
+  psReadout->i16X = i32X;
+  psReadout->i16Y = i32Y;
+  psReadout->ui32NumCells = (ui32NumCells > READOUT_MAX_CELLS) ?
+                            READOUT_MAX_CELLS : ui32NumCells;
+  psReadout->pui32Palette[0] =
+    psDisplay->pfnColorTranslate(psDisplay->pvDisplayData, ui32Background);
+  psReadout->pui32Palette[1] =
+    psDisplay->pfnColorTranslate(psDisplay->pvDisplayData, ui32Foreground);
+  psReadout->ui32Cells = 0;
+  psReadout->ui32Total = 0;
+  ReadoutInvalidate(psReadout);
+}
+
+//*****************************************************************************
+//
+// Forgets what the cells show, so the next update draws all of them.
+//
+//*****************************************************************************
+void
+ReadoutInvalidate(tReadout *psReadout)
+{
+  uint32_t ui32Cell;
+
+  for(ui32Cell = 0; ui32Cell < READOUT_MAX_CELLS; ui32Cell++) {
+    psReadout->pui8Shown[ui32Cell] = READOUT_TILE_UNKNOWN;
+  }
+}
+
+//*****************************************************************************
+//
+// Shows an unsigned value.  Returns the number of cells drawn.
+//
+//*****************************************************************************
+uint32_t
+ReadoutSetUnsigned(tReadout *psReadout, uint32_t ui32Value)
+{
+  return(ReadoutNumber(psReadout, ui32Value, false));
+}
+
+//*****************************************************************************
+//
+// Shows a signed value.  Returns the number of cells drawn.
+//
+//*****************************************************************************
+uint32_t
+ReadoutSetSigned(tReadout *psReadout, int32_t i32Value)
+{
+  if(i32Value < 0) {
+    return(ReadoutNumber(psReadout, 0 - (uint32_t)i32Value, true));
+  }
+
+  return(ReadoutNumber(psReadout, i32Value, false));
+}
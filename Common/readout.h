@@ -0,0 +1,65 @@
+//*****************************************************************************
+//
+// readout.h - Prototypes for the digit tile numeric readout.
+//
+//*****************************************************************************
+
+#ifndef __READOUT_H__
+#define __READOUT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "grlib/grlib.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Size of one digit cell, matching g_psFontFixed6x8, and the most cells a
+// readout may have.
+//
+//*****************************************************************************
+#define READOUT_CELL_WIDTH      6
+#define READOUT_CELL_HEIGHT     8
+#define READOUT_MAX_CELLS       11
+
+//*****************************************************************************
+//
+// A right-aligned number in a fixed row of cells.  Each cell remembers the
+// tile it shows, so an update draws only the cells whose character changed.
+// A value too wide for the readout is shown as a row of dashes.
+//
+//*****************************************************************************
+typedef struct
+{
+  const tDisplay *psDisplay;    // Display the cells are drawn on
+  int16_t i16X;                 // Top left of the leftmost cell
+  int16_t i16Y;
+  uint32_t ui32NumCells;        // Cells in the readout
+  uint32_t pui32Palette[2];     // Translated background and foreground
+  uint8_t pui8Shown[READOUT_MAX_CELLS];         // Tile in each cell
+  uint32_t ui32Cells;           // Cells drawn by the last update
+  uint32_t ui32Total;           // Cells drawn since ReadoutInit()
+} tReadout;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void ReadoutInit(tReadout *psReadout, const tDisplay *psDisplay,
+                        int32_t i32X, int32_t i32Y, uint32_t ui32NumCells,
+                        uint32_t ui32Foreground, uint32_t ui32Background);
+extern void ReadoutInvalidate(tReadout *psReadout);
+extern uint32_t ReadoutSetUnsigned(tReadout *psReadout, uint32_t ui32Value);
+extern uint32_t ReadoutSetSigned(tReadout *psReadout, int32_t i32Value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __READOUT_H__
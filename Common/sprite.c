@@ -0,0 +1,175 @@
+//*****************************************************************************
+//
+// sprite.c - Framebuffer sprites with save-under.
+//
+// Animating an object through grlib means redrawing it from scratch each
+// frame, and repainting whatever it uncovered, often a larger area than the
+// object itself.  A sprite instead keeps a ready-made image of the object
+// and a copy of the pixels beneath it.  Hiding it puts those pixels back;
+// showing it saves the new ones and writes the image over them.  A move
+// therefore writes just the old and the new bounding box, whatever is
+// behind the sprite.
+//
+// Anything drawn with grlib where a sprite is shown would be lost when the
+// sprite is hidden, so sprites are hidden while the scene behind them is
+// drawn.  Overlapping sprites are hidden in the reverse of the order they
+// were shown.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "grlib/grlib.h"
+
+#include "framebuf.h"
+#include "sprite.h"
+
+//*****************************************************************************
+//
+// Sets the mask bits for columns i32X1 to i32X2 of row i32Y.
+//
+//*****************************************************************************
+static void
+SpriteMaskSpan(tSprite *psSprite, int32_t i32X1, int32_t i32X2,
+               int32_t i32Y)
+{
+  uint32_t ui32Stride;
+  int32_t i32X;
+
+  ui32Stride = (psSprite->i16Width + 7) / 8;
+  for(i32X = i32X1; i32X <= i32X2; i32X++) {
+    psSprite->pui8Mask[(i32Y * ui32Stride) + (i32X / 8)] |=
+      0x80 >> (i32X & 7);
+  }
+}
+
+//*****************************************************************************
+//
+// Sets up a sprite with no image, not shown.
+//
+//*****************************************************************************
+void
+SpriteInit(tSprite *psSprite, tFrameBuf *psFB)
+{
+  psSprite->psFB = psFB;
+  psSprite->i16Width = 0;
+  psSprite->i16Height = 0;
+  psSprite->i16HotX = 0;
+  psSprite->i16HotY = 0;
+  psSprite->bShown = false;
+}
+
+//*****************************************************************************
+//
+// Makes the image a filled circle of the given radius and 24-bit RGB color,
+// positioned by its center.  The circle is built with the same midpoint
+// steps as GrCircleFill(), so it looks the same as one drawn by grlib.
+// Returns false if it would not fit in SPRITE_MAX_WIDTH.  The sprite must
+// be hidden.
+//
+//*****************************************************************************
+bool
+SpriteCircle(tSprite *psSprite, int32_t i32Radius, uint32_t ui32Color)
+{
+  const tDisplay *psDisplay = &psSprite->psFB->sDisplay;
+  uint32_t ui32Idx, ui32Value;
+  int32_t i32A, i32B, i32D, i32Size;
+
+  i32Size = (2 * i32Radius) + 1;
+  if((i32Radius < 0) || (i32Size > SPRITE_MAX_WIDTH) ||
+     (i32Size > SPRITE_MAX_HEIGHT)) {
+    return(false);
+  }
+
+  psSprite->i16Width = i32Size;
+  psSprite->i16Height = i32Size;
+  psSprite->i16HotX = i32Radius;
+  psSprite->i16HotY = i32Radius;
+
+  ui32Value = psDisplay->pfnColorTranslate(psDisplay->pvDisplayData,
+                                           ui32Color);
+  for(ui32Idx = 0; ui32Idx < (uint32_t)(i32Size * i32Size); ui32Idx++) {
+    psSprite->pui16Image[ui32Idx] = ui32Value;
+  }
+  for(ui32Idx = 0; ui32Idx < sizeof(psSprite->pui8Mask); ui32Idx++) {
+    psSprite->pui8Mask[ui32Idx] = 0;
+  }
+
+  i32A = 0;
+  i32B = i32Radius;
+  i32D = 3 - (2 * i32Radius);
+  while(i32A <= i32B) {
+    SpriteMaskSpan(psSprite, i32Radius - i32B, i32Radius + i32B,
+                   i32Radius - i32A);
+    SpriteMaskSpan(psSprite, i32Radius - i32B, i32Radius + i32B,
+                   i32Radius + i32A);
+    SpriteMaskSpan(psSprite, i32Radius - i32A, i32Radius + i32A,
+                   i32Radius - i32B);
+    SpriteMaskSpan(psSprite, i32Radius - i32A, i32Radius + i32A,
+                   i32Radius + i32B);
+    if(i32D < 0) {
+      i32D += (4 * i32A) + 6;
+    }
+    else {
+      i32D += (4 * (i32A - i32B)) + 10;
+      i32B--;
+    }
+    i32A++;
+  }
+
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Draws the sprite with its hot spot at (i32X, i32Y), saving what it
+// covers.  Does nothing if it is already shown.
+//
+//*****************************************************************************
+void
+SpriteShow(tSprite *psSprite, int32_t i32X, int32_t i32Y)
+{
+  if(psSprite->bShown || (psSprite->i16Width == 0)) {
+    return;
+  }
+
+  psSprite->sRect.i16XMin = i32X - psSprite->i16HotX;
+  psSprite->sRect.i16YMin = i32Y - psSprite->i16HotY;
+  psSprite->sRect.i16XMax = psSprite->sRect.i16XMin + psSprite->i16Width - 1;
+  psSprite->sRect.i16YMax = psSprite->sRect.i16YMin + psSprite->i16Height - 1;
+  FrameBufRead(psSprite->psFB, &psSprite->sRect, psSprite->pui16Under);
+  FrameBufBlit(psSprite->psFB, &psSprite->sRect, psSprite->pui16Image,
+               psSprite->pui8Mask);
+  psSprite->bShown = true;
+}
+
+//*****************************************************************************
+//
+// Puts back the pixels the sprite covered.
+//
+//*****************************************************************************
+void
+SpriteHide(tSprite *psSprite)
+{
+  if(!psSprite->bShown) {
+    return;
+  }
+
+  FrameBufBlit(psSprite->psFB, &psSprite->sRect, psSprite->pui16Under,
+               psSprite->pui8Mask);
+  psSprite->bShown = false;
+}
+
+//*****************************************************************************
+//
+// Moves the sprite so its hot spot is at (i32X, i32Y), showing it if it was
+// hidden.
+//
+//*****************************************************************************
+void
+SpriteMove(tSprite *psSprite, int32_t i32X, int32_t i32Y)
+{
+  SpriteHide(psSprite);
+  SpriteShow(psSprite, i32X, i32Y);
+}
@@ -0,0 +1,68 @@
+//*****************************************************************************
+//
+// sprite.h - Prototypes for framebuffer sprites.
+//
+//*****************************************************************************
+
+#ifndef __SPRITE_H__
+#define __SPRITE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "grlib/grlib.h"
+#include "framebuf.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Largest sprite image.  Each sprite holds its image and what lies under it
+// at full size, about 1 KB at 16x16.
+//
+//*****************************************************************************
+#define SPRITE_MAX_WIDTH        16
+#define SPRITE_MAX_HEIGHT       16
+#define SPRITE_MASK_STRIDE      ((SPRITE_MAX_WIDTH + 7) / 8)
+
+//*****************************************************************************
+//
+// A moving object drawn over a framebuffer.  The image is built once; while
+// the sprite is shown, the pixels it covers are kept in pui16Under, so
+// moving it touches only its old and new bounding boxes.
+//
+//*****************************************************************************
+typedef struct
+{
+  tFrameBuf *psFB;              // Framebuffer the sprite is drawn in
+  int16_t i16Width;             // Image size in pixels
+  int16_t i16Height;
+  int16_t i16HotX;              // Image pixel placed at the sprite position
+  int16_t i16HotY;
+  bool bShown;                  // The image is in the framebuffer
+  tRectangle sRect;             // Where it is, while bShown
+  uint16_t pui16Image[SPRITE_MAX_WIDTH * SPRITE_MAX_HEIGHT];
+  uint8_t pui8Mask[SPRITE_MAX_HEIGHT * SPRITE_MASK_STRIDE];
+  uint16_t pui16Under[SPRITE_MAX_WIDTH * SPRITE_MAX_HEIGHT];
+} tSprite;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void SpriteInit(tSprite *psSprite, tFrameBuf *psFB);
+extern bool SpriteCircle(tSprite *psSprite, int32_t i32Radius,
+                         uint32_t ui32Color);
+extern void SpriteShow(tSprite *psSprite, int32_t i32X, int32_t i32Y);
+extern void SpriteHide(tSprite *psSprite);
+extern void SpriteMove(tSprite *psSprite, int32_t i32X, int32_t i32Y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SPRITE_H__
@@ -0,0 +1,151 @@
+//*****************************************************************************
+//
+// spscq.c - Lock-free single-producer/single-consumer queue.
+//
+// Push is wait-free and safe to call from an interrupt handler; pop takes as
+// many elements as are ready in one call so the main loop can work through a
+// batch.  The only ordering needed is that the element is written before
+// the head is published, and read before the tail is released, which a data
+// memory barrier provides on both the Cortex-M4 and a host build.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "spscq.h"
+
+//*****************************************************************************
+//
+// Orders the element copy against the index update.
+//
+//*****************************************************************************
+#if defined(ewarm)
+#include <intrinsics.h>
+#define SPSCQueueBarrier()      __DMB()
+#elif defined(ccs)
+#define SPSCQueueBarrier()      __asm(" dmb")
+#else
+#define SPSCQueueBarrier()      __sync_synchronize()
+#endif
+
+//*****************************************************************************
+//
+// Prepares a queue over pvBuf, which must hold ui32Capacity elements of
+// ui32ElemSize bytes.  ui32Capacity must be a power of two.
+//
+//*****************************************************************************
+void
+SPSCQueueInit(tSPSCQueue *psQueue, void *pvBuf, uint32_t ui32ElemSize,
+              uint32_t ui32Capacity)
+{
+  psQueue->pui8Buf = (uint8_t *)pvBuf;
+  psQueue->ui32ElemSize = ui32ElemSize;
+  psQueue->ui32Mask = ui32Capacity - 1;
+  psQueue->ui32Head = 0;
+  psQueue->ui32Tail = 0;
+  psQueue->ui32Dropped = 0;
+  psQueue->ui32HighWater = 0;
+}
+
+//*****************************************************************************
+//
+// Appends one element.  Returns false, and counts a drop, if the queue is
+// full.  Only the producer may call this.
+//
+//*****************************************************************************
+bool
+SPSCQueuePush(tSPSCQueue *psQueue, const void *pvElem)
+{
+  uint32_t ui32Head = psQueue->ui32Head;
+  uint32_t ui32Used = ui32Head - psQueue->ui32Tail;
+  uint32_t ui32Size = psQueue->ui32ElemSize;
+  const uint8_t *pui8Src = (const uint8_t *)pvElem;
+  uint8_t *pui8Slot;
+
+  if(ui32Used > psQueue->ui32Mask) {
+    psQueue->ui32Dropped++;
+    return(false);
+  }
+
+  pui8Slot = psQueue->pui8Buf + ((ui32Head & psQueue->ui32Mask) * ui32Size);
+  if(ui32Size == 1) {
+    *pui8Slot = *pui8Src;
+  }
+  else {
+    while(ui32Size--) {
+      *pui8Slot++ = *pui8Src++;
+    }
+  }
+
+  SPSCQueueBarrier();
+  psQueue->ui32Head = ui32Head + 1;
+
+  if(ui32Used + 1 > psQueue->ui32HighWater) {
+    psQueue->ui32HighWater = ui32Used + 1;
+  }
+
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Removes up to ui32Max elements into pvElems and returns how many were
+// removed.  Only the consumer may call this.
+//
+//*****************************************************************************
+uint32_t
+SPSCQueuePopBatch(tSPSCQueue *psQueue, void *pvElems, uint32_t ui32Max)
+{
+  uint32_t ui32Tail = psQueue->ui32Tail;
+  uint32_t ui32Count = psQueue->ui32Head - ui32Tail;
+  uint32_t ui32Size = psQueue->ui32ElemSize;
+  uint32_t ui32First, ui32Bytes, ui32Idx;
+  uint8_t *pui8Dst = (uint8_t *)pvElems;
+  const uint8_t *pui8Src;
+
+  if(ui32Count > ui32Max) {
+    ui32Count = ui32Max;
+  }
+  if(ui32Count == 0) {
+    return(0);
+  }
+
+  // See the element writes that went with the head just read.
+  SPSCQueueBarrier();
+
+  // Copy in at most two runs: up to the end of the buffer, then from the
+  // start if the batch wraps.
+  ui32First = (psQueue->ui32Mask + 1) - (ui32Tail & psQueue->ui32Mask);
+  if(ui32First > ui32Count) {
+    ui32First = ui32Count;
+  }
+  pui8Src = psQueue->pui8Buf + ((ui32Tail & psQueue->ui32Mask) * ui32Size);
+  ui32Bytes = ui32First * ui32Size;
+  for(ui32Idx = 0; ui32Idx < ui32Bytes; ui32Idx++) {
+    *pui8Dst++ = pui8Src[ui32Idx];
+  }
+  pui8Src = psQueue->pui8Buf;
+  ui32Bytes = (ui32Count - ui32First) * ui32Size;
+  for(ui32Idx = 0; ui32Idx < ui32Bytes; ui32Idx++) {
+    *pui8Dst++ = pui8Src[ui32Idx];
+  }
+
+  // Finish reading the slots before handing them back to the producer.
+  SPSCQueueBarrier();
+  psQueue->ui32Tail = ui32Tail + ui32Count;
+
+  return(ui32Count);
+}
+
+//*****************************************************************************
+//
+// Returns the number of elements waiting.  Exact for the consumer; a lower
+// bound for anyone else.
+//
+//*****************************************************************************
+uint32_t
+SPSCQueueCount(tSPSCQueue *psQueue)
+{
+  return(psQueue->ui32Head - psQueue->ui32Tail);
+}
@@ -0,0 +1,61 @@
+//*****************************************************************************
+//
+// spscq.h - Lock-free single-producer/single-consumer queue.
+//
+// Carries fixed-size elements from one interrupt handler to the main loop
+// (or the other way round) without masking interrupts.  The element size is
+// chosen at init time, so the same code moves UART bytes, button codes or
+// packed ADC samples, e.g.
+//
+//     typedef struct { uint16_t ui16Channel; uint16_t ui16Value; } tADCEvent;
+//     static tADCEvent g_psADCEvents[32];
+//     SPSCQueueInit(&g_sADCQueue, g_psADCEvents, sizeof(tADCEvent), 32);
+//
+//*****************************************************************************
+
+#ifndef __SPSCQ_H__
+#define __SPSCQ_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Queue state.  Head and the producer counters belong to the producer, tail
+// belongs to the consumer; neither side ever writes the other's fields.  The
+// capacity must be a power of two.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint8_t *pui8Buf;             // Element storage supplied by the caller
+  uint32_t ui32ElemSize;        // Size of one element in bytes
+  uint32_t ui32Mask;            // Capacity in elements minus one
+  volatile uint32_t ui32Head;   // Elements ever pushed (producer)
+  volatile uint32_t ui32Tail;   // Elements ever popped (consumer)
+  volatile uint32_t ui32Dropped;    // Pushes refused while full (producer)
+  volatile uint32_t ui32HighWater;  // Deepest the queue has been (producer)
+} tSPSCQueue;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void SPSCQueueInit(tSPSCQueue *psQueue, void *pvBuf,
+                          uint32_t ui32ElemSize, uint32_t ui32Capacity);
+extern bool SPSCQueuePush(tSPSCQueue *psQueue, const void *pvElem);
+extern uint32_t SPSCQueuePopBatch(tSPSCQueue *psQueue, void *pvElems,
+                                  uint32_t ui32Max);
+extern uint32_t SPSCQueueCount(tSPSCQueue *psQueue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SPSCQ_H__
@@ -0,0 +1,348 @@
+//*****************************************************************************
+//
+// strcache.c - Pre-rendered string cache.
+//
+// Banners and splash text are drawn again and again with the same words in
+// the same font, and each time grlib walks the font data and decodes every
+// glyph.  The cache renders a string once, on its first draw, into a small
+// capture display that records which pixels the font engine set.  Those
+// pixels are kept as horizontal runs, and later draws of the same string
+// fill the runs straight onto the context with GrLineDrawH().
+//
+// A string's first draw goes to the context through GrStringDraw() and is
+// timed, and each hit times its fill onto the same context, so the cycles a
+// hit saves are measured like for like rather than estimated.  The cycle
+// counter must be started with CycleCounterInit().
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "grlib/grlib.h"
+
+#include "cyccnt.h"
+#include "strcache.h"
+
+//*****************************************************************************
+//
+// Capture display callbacks.  They set a bit in the cache's scratch bitmap
+// for every pixel drawn in a non-zero color.  The display is sized to the
+// string, so grlib has already clipped every call to the bitmap.
+//
+//*****************************************************************************
+static void
+StrCachePixelDraw(void *pvDisplayData, int32_t i32X, int32_t i32Y,
+                  uint32_t ui32Value)
+{
+  tStrCache *psCache = (tStrCache *)pvDisplayData;
+
+  if(ui32Value) {
+    psCache->pui8Bits[i32Y][i32X >> 3] |= 0x80 >> (i32X & 7);
+  }
+  else {
+    psCache->pui8Bits[i32Y][i32X >> 3] &= ~(0x80 >> (i32X & 7));
+  }
+}
+
+static void
+StrCachePixelDrawMultiple(void *pvDisplayData, int32_t i32X, int32_t i32Y,
+                          int32_t i32X0, int32_t i32Count, int32_t i32BPP,
+                          const uint8_t *pui8Data, const uint8_t *pui8Palette)
+{
+  uint32_t ui32Pos;
+  int32_t i32Idx;
+
+  // Text only ever comes through here as 1 bpp.
+  if((i32BPP & 0xFF) != 1) {
+    return;
+  }
+  for(i32Idx = 0; i32Idx < i32Count; i32Idx++) {
+    ui32Pos = i32X0 + i32Idx;
+    StrCachePixelDraw(pvDisplayData, i32X + i32Idx, i32Y,
+                      ((const uint32_t *)pui8Palette)
+                      [(pui8Data[ui32Pos >> 3] >> (7 - (ui32Pos & 7))) & 1]);
+  }
+}
+
+static void
+StrCacheLineDrawH(void *pvDisplayData, int32_t i32X1, int32_t i32X2,
+                  int32_t i32Y, uint32_t ui32Value)
+{
+  for(; i32X1 <= i32X2; i32X1++) {
+    StrCachePixelDraw(pvDisplayData, i32X1, i32Y, ui32Value);
+  }
+}
+
+static void
+StrCacheLineDrawV(void *pvDisplayData, int32_t i32X, int32_t i32Y1,
+                  int32_t i32Y2, uint32_t ui32Value)
+{
+  for(; i32Y1 <= i32Y2; i32Y1++) {
+    StrCachePixelDraw(pvDisplayData, i32X, i32Y1, ui32Value);
+  }
+}
+
+static void
+StrCacheRectFill(void *pvDisplayData, const tRectangle *psRect,
+                 uint32_t ui32Value)
+{
+  int32_t i32Y;
+
+  for(i32Y = psRect->i16YMin; i32Y <= psRect->i16YMax; i32Y++) {
+    StrCacheLineDrawH(pvDisplayData, psRect->i16XMin, psRect->i16XMax, i32Y,
+                      ui32Value);
+  }
+}
+
+static uint32_t
+StrCacheColorTranslate(void *pvDisplayData, uint32_t ui32Value)
+{
+  return(ui32Value != 0);
+}
+
+static void
+StrCacheFlush(void *pvDisplayData)
+{
+}
+
+//*****************************************************************************
+//
+// Finds a string already in the cache.  The pointer is checked first since
+// a literal is normally drawn from the same place every time.
+//
+//*****************************************************************************
+static tStrCacheEntry *
+StrCacheFind(tStrCache *psCache, const tFont *psFont, const char *pcText)
+{
+  tStrCacheEntry *psEntry;
+  uint32_t ui32Idx;
+
+  for(ui32Idx = 0; ui32Idx < psCache->ui32NumEntries; ui32Idx++) {
+    psEntry = &psCache->psEntries[ui32Idx];
+    if((psEntry->psFont == psFont) &&
+       ((psEntry->pcText == pcText) || !strcmp(psEntry->pcText, pcText))) {
+      return(psEntry);
+    }
+  }
+  return(0);
+}
+
+//*****************************************************************************
+//
+// Renders a string through the font engine into the scratch bitmap and
+// stores it as runs.  Returns the new entry, or 0 if it does not fit.  The
+// entry's render time is left for the caller to fill in.
+//
+//*****************************************************************************
+static tStrCacheEntry *
+StrCacheAdd(tStrCache *psCache, const tContext *psContext, const char *pcText)
+{
+  tStrCacheEntry *psEntry;
+  tDisplay sCapture;
+  tContext sRender;
+  uint32_t ui32Run;
+  int32_t i32Width, i32Height, i32X, i32Y;
+  bool bSet;
+
+  i32Width = GrStringWidthGet(psContext, pcText, -1);
+  i32Height = GrStringHeightGet(psContext);
+  if((psCache->ui32NumEntries == STRCACHE_MAX_ENTRIES) ||
+     (i32Width > STRCACHE_MAX_WIDTH) || (i32Height > STRCACHE_MAX_HEIGHT)) {
+    return(0);
+  }
+
+  sCapture.i32Size = sizeof(tDisplay);
+  sCapture.pvDisplayData = psCache;
+  sCapture.ui16Width = i32Width;
+  sCapture.ui16Height = i32Height;
+  sCapture.pfnPixelDraw = StrCachePixelDraw;
+  sCapture.pfnPixelDrawMultiple = StrCachePixelDrawMultiple;
+  sCapture.pfnLineDrawH = StrCacheLineDrawH;
+  sCapture.pfnLineDrawV = StrCacheLineDrawV;
+  sCapture.pfnRectFill = StrCacheRectFill;
+  sCapture.pfnColorTranslate = StrCacheColorTranslate;
+  sCapture.pfnFlush = StrCacheFlush;
+
+  memset(psCache->pui8Bits, 0, sizeof(psCache->pui8Bits));
+  GrContextInit(&sRender, &sCapture);
+  GrContextFontSet(&sRender, psContext->psFont);
+  GrContextForegroundSet(&sRender, ClrWhite);
+  GrStringDraw(&sRender, pcText, -1, 0, 0, false);
+
+  // Turn the bitmap into runs, giving up if the pool fills.
+  ui32Run = psCache->ui32NumRuns;
+  for(i32Y = 0; i32Y < i32Height; i32Y++) {
+    for(i32X = 0; i32X < i32Width; i32X++) {
+      bSet = (psCache->pui8Bits[i32Y][i32X >> 3] & (0x80 >> (i32X & 7))) != 0;
+      if(!bSet) {
+        continue;
+      }
+      if((ui32Run > psCache->ui32NumRuns) &&
+         (psCache->psRuns[ui32Run - 1].ui8Y == i32Y) &&
+         (psCache->psRuns[ui32Run - 1].ui8X2 == (i32X - 1))) {
+        psCache->psRuns[ui32Run - 1].ui8X2 = i32X;
+        continue;
+      }
+      if(ui32Run == STRCACHE_MAX_RUNS) {
+        return(0);
+      }
+      psCache->psRuns[ui32Run].ui8Y = i32Y;
+      psCache->psRuns[ui32Run].ui8X1 = i32X;
+      psCache->psRuns[ui32Run].ui8X2 = i32X;
+      ui32Run++;
+    }
+  }
+
+  psEntry = &psCache->psEntries[psCache->ui32NumEntries++];
+  psEntry->pcText = pcText;
+  psEntry->psFont = psContext->psFont;
+  psEntry->ui8Width = i32Width;
+  psEntry->ui8Height = i32Height;
+  psEntry->ui16First = psCache->ui32NumRuns;
+  psEntry->ui16Runs = ui32Run - psCache->ui32NumRuns;
+  psEntry->ui32RenderCycles = 0;
+  psCache->ui32NumRuns = ui32Run;
+
+  return(psEntry);
+}
+
+//*****************************************************************************
+//
+// Fills a cached string's runs in the foreground color.  When opaque, the
+// gaps between them are filled in the background color, covering the same
+// cells as an opaque GrStringDraw().
+//
+//*****************************************************************************
+static void
+StrCacheBlit(tStrCache *psCache, const tContext *psContext,
+             const tStrCacheEntry *psEntry, int32_t i32X, int32_t i32Y,
+             bool bOpaque)
+{
+  const tStrRun *psRun, *psEnd;
+  tContext sBack;
+  int32_t i32Row, i32Col;
+
+  psRun = &psCache->psRuns[psEntry->ui16First];
+  psEnd = psRun + psEntry->ui16Runs;
+  if(!bOpaque) {
+    for(; psRun < psEnd; psRun++) {
+      GrLineDrawH(psContext, i32X + psRun->ui8X1, i32X + psRun->ui8X2,
+                  i32Y + psRun->ui8Y);
+    }
+    return;
+  }
+
+  sBack = *psContext;
+  sBack.ui32Foreground = psContext->ui32Background;
+  for(i32Row = 0; i32Row < psEntry->ui8Height; i32Row++) {
+    i32Col = 0;
+    for(; (psRun < psEnd) && (psRun->ui8Y == i32Row); psRun++) {
+      if(psRun->ui8X1 > i32Col) {
+        GrLineDrawH(&sBack, i32X + i32Col, i32X + psRun->ui8X1 - 1,
+                    i32Y + i32Row);
+      }
+      GrLineDrawH(psContext, i32X + psRun->ui8X1, i32X + psRun->ui8X2,
+                  i32Y + i32Row);
+      i32Col = psRun->ui8X2 + 1;
+    }
+    if(i32Col < psEntry->ui8Width) {
+      GrLineDrawH(&sBack, i32X + i32Col, i32X + psEntry->ui8Width - 1,
+                  i32Y + i32Row);
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// Empties the cache and clears its counters.
+//
+//*****************************************************************************
+void
+StrCacheInit(tStrCache *psCache)
+{
+  psCache->ui32NumEntries = 0;
+  psCache->ui32NumRuns = 0;
+  psCache->ui32Hits = 0;
+  psCache->ui32Misses = 0;
+  psCache->ui32Uncached = 0;
+  psCache->ui32Saved = 0;
+}
+
+//*****************************************************************************
+//
+// Draws a string given the result of looking it up, adding it to the cache
+// if it was not found.
+//
+//*****************************************************************************
+static void
+StrCacheDrawEntry(tStrCache *psCache, const tContext *psContext,
+                  tStrCacheEntry *psEntry, const char *pcText, int32_t i32X,
+                  int32_t i32Y, bool bOpaque)
+{
+  uint32_t ui32Start, ui32Cycles;
+
+  if(psEntry) {
+    ui32Start = CycleCounterGet();
+    StrCacheBlit(psCache, psContext, psEntry, i32X, i32Y, bOpaque);
+    ui32Cycles = CycleCounterGet() - ui32Start;
+    psCache->ui32Hits++;
+    if(psEntry->ui32RenderCycles > ui32Cycles) {
+      psCache->ui32Saved += psEntry->ui32RenderCycles - ui32Cycles;
+    }
+    return;
+  }
+
+  // A new string is drawn by grlib this once, timed as the cost each later
+  // hit avoids.
+  psEntry = StrCacheAdd(psCache, psContext, pcText);
+  ui32Start = CycleCounterGet();
+  GrStringDraw(psContext, pcText, -1, i32X, i32Y, bOpaque);
+  ui32Cycles = CycleCounterGet() - ui32Start;
+  if(psEntry) {
+    psCache->ui32Misses++;
+    psEntry->ui32RenderCycles = ui32Cycles;
+  }
+  else {
+    psCache->ui32Uncached++;
+  }
+}
+
+//*****************************************************************************
+//
+// Draws a string with its top left corner at i32X, i32Y in the context's
+// font and colors, like GrStringDraw() with the whole string.  pcText
+// must stay in place while the cache is in use, as a literal does.
+//
+//*****************************************************************************
+void
+StrCacheDraw(tStrCache *psCache, const tContext *psContext,
+             const char *pcText, int32_t i32X, int32_t i32Y, bool bOpaque)
+{
+  StrCacheDrawEntry(psCache, psContext,
+                    StrCacheFind(psCache, psContext->psFont, pcText), pcText,
+                    i32X, i32Y, bOpaque);
+}
+
+//*****************************************************************************
+//
+// Draws a string centered on i32X, i32Y, placed as GrStringDrawCentered()
+// would place it.  A cached string is centered on its stored width, so only
+// a miss walks the font to measure it.
+//
+//*****************************************************************************
+void
+StrCacheDrawCentered(tStrCache *psCache, const tContext *psContext,
+                     const char *pcText, int32_t i32X, int32_t i32Y,
+                     bool bOpaque)
+{
+  tStrCacheEntry *psEntry;
+  int32_t i32Width;
+
+  psEntry = StrCacheFind(psCache, psContext->psFont, pcText);
+  i32Width = psEntry ? psEntry->ui8Width :
+                       GrStringWidthGet(psContext, pcText, -1);
+  StrCacheDrawEntry(psCache, psContext, psEntry, pcText, i32X - (i32Width / 2),
+                    i32Y - (GrStringBaselineGet(psContext) / 2), bOpaque);
+}
@@ -0,0 +1,98 @@
+//*****************************************************************************
+//
+// strcache.h - Prototypes for the pre-rendered string cache.
+//
+//*****************************************************************************
+
+#ifndef __STRCACHE_H__
+#define __STRCACHE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "grlib/grlib.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Limits of the cache.  Strings larger than STRCACHE_MAX_WIDTH by
+// STRCACHE_MAX_HEIGHT pixels, or whose runs do not fit in what is left of
+// the run pool, are drawn through the font engine every time.
+//
+//*****************************************************************************
+#define STRCACHE_MAX_ENTRIES    16
+#define STRCACHE_MAX_RUNS       768
+#define STRCACHE_MAX_WIDTH      96
+#define STRCACHE_MAX_HEIGHT     24
+
+//*****************************************************************************
+//
+// One horizontal run of foreground pixels, relative to the string's top
+// left corner.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint8_t ui8Y;                 // Row within the string
+  uint8_t ui8X1;                // First column of the run
+  uint8_t ui8X2;                // Last column of the run
+} tStrRun;
+
+//*****************************************************************************
+//
+// A cached string: which text in which font, its size and its runs.
+//
+//*****************************************************************************
+typedef struct
+{
+  const char *pcText;           // The string, which must stay in place
+  const tFont *psFont;          // Font it was rendered in
+  uint8_t ui8Width;             // Width in pixels, as GrStringWidthGet()
+  uint8_t ui8Height;            // Height in pixels, the font height
+  uint16_t ui16First;           // Index of its first run in the pool
+  uint16_t ui16Runs;            // Number of runs
+  uint32_t ui32RenderCycles;    // Cycles GrStringDraw() took on the context
+} tStrCacheEntry;
+
+//*****************************************************************************
+//
+// Cache state.  Each string is rasterized once, on its first draw, into a
+// list of runs; later draws fill the runs directly.
+//
+//*****************************************************************************
+typedef struct
+{
+  tStrCacheEntry psEntries[STRCACHE_MAX_ENTRIES];
+  uint32_t ui32NumEntries;      // Entries in use
+  tStrRun psRuns[STRCACHE_MAX_RUNS];
+  uint32_t ui32NumRuns;         // Runs in use
+  uint32_t ui32Hits;            // Draws served from the cache
+  uint32_t ui32Misses;          // Draws that rasterized a new string
+  uint32_t ui32Uncached;        // Draws of strings that did not fit
+  uint32_t ui32Saved;           // Cycles hits saved against GrStringDraw()
+  uint8_t pui8Bits[STRCACHE_MAX_HEIGHT][STRCACHE_MAX_WIDTH / 8];
+} tStrCache;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void StrCacheInit(tStrCache *psCache);
+extern void StrCacheDraw(tStrCache *psCache, const tContext *psContext,
+                         const char *pcText, int32_t i32X, int32_t i32Y,
+                         bool bOpaque);
+extern void StrCacheDrawCentered(tStrCache *psCache,
+                                 const tContext *psContext,
+                                 const char *pcText, int32_t i32X,
+                                 int32_t i32Y, bool bOpaque);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __STRCACHE_H__
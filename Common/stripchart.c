@@ -0,0 +1,220 @@
+//*****************************************************************************
+//
+// stripchart.c - Sweeping strip chart.
+//
+// A scrolling chart that shifts every column left for each new sample has to
+// redraw and resend the whole chart per sample, and the CFAL96x64x16 driver
+// offers no hardware scroll to do the shifting in the panel.  This chart
+// sweeps instead, like an oscilloscope: the plot area is used as a ring of
+// columns and each sample is drawn into the column after the last one,
+// over the oldest.  A sample therefore costs one column of pixels, and
+// through the framebuffer only the pixels of that column that changed are
+// sent, however fast samples arrive.
+//
+// Samples are queued by StripChartSample(), which may be called from an
+// interrupt, and drawn by StripChartUpdate() from the main loop, so the
+// chart keeps an exact sample rate even when a pass of the loop is slow.
+// A pass longer than STRIP_CHART_QUEUE samples loses the rest, so nothing
+// that busy-waits may run while the chart is sampling.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "grlib/grlib.h"
+
+#include "stripchart.h"
+
+//*****************************************************************************
+//
+// Plots one sample in the next column and moves the sweep cursor on.
+//
+//*****************************************************************************
+static void
+StripChartColumn(tStripChart *psChart, const uint16_t *pui16Values)
+{
+  const tDisplay *psDisplay = psChart->psDisplay;
+  const tRectangle *psRect = &psChart->sRect;
+  uint32_t ui32Trace, ui32Value, ui32Height;
+  int32_t i32X, i32Row, i32Top, i32Bottom;
+
+  i32X = psRect->i16XMin + psChart->i16Column;
+  ui32Height = psRect->i16YMax - psRect->i16YMin;
+
+  // Paint out the oldest column, then draw each trace from its row in the
+  // previous column to its new row, so a fast edge stays joined up.
+  psDisplay->pfnLineDrawV(psDisplay->pvDisplayData, i32X, psRect->i16YMin,
+                          psRect->i16YMax, psChart->ui32Background);
+  for(ui32Trace = 0; ui32Trace < psChart->ui32NumTraces; ui32Trace++) {
+    if(!(psChart->ui32Traces & (1 << ui32Trace))) {
+      continue;
+    }
+    ui32Value = pui16Values[ui32Trace];
+    if(ui32Value > psChart->ui32FullScale) {
+      ui32Value = psChart->ui32FullScale;
+    }
+    i32Row = psRect->i16YMax -
+             (((ui32Value * ui32Height) + (psChart->ui32FullScale / 2)) /
+              psChart->ui32FullScale);
+    i32Top = i32Row;
+    i32Bottom = i32Row;
+    if(psChart->pi16Last[ui32Trace] >= 0) {
+      if(psChart->pi16Last[ui32Trace] < i32Top) {
+        i32Top = psChart->pi16Last[ui32Trace];
+      }
+      if(psChart->pi16Last[ui32Trace] > i32Bottom) {
+        i32Bottom = psChart->pi16Last[ui32Trace];
+      }
+    }
+    psDisplay->pfnLineDrawV(psDisplay->pvDisplayData, i32X, i32Top,
+                            i32Bottom, psChart->pui32Colors[ui32Trace]);
+    psChart->pi16Last[ui32Trace] = i32Row;
+  }
+
+  // The cursor goes on the column the next sample overwrites.
+  psChart->i16Column++;
+  if(psChart->i16Column > (psRect->i16XMax - psRect->i16XMin)) {
+    psChart->i16Column = 0;
+  }
+  psDisplay->pfnLineDrawV(psDisplay->pvDisplayData,
+                          psRect->i16XMin + psChart->i16Column,
+                          psRect->i16YMin, psRect->i16YMax,
+                          psChart->ui32Cursor);
+  psChart->ui32Columns++;
+}
+
+//*****************************************************************************
+//
+// Sets up a chart over psRect, which must lie wholly on the screen, for
+// samples of ui32NumTraces values from 0 to ui32FullScale.  Colors are
+// 24-bit RGB, one per trace.  All traces are plotted until
+// StripChartTracesSet() says otherwise.  Nothing is drawn until
+// StripChartClear().
+//
+//*****************************************************************************
+void
+StripChartInit(tStripChart *psChart, const tDisplay *psDisplay,
+               const tRectangle *psRect, uint32_t ui32NumTraces,
+               const uint32_t *pui32Colors, uint32_t ui32Background,
+               uint32_t ui32Cursor, uint32_t ui32FullScale)
+{
+  uint32_t ui32Trace;
+
+  if(ui32NumTraces > STRIP_CHART_MAX_TRACES) {
+    ui32NumTraces = STRIP_CHART_MAX_TRACES;
+  }
+  psChart->psDisplay = psDisplay;
+  psChart->sRect = *psRect;
+  psChart->ui32NumTraces = ui32NumTraces;
+  psChart->ui32FullScale = ui32FullScale ? ui32FullScale : 1;
+  for(ui32Trace = 0; ui32Trace < ui32NumTraces; ui32Trace++) {
+    psChart->pui32Colors[ui32Trace] =
+      psDisplay->pfnColorTranslate(psDisplay->pvDisplayData,
+                                   pui32Colors[ui32Trace]);
+    psChart->pi16Last[ui32Trace] = -1;
+  }
+  psChart->ui32Background =
+    psDisplay->pfnColorTranslate(psDisplay->pvDisplayData, ui32Background);
+  psChart->ui32Cursor =
+    psDisplay->pfnColorTranslate(psDisplay->pvDisplayData, ui32Cursor);
+  psChart->ui32Traces = (1 << ui32NumTraces) - 1;
+  psChart->i16Column = 0;
+  psChart->ui32Head = 0;
+  psChart->ui32Tail = 0;
+  psChart->ui32Columns = 0;
+  psChart->ui32Dropped = 0;
+}
+
+//*****************************************************************************
+//
+// Paints the chart area with the background, discards any queued samples
+// and starts the sweep again from the left.  Call it after anything else
+// has drawn over the chart.
+//
+//*****************************************************************************
+void
+StripChartClear(tStripChart *psChart)
+{
+  const tDisplay *psDisplay = psChart->psDisplay;
+  uint32_t ui32Trace;
+
+  psDisplay->pfnRectFill(psDisplay->pvDisplayData, &psChart->sRect,
+                         psChart->ui32Background);
+  for(ui32Trace = 0; ui32Trace < psChart->ui32NumTraces; ui32Trace++) {
+    psChart->pi16Last[ui32Trace] = -1;
+  }
+  psChart->i16Column = 0;
+  psChart->ui32Tail = psChart->ui32Head;
+  psDisplay->pfnLineDrawV(psDisplay->pvDisplayData, psChart->sRect.i16XMin,
+                          psChart->sRect.i16YMin, psChart->sRect.i16YMax,
+                          psChart->ui32Cursor);
+}
+
+//*****************************************************************************
+//
+// Chooses the traces plotted, bit n for trace n.  A trace switched on
+// starts with a single point instead of a line from where it last was.
+//
+//*****************************************************************************
+void
+StripChartTracesSet(tStripChart *psChart, uint32_t ui32Traces)
+{
+  uint32_t ui32Trace;
+
+  for(ui32Trace = 0; ui32Trace < psChart->ui32NumTraces; ui32Trace++) {
+    if((ui32Traces & ~psChart->ui32Traces) & (1 << ui32Trace)) {
+      psChart->pi16Last[ui32Trace] = -1;
+    }
+  }
+  psChart->ui32Traces = ui32Traces;
+}
+
+//*****************************************************************************
+//
+// Queues a sample of ui32NumTraces values to be plotted.  Returns false,
+// and counts the sample as dropped, if the queue is full.  May be called
+// from an interrupt.
+//
+//*****************************************************************************
+bool
+StripChartSample(tStripChart *psChart, const uint32_t *pui32Values)
+{
+  uint16_t *pui16Slot;
+  uint32_t ui32Trace;
+
+  if((psChart->ui32Head - psChart->ui32Tail) >= STRIP_CHART_QUEUE) {
+    psChart->ui32Dropped++;
+    return(false);
+  }
+  pui16Slot = psChart->ppui16Queue[psChart->ui32Head &
+                                   (STRIP_CHART_QUEUE - 1)];
+  for(ui32Trace = 0; ui32Trace < psChart->ui32NumTraces; ui32Trace++) {
+    pui16Slot[ui32Trace] = pui32Values[ui32Trace];
+  }
+  psChart->ui32Head++;
+
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Plots every queued sample, one column each.  Returns the number plotted.
+//
+//*****************************************************************************
+uint32_t
+StripChartUpdate(tStripChart *psChart)
+{
+  uint32_t ui32Count;
+
+  ui32Count = 0;
+  while(psChart->ui32Tail != psChart->ui32Head) {
+    StripChartColumn(psChart,
+                     psChart->ppui16Queue[psChart->ui32Tail &
+                                          (STRIP_CHART_QUEUE - 1)]);
+    psChart->ui32Tail++;
+    ui32Count++;
+  }
+
+  return(ui32Count);
+}
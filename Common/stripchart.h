@@ -0,0 +1,79 @@
+//*****************************************************************************
+//
+// stripchart.h - Prototypes for the sweeping strip chart.
+//
+//*****************************************************************************
+
+#ifndef __STRIPCHART_H__
+#define __STRIPCHART_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "grlib/grlib.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Most traces one chart can plot, and the samples that may wait between
+// updates.  The queue length must be a power of two.  At 1 kHz, 128 samples
+// cover a 128 ms pass of the main loop; the slowest pass while a chart is
+// shown sends a whole frame to the panel, about 25-40 ms.
+//
+//*****************************************************************************
+#define STRIP_CHART_MAX_TRACES  3
+#define STRIP_CHART_QUEUE       128
+
+//*****************************************************************************
+//
+// A strip chart.  Samples are queued from an interrupt and plotted one
+// column each at the next update.  The chart area is a ring of columns: the
+// newest column overwrites the oldest, and a cursor column just ahead of it
+// marks where the sweep is, so no plotted pixel ever has to move.
+//
+//*****************************************************************************
+typedef struct
+{
+  const tDisplay *psDisplay;    // Display the chart is drawn on
+  tRectangle sRect;             // Chart area, inclusive
+  uint32_t ui32NumTraces;       // Values in each sample
+  uint32_t ui32FullScale;       // Sample value plotted on the top row
+  uint32_t pui32Colors[STRIP_CHART_MAX_TRACES]; // Translated trace colors
+  uint32_t ui32Background;      // Translated background color
+  uint32_t ui32Cursor;          // Translated sweep cursor color
+  uint32_t ui32Traces;          // Bit mask of the traces plotted
+  int16_t pi16Last[STRIP_CHART_MAX_TRACES];     // Row of each trace in the
+                                                // previous column, or -1
+  int16_t i16Column;            // Offset of the next column to plot
+  uint16_t ppui16Queue[STRIP_CHART_QUEUE][STRIP_CHART_MAX_TRACES];
+  volatile uint32_t ui32Head;   // Samples queued, written by the interrupt
+  volatile uint32_t ui32Tail;   // Samples plotted, written by the update
+  uint32_t ui32Columns;         // Columns plotted since StripChartInit()
+  volatile uint32_t ui32Dropped;        // Samples lost to a full queue
+} tStripChart;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void StripChartInit(tStripChart *psChart, const tDisplay *psDisplay,
+                           const tRectangle *psRect, uint32_t ui32NumTraces,
+                           const uint32_t *pui32Colors,
+                           uint32_t ui32Background, uint32_t ui32Cursor,
+                           uint32_t ui32FullScale);
+extern void StripChartClear(tStripChart *psChart);
+extern void StripChartTracesSet(tStripChart *psChart, uint32_t ui32Traces);
+extern bool StripChartSample(tStripChart *psChart,
+                             const uint32_t *pui32Values);
+extern uint32_t StripChartUpdate(tStripChart *psChart);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __STRIPCHART_H__
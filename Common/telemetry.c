@@ -0,0 +1,322 @@
+//*****************************************************************************
+//
+// telemetry.c - Binary framed telemetry: COBS framing, CRC-16 and packed
+// 12-bit samples.
+//
+// Replaces sprintf()-formatted text for streaming ADC readings.  Three pot
+// channels as text take around 20 bytes per reading plus the formatting
+// time; packed they take 4.5 bytes, and a frame header of a sequence number
+// and timestamp is shared by every reading in the frame.
+//
+// Nothing here touches hardware, so the host-side decoder in Tools/ links
+// this same file to parse the stream.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "telemetry.h"
+
+//*****************************************************************************
+//
+// CRC-16/CCITT remainders for each value of a nibble, so the CRC costs two
+// table lookups per byte with a 32 byte table.
+//
+//*****************************************************************************
+static const uint16_t g_pui16CRCTable[16] =
+{
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+//*****************************************************************************
+//
+// Returns the CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF)
+// of a buffer.
+//
+//*****************************************************************************
+uint16_t
+TelemetryCRC16(const uint8_t *pui8Data, uint32_t ui32Count)
+{
+  uint16_t ui16CRC = 0xFFFF;
+
+  while(ui32Count--) {
+    ui16CRC = (ui16CRC << 4) ^
+              g_pui16CRCTable[(ui16CRC >> 12) ^ (*pui8Data >> 4)];
+    ui16CRC = (ui16CRC << 4) ^
+              g_pui16CRCTable[(ui16CRC >> 12) ^ (*pui8Data & 0x0F)];
+    pui8Data++;
+  }
+
+  return(ui16CRC);
+}
+
+//*****************************************************************************
+//
+// COBS encodes ui32Count bytes into pui8Out, which must hold
+// ui32Count + ui32Count / 254 + 1 bytes.  The output contains no zeros and
+// does not include the trailing delimiter.  Returns the encoded length.
+//
+//*****************************************************************************
+uint32_t
+TelemetryCOBSEncode(const uint8_t *pui8In, uint32_t ui32Count,
+                    uint8_t *pui8Out)
+{
+  uint32_t ui32Code = 0;
+  uint32_t ui32Out = 1;
+  uint8_t ui8Run = 1;
+
+  while(ui32Count--) {
+    if(*pui8In) {
+      pui8Out[ui32Out++] = *pui8In;
+      ui8Run++;
+    }
+    if(!*pui8In || (ui8Run == 0xFF)) {
+      // Close the run by storing its length in the code byte, and start the
+      // next one.  A full run of 254 non-zero bytes has no implied zero.
+      pui8Out[ui32Code] = ui8Run;
+      ui32Code = ui32Out++;
+      ui8Run = 1;
+    }
+    pui8In++;
+  }
+  pui8Out[ui32Code] = ui8Run;
+
+  return(ui32Out);
+}
+
+//*****************************************************************************
+//
+// Decodes a COBS block, without its delimiter, into pui8Out, which may be
+// the same buffer as pui8In.  Returns the decoded length, or 0 if the block
+// is malformed.
+//
+//*****************************************************************************
+uint32_t
+TelemetryCOBSDecode(const uint8_t *pui8In, uint32_t ui32Count,
+                    uint8_t *pui8Out)
+{
+  uint32_t ui32In = 0;
+  uint32_t ui32Out = 0;
+  uint8_t ui8Code, ui8Idx;
+
+  while(ui32In < ui32Count) {
+    ui8Code = pui8In[ui32In++];
+    if((ui8Code == 0) || ((ui32In + ui8Code - 1) > ui32Count)) {
+      return(0);
+    }
+    for(ui8Idx = 1; ui8Idx < ui8Code; ui8Idx++) {
+      pui8Out[ui32Out++] = pui8In[ui32In++];
+    }
+    if((ui8Code != 0xFF) && (ui32In < ui32Count)) {
+      pui8Out[ui32Out++] = 0;
+    }
+  }
+
+  return(ui32Out);
+}
+
+//*****************************************************************************
+//
+// Packs 12-bit samples two to every three bytes.  An odd final sample takes
+// two bytes.  Returns the number of bytes written.
+//
+//*****************************************************************************
+uint32_t
+TelemetryPack12(const uint32_t *pui32Samples, uint32_t ui32Count,
+                uint8_t *pui8Out)
+{
+  uint8_t *pui8Start = pui8Out;
+  uint32_t ui32A, ui32B;
+
+  while(ui32Count >= 2) {
+    ui32A = pui32Samples[0] & 0xFFF;
+    ui32B = pui32Samples[1] & 0xFFF;
+    *pui8Out++ = ui32A;
+    *pui8Out++ = (ui32A >> 8) | (ui32B << 4);
+    *pui8Out++ = ui32B >> 4;
+    pui32Samples += 2;
+    ui32Count -= 2;
+  }
+  if(ui32Count) {
+    ui32A = pui32Samples[0] & 0xFFF;
+    *pui8Out++ = ui32A;
+    *pui8Out++ = ui32A >> 8;
+  }
+
+  return(pui8Out - pui8Start);
+}
+
+//*****************************************************************************
+//
+// Reverses TelemetryPack12() for ui32Count samples.  Returns the number of
+// bytes consumed.
+//
+//*****************************************************************************
+uint32_t
+TelemetryUnpack12(const uint8_t *pui8In, uint32_t ui32Count,
+                  uint16_t *pui16Samples)
+{
+  const uint8_t *pui8Start = pui8In;
+
+  while(ui32Count >= 2) {
+    *pui16Samples++ = pui8In[0] | ((pui8In[1] & 0x0F) << 8);
+    *pui16Samples++ = (pui8In[1] >> 4) | (pui8In[2] << 4);
+    pui8In += 3;
+    ui32Count -= 2;
+  }
+  if(ui32Count) {
+    *pui16Samples = pui8In[0] | ((pui8In[1] & 0x0F) << 8);
+    pui8In += 2;
+  }
+
+  return(pui8In - pui8Start);
+}
+
+//*****************************************************************************
+//
+// Resets a stream's sequence number and frame count.
+//
+//*****************************************************************************
+void
+TelemetryInit(tTelemetry *psTelem)
+{
+  psTelem->ui8Seq = 0;
+  psTelem->ui32Frames = 0;
+}
+
+//*****************************************************************************
+//
+// Builds one frame around a payload and writes it to pui8Out COBS encoded
+// with its delimiter, ready to send.  pui8Out must hold
+// TELEMETRY_MAX_ENCODED bytes.  Returns the number of bytes to send, or 0 if
+// the payload is too long.
+//
+//*****************************************************************************
+uint32_t
+TelemetryFrameBuild(tTelemetry *psTelem, uint8_t ui8Type,
+                    uint32_t ui32Timestamp, const uint8_t *pui8Payload,
+                    uint32_t ui32PayloadLen, uint8_t *pui8Out)
+{
+  uint8_t pui8Raw[TELEMETRY_MAX_FRAME];
+  uint32_t ui32Len, ui32Idx;
+  uint16_t ui16CRC;
+
+  if(ui32PayloadLen > TELEMETRY_MAX_PAYLOAD) {
+    return(0);
+  }
+
+  pui8Raw[0] = ui8Type;
+  pui8Raw[1] = psTelem->ui8Seq++;
+  pui8Raw[2] = ui32Timestamp;
+  pui8Raw[3] = ui32Timestamp >> 8;
+  pui8Raw[4] = ui32Timestamp >> 16;
+  pui8Raw[5] = ui32Timestamp >> 24;
+  ui32Len = TELEMETRY_HDR_SIZE;
+  for(ui32Idx = 0; ui32Idx < ui32PayloadLen; ui32Idx++) {
+    pui8Raw[ui32Len++] = pui8Payload[ui32Idx];
+  }
+  ui16CRC = TelemetryCRC16(pui8Raw, ui32Len);
+  pui8Raw[ui32Len++] = ui16CRC;
+  pui8Raw[ui32Len++] = ui16CRC >> 8;
+
+  ui32Len = TelemetryCOBSEncode(pui8Raw, ui32Len, pui8Out);
+  pui8Out[ui32Len++] = 0;
+  psTelem->ui32Frames++;
+
+  return(ui32Len);
+}
+
+//*****************************************************************************
+//
+// Builds an ADC frame from ui32Count readings of ui32Channels channels each,
+// stored channel-interleaved in pui32Samples.  Returns the number of bytes
+// to send, or 0 if the samples do not fit in one frame.
+//
+//*****************************************************************************
+uint32_t
+TelemetryADCFrame(tTelemetry *psTelem, uint32_t ui32Timestamp,
+                  const uint32_t *pui32Samples, uint32_t ui32Channels,
+                  uint32_t ui32Count, uint8_t *pui8Out)
+{
+  uint8_t pui8Payload[TELEMETRY_MAX_PAYLOAD];
+  uint32_t ui32Len;
+
+  if((ui32Channels == 0) || (ui32Channels > 0xFF) ||
+     ((ui32Channels * ui32Count) > TELEMETRY_ADC_MAX_SAMPLES)) {
+    return(0);
+  }
+
+  pui8Payload[0] = ui32Channels;
+  ui32Len = 1 + TelemetryPack12(pui32Samples, ui32Channels * ui32Count,
+                                pui8Payload + 1);
+
+  return(TelemetryFrameBuild(psTelem, TELEMETRY_TYPE_ADC, ui32Timestamp,
+                             pui8Payload, ui32Len, pui8Out));
+}
+
+//*****************************************************************************
+//
+// Builds a frame whose payload is ui32Count 32-bit words, little-endian, such
+// as a block of counters.  Returns the number of bytes to send, or 0 if the
+// words do not fit in one frame.
+//
+//*****************************************************************************
+uint32_t
+TelemetryWordsFrame(tTelemetry *psTelem, uint8_t ui8Type,
+                    uint32_t ui32Timestamp, const uint32_t *pui32Words,
+                    uint32_t ui32Count, uint8_t *pui8Out)
+{
+  uint8_t pui8Payload[TELEMETRY_MAX_PAYLOAD];
+  uint32_t ui32Idx;
+
+  if((ui32Count * 4) > TELEMETRY_MAX_PAYLOAD) {
+    return(0);
+  }
+
+  for(ui32Idx = 0; ui32Idx < ui32Count; ui32Idx++) {
+    pui8Payload[(ui32Idx * 4) + 0] = pui32Words[ui32Idx];
+    pui8Payload[(ui32Idx * 4) + 1] = pui32Words[ui32Idx] >> 8;
+    pui8Payload[(ui32Idx * 4) + 2] = pui32Words[ui32Idx] >> 16;
+    pui8Payload[(ui32Idx * 4) + 3] = pui32Words[ui32Idx] >> 24;
+  }
+
+  return(TelemetryFrameBuild(psTelem, ui8Type, ui32Timestamp, pui8Payload,
+                             ui32Count * 4, pui8Out));
+}
+
+//*****************************************************************************
+//
+// Decodes one received frame, without its delimiter, in place and checks its
+// CRC.  On success psFrame points into pui8Raw.  Returns false if the frame
+// is malformed or corrupt.
+//
+//*****************************************************************************
+bool
+TelemetryFrameDecode(uint8_t *pui8Raw, uint32_t ui32Count,
+                     tTelemetryFrame *psFrame)
+{
+  uint32_t ui32Len;
+  uint16_t ui16CRC;
+
+  ui32Len = TelemetryCOBSDecode(pui8Raw, ui32Count, pui8Raw);
+  if(ui32Len < (TELEMETRY_HDR_SIZE + TELEMETRY_CRC_SIZE)) {
+    return(false);
+  }
+
+  ui32Len -= TELEMETRY_CRC_SIZE;
+  ui16CRC = pui8Raw[ui32Len] | (pui8Raw[ui32Len + 1] << 8);
+  if(ui16CRC != TelemetryCRC16(pui8Raw, ui32Len)) {
+    return(false);
+  }
+
+  psFrame->ui8Type = pui8Raw[0];
+  psFrame->ui8Seq = pui8Raw[1];
+  psFrame->ui32Timestamp = pui8Raw[2] | (pui8Raw[3] << 8) |
+                           (pui8Raw[4] << 16) | ((uint32_t)pui8Raw[5] << 24);
+  psFrame->pui8Payload = pui8Raw + TELEMETRY_HDR_SIZE;
+  psFrame->ui32PayloadLen = ui32Len - TELEMETRY_HDR_SIZE;
+
+  return(true);
+}
@@ -0,0 +1,126 @@
+//*****************************************************************************
+//
+// telemetry.h - Binary framed telemetry: COBS framing, CRC-16 and packed
+// 12-bit samples.
+//
+//*****************************************************************************
+
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Frame layout before encoding, all fields little-endian:
+//
+//     type (1)  seq (1)  timestamp (4)  payload (n)  crc16 (2)
+//
+// The CRC is CRC-16/CCITT-FALSE over everything before it.  The frame is
+// then COBS encoded, which removes every zero byte, and a single zero ends
+// it on the wire.  A receiver that joins mid-stream or sees a corrupt frame
+// resynchronizes at the next zero.
+//
+// Frames are built on the stack, so the payload limit is kept small; 96
+// bytes carries 21 readings of three channels.
+//
+//*****************************************************************************
+#define TELEMETRY_HDR_SIZE      6
+#define TELEMETRY_CRC_SIZE      2
+#define TELEMETRY_MAX_PAYLOAD   96
+
+//*****************************************************************************
+//
+// Largest raw frame and the largest it can become once COBS encoded and
+// delimited: one overhead byte per 254 bytes plus the trailing zero.
+//
+//*****************************************************************************
+#define TELEMETRY_MAX_FRAME     (TELEMETRY_HDR_SIZE + TELEMETRY_MAX_PAYLOAD + \
+                                 TELEMETRY_CRC_SIZE)
+#define TELEMETRY_MAX_ENCODED   (TELEMETRY_MAX_FRAME +                        \
+                                 (TELEMETRY_MAX_FRAME / 254) + 2)
+
+//*****************************************************************************
+//
+// Frame types.
+//
+//*****************************************************************************
+#define TELEMETRY_TYPE_ADC      0x01    // Packed 12-bit ADC samples
+#define TELEMETRY_TYPE_UART_RX  0x02    // tUARTRxStats as 32-bit words
+
+//*****************************************************************************
+//
+// ADC payload: a channel count followed by 12-bit samples packed two to
+// every three bytes, channel-interleaved (ch0, ch1, ch2, ch0, ...).
+//
+//*****************************************************************************
+#define TELEMETRY_ADC_MAX_SAMPLES                                             \
+                                (((TELEMETRY_MAX_PAYLOAD - 1) / 3) * 2)
+
+//*****************************************************************************
+//
+// Per-stream state: the next sequence number and a count of frames built.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint8_t ui8Seq;
+  uint32_t ui32Frames;
+} tTelemetry;
+
+//*****************************************************************************
+//
+// A decoded frame, as filled in by TelemetryFrameDecode().
+//
+//*****************************************************************************
+typedef struct
+{
+  uint8_t ui8Type;
+  uint8_t ui8Seq;
+  uint32_t ui32Timestamp;
+  const uint8_t *pui8Payload;
+  uint32_t ui32PayloadLen;
+} tTelemetryFrame;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern uint16_t TelemetryCRC16(const uint8_t *pui8Data, uint32_t ui32Count);
+extern uint32_t TelemetryCOBSEncode(const uint8_t *pui8In, uint32_t ui32Count,
+                                    uint8_t *pui8Out);
+extern uint32_t TelemetryCOBSDecode(const uint8_t *pui8In, uint32_t ui32Count,
+                                    uint8_t *pui8Out);
+extern uint32_t TelemetryPack12(const uint32_t *pui32Samples,
+                                uint32_t ui32Count, uint8_t *pui8Out);
+extern uint32_t TelemetryUnpack12(const uint8_t *pui8In, uint32_t ui32Count,
+                                  uint16_t *pui16Samples);
+extern void TelemetryInit(tTelemetry *psTelem);
+extern uint32_t TelemetryFrameBuild(tTelemetry *psTelem, uint8_t ui8Type,
+                                    uint32_t ui32Timestamp,
+                                    const uint8_t *pui8Payload,
+                                    uint32_t ui32PayloadLen,
+                                    uint8_t *pui8Out);
+extern uint32_t TelemetryADCFrame(tTelemetry *psTelem, uint32_t ui32Timestamp,
+                                  const uint32_t *pui32Samples,
+                                  uint32_t ui32Channels, uint32_t ui32Count,
+                                  uint8_t *pui8Out);
+extern uint32_t TelemetryWordsFrame(tTelemetry *psTelem, uint8_t ui8Type,
+                                    uint32_t ui32Timestamp,
+                                    const uint32_t *pui32Words,
+                                    uint32_t ui32Count, uint8_t *pui8Out);
+extern bool TelemetryFrameDecode(uint8_t *pui8Raw, uint32_t ui32Count,
+                                 tTelemetryFrame *psFrame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TELEMETRY_H__
@@ -0,0 +1,125 @@
+//*****************************************************************************
+//
+// uartbaud.c - Checked UART baud rate changes.
+//
+// UARTConfigSetExpClk() programs whatever divisor is nearest to the rate it
+// is given, however far off that is.  At higher rates the fractional
+// divisor's 1/64 steps become coarse, so this works out the rate the divisor
+// will really produce and refuses any that are outside tolerance before the
+// port is touched.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_uart.h"
+#include "driverlib/uart.h"
+
+#include "uartbaud.h"
+
+//*****************************************************************************
+//
+// Works out the divisor for ui32Baud from a UART clock of ui32UARTClk, the
+// same way the hardware will use it: BRD = UARTClk / (ClkDiv * Baud), with
+// ClkDiv 16, or 8 when the rate needs the high-speed enable.  Returns true
+// if the resulting error is within UART_BAUD_MAX_ERROR_PPM.
+//
+//*****************************************************************************
+bool
+UARTBaudCompute(uint32_t ui32UARTClk, uint32_t ui32Baud, tUARTBaud *psBaud)
+{
+  uint32_t ui32ClkDiv, ui32Div;
+  int64_t i64Diff;
+
+  psBaud->ui32Baud = ui32Baud;
+  psBaud->ui32Actual = 0;
+  psBaud->i32ErrorPPM = 0;
+  psBaud->ui32IBRD = 0;
+  psBaud->ui32FBRD = 0;
+  psBaud->bHSE = false;
+  psBaud->bReachable = false;
+
+  if(ui32Baud == 0) {
+    return(false);
+  }
+
+  // The UART needs at least 8 clocks per bit, and 16 without HSE.
+  if((uint64_t)ui32Baud * 16 <= ui32UARTClk) {
+    ui32ClkDiv = 16;
+  }
+  else if((uint64_t)ui32Baud * 8 <= ui32UARTClk) {
+    ui32ClkDiv = 8;
+    psBaud->bHSE = true;
+  }
+  else {
+    return(false);
+  }
+
+  // Divisor in 64ths, rounded to nearest.
+  ui32Div = (uint32_t)((((uint64_t)ui32UARTClk * 128 /
+                         ((uint64_t)ui32ClkDiv * ui32Baud)) + 1) / 2);
+  psBaud->ui32IBRD = ui32Div / 64;
+  psBaud->ui32FBRD = ui32Div % 64;
+  if((psBaud->ui32IBRD == 0) || (psBaud->ui32IBRD > 0xFFFF)) {
+    return(false);
+  }
+  psBaud->bReachable = true;
+
+  psBaud->ui32Actual = (uint32_t)(((uint64_t)ui32UARTClk * 64) /
+                                  ((uint64_t)ui32ClkDiv * ui32Div));
+  i64Diff = (int64_t)psBaud->ui32Actual - ui32Baud;
+  psBaud->i32ErrorPPM = (int32_t)((i64Diff * 1000000) / ui32Baud);
+
+  return((psBaud->i32ErrorPPM <= UART_BAUD_MAX_ERROR_PPM) &&
+         (psBaud->i32ErrorPPM >= -UART_BAUD_MAX_ERROR_PPM));
+}
+
+//*****************************************************************************
+//
+// Switches a running UART to ui32Baud if the divisor error is within
+// tolerance, keeping its framing, FIFO and interrupt settings.  Returns false
+// and leaves the port alone otherwise.  Either way psBaud, if not NULL,
+// receives the divisor details for reporting.
+//
+// Anything still in the TX FIFO would go out at the new rate, so the caller
+// should flush its output first.
+//
+//*****************************************************************************
+bool
+UARTBaudSet(uint32_t ui32Base, uint32_t ui32UARTClk, uint32_t ui32Baud,
+            tUARTBaud *psBaud)
+{
+  tUARTBaud sBaud;
+  uint32_t ui32LCRH;
+
+  if(psBaud == 0) {
+    psBaud = &sBaud;
+  }
+  if(!UARTBaudCompute(ui32UARTClk, ui32Baud, psBaud)) {
+    return(false);
+  }
+
+  while(UARTBusy(ui32Base)) {
+  }
+  UARTDisable(ui32Base);
+
+  if(psBaud->bHSE) {
+    HWREG(ui32Base + UART_O_CTL) |= UART_CTL_HSE;
+  }
+  else {
+    HWREG(ui32Base + UART_O_CTL) &= ~UART_CTL_HSE;
+  }
+  HWREG(ui32Base + UART_O_IBRD) = psBaud->ui32IBRD;
+  HWREG(ui32Base + UART_O_FBRD) = psBaud->ui32FBRD;
+
+  // The divisor only takes effect on a write to the line control register.
+  ui32LCRH = HWREG(ui32Base + UART_O_LCRH);
+  HWREG(ui32Base + UART_O_LCRH) = ui32LCRH;
+
+  UARTEnable(ui32Base);
+
+  return(true);
+}
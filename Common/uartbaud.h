@@ -0,0 +1,57 @@
+//*****************************************************************************
+//
+// uartbaud.h - Prototypes for checked UART baud rate changes.
+//
+//*****************************************************************************
+
+#ifndef __UARTBAUD_H__
+#define __UARTBAUD_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Largest divisor error accepted, in parts per million.  A UART frame
+// tolerates roughly 4% of combined mismatch between the two ends; keeping
+// our side under 1.5% leaves the rest for the host adapter's own error.
+//
+//*****************************************************************************
+#define UART_BAUD_MAX_ERROR_PPM 15000
+
+//*****************************************************************************
+//
+// The divisor chosen for a requested rate and how close it gets.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint32_t ui32Baud;            // Rate that was asked for
+  uint32_t ui32Actual;          // Rate the divisor really produces
+  int32_t i32ErrorPPM;          // (actual - asked) / asked, in ppm
+  uint32_t ui32IBRD;            // Integer part of the divisor
+  uint32_t ui32FBRD;            // Fractional part, in 64ths
+  bool bHSE;                    // Uses the high-speed /8 clock divider
+  bool bReachable;              // A divisor exists at all
+} tUARTBaud;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern bool UARTBaudCompute(uint32_t ui32UARTClk, uint32_t ui32Baud,
+                            tUARTBaud *psBaud);
+extern bool UARTBaudSet(uint32_t ui32Base, uint32_t ui32UARTClk,
+                        uint32_t ui32Baud, tUARTBaud *psBaud);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UARTBAUD_H__
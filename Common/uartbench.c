@@ -0,0 +1,244 @@
+//*****************************************************************************
+//
+// uartbench.c - UART transmit throughput benchmark.
+//
+// Streams a pattern out of a UART for a fixed time through one of the
+// transmit backends and reports the rate achieved, the CPU time it cost and
+// how often the sender had to wait for room.
+//
+// CPU time is measured by difference.  Whenever the sender has to wait it
+// runs a fixed idle loop whose length was timed beforehand with interrupts
+// off.  Anything not spent idling was spent on transmit work.  That includes
+// the TX interrupts, which a stopwatch around the send calls would miss.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "driverlib/interrupt.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+
+#include "cyccnt.h"
+#include "uarttx.h"
+#include "uartdma.h"
+#include "uartbench.h"
+
+//*****************************************************************************
+//
+// Length of one idle step and the number of steps timed to calibrate it.
+//
+//*****************************************************************************
+#define UART_BENCH_IDLE_SPIN    16
+#define UART_BENCH_CAL_STEPS    64
+
+//*****************************************************************************
+//
+// One step of waiting.  Kept out of line so every call costs the same.
+//
+//*****************************************************************************
+static void
+UARTBenchIdle(void)
+{
+  volatile uint32_t ui32Spin;
+
+  for(ui32Spin = 0; ui32Spin < UART_BENCH_IDLE_SPIN; ui32Spin++) {
+  }
+}
+
+//*****************************************************************************
+//
+// Returns the clocks taken by UART_BENCH_CAL_STEPS idle steps with nothing
+// able to interrupt them.
+//
+//*****************************************************************************
+static uint32_t
+UARTBenchCalibrate(void)
+{
+  uint32_t ui32Start, ui32Idx, ui32Cycles;
+  bool bWasDisabled;
+
+  bWasDisabled = IntMasterDisable();
+  ui32Start = CycleCounterGet();
+  for(ui32Idx = 0; ui32Idx < UART_BENCH_CAL_STEPS; ui32Idx++) {
+    UARTBenchIdle();
+  }
+  ui32Cycles = CycleCounterGet() - ui32Start;
+  if(!bWasDisabled) {
+    IntMasterEnable();
+  }
+
+  return(ui32Cycles);
+}
+
+//*****************************************************************************
+//
+// Fills a buffer with lines of printable characters, each ended with CR LF,
+// so the flood is readable in a terminal and a dropped byte is easy to spot.
+//
+//*****************************************************************************
+void
+UARTBenchPatternFill(uint8_t *pui8Buf, uint32_t ui32Size)
+{
+  uint32_t ui32Idx;
+
+  for(ui32Idx = 0; ui32Idx < ui32Size; ui32Idx++) {
+    if((ui32Idx % 64) == 62) {
+      pui8Buf[ui32Idx] = '\r';
+    }
+    else if((ui32Idx % 64) == 63) {
+      pui8Buf[ui32Idx] = '\n';
+    }
+    else {
+      pui8Buf[ui32Idx] = '!' + ((ui32Idx % 64) + (ui32Idx / 64)) % 94;
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// Returns a short name for a backend.
+//
+//*****************************************************************************
+const char *
+UARTBenchName(uint32_t ui32Backend)
+{
+  switch(ui32Backend) {
+    case UART_BENCH_BLOCKING:
+      return("Blocking");
+    case UART_BENCH_INTERRUPT:
+      return("Interrupt");
+    case UART_BENCH_DMA:
+      return("uDMA");
+    default:
+      return("?");
+  }
+}
+
+//*****************************************************************************
+//
+// Sends pui8Pattern over and over for ui32Ms milliseconds through the chosen
+// backend and fills in psResult.  The pattern is sent whole each time, so it
+// must fit in the transmit ring and in one uDMA transfer.  psDMA is only
+// used by the uDMA backend and may be NULL otherwise.  Interrupts must be
+// enabled for the interrupt and uDMA backends to make progress.  Returns
+// false without sending anything if the arguments cannot be benchmarked.
+//
+// Any output already queued is flushed first, and the run's own output is
+// flushed afterwards, so neither is counted.
+//
+//*****************************************************************************
+bool
+UARTBenchRun(tUARTTx *psTx, tUARTDMA *psDMA, uint32_t ui32Backend,
+             uint32_t ui32SysClk, uint32_t ui32Ms,
+             const uint8_t *pui8Pattern, uint32_t ui32Len,
+             tUARTBenchResult *psResult)
+{
+  uint32_t ui32Base = psTx->ui32Base;
+  uint32_t ui32Limit, ui32Start, ui32Cal, ui32Idle, ui32Idx;
+  uint32_t ui32Bytes = 0;
+  uint32_t ui32Stalls = 0;
+  uint64_t ui64Idle;
+  bool bWaiting = false;
+
+  if((ui32Ms == 0) || (ui32Ms > UART_BENCH_MAX_MS) || (ui32Len == 0) ||
+     (ui32Len > (psTx->ui32Mask + 1)) || (ui32Len > UART_DMA_MAX_XFER) ||
+     (ui32Backend >= UART_BENCH_NUM_BACKENDS) ||
+     ((ui32Backend == UART_BENCH_DMA) && (psDMA == 0))) {
+    return(false);
+  }
+
+  if(psDMA) {
+    UARTDMAFlush(psDMA);
+  }
+  UARTTxFlush(psTx);
+
+  CycleCounterInit();
+  ui32Cal = UARTBenchCalibrate();
+  ui32Limit = ui32Ms * (ui32SysClk / 1000);
+  ui32Idle = 0;
+  ui32Idx = 0;
+
+  // The blocking backend never uses the ring, so keep its interrupt from
+  // being charged to it.
+  if(ui32Backend == UART_BENCH_BLOCKING) {
+    UARTIntDisable(ui32Base, UART_INT_TX);
+  }
+
+  ui32Start = CycleCounterGet();
+  while((CycleCounterGet() - ui32Start) < ui32Limit) {
+    switch(ui32Backend) {
+      case UART_BENCH_BLOCKING:
+        // UARTCharPut() spins until there is room, which is CPU time lost
+        // to transmitting, so there is no idle step here.
+        if(!UARTSpaceAvail(ui32Base)) {
+          ui32Stalls += !bWaiting;
+          bWaiting = true;
+        }
+        else {
+          bWaiting = false;
+        }
+        UARTCharPut(ui32Base, pui8Pattern[ui32Idx]);
+        if(++ui32Idx == ui32Len) {
+          ui32Idx = 0;
+        }
+        ui32Bytes++;
+        continue;
+
+      case UART_BENCH_INTERRUPT:
+        if(UARTTxSpace(psTx) >= ui32Len) {
+          ui32Bytes += UARTTxWrite(psTx, pui8Pattern, ui32Len);
+          bWaiting = false;
+          continue;
+        }
+        break;
+
+      case UART_BENCH_DMA:
+        if(!UARTDMABusy(psDMA) &&
+           UARTDMASend(psDMA, pui8Pattern, ui32Len, 0, 0)) {
+          ui32Bytes += ui32Len;
+          bWaiting = false;
+          continue;
+        }
+        break;
+    }
+
+    ui32Stalls += !bWaiting;
+    bWaiting = true;
+    UARTBenchIdle();
+    ui32Idle++;
+  }
+  psResult->ui32Cycles = CycleCounterGet() - ui32Start;
+
+  // Only count what actually left: take off whatever is still queued.
+  if(ui32Backend == UART_BENCH_INTERRUPT) {
+    ui32Bytes -= psTx->ui32Head - psTx->ui32Tail;
+  }
+  else if((ui32Backend == UART_BENCH_DMA) && UARTDMABusy(psDMA)) {
+    ui32Bytes -= uDMAChannelSizeGet(psDMA->ui32Channel | UDMA_PRI_SELECT);
+  }
+
+  if(ui32Backend == UART_BENCH_BLOCKING) {
+    UARTIntEnable(ui32Base, UART_INT_TX);
+  }
+  if(psDMA) {
+    UARTDMAFlush(psDMA);
+  }
+  UARTTxFlush(psTx);
+
+  ui64Idle = ((uint64_t)ui32Idle * ui32Cal) / UART_BENCH_CAL_STEPS;
+  if(ui64Idle > psResult->ui32Cycles) {
+    ui64Idle = psResult->ui32Cycles;
+  }
+  psResult->ui32Bytes = ui32Bytes;
+  psResult->ui32Stalls = ui32Stalls;
+  psResult->ui32BusyCycles = psResult->ui32Cycles - (uint32_t)ui64Idle;
+  psResult->ui32BytesPerSec =
+    (uint32_t)(((uint64_t)ui32Bytes * ui32SysClk) / psResult->ui32Cycles);
+  psResult->ui32CPUPercent =
+    (uint32_t)(((uint64_t)psResult->ui32BusyCycles * 100) /
+               psResult->ui32Cycles);
+
+  return(true);
+}
@@ -0,0 +1,70 @@
+//*****************************************************************************
+//
+// uartbench.h - Prototypes for the UART transmit throughput benchmark.
+//
+//*****************************************************************************
+
+#ifndef __UARTBENCH_H__
+#define __UARTBENCH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "uarttx.h"
+#include "uartdma.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Transmit backends that can be measured.
+//
+//*****************************************************************************
+#define UART_BENCH_BLOCKING     0       // UARTCharPut() spinning on the FIFO
+#define UART_BENCH_INTERRUPT    1       // Transmit ring drained by the ISR
+#define UART_BENCH_DMA          2       // Whole blocks fed by the uDMA
+#define UART_BENCH_NUM_BACKENDS 3
+
+//*****************************************************************************
+//
+// Longest run accepted.  The run is timed with the 32-bit cycle counter,
+// which wraps after about 53 s at 80 MHz.
+//
+//*****************************************************************************
+#define UART_BENCH_MAX_MS       10000
+
+//*****************************************************************************
+//
+// Results of one run.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint32_t ui32Bytes;           // Bytes that left the UART during the run
+  uint32_t ui32Cycles;          // Length of the run in system clocks
+  uint32_t ui32BusyCycles;      // Clocks the CPU spent on transmit work
+  uint32_t ui32Stalls;          // Times the sender found no room and waited
+  uint32_t ui32BytesPerSec;     // Achieved throughput
+  uint32_t ui32CPUPercent;      // ui32BusyCycles as a share of the run
+} tUARTBenchResult;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void UARTBenchPatternFill(uint8_t *pui8Buf, uint32_t ui32Size);
+extern bool UARTBenchRun(tUARTTx *psTx, tUARTDMA *psDMA, uint32_t ui32Backend,
+                         uint32_t ui32SysClk, uint32_t ui32Ms,
+                         const uint8_t *pui8Pattern, uint32_t ui32Len,
+                         tUARTBenchResult *psResult);
+extern const char *UARTBenchName(uint32_t ui32Backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UARTBENCH_H__
@@ -0,0 +1,205 @@
+//*****************************************************************************
+//
+// uartdma.c - uDMA-backed bulk UART transmit.
+//
+// Hands a whole constant buffer (a menu, a banner, a telemetry block) to a
+// uDMA channel that feeds the UART TX FIFO, so the CPU returns immediately
+// instead of copying the block byte by byte.  Completion is reported through
+// a callback run from the UART interrupt.
+//
+// The block shares the TX FIFO with the port's transmit ring.  A barrier in
+// the ring keeps output in the order it was written.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "inc/hw_uart.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+
+#include "udmactl.h"
+#include "uarttx.h"
+#include "uartdma.h"
+
+//*****************************************************************************
+//
+// Starts the channel on the queued block.  Called through the ring barrier
+// once every byte queued ahead of the block is in the TX FIFO.
+//
+//*****************************************************************************
+static void
+UARTDMAStart(void *pvData)
+{
+  tUARTDMA *psDMA = (tUARTDMA *)pvData;
+  uint32_t ui32Base = psDMA->psTx->ui32Base;
+
+  uDMAChannelTransferSet(psDMA->ui32Channel | UDMA_PRI_SELECT,
+                         UDMA_MODE_BASIC, (void *)psDMA->pui8Block,
+                         (void *)(ui32Base + UART_O_DR), psDMA->ui32Count);
+  psDMA->ui32State = UART_DMA_ACTIVE;
+  uDMAChannelEnable(psDMA->ui32Channel);
+  UARTDMAEnable(ui32Base, UART_DMA_TX);
+}
+
+//*****************************************************************************
+//
+// Retires a finished block, lets the ring resume and runs the callback.
+// Called with the UART interrupt unable to preempt.
+//
+//*****************************************************************************
+static void
+UARTDMAComplete(tUARTDMA *psDMA)
+{
+  tUARTDMACallback pfnCallback = psDMA->pfnCallback;
+  void *pvCBData = psDMA->pvCBData;
+
+  UARTDMADisable(psDMA->psTx->ui32Base, UART_DMA_TX);
+  psDMA->ui32Blocks++;
+  psDMA->ui32Bytes += psDMA->ui32Count;
+  psDMA->ui32State = UART_DMA_IDLE;
+
+  UARTTxBarrierClear(psDMA->psTx);
+
+  // The callback may queue the next block, so it runs after the state is
+  // back to idle.
+  if(pfnCallback) {
+    pfnCallback(pvCBData);
+  }
+}
+
+//*****************************************************************************
+//
+// Binds a uDMA channel to the UART behind psTx.  ui32Channel is the
+// channel mapping for the port's TX request, e.g. UDMA_CH9_UART0TX.
+//
+//*****************************************************************************
+void
+UARTDMAInit(tUARTDMA *psDMA, tUARTTx *psTx, uint32_t ui32Channel)
+{
+  psDMA->psTx = psTx;
+  psDMA->ui32Channel = ui32Channel & 0xff;
+  psDMA->ui32State = UART_DMA_IDLE;
+  psDMA->pfnCallback = 0;
+  psDMA->ui32Blocks = 0;
+  psDMA->ui32Bytes = 0;
+
+  uDMAControlInit();
+  uDMAChannelAssign(ui32Channel);
+  uDMAChannelAttributeDisable(psDMA->ui32Channel,
+                              UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST |
+                              UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+
+  // Byte writes to the fixed data register.  The arbitration size matches
+  // the free space the UART guarantees when it raises a burst request.
+  uDMAChannelControlSet(psDMA->ui32Channel | UDMA_PRI_SELECT,
+                        UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE |
+                        UDMA_ARB_4);
+}
+
+//*****************************************************************************
+//
+// Queues a block for transmission and returns immediately.  The block must
+// stay valid until pfnCallback runs, so it is normally a const string.
+// Returns false if a block is already in flight or ui32Count is out of
+// range; the caller can then fall back to the transmit ring.
+//
+//*****************************************************************************
+bool
+UARTDMASend(tUARTDMA *psDMA, const void *pvBlock, uint32_t ui32Count,
+            tUARTDMACallback pfnCallback, void *pvCBData)
+{
+  bool bWasDisabled;
+
+  if((ui32Count == 0) || (ui32Count > UART_DMA_MAX_XFER)) {
+    return(false);
+  }
+
+  bWasDisabled = IntMasterDisable();
+
+  if(psDMA->ui32State != UART_DMA_IDLE) {
+    if(!bWasDisabled) {
+      IntMasterEnable();
+    }
+    return(false);
+  }
+
+  psDMA->pui8Block = (const uint8_t *)pvBlock;
+  psDMA->ui32Count = ui32Count;
+  psDMA->pfnCallback = pfnCallback;
+  psDMA->pvCBData = pvCBData;
+  psDMA->ui32State = UART_DMA_PENDING;
+
+  // Starts the channel now if the ring is empty, otherwise once it has
+  // drained up to this point.
+  UARTTxBarrierSet(psDMA->psTx, UARTDMAStart, psDMA);
+
+  if(!bWasDisabled) {
+    IntMasterEnable();
+  }
+
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Returns true while a block is queued or being sent.
+//
+//*****************************************************************************
+bool
+UARTDMABusy(tUARTDMA *psDMA)
+{
+  return(psDMA->ui32State != UART_DMA_IDLE);
+}
+
+//*****************************************************************************
+//
+// Completion service.  The uDMA signals the end of a transfer on the UART's
+// own interrupt vector, so the port's UART interrupt handler calls this
+// after UARTTxIntHandler().
+//
+//*****************************************************************************
+void
+UARTDMAIntHandler(tUARTDMA *psDMA)
+{
+  if((psDMA->ui32State == UART_DMA_ACTIVE) &&
+     !uDMAChannelIsEnabled(psDMA->ui32Channel)) {
+    UARTDMAComplete(psDMA);
+  }
+}
+
+//*****************************************************************************
+//
+// Blocks until any queued block, and everything in the ring before and after
+// it, has left the UART, so the port can then be reconfigured safely.  Polls
+// the channel, so it also works with interrupts masked.
+//
+//*****************************************************************************
+void
+UARTDMAFlush(tUARTDMA *psDMA)
+{
+  tUARTTx *psTx = psDMA->psTx;
+  bool bWasDisabled;
+
+  // The ring only drains up to a pending block's barrier.  Bytes queued
+  // behind the block are released when it completes, and its callback may
+  // queue another, so keep going until both the channel and the ring are
+  // empty.
+  do {
+    UARTTxFlush(psTx);
+    while(psDMA->ui32State != UART_DMA_IDLE) {
+      bWasDisabled = IntMasterDisable();
+      UARTDMAIntHandler(psDMA);
+      if(!bWasDisabled) {
+        IntMasterEnable();
+      }
+    }
+  }
+  while(psTx->ui32Tail != psTx->ui32Head);
+
+  // The end of a block may still be in the FIFO.
+  while(UARTBusy(psTx->ui32Base)) {
+  }
+}
@@ -0,0 +1,80 @@
+//*****************************************************************************
+//
+// uartdma.h - Prototypes for uDMA-backed bulk UART transmit.
+//
+//*****************************************************************************
+
+#ifndef __UARTDMA_H__
+#define __UARTDMA_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "uarttx.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The largest block a single basic-mode uDMA transfer can move.
+//
+//*****************************************************************************
+#define UART_DMA_MAX_XFER       1024
+
+//*****************************************************************************
+//
+// Called from the UART interrupt once a block has been handed to the TX FIFO.
+//
+//*****************************************************************************
+typedef void (*tUARTDMACallback)(void *pvCBData);
+
+//*****************************************************************************
+//
+// States of a bulk transfer.
+//
+//*****************************************************************************
+#define UART_DMA_IDLE           0   // No block queued
+#define UART_DMA_PENDING        1   // Waiting for the ring ahead of it
+#define UART_DMA_ACTIVE         2   // Channel is feeding the TX FIFO
+
+//*****************************************************************************
+//
+// Bulk transmit state for one UART.  Blocks are ordered with respect to the
+// port's transmit ring: bytes queued before UARTDMASend() go out first,
+// bytes queued after it wait until the block is done.
+//
+//*****************************************************************************
+typedef struct
+{
+  tUARTTx *psTx;                // Transmit ring sharing the TX FIFO
+  uint32_t ui32Channel;         // uDMA channel mapped to the UART TX request
+  volatile uint32_t ui32State;  // One of the UART_DMA_* states
+  const uint8_t *pui8Block;     // Block being sent; must stay valid
+  uint32_t ui32Count;           // Length of the block in bytes
+  tUARTDMACallback pfnCallback; // Completion callback, may be 0
+  void *pvCBData;               // Argument passed to pfnCallback
+  uint32_t ui32Blocks;          // Blocks completed
+  uint32_t ui32Bytes;           // Bytes moved by the uDMA
+} tUARTDMA;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void UARTDMAInit(tUARTDMA *psDMA, tUARTTx *psTx, uint32_t ui32Channel);
+extern bool UARTDMASend(tUARTDMA *psDMA, const void *pvBlock,
+                        uint32_t ui32Count, tUARTDMACallback pfnCallback,
+                        void *pvCBData);
+extern bool UARTDMABusy(tUARTDMA *psDMA);
+extern void UARTDMAIntHandler(tUARTDMA *psDMA);
+extern void UARTDMAFlush(tUARTDMA *psDMA);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UARTDMA_H__
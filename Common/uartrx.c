@@ -0,0 +1,317 @@
+//*****************************************************************************
+//
+// uartrx.c - Interrupt-filled UART receive ring buffer.
+//
+// The RX FIFO interrupt fires once the hardware FIFO is half full and the
+// receive-timeout (RT) interrupt fires when the line goes quiet with bytes
+// still in it, so input is moved in batches rather than one interrupt per
+// character.  The interrupt only copies bytes; acting on them is left to a
+// consumer in the main loop, so a pasted script cannot hold off the timer
+// interrupts.  The one exception is echo, which can optionally be done in
+// the interrupt so keystrokes come straight back however busy the main loop
+// is.
+//
+// Echo latency is measured from when each byte finished arriving, not from
+// when the interrupt ran.  The byte that reached the trigger level arrived as
+// the interrupt was raised and the ones ahead of it one frame apart before
+// that; a batch short of the trigger level was raised by the receive timeout,
+// 32 bit periods after its last byte.  Keeping a stamp per byte lets the main
+// loop measure its own echo the same way.
+//
+// Each byte's receive status is checked as it is read.  Bytes with framing,
+// parity or break errors are counted and thrown away rather than handed on
+// as garbage, and overruns, where the hardware FIFO filled and input was
+// lost, are counted so a console that cannot keep up shows in the stats.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "inc/hw_types.h"
+#include "inc/hw_uart.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/uart.h"
+
+#include "cyccnt.h"
+#include "spscq.h"
+#include "uarttx.h"
+#include "lathist.h"
+#include "uartrx.h"
+
+//*****************************************************************************
+//
+// Depth of the hardware receive FIFO, bits in a frame (8N1, as every lab sets
+// the console up) and bit periods of idle line before the receive timeout.
+//
+//*****************************************************************************
+#define UART_RX_FIFO_DEPTH      16
+#define UART_RX_FRAME_BITS      10
+#define UART_RX_TIMEOUT_BITS    32
+
+//*****************************************************************************
+//
+// Returns the length of one bit in core clocks from the baud divisor, which
+// holds the clocks per bit times 64 / 16, or 64 / 8 with high-speed mode on.
+//
+//*****************************************************************************
+static uint32_t
+UARTRxBitCycles(uint32_t ui32Base)
+{
+  uint32_t ui32Div;
+
+  ui32Div = (HWREG(ui32Base + UART_O_IBRD) << 6) |
+            HWREG(ui32Base + UART_O_FBRD);
+  if(HWREG(ui32Base + UART_O_CTL) & UART_CTL_HSE) {
+    return(ui32Div >> 3);
+  }
+  return(ui32Div >> 2);
+}
+
+//*****************************************************************************
+//
+// Sets up a receive ring for the given UART and enables its RX and RT
+// interrupts.  ui32Size must be a power of two.  The caller still enables the
+// port's interrupt in the NVIC.
+//
+//*****************************************************************************
+void
+UARTRxInit(tUARTRx *psRx, uint32_t ui32Base, uint8_t *pui8Buf,
+           uint32_t ui32Size)
+{
+  psRx->ui32Base = ui32Base;
+  psRx->psEchoTx = 0;
+  psRx->psEchoHist = 0;
+  psRx->pui32Stamps = 0;
+  psRx->ui32Trigger = 8;
+  psRx->ui32Interrupts = 0;
+  psRx->ui32Bytes = 0;
+  psRx->ui32Overrun = 0;
+  psRx->ui32Framing = 0;
+  psRx->ui32Parity = 0;
+  psRx->ui32Break = 0;
+  psRx->ui32FIFOPeak = 0;
+  SPSCQueueInit(&psRx->sQueue, pui8Buf, 1, ui32Size);
+
+  // Same levels as the transmit ring so the two can share a port.
+  UARTFIFOLevelSet(ui32Base, UART_FIFO_TX4_8, UART_FIFO_RX4_8);
+  UARTIntEnable(ui32Base, UART_INT_RX | UART_INT_RT);
+}
+
+//*****************************************************************************
+//
+// RX and RT interrupt service.  Empties the hardware FIFO into the queue;
+// bytes that do not fit are counted as drops and bytes received in error
+// are counted and discarded.  With echo on, each good byte is
+// also written back out before the next is read, so the echo does not wait
+// for the main loop.  Called from the port's UART interrupt handler after it
+// has read and cleared the interrupt status.
+//
+// At most one FIFO's worth is taken per call, so the size of the batch says
+// which interrupt raised it; anything that arrives meanwhile raises another.
+//
+//*****************************************************************************
+void
+UARTRxIntHandler(tUARTRx *psRx)
+{
+  uint32_t pui32FIFO[UART_RX_FIFO_DEPTH];
+  uint32_t ui32Entry = CycleCounterGet();
+  uint32_t ui32Count = 0;
+  uint32_t ui32Frame = 0;
+  uint32_t ui32Arrival = ui32Entry;
+  uint32_t ui32Idx, ui32Bit, ui32Data;
+  bool bTimed;
+  uint8_t ui8Char;
+
+  psRx->ui32Interrupts++;
+  while((ui32Count < UART_RX_FIFO_DEPTH) &&
+        UARTCharsAvail(psRx->ui32Base)) {
+    pui32FIFO[ui32Count++] =
+      (uint32_t)UARTCharGetNonBlocking(psRx->ui32Base);
+  }
+
+  // Work out when the first byte arrived; each later one is a frame on, up
+  // to the one that raised the interrupt.
+  bTimed = (psRx->pui32Stamps != 0) ||
+           ((psRx->psEchoTx != 0) && (psRx->psEchoHist != 0));
+  if(bTimed && ui32Count) {
+    ui32Bit = UARTRxBitCycles(psRx->ui32Base);
+    ui32Frame = ui32Bit * UART_RX_FRAME_BITS;
+    if(ui32Count < psRx->ui32Trigger) {
+      ui32Arrival = ui32Entry - (ui32Bit * UART_RX_TIMEOUT_BITS) -
+                    (ui32Frame * (ui32Count - 1));
+    }
+    else {
+      ui32Arrival = ui32Entry - (ui32Frame * (psRx->ui32Trigger - 1));
+    }
+  }
+
+  for(ui32Idx = 0; ui32Idx < ui32Count; ui32Idx++) {
+    // Bytes past the trigger level came in while the handler was running;
+    // the entry time is the best stamp they have.
+    if(ui32Idx >= psRx->ui32Trigger) {
+      ui32Arrival = ui32Entry;
+    }
+    else if(ui32Idx) {
+      ui32Arrival += ui32Frame;
+    }
+
+    // The data register holds the byte's error flags above the byte itself.
+    ui32Data = pui32FIFO[ui32Idx];
+    if(ui32Data & UART_DR_OE) {
+      psRx->ui32Overrun++;
+    }
+    if(ui32Data & (UART_DR_BE | UART_DR_PE | UART_DR_FE)) {
+      if(ui32Data & UART_DR_BE) {
+        psRx->ui32Break++;
+      }
+      else if(ui32Data & UART_DR_FE) {
+        psRx->ui32Framing++;
+      }
+      else {
+        psRx->ui32Parity++;
+      }
+      continue;
+    }
+    ui8Char = (uint8_t)(ui32Data & UART_DR_DATA_M);
+    if(psRx->psEchoTx) {
+      // Straight into the TX FIFO unless earlier output is still queued
+      // ahead of it in the ring.
+      UARTTxSend(psRx->psEchoTx, &ui8Char, 1, true);
+      if(psRx->psEchoHist) {
+        LatHistAdd(psRx->psEchoHist, CycleCounterGet() - ui32Arrival);
+      }
+    }
+
+    // The stamp goes in the slot the byte is about to fill, unless the
+    // queue is full and that slot still holds an unread byte.
+    if(psRx->pui32Stamps &&
+       (SPSCQueueCount(&psRx->sQueue) <= psRx->sQueue.ui32Mask)) {
+      psRx->pui32Stamps[psRx->sQueue.ui32Head & psRx->sQueue.ui32Mask] =
+        ui32Arrival;
+    }
+    SPSCQueuePush(&psRx->sQueue, &ui8Char);
+  }
+
+  psRx->ui32Bytes += ui32Count;
+  if(ui32Count > psRx->ui32FIFOPeak) {
+    psRx->ui32FIFOPeak = ui32Count;
+  }
+}
+
+//*****************************************************************************
+//
+// Copies up to ui32Max received bytes into pui8Data and returns how many were
+// copied.  Only the main loop may call this.
+//
+//*****************************************************************************
+uint32_t
+UARTRxRead(tUARTRx *psRx, uint8_t *pui8Data, uint32_t ui32Max)
+{
+  return(SPSCQueuePopBatch(&psRx->sQueue, pui8Data, ui32Max));
+}
+
+//*****************************************************************************
+//
+// As UARTRxRead(), and also copies each byte's arrival time into
+// pui32Stamps.  Stamps must have been turned on with UARTRxStampsSet()
+// before the bytes were received.  Only the main loop may call this.
+//
+//*****************************************************************************
+uint32_t
+UARTRxReadStamped(tUARTRx *psRx, uint8_t *pui8Data, uint32_t *pui32Stamps,
+                  uint32_t ui32Max)
+{
+  uint32_t ui32Tail = psRx->sQueue.ui32Tail;
+  uint32_t ui32Count = SPSCQueueCount(&psRx->sQueue);
+  uint32_t ui32Idx;
+
+  if(ui32Count > ui32Max) {
+    ui32Count = ui32Max;
+  }
+
+  // Take the stamps while the slots are still ours; once popped, the
+  // interrupt may reuse them.
+  for(ui32Idx = 0; ui32Idx < ui32Count; ui32Idx++) {
+    pui32Stamps[ui32Idx] =
+      psRx->pui32Stamps[(ui32Tail + ui32Idx) & psRx->sQueue.ui32Mask];
+  }
+  return(SPSCQueuePopBatch(&psRx->sQueue, pui8Data, ui32Count));
+}
+
+//*****************************************************************************
+//
+// Returns the number of received bytes waiting to be read.
+//
+//*****************************************************************************
+uint32_t
+UARTRxAvail(tUARTRx *psRx)
+{
+  return(SPSCQueueCount(&psRx->sQueue));
+}
+
+//*****************************************************************************
+//
+// Turns echo from the interrupt handler on, sending received bytes to psTx,
+// or off when psTx is NULL.  If psHist is given, the time from each byte
+// arriving to it being handed to the transmitter is recorded in it.  The cycle counter must be running for the times to mean anything.
+//
+//*****************************************************************************
+void
+UARTRxEchoSet(tUARTRx *psRx, tUARTTx *psTx, tLatHist *psHist)
+{
+  bool bWasDisabled;
+
+  bWasDisabled = IntMasterDisable();
+  psRx->psEchoHist = psHist;
+  psRx->psEchoTx = psTx;
+  if(!bWasDisabled) {
+    IntMasterEnable();
+  }
+}
+
+//*****************************************************************************
+//
+// Starts recording each received byte's arrival time in pui32Stamps, which
+// needs one word per queue slot, or stops when it is NULL.  While stamping,
+// the RX interrupt is raised at 2 bytes rather than 8 so a keystroke is not
+// held in the FIFO waiting for company; a lone byte still waits for the
+// receive timeout, and that wait is counted in its stamp.  The cycle counter
+// must be running.  Turn stamps on before input arrives; bytes already
+// queued have no stamp.
+//
+//*****************************************************************************
+void
+UARTRxStampsSet(tUARTRx *psRx, uint32_t *pui32Stamps)
+{
+  bool bWasDisabled;
+
+  bWasDisabled = IntMasterDisable();
+  psRx->pui32Stamps = pui32Stamps;
+  psRx->ui32Trigger = pui32Stamps ? 2 : 8;
+  UARTFIFOLevelSet(psRx->ui32Base, UART_FIFO_TX4_8,
+                   pui32Stamps ? UART_FIFO_RX1_8 : UART_FIFO_RX4_8);
+  if(!bWasDisabled) {
+    IntMasterEnable();
+  }
+}
+
+//*****************************************************************************
+//
+// Copies the receive counters, and the queue's peak depth and drops, into
+// psStats.
+//
+//*****************************************************************************
+void
+UARTRxStatsGet(tUARTRx *psRx, tUARTRxStats *psStats)
+{
+  psStats->ui32Interrupts = psRx->ui32Interrupts;
+  psStats->ui32Bytes = psRx->ui32Bytes;
+  psStats->ui32Overrun = psRx->ui32Overrun;
+  psStats->ui32Framing = psRx->ui32Framing;
+  psStats->ui32Parity = psRx->ui32Parity;
+  psStats->ui32Break = psRx->ui32Break;
+  psStats->ui32FIFOPeak = psRx->ui32FIFOPeak;
+  psStats->ui32QueuePeak = psRx->sQueue.ui32HighWater;
+  psStats->ui32Dropped = psRx->sQueue.ui32Dropped;
+}
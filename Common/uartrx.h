@@ -0,0 +1,96 @@
+//*****************************************************************************
+//
+// uartrx.h - Prototypes for the interrupt-filled UART receive ring buffer.
+//
+//*****************************************************************************
+
+#ifndef __UARTRX_H__
+#define __UARTRX_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "spscq.h"
+#include "uarttx.h"
+#include "lathist.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Receive state for one UART port.  The queue is filled by the UART RX and
+// receive-timeout interrupts and emptied by the main loop; its high-water
+// and drop counters cover the port's input.  The buffer size must be a power
+// of two.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint32_t ui32Base;            // UARTx_BASE of the port being read
+  tSPSCQueue sQueue;            // Bytes from the interrupt to the main loop
+  tUARTTx *psEchoTx;            // Echo received bytes here from the ISR
+  tLatHist *psEchoHist;         // Records ISR echo latency, may be NULL
+  uint32_t *pui32Stamps;        // Arrival time of each queued byte, or NULL
+  uint32_t ui32Trigger;         // Bytes in the FIFO that raise the RX interrupt
+  uint32_t ui32Interrupts;      // Times the interrupt handler ran
+  uint32_t ui32Bytes;           // Bytes read from the hardware FIFO
+  uint32_t ui32Overrun;         // Hardware FIFO overruns, input was lost
+  uint32_t ui32Framing;         // Bytes with a bad stop bit, discarded
+  uint32_t ui32Parity;          // Bytes with a bad parity bit, discarded
+  uint32_t ui32Break;           // Break conditions, discarded
+  uint32_t ui32FIFOPeak;        // Most bytes read in one interrupt
+} tUARTRx;
+
+//*****************************************************************************
+//
+// Snapshot of the receive counters returned by UARTRxStatsGet().  A FIFO
+// peak reaching the hardware depth of 16, or any overruns, means the
+// interrupt is not serviced fast enough; drops mean the main loop is not
+// emptying the queue fast enough.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint32_t ui32Interrupts;      // Times the interrupt handler ran
+  uint32_t ui32Bytes;           // Bytes read from the hardware FIFO
+  uint32_t ui32Overrun;         // Hardware FIFO overruns, input was lost
+  uint32_t ui32Framing;         // Bytes with a bad stop bit, discarded
+  uint32_t ui32Parity;          // Bytes with a bad parity bit, discarded
+  uint32_t ui32Break;           // Break conditions, discarded
+  uint32_t ui32FIFOPeak;        // Most bytes read in one interrupt
+  uint32_t ui32QueuePeak;       // Deepest the queue has been
+  uint32_t ui32Dropped;         // Bytes lost because the queue was full
+} tUARTRxStats;
+
+//*****************************************************************************
+//
+// Number of 32-bit words in tUARTRxStats, as sent in a telemetry frame.
+//
+//*****************************************************************************
+#define UART_RX_STATS_WORDS     (sizeof(tUARTRxStats) / sizeof(uint32_t))
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void UARTRxInit(tUARTRx *psRx, uint32_t ui32Base, uint8_t *pui8Buf,
+                       uint32_t ui32Size);
+extern void UARTRxIntHandler(tUARTRx *psRx);
+extern uint32_t UARTRxRead(tUARTRx *psRx, uint8_t *pui8Data,
+                           uint32_t ui32Max);
+extern uint32_t UARTRxAvail(tUARTRx *psRx);
+extern uint32_t UARTRxReadStamped(tUARTRx *psRx, uint8_t *pui8Data,
+                                  uint32_t *pui32Stamps, uint32_t ui32Max);
+extern void UARTRxEchoSet(tUARTRx *psRx, tUARTTx *psTx, tLatHist *psHist);
+extern void UARTRxStampsSet(tUARTRx *psRx, uint32_t *pui32Stamps);
+extern void UARTRxStatsGet(tUARTRx *psRx, tUARTRxStats *psStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UARTRX_H__
@@ -0,0 +1,291 @@
+//*****************************************************************************
+//
+// uarttx.c - Interrupt-driven UART transmit ring buffer.
+//
+// Writers queue bytes with UARTTxWrite() and return immediately.  The UART TX
+// FIFO interrupt moves queued bytes into the hardware FIFO as it empties, so
+// printing a full menu no longer stalls the main loop for the whole time it
+// takes to shift it out at 115200 baud.
+//
+// The module only touches the hardware through driverlib calls, so
+// Tools/uarttxtest.c links it against a model UART and checks it on the host.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "driverlib/interrupt.h"
+#include "driverlib/uart.h"
+
+#include "uarttx.h"
+
+//*****************************************************************************
+//
+// Returns the position draining may advance to: the head, or the barrier if
+// one is set.
+//
+//*****************************************************************************
+static uint32_t
+UARTTxEnd(tUARTTx *psTx)
+{
+  return(psTx->bBarrier ? psTx->ui32Barrier : psTx->ui32Head);
+}
+
+//*****************************************************************************
+//
+// Moves queued bytes into the hardware FIFO until either runs out.  Must be
+// called with the UART interrupt unable to preempt, i.e. from the ISR itself
+// or with interrupts masked.
+//
+//*****************************************************************************
+static void
+UARTTxDrain(tUARTTx *psTx)
+{
+  uint32_t ui32Tail = psTx->ui32Tail;
+  uint32_t ui32End = UARTTxEnd(psTx);
+
+  while((ui32Tail != ui32End) && UARTSpaceAvail(psTx->ui32Base)) {
+    UARTCharPutNonBlocking(psTx->ui32Base,
+                           psTx->pui8Buf[ui32Tail & psTx->ui32Mask]);
+    ui32Tail++;
+  }
+  psTx->ui32Tail = ui32Tail;
+
+  // Everything queued ahead of the barrier is now in the hardware FIFO, so
+  // whoever set it may take over the FIFO.
+  if(psTx->bBarrier && !psTx->bBarrierFired && (ui32Tail == ui32End)) {
+    psTx->bBarrierFired = true;
+    psTx->pfnBarrier(psTx->pvBarrierData);
+  }
+}
+
+//*****************************************************************************
+//
+// Sets up a transmit ring for the given UART.  ui32Size must be a power of
+// two.  The UART itself must already be configured; this only arms the TX
+// interrupt, the caller still enables the port's interrupt in the NVIC.
+//
+//*****************************************************************************
+void
+UARTTxInit(tUARTTx *psTx, uint32_t ui32Base, uint8_t *pui8Buf,
+           uint32_t ui32Size)
+{
+  psTx->ui32Base = ui32Base;
+  psTx->pui8Buf = pui8Buf;
+  psTx->ui32Mask = ui32Size - 1;
+  psTx->ui32Head = 0;
+  psTx->ui32Tail = 0;
+  psTx->ui32HighWater = 0;
+  psTx->ui32Overflow = 0;
+  psTx->ui32Accepted = 0;
+  psTx->ui32Deferred = 0;
+  psTx->bBarrier = false;
+
+  // Interrupt when the TX FIFO drains below half so there is time to refill
+  // it before the shifter runs dry.
+  UARTFIFOLevelSet(ui32Base, UART_FIFO_TX4_8, UART_FIFO_RX4_8);
+  UARTTxIntModeSet(ui32Base, UART_TXINT_MODE_FIFO);
+  UARTIntEnable(ui32Base, UART_INT_TX);
+}
+
+//*****************************************************************************
+//
+// Queues up to ui32Count bytes without blocking.  Returns the number of bytes
+// accepted; anything beyond the free space is counted as overflow and
+// dropped.  Safe to call from both the main loop and interrupt handlers.
+//
+//*****************************************************************************
+uint32_t
+UARTTxWrite(tUARTTx *psTx, const uint8_t *pui8Data, uint32_t ui32Count)
+{
+  uint32_t ui32Head, ui32Used, ui32Free, ui32Idx;
+  bool bWasDisabled;
+
+  bWasDisabled = IntMasterDisable();
+
+  ui32Head = psTx->ui32Head;
+  ui32Free = (psTx->ui32Mask + 1) - (ui32Head - psTx->ui32Tail);
+  if(ui32Count > ui32Free) {
+    psTx->ui32Overflow += ui32Count - ui32Free;
+    ui32Count = ui32Free;
+  }
+
+  for(ui32Idx = 0; ui32Idx < ui32Count; ui32Idx++) {
+    psTx->pui8Buf[(ui32Head + ui32Idx) & psTx->ui32Mask] = pui8Data[ui32Idx];
+  }
+  psTx->ui32Head = ui32Head + ui32Count;
+
+  ui32Used = psTx->ui32Head - psTx->ui32Tail;
+  if(ui32Used > psTx->ui32HighWater) {
+    psTx->ui32HighWater = ui32Used;
+  }
+
+  // The TX interrupt only fires as the FIFO level falls, so an idle FIFO has
+  // to be primed here to get the interrupt chain going.
+  UARTTxDrain(psTx);
+
+  if(!bWasDisabled) {
+    IntMasterEnable();
+  }
+
+  return(ui32Count);
+}
+
+//*****************************************************************************
+//
+// Sends with back-pressure.  Bytes go straight into the hardware FIFO up to
+// its free level; with bDefer set, the remainder is queued in the ring and
+// only what does not fit there is dropped.  With bDefer clear, nothing is
+// queued or dropped and the caller keeps the unsent tail.  Returns the
+// number of bytes accepted, sent or queued.
+//
+//*****************************************************************************
+uint32_t
+UARTTxSend(tUARTTx *psTx, const uint8_t *pui8Data, uint32_t ui32Count,
+           bool bDefer)
+{
+  uint32_t ui32Sent = 0;
+  uint32_t ui32Queued = 0;
+  bool bWasDisabled;
+
+  bWasDisabled = IntMasterDisable();
+
+  // Only bypass the ring when it is empty, or the bytes would overtake
+  // earlier output.
+  if((psTx->ui32Tail == psTx->ui32Head) && !psTx->bBarrier) {
+    while((ui32Sent < ui32Count) &&
+          UARTCharPutNonBlocking(psTx->ui32Base, pui8Data[ui32Sent])) {
+      ui32Sent++;
+    }
+    psTx->ui32Accepted += ui32Sent;
+  }
+
+  if(bDefer && (ui32Sent < ui32Count)) {
+    ui32Queued = UARTTxWrite(psTx, pui8Data + ui32Sent, ui32Count - ui32Sent);
+    psTx->ui32Deferred += ui32Queued;
+  }
+
+  if(!bWasDisabled) {
+    IntMasterEnable();
+  }
+
+  return(ui32Sent + ui32Queued);
+}
+
+//*****************************************************************************
+//
+// Queues a single byte.  Returns 1 if it was accepted, 0 if the ring is full.
+//
+//*****************************************************************************
+uint32_t
+UARTTxPutChar(tUARTTx *psTx, uint8_t ui8Char)
+{
+  return(UARTTxWrite(psTx, &ui8Char, 1));
+}
+
+//*****************************************************************************
+//
+// Queues a NUL-terminated string.  Returns the number of bytes accepted.
+//
+//*****************************************************************************
+uint32_t
+UARTTxPutString(tUARTTx *psTx, const char *pcStr)
+{
+  return(UARTTxWrite(psTx, (const uint8_t *)pcStr, strlen(pcStr)));
+}
+
+//*****************************************************************************
+//
+// Returns the number of bytes that can currently be queued.
+//
+//*****************************************************************************
+uint32_t
+UARTTxSpace(tUARTTx *psTx)
+{
+  return((psTx->ui32Mask + 1) - (psTx->ui32Head - psTx->ui32Tail));
+}
+
+//*****************************************************************************
+//
+// Blocks until every queued byte has left the UART.  Drains the ring by
+// polling, so it also works after IntMasterDisable(), e.g. when quitting.
+// If a barrier is set, only the bytes ahead of it are flushed.
+//
+//*****************************************************************************
+void
+UARTTxFlush(tUARTTx *psTx)
+{
+  bool bWasDisabled;
+
+  while(psTx->ui32Tail != UARTTxEnd(psTx)) {
+    bWasDisabled = IntMasterDisable();
+    UARTTxDrain(psTx);
+    if(!bWasDisabled) {
+      IntMasterEnable();
+    }
+  }
+  while(UARTBusy(psTx->ui32Base)) {
+  }
+}
+
+//*****************************************************************************
+//
+// TX FIFO interrupt service.  Called from the port's UART interrupt handler
+// after it has read and cleared the interrupt status.
+//
+//*****************************************************************************
+void
+UARTTxIntHandler(tUARTTx *psTx)
+{
+  UARTTxDrain(psTx);
+}
+
+//*****************************************************************************
+//
+// Copies the current queue depth and counters into psStats.
+//
+//*****************************************************************************
+void
+UARTTxStatsGet(tUARTTx *psTx, tUARTTxStats *psStats)
+{
+  psStats->ui32Queued = psTx->ui32Head - psTx->ui32Tail;
+  psStats->ui32Space = (psTx->ui32Mask + 1) - psStats->ui32Queued;
+  psStats->ui32HighWater = psTx->ui32HighWater;
+  psStats->ui32Overflow = psTx->ui32Overflow;
+  psStats->ui32Accepted = psTx->ui32Accepted;
+  psStats->ui32Deferred = psTx->ui32Deferred;
+}
+
+//*****************************************************************************
+//
+// Stops draining at the current head so another engine, such as a uDMA
+// channel, can take over the TX FIFO without reordering output.  pfnBarrier
+// is called once every byte queued so far is in the hardware FIFO, which may
+// be immediately.  Bytes queued after this call wait until
+// UARTTxBarrierClear().  Call with interrupts masked.
+//
+//*****************************************************************************
+void
+UARTTxBarrierSet(tUARTTx *psTx, tUARTTxBarrierFn pfnBarrier, void *pvData)
+{
+  psTx->ui32Barrier = psTx->ui32Head;
+  psTx->pfnBarrier = pfnBarrier;
+  psTx->pvBarrierData = pvData;
+  psTx->bBarrierFired = false;
+  psTx->bBarrier = true;
+  UARTTxDrain(psTx);
+}
+
+//*****************************************************************************
+//
+// Removes the barrier and resumes draining the bytes queued behind it.
+//
+//*****************************************************************************
+void
+UARTTxBarrierClear(tUARTTx *psTx)
+{
+  psTx->bBarrier = false;
+  UARTTxDrain(psTx);
+}
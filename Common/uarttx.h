@@ -0,0 +1,94 @@
+//*****************************************************************************
+//
+// uarttx.h - Prototypes for the interrupt-driven UART transmit ring buffer.
+//
+// Shared by the lab programs so that putString() and friends queue their
+// output instead of spinning in UARTCharPut() for every byte.
+//
+//*****************************************************************************
+
+#ifndef __UARTTX_H__
+#define __UARTTX_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Called once the ring has drained up to a barrier set with
+// UARTTxBarrierSet().  Runs with the UART interrupt unable to preempt.
+//
+//*****************************************************************************
+typedef void (*tUARTTxBarrierFn)(void *pvData);
+
+//*****************************************************************************
+//
+// Transmit state for one UART port.  The ring is written by the main loop and
+// drained by the UART TX FIFO interrupt.  The buffer size must be a power of
+// two so the free-running head and tail counters can be masked into it.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint32_t ui32Base;            // UARTx_BASE of the port being driven
+  uint8_t *pui8Buf;             // Ring storage supplied by the caller
+  uint32_t ui32Mask;            // Ring size minus one
+  volatile uint32_t ui32Head;   // Next byte to be written by a producer
+  volatile uint32_t ui32Tail;   // Next byte to be sent to the TX FIFO
+  uint32_t ui32HighWater;       // Largest number of bytes ever queued
+  uint32_t ui32Overflow;        // Bytes dropped because the ring was full
+  uint32_t ui32Accepted;        // Bytes UARTTxSend() put straight in the FIFO
+  uint32_t ui32Deferred;        // Bytes UARTTxSend() left in the ring
+  volatile bool bBarrier;       // Draining stops at ui32Barrier when set
+  bool bBarrierFired;           // pfnBarrier has been called for this barrier
+  uint32_t ui32Barrier;         // Head position when the barrier was set
+  tUARTTxBarrierFn pfnBarrier;  // Called when the tail reaches the barrier
+  void *pvBarrierData;          // Argument passed to pfnBarrier
+} tUARTTx;
+
+//*****************************************************************************
+//
+// Snapshot of the transmit counters returned by UARTTxStatsGet().
+//
+//*****************************************************************************
+typedef struct
+{
+  uint32_t ui32Queued;          // Bytes currently waiting in the ring
+  uint32_t ui32Space;           // Bytes that can still be queued
+  uint32_t ui32HighWater;       // Largest number of bytes ever queued
+  uint32_t ui32Overflow;        // Bytes dropped because the ring was full
+  uint32_t ui32Accepted;        // Bytes UARTTxSend() put straight in the FIFO
+  uint32_t ui32Deferred;        // Bytes UARTTxSend() left in the ring
+} tUARTTxStats;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void UARTTxInit(tUARTTx *psTx, uint32_t ui32Base, uint8_t *pui8Buf,
+                       uint32_t ui32Size);
+extern uint32_t UARTTxWrite(tUARTTx *psTx, const uint8_t *pui8Data,
+                            uint32_t ui32Count);
+extern uint32_t UARTTxSend(tUARTTx *psTx, const uint8_t *pui8Data,
+                           uint32_t ui32Count, bool bDefer);
+extern uint32_t UARTTxPutChar(tUARTTx *psTx, uint8_t ui8Char);
+extern uint32_t UARTTxPutString(tUARTTx *psTx, const char *pcStr);
+extern uint32_t UARTTxSpace(tUARTTx *psTx);
+extern void UARTTxFlush(tUARTTx *psTx);
+extern void UARTTxIntHandler(tUARTTx *psTx);
+extern void UARTTxStatsGet(tUARTTx *psTx, tUARTTxStats *psStats);
+extern void UARTTxBarrierSet(tUARTTx *psTx, tUARTTxBarrierFn pfnBarrier,
+                             void *pvData);
+extern void UARTTxBarrierClear(tUARTTx *psTx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UARTTX_H__
@@ -0,0 +1,63 @@
+//*****************************************************************************
+//
+// udmactl.c - Shared uDMA controller setup and channel control table.
+//
+// Every module that moves data with the uDMA (UART transmit, the OLED flush)
+// shares the one control table the controller supports, so it lives here
+// instead of in each user.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "driverlib/sysctl.h"
+#include "driverlib/udma.h"
+
+#include "udmactl.h"
+
+//*****************************************************************************
+//
+// The control table used by the uDMA controller.  It must be aligned to a
+// 1024 byte boundary and holds the primary and alternate structures for all
+// 32 channels.
+//
+//*****************************************************************************
+#if defined(ewarm)
+#pragma data_alignment=1024
+static tDMAControlTable g_psDMAControlTable[64];
+#elif defined(ccs)
+#pragma DATA_ALIGN(g_psDMAControlTable, 1024)
+static tDMAControlTable g_psDMAControlTable[64];
+#else
+static tDMAControlTable g_psDMAControlTable[64] __attribute__ ((aligned(1024)));
+#endif
+
+//*****************************************************************************
+//
+// Set once the controller has been enabled so users can call
+// uDMAControlInit() without knowing whether another module already has.
+//
+//*****************************************************************************
+static bool g_bDMAControlReady = false;
+
+//*****************************************************************************
+//
+// Enables the uDMA controller and points it at the control table.
+//
+//*****************************************************************************
+void
+uDMAControlInit(void)
+{
+  if(g_bDMAControlReady) {
+    return;
+  }
+
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+  while(!SysCtlPeripheralReady(SYSCTL_PERIPH_UDMA)) {
+  }
+  uDMAEnable();
+  uDMAControlBaseSet(g_psDMAControlTable);
+
+  g_bDMAControlReady = true;
+}
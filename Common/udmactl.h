@@ -0,0 +1,26 @@
+//*****************************************************************************
+//
+// udmactl.h - Shared uDMA controller setup and channel control table.
+//
+//*****************************************************************************
+
+#ifndef __UDMACTL_H__
+#define __UDMACTL_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void uDMAControlInit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UDMACTL_H__
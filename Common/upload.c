@@ -0,0 +1,251 @@
+//*****************************************************************************
+//
+// upload.c - Windowed bulk upload receiver.
+//
+// Takes a file such as a note table or motion profile from the host over
+// the console UART, so it can be changed without reflashing.  Frames reuse
+// the telemetry framing, so every one is CRC checked and a receiver that
+// loses a byte resynchronizes at the next delimiter.
+//
+// The sender keeps a window of frames in flight and the receiver
+// acknowledges each one as it is taken, go-back-N style, so the link stays
+// busy instead of stopping for every ack.  The receiver needs no buffering
+// beyond the frame being received: out of order frames are dropped, and one
+// NAK sends the host back to the first missing frame.
+//
+// UploadInput() does a little work per byte, and a frame's worth of copying
+// and encoding when a frame ends, so it may be called from the UART receive
+// interrupt.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "telemetry.h"
+#include "upload.h"
+
+//*****************************************************************************
+//
+// Builds an ACK or NAK naming the next frame expected.  Returns its length.
+//
+//*****************************************************************************
+static uint32_t
+UploadReply(tUpload *psUpload, uint8_t ui8Type, uint8_t ui8Reason)
+{
+  psUpload->sReply.ui8Seq = psUpload->ui8Expect;
+  return(TelemetryFrameBuild(&psUpload->sReply, ui8Type, psUpload->ui32Offset,
+                             &ui8Reason, (ui8Type == UPLOAD_TYPE_NAK) ? 1 : 0,
+                             psUpload->pui8Reply));
+}
+
+//*****************************************************************************
+//
+// Fails the upload and builds the NAK that tells the host why.
+//
+//*****************************************************************************
+static uint32_t
+UploadFail(tUpload *psUpload, uint8_t ui8Reason)
+{
+  psUpload->ui32State = UPLOAD_FAILED;
+  return(UploadReply(psUpload, UPLOAD_TYPE_NAK, ui8Reason));
+}
+
+//*****************************************************************************
+//
+// Starts a new upload.  A repeated START, sent again because its ack was
+// lost, simply starts over; the frames after it follow it again anyway.
+//
+//*****************************************************************************
+static uint32_t
+UploadStart(tUpload *psUpload, const tTelemetryFrame *psFrame)
+{
+  if(psFrame->ui32PayloadLen < 1) {
+    psUpload->ui32Bad++;
+    return(0);
+  }
+
+  psUpload->ui8Target = psFrame->pui8Payload[0];
+  psUpload->ui32Length = psFrame->ui32Timestamp;
+  psUpload->ui32Offset = 0;
+  psUpload->ui8Expect = psFrame->ui8Seq + 1;
+  psUpload->bNakSent = false;
+  psUpload->pui8Dest = psUpload->pfnBegin(psUpload->ui8Target,
+                                          psUpload->ui32Length,
+                                          psUpload->pvData);
+  if(psUpload->pui8Dest == 0) {
+    return(UploadFail(psUpload, UPLOAD_NAK_REFUSED));
+  }
+  psUpload->ui32State = UPLOAD_RECEIVING;
+
+  return(UploadReply(psUpload, UPLOAD_TYPE_ACK, 0));
+}
+
+//*****************************************************************************
+//
+// Checks the finished image and hands it to the target.
+//
+//*****************************************************************************
+static uint32_t
+UploadEnd(tUpload *psUpload, const tTelemetryFrame *psFrame)
+{
+  uint16_t ui16CRC;
+
+  if(psFrame->ui32PayloadLen < 2) {
+    psUpload->ui32Bad++;
+    return(0);
+  }
+  ui16CRC = psFrame->pui8Payload[0] | (psFrame->pui8Payload[1] << 8);
+  if((psUpload->ui32Offset != psUpload->ui32Length) ||
+     (psFrame->ui32Timestamp != psUpload->ui32Length) ||
+     (ui16CRC != TelemetryCRC16(psUpload->pui8Dest, psUpload->ui32Length))) {
+    return(UploadFail(psUpload, UPLOAD_NAK_CRC));
+  }
+  if(!psUpload->pfnEnd(psUpload->ui8Target, psUpload->ui32Length,
+                       psUpload->pvData)) {
+    return(UploadFail(psUpload, UPLOAD_NAK_REJECTED));
+  }
+
+  psUpload->ui8Expect++;
+  psUpload->ui32State = UPLOAD_DONE;
+
+  return(UploadReply(psUpload, UPLOAD_TYPE_ACK, 0));
+}
+
+//*****************************************************************************
+//
+// Acts on one good frame.  Returns the length of the reply, if any.
+//
+//*****************************************************************************
+static uint32_t
+UploadFrame(tUpload *psUpload, const tTelemetryFrame *psFrame)
+{
+  uint8_t ui8Behind;
+
+  if(psFrame->ui8Type == UPLOAD_TYPE_START) {
+    return(UploadStart(psUpload, psFrame));
+  }
+  if(psFrame->ui8Type == UPLOAD_TYPE_ABORT) {
+    psUpload->ui32State = UPLOAD_FAILED;
+    return(UploadReply(psUpload, UPLOAD_TYPE_ACK, 0));
+  }
+  if(((psFrame->ui8Type != UPLOAD_TYPE_DATA) &&
+      (psFrame->ui8Type != UPLOAD_TYPE_END)) ||
+     (psUpload->ui32State == UPLOAD_IDLE) ||
+     (psUpload->ui32State == UPLOAD_FAILED)) {
+    return(0);
+  }
+
+  // A frame already taken means its ack was lost, so ack again.  One from
+  // beyond a gap is dropped and the host is sent back, once per gap.
+  if(psFrame->ui8Seq != psUpload->ui8Expect) {
+    psUpload->ui32Resent++;
+    ui8Behind = psUpload->ui8Expect - psFrame->ui8Seq;
+    if((ui8Behind != 0) && (ui8Behind <= UPLOAD_WINDOW)) {
+      return(UploadReply(psUpload, UPLOAD_TYPE_ACK, 0));
+    }
+    if(psUpload->bNakSent) {
+      return(0);
+    }
+    psUpload->bNakSent = true;
+    return(UploadReply(psUpload, UPLOAD_TYPE_NAK, UPLOAD_NAK_GAP));
+  }
+  if(psUpload->ui32State != UPLOAD_RECEIVING) {
+    return(0);
+  }
+  psUpload->bNakSent = false;
+
+  if(psFrame->ui8Type == UPLOAD_TYPE_END) {
+    return(UploadEnd(psUpload, psFrame));
+  }
+  if((psFrame->ui32Timestamp != psUpload->ui32Offset) ||
+     (psFrame->ui32PayloadLen >
+      (psUpload->ui32Length - psUpload->ui32Offset))) {
+    return(UploadFail(psUpload, UPLOAD_NAK_REFUSED));
+  }
+  memcpy(psUpload->pui8Dest + psUpload->ui32Offset, psFrame->pui8Payload,
+         psFrame->ui32PayloadLen);
+  psUpload->ui32Offset += psFrame->ui32PayloadLen;
+  psUpload->ui8Expect++;
+
+  return(UploadReply(psUpload, UPLOAD_TYPE_ACK, 0));
+}
+
+//*****************************************************************************
+//
+// Sets up a receiver.  pfnBegin finds storage for each upload and pfnEnd
+// commits it; both are passed pvData.
+//
+//*****************************************************************************
+void
+UploadInit(tUpload *psUpload, tUploadBeginFn pfnBegin, tUploadEndFn pfnEnd,
+           void *pvData)
+{
+  psUpload->pfnBegin = pfnBegin;
+  psUpload->pfnEnd = pfnEnd;
+  psUpload->pvData = pvData;
+  TelemetryInit(&psUpload->sReply);
+  UploadReset(psUpload);
+}
+
+//*****************************************************************************
+//
+// Forgets any upload in progress and waits for a new START frame.
+//
+//*****************************************************************************
+void
+UploadReset(tUpload *psUpload)
+{
+  psUpload->ui32State = UPLOAD_IDLE;
+  psUpload->ui8Expect = 0;
+  psUpload->bNakSent = false;
+  psUpload->bOverrun = false;
+  psUpload->pui8Dest = 0;
+  psUpload->ui32Length = 0;
+  psUpload->ui32Offset = 0;
+  psUpload->ui32FrameLen = 0;
+  psUpload->ui32Bad = 0;
+  psUpload->ui32Resent = 0;
+}
+
+//*****************************************************************************
+//
+// Takes one received byte.  When it completes a frame that needs an answer,
+// the reply is built in psUpload->pui8Reply and its length returned for the
+// caller to send; otherwise returns 0.  psUpload->ui32State shows when the
+// upload has finished.
+//
+//*****************************************************************************
+uint32_t
+UploadInput(tUpload *psUpload, uint8_t ui8Byte)
+{
+  tTelemetryFrame sFrame;
+  uint32_t ui32Len;
+
+  if(ui8Byte != 0) {
+    if(psUpload->ui32FrameLen < sizeof(psUpload->pui8Frame)) {
+      psUpload->pui8Frame[psUpload->ui32FrameLen++] = ui8Byte;
+    }
+    else {
+      psUpload->bOverrun = true;
+    }
+    return(0);
+  }
+
+  // A zero ends a frame.  Corrupt frames get no answer; the gap they leave
+  // is reported when the next good one arrives.
+  ui32Len = psUpload->ui32FrameLen;
+  psUpload->ui32FrameLen = 0;
+  if(ui32Len == 0) {
+    return(0);
+  }
+  if(psUpload->bOverrun ||
+     !TelemetryFrameDecode(psUpload->pui8Frame, ui32Len, &sFrame)) {
+    psUpload->bOverrun = false;
+    psUpload->ui32Bad++;
+    return(0);
+  }
+
+  return(UploadFrame(psUpload, &sFrame));
+}
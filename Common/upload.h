@@ -0,0 +1,128 @@
+//*****************************************************************************
+//
+// upload.h - Prototypes for the windowed bulk upload receiver.
+//
+//*****************************************************************************
+
+#ifndef __UPLOAD_H__
+#define __UPLOAD_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "telemetry.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Uploads travel in telemetry frames, so each one is COBS encoded and CRC
+// checked.  The timestamp field carries the byte offset or length instead of
+// a time.
+//
+//     START  seq  total length   target id (1)
+//     DATA   seq  byte offset    up to UPLOAD_CHUNK_SIZE bytes
+//     END    seq  total length   CRC-16 of the whole image (2)
+//     ABORT  seq  0              none
+//
+// Sequence numbers run on from the START frame.  The sender may have up to
+// UPLOAD_WINDOW frames unacknowledged; every frame taken in order is
+// acknowledged with the next sequence number expected, so acks stream back
+// while data streams out.  A gap is answered with a single NAK naming the
+// frame to go back to; a corrupt frame is simply dropped and shows up as a
+// gap when the next one arrives.
+//
+//*****************************************************************************
+#define UPLOAD_TYPE_START       0x10
+#define UPLOAD_TYPE_DATA        0x11
+#define UPLOAD_TYPE_END         0x12
+#define UPLOAD_TYPE_ABORT       0x13
+#define UPLOAD_TYPE_ACK         0x18    // seq is the next frame expected
+#define UPLOAD_TYPE_NAK         0x19    // Same, payload is the reason
+
+#define UPLOAD_CHUNK_SIZE       TELEMETRY_MAX_PAYLOAD
+#define UPLOAD_WINDOW           8
+
+//*****************************************************************************
+//
+// Reasons given in a NAK.  Only UPLOAD_NAK_GAP can be recovered by resending.
+//
+//*****************************************************************************
+#define UPLOAD_NAK_GAP          1       // Go back to the frame in seq
+#define UPLOAD_NAK_REFUSED      2       // Unknown target or too long
+#define UPLOAD_NAK_CRC          3       // Image CRC did not match
+#define UPLOAD_NAK_REJECTED     4       // The target would not take it
+
+//*****************************************************************************
+//
+// Receiver states.
+//
+//*****************************************************************************
+#define UPLOAD_IDLE             0       // Waiting for a START frame
+#define UPLOAD_RECEIVING        1       // Taking DATA frames
+#define UPLOAD_DONE             2       // Image received and committed
+#define UPLOAD_FAILED           3       // Refused, corrupt or aborted
+
+//*****************************************************************************
+//
+// Called on a START frame.  Returns where ui32Length bytes for ui8Target
+// should be written, or 0 to refuse the upload.
+//
+//*****************************************************************************
+typedef uint8_t *(*tUploadBeginFn)(uint8_t ui8Target, uint32_t ui32Length,
+                                   void *pvData);
+
+//*****************************************************************************
+//
+// Called once the whole image is in and its CRC checks.  Returns false if
+// the contents are not acceptable, e.g. an invalid table.
+//
+//*****************************************************************************
+typedef bool (*tUploadEndFn)(uint8_t ui8Target, uint32_t ui32Length,
+                             void *pvData);
+
+//*****************************************************************************
+//
+// Receiver state.  Bytes are fed in one at a time; any reply is left in
+// pui8Reply for the caller to send.
+//
+//*****************************************************************************
+typedef struct
+{
+  tUploadBeginFn pfnBegin;      // Finds storage for a new upload
+  tUploadEndFn pfnEnd;          // Commits a finished upload
+  void *pvData;                 // Argument passed to both
+  uint32_t ui32State;           // One of the UPLOAD_ states
+  uint8_t ui8Target;            // Target named by the START frame
+  uint8_t ui8Expect;            // Sequence number of the next frame
+  bool bNakSent;                // A gap has been reported already
+  bool bOverrun;                // The frame being received is too long
+  uint8_t *pui8Dest;            // Where the image is written
+  uint32_t ui32Length;          // Image length from the START frame
+  uint32_t ui32Offset;          // Bytes received so far
+  uint32_t ui32FrameLen;        // Bytes of the current frame so far
+  uint32_t ui32Bad;             // Frames dropped as corrupt
+  uint32_t ui32Resent;          // Frames dropped as out of order
+  tTelemetry sReply;            // Numbering of replies sent
+  uint8_t pui8Frame[TELEMETRY_MAX_ENCODED];     // Frame being received
+  uint8_t pui8Reply[TELEMETRY_MAX_ENCODED];     // Reply to send
+} tUpload;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void UploadInit(tUpload *psUpload, tUploadBeginFn pfnBegin,
+                       tUploadEndFn pfnEnd, void *pvData);
+extern void UploadReset(tUpload *psUpload);
+extern uint32_t UploadInput(tUpload *psUpload, uint8_t ui8Byte);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UPLOAD_H__
@@ -0,0 +1,248 @@
+//*****************************************************************************
+//
+// vtdash.c - Incremental VT100 terminal dashboard.
+//
+// Clearing the terminal and printing every value again costs hundreds of
+// bytes a refresh.  The dashboard instead draws its labels once and from
+// then on moves the cursor to each value that changed and overwrites just
+// that field, so a refresh where one or two values moved is a few dozen
+// bytes.  Scrolling is confined to the rows below the layout, so menu output
+// and typed commands scroll underneath it without disturbing it.
+//
+// Updates save and restore the cursor around the fields they rewrite, so
+// they can go out while the user is part way through typing a command.
+// Only standard VT100 sequences are used, which PuTTY understands.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "uarttx.h"
+#include "numfmt.h"
+#include "vtdash.h"
+
+//*****************************************************************************
+//
+// Longest cursor positioning sequence, ESC [ row ; col H.
+//
+//*****************************************************************************
+#define VTDASH_CURSOR_SIZE      10
+
+//*****************************************************************************
+//
+// Writes the sequence that moves the cursor to a row and column.
+//
+//*****************************************************************************
+static char *
+VTDashCursor(char *pcBuf, uint32_t ui32Row, uint32_t ui32Col)
+{
+  pcBuf = NumFmtStr(pcBuf, "\033[");
+  pcBuf = NumFmtUDec(pcBuf, ui32Row, 0, ' ');
+  pcBuf = NumFmtStr(pcBuf, ";");
+  pcBuf = NumFmtUDec(pcBuf, ui32Col, 0, ' ');
+  return(NumFmtStr(pcBuf, "H"));
+}
+
+//*****************************************************************************
+//
+// Writes a field's value padded to its width: names on the left, numbers on
+// the right.  A name longer than the field is cut short.
+//
+//*****************************************************************************
+static char *
+VTDashValue(char *pcBuf, const tVTDashField *psField, int32_t i32Value)
+{
+  const char *pcName;
+  uint32_t ui32Len;
+
+  if(psField->ppcNames && (i32Value >= 0) &&
+     ((uint32_t)i32Value < psField->ui32NumNames)) {
+    pcName = psField->ppcNames[i32Value];
+    for(ui32Len = 0; ui32Len < psField->ui8Width; ui32Len++) {
+      *pcBuf++ = *pcName ? *pcName++ : ' ';
+    }
+    *pcBuf = '\0';
+    return(pcBuf);
+  }
+  if(psField->ui8Decimals) {
+    return(NumFmtFixed(pcBuf, i32Value, psField->ui8Decimals,
+                       psField->ui8Width, ' '));
+  }
+  return(NumFmtDec(pcBuf, i32Value, psField->ui8Width, ' '));
+}
+
+//*****************************************************************************
+//
+// Sets up a dashboard with the given layout.  Nothing is sent until
+// VTDashDraw().  ui32Period is in the same ticks as the times later passed to
+// VTDashUpdate().
+//
+//*****************************************************************************
+void
+VTDashInit(tVTDash *psDash, tUARTTx *psTx, const tVTDashField *psFields,
+           uint32_t ui32NumFields, uint32_t ui32Period)
+{
+  uint32_t ui32Idx;
+
+  if(ui32NumFields > VTDASH_MAX_FIELDS) {
+    ui32NumFields = VTDASH_MAX_FIELDS;
+  }
+
+  psDash->psTx = psTx;
+  psDash->psFields = psFields;
+  psDash->ui32NumFields = ui32NumFields;
+  psDash->ui32Period = ui32Period;
+  psDash->ui32Last = 0;
+  psDash->ui32Dirty = 0;
+  psDash->ui32Redraw = 0;
+  psDash->ui32Bytes = 0;
+  psDash->bActive = false;
+
+  // The title takes row 1 and a blank row separates the layout from the
+  // scrolling area.
+  psDash->ui32Rows = 1;
+  for(ui32Idx = 0; ui32Idx < ui32NumFields; ui32Idx++) {
+    psDash->pi32Value[ui32Idx] = 0;
+    psDash->pi32Shown[ui32Idx] = 0;
+    if(psFields[ui32Idx].ui8Row > psDash->ui32Rows) {
+      psDash->ui32Rows = psFields[ui32Idx].ui8Row;
+    }
+  }
+  psDash->ui32Rows++;
+}
+
+//*****************************************************************************
+//
+// Clears the terminal and draws the title and labels, then leaves the cursor
+// at the top of the scrolling area below them.  Every value is sent by the
+// next VTDashUpdate(), however soon it comes.
+//
+//*****************************************************************************
+void
+VTDashDraw(tVTDash *psDash, const char *pcTitle)
+{
+  const tVTDashField *psField;
+  char pcBuf[VTDASH_CURSOR_SIZE * 2 + 8];
+  uint32_t ui32Idx;
+
+  UARTTxPutString(psDash->psTx, "\033[r\033[2J\033[H");
+  if(pcTitle) {
+    UARTTxPutString(psDash->psTx, pcTitle);
+  }
+  for(ui32Idx = 0; ui32Idx < psDash->ui32NumFields; ui32Idx++) {
+    psField = &psDash->psFields[ui32Idx];
+    VTDashCursor(pcBuf, psField->ui8Row, psField->ui8Col);
+    UARTTxPutString(psDash->psTx, pcBuf);
+    UARTTxPutString(psDash->psTx, psField->pcLabel);
+  }
+
+  // Setting the scrolling region homes the cursor, so it has to be moved
+  // into the region afterwards.
+  NumFmtStr(NumFmtUDec(NumFmtStr(pcBuf, "\033["), psDash->ui32Rows + 1, 0,
+                       ' '), "r");
+  UARTTxPutString(psDash->psTx, pcBuf);
+  VTDashCursor(pcBuf, psDash->ui32Rows + 1, 1);
+  UARTTxPutString(psDash->psTx, pcBuf);
+
+  psDash->ui32Redraw = (1UL << psDash->ui32NumFields) - 1;
+  psDash->bActive = true;
+}
+
+//*****************************************************************************
+//
+// Stops updates and gives the whole terminal back to ordinary output.
+//
+//*****************************************************************************
+void
+VTDashStop(tVTDash *psDash)
+{
+  psDash->bActive = false;
+  UARTTxPutString(psDash->psTx, "\033[r\033[2J\033[H");
+}
+
+//*****************************************************************************
+//
+// Records the latest value of a field.  Cheap enough to call every pass of
+// the main loop; nothing is sent until VTDashUpdate().  Not safe to call
+// from an interrupt handler while the main loop updates the same dashboard.
+//
+//*****************************************************************************
+void
+VTDashSet(tVTDash *psDash, uint32_t ui32Field, int32_t i32Value)
+{
+  psDash->pi32Value[ui32Field] = i32Value;
+  if(i32Value != psDash->pi32Shown[ui32Field]) {
+    psDash->ui32Dirty |= 1UL << ui32Field;
+  }
+  else {
+    psDash->ui32Dirty &= ~(1UL << ui32Field);
+  }
+}
+
+//*****************************************************************************
+//
+// Sends the fields that changed since they were last shown, provided a
+// period has passed since the last update.  The update is queued whole or
+// not at all, so a full ring delays it rather than leaving the cursor
+// somewhere stray.  Returns the number of bytes queued.
+//
+//*****************************************************************************
+uint32_t
+VTDashUpdate(tVTDash *psDash, uint32_t ui32Now)
+{
+  const tVTDashField *psField;
+  char pcBuf[VTDASH_UPDATE_SIZE];
+  char *pcEnd;
+  uint32_t ui32Idx, ui32Pending, ui32Sent, ui32Len, ui32Need;
+
+  // Fields still to be drawn for a fresh layout go out at once; changes
+  // wait out the period.
+  ui32Pending = psDash->ui32Dirty | psDash->ui32Redraw;
+  if(!psDash->bActive || (ui32Pending == 0)) {
+    return(0);
+  }
+  if((psDash->ui32Redraw == 0) &&
+     ((ui32Now - psDash->ui32Last) < psDash->ui32Period)) {
+    return(0);
+  }
+
+  // Save the cursor, rewrite each changed field, then put the cursor back
+  // where the user was typing.
+  ui32Sent = 0;
+  pcEnd = NumFmtStr(pcBuf, "\0337");
+  for(ui32Idx = 0; ui32Idx < psDash->ui32NumFields; ui32Idx++) {
+    if(!(ui32Pending & (1UL << ui32Idx))) {
+      continue;
+    }
+    psField = &psDash->psFields[ui32Idx];
+    ui32Need = VTDASH_CURSOR_SIZE + psField->ui8Width + NUMFMT_MAX_DIGITS + 3;
+    if((uint32_t)(pcEnd - pcBuf) + ui32Need > sizeof(pcBuf)) {
+      break;
+    }
+    pcEnd = VTDashCursor(pcEnd, psField->ui8Row,
+                         psField->ui8Col + strlen(psField->pcLabel));
+    pcEnd = VTDashValue(pcEnd, psField, psDash->pi32Value[ui32Idx]);
+    ui32Sent |= 1UL << ui32Idx;
+  }
+  pcEnd = NumFmtStr(pcEnd, "\0338");
+
+  ui32Len = pcEnd - pcBuf;
+  if(UARTTxSpace(psDash->psTx) < ui32Len) {
+    return(0);
+  }
+  UARTTxWrite(psDash->psTx, (const uint8_t *)pcBuf, ui32Len);
+
+  for(ui32Idx = 0; ui32Idx < psDash->ui32NumFields; ui32Idx++) {
+    if(ui32Sent & (1UL << ui32Idx)) {
+      psDash->pi32Shown[ui32Idx] = psDash->pi32Value[ui32Idx];
+    }
+  }
+  psDash->ui32Dirty &= ~ui32Sent;
+  psDash->ui32Redraw &= ~ui32Sent;
+  psDash->ui32Last = ui32Now;
+  psDash->ui32Bytes = ui32Len;
+
+  return(ui32Len);
+}
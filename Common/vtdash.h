@@ -0,0 +1,94 @@
+//*****************************************************************************
+//
+// vtdash.h - Prototypes for the incremental VT100 terminal dashboard.
+//
+//*****************************************************************************
+
+#ifndef __VTDASH_H__
+#define __VTDASH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "uarttx.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Most fields one dashboard can hold; one bit each in the dirty mask.
+//
+//*****************************************************************************
+#define VTDASH_MAX_FIELDS       16
+
+//*****************************************************************************
+//
+// Largest update queued in one go.  Fields that do not fit wait for the
+// next update.
+//
+//*****************************************************************************
+#define VTDASH_UPDATE_SIZE      160
+
+//*****************************************************************************
+//
+// Where one live value sits on the screen.  The label is drawn once with the
+// layout and the value is rewritten in the ui8Width columns after it.  With
+// ppcNames set the value is an index into it and the name is shown instead
+// of the number, e.g. for a mode or a note.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint8_t ui8Row;               // Terminal row of the label, from 1
+  uint8_t ui8Col;               // Terminal column of the label, from 1
+  uint8_t ui8Width;             // Columns reserved for the value
+  uint8_t ui8Decimals;          // Fixed point places, 0 for an integer
+  const char *pcLabel;          // Drawn once, the value follows it
+  const char *const *ppcNames;  // Names indexed by value, or 0
+  uint32_t ui32NumNames;        // Entries in ppcNames
+} tVTDashField;
+
+//*****************************************************************************
+//
+// Dashboard state.  Values are set as often as the caller likes; only those
+// that changed since they were last sent go out, and no more often than
+// every ui32Period ticks of whatever clock the caller passes in.
+//
+//*****************************************************************************
+typedef struct
+{
+  tUARTTx *psTx;                // Transmit ring the dashboard is drawn on
+  const tVTDashField *psFields; // Layout, one entry per value
+  uint32_t ui32NumFields;       // Entries in psFields
+  uint32_t ui32Rows;            // Rows the layout covers
+  uint32_t ui32Period;          // Minimum ticks between updates
+  uint32_t ui32Last;            // Tick of the last update
+  uint32_t ui32Dirty;           // Fields whose value differs from the screen
+  uint32_t ui32Redraw;          // Fields to send at once whatever their value
+  uint32_t ui32Bytes;           // Bytes queued by the last update
+  bool bActive;                 // Layout is on the screen
+  int32_t pi32Value[VTDASH_MAX_FIELDS];         // Latest value of each field
+  int32_t pi32Shown[VTDASH_MAX_FIELDS];         // Value on the screen
+} tVTDash;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern void VTDashInit(tVTDash *psDash, tUARTTx *psTx,
+                       const tVTDashField *psFields, uint32_t ui32NumFields,
+                       uint32_t ui32Period);
+extern void VTDashDraw(tVTDash *psDash, const char *pcTitle);
+extern void VTDashStop(tVTDash *psDash);
+extern void VTDashSet(tVTDash *psDash, uint32_t ui32Field, int32_t i32Value);
+extern uint32_t VTDashUpdate(tVTDash *psDash, uint32_t ui32Now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __VTDASH_H__
@@ -37,9 +37,29 @@
 #include "grlib/grlib.h"
 #include "drivers/cfal96x64x16.h"
 
+#include "../Common/uarttx.h" // Interrupt-driven UART transmit ring buffer
+#include "../Common/uartbaud.h" // Checked baud rate changes
+#include "../Common/cmdparse.h" // Table-driven command line parser
+#include "../Common/vtdash.h" // Incremental VT100 terminal dashboard
+#include "../Common/cyccnt.h" // Cycle counter to pace the dashboard
+#include "../Common/upload.h" // Windowed bulk upload receiver
+
 // Helps with timing in the while(1) loop, creating ~1s LED cycle at 16MHZ
 #define TIMING 800000
 
+// Size of the UART 0 transmit ring, must be a power of two
+#define UART0_TX_BUF_SIZE 512
+
+// Terminal dashboard refreshes a second
+#define DASH_UPDATE_HZ 2
+
+// Longest song that can be uploaded, and the upload target id for a song
+#define MAX_NOTES 256
+#define UPLOAD_TARGET_SONG 1
+
+// Largest PWM period a note can have; the generator counter is 16 bits
+#define MAX_NOTE_LOAD 0xFFFF
+
 // Define load values to achieve correct note frequencies
 #define F 45815
 #define G 40816
@@ -68,7 +88,15 @@ uint32_t ui32TotalNotes = 97;
 //
 // Array to hold the notes to be played
 //
-uint32_t g_ui32Notes[97] = {Rest};
+uint32_t g_ui32Notes[MAX_NOTES] = {Rest};
+
+//
+// Bulk upload receiver and the buffer a new song is received into, so the
+// song playing is only replaced once the whole new one has arrived intact
+//
+tUpload g_sUpload;
+bool g_bUploading = false;
+uint32_t g_pui32NoteUpload[MAX_NOTES];
 
 //
 // Global to allow Interupts to call drawing/printing to screen functions
@@ -76,6 +104,37 @@ uint32_t g_ui32Notes[97] = {Rest};
 //
 tContext Context;
 
+//
+// UART 0 transmit ring and its storage, drained by the TX FIFO interrupt
+//
+uint8_t g_pui8UART0TxBuf[UART0_TX_BUF_SIZE];
+tUARTTx g_sUART0Tx;
+
+//
+// Assembles received characters into command lines for the dispatch table
+//
+tCmdParser g_sCmdParser;
+
+//
+// Note load values and the names the dashboard shows for them
+//
+const uint32_t g_pui32NoteLoads[] = {Rest, F, G, Ab, Bb, C, Db, Eb};
+const char *const g_ppcNoteNames[] = {"Rest", "F", "G", "Ab", "Bb", "C",
+                                      "Db", "Eb"};
+#define NUM_NOTE_NAMES (sizeof(g_ppcNoteNames) / sizeof(g_ppcNoteNames[0]))
+
+//
+// Terminal dashboard of the motor speed, rpm and the note playing.  The
+// labels are drawn once and only values that changed are rewritten.
+//
+const tVTDashField g_psDashFields[] = {
+  {2, 1, 6, 0, "Speed: ", 0, 0},
+  {2, 16, 4, 0, "RPM: ", 0, 0},
+  {2, 28, 4, 0, "Note: ", g_ppcNoteNames, NUM_NOTE_NAMES},
+};
+#define NUM_DASH_FIELDS (sizeof(g_psDashFields) / sizeof(g_psDashFields[0]))
+tVTDash g_sDash;
+
 //
 // Function Prototypes
 //
@@ -89,6 +148,11 @@ void ConfigureUART(void);
 void UARTIntHandler(void);
 void ReadChar(const int32_t local_char);
 void PlayNote(void);
+void menuSwitch(int32_t local_char);
+void cmdError(const char *pcCmd, int32_t i32Status);
+void updateDash(void);
+void uploadInput(uint8_t ui8Byte);
+extern const tCmdEntry *const g_ppsCmdTable[CMD_TABLE_SIZE];
 
 //*****************************************************************************
 //
@@ -114,8 +178,7 @@ void Timer0IntHandler(void) {
     //          
     while(UARTCharsAvail(UART0_BASE)) {
         local_char = UARTCharGetNonBlocking(UART0_BASE);
-        if (local_char != -1) 
-            menuSwitch();
+        menuSwitch(local_char);
     }
 }
 
@@ -142,6 +205,7 @@ int main(void) {
     // Initialize the graphics context and find the middle X coordinate.
     //
     GrContextInit(&g_sContext, &g_sCFAL96x64x16);
+    CmdParserInit(&g_sCmdParser, g_ppsCmdTable, cmdError);
 
     
     //
@@ -172,6 +236,7 @@ int main(void) {
       blinkyHandler++;
     }
     whileLoop++; 
+    updateDash();
   }
 }
 
@@ -189,14 +254,12 @@ __error__(char *pcFilename, uint32_t ui32Line)
 
 //*****************************************************************************
 //
-// Using the character output function as a base for a parent function
-// used to output an entire string to the OLED one character at a time.
+// Queues an entire string for the PuTTY window.  The bytes are sent by the
+// UART TX interrupt so the caller does not wait for them to go out.
 //
 //*****************************************************************************
 void putString(char *str) {
-  for(int i = 0; i < strlen(str); i++) {
-    UARTCharPut(UART0_BASE, str[i]);
-  }
+  UARTTxPutString(&g_sUART0Tx, str);
 }
 
 
@@ -259,104 +322,309 @@ void UARTIntHandler(void){
   uint32_t ui32Status;
   ui32Status = UARTIntStatus(UART0_BASE, true); // Get the interrupt status.
   UARTIntClear(UART0_BASE, ui32Status); // Clear the interrupt for UART
+  UARTTxIntHandler(&g_sUART0Tx); // Refill the TX FIFO from the ring
   // Loop while there are characters in the receive FIFO.
   while(UARTCharsAvail(UART0_BASE)) {
-    // Read the next character from the UART and write it back to the UART.
-    local_char = UARTCharGetNonBlocking(UART0_BASE);
-    menuSwitch();
+    // Read the next character and hand it to the command parser.
+    menuSwitch(UARTCharGetNonBlocking(UART0_BASE));
+  }
+}
+
+//*****************************************************************************
+//
+// Sets the motor speed and the matching rpm readout, and reloads the step
+// timer.  A speed of zero or less drops back to the slowest step rate.
+//
+//*****************************************************************************
+void setSpeed(int32_t i32Speed) {
+  speed = i32Speed;
+  rpm = (i32Speed * 60) / 200; // 60 rpm for every 200 steps per second
+  if (speed <= 0) {
+    rpm = 0;
+    speed = 60;
+  }
+  TimerLoadSet(TIMER0_BASE, TIMER_A, SysCtlClockGet()/speed);
+}
+
+//*****************************************************************************
+//
+// Command handlers.  Each is called from the dispatch table below with the
+// numeric arguments that followed it on the line.
+//
+//*****************************************************************************
+int32_t cmdClear(uint32_t argc, const int32_t *argv) { // Clear PuTTY window
+  clear();
+  return(CMD_OK);
+}
+
+int32_t cmdFollow(uint32_t argc, const int32_t *argv) { // Follow mode
+  firstCycle = true;
+  mode = 2;
+  return(CMD_OK);
+}
+
+int32_t cmdLED(uint32_t argc, const int32_t *argv) { // LED toggle
+  if(blinkyHandler == 0)
+    blinkyHandler = 1;
+  else
+    blinkyHandler = 0;
+  GPIOPinWrite(GPIO_PORTG_BASE, GPIO_PIN_2, 0);
+  return(CMD_OK);
+}
+
+int32_t cmdMenu(uint32_t argc, const int32_t *argv) { // Re-print menu
+  UARTTxPutChar(&g_sUART0Tx, 5);
+  printMenu();
+  return(CMD_OK);
+}
+
+int32_t cmdNormal(uint32_t argc, const int32_t *argv) { // Normal mode
+  mode = 1;
+  return(CMD_OK);
+}
+
+int32_t cmdQuit(uint32_t argc, const int32_t *argv) { // Quit program
+  IntMasterDisable();
+  putString("\n\rBYE!"); // Goodbye message to PuTTy
+  UARTTxFlush(&g_sUART0Tx); // Interrupts are off, so send it out now
+  sRect.i16XMin = 0;
+  sRect.i16YMin = 0;
+  sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
+  sRect.i16YMax = GrContextDpyHeightGet(&sContext) - 1;
+  GrContextForegroundSet(&sContext, ClrBlack);
+  GrContextBackgroundSet(&sContext, ClrBlack);
+  GrRectFill(&sContext, &sRect);
+  GrContextForegroundSet(&sContext, ClrRed);
+  GrContextFontSet(&sContext, g_psFontFixed6x8);
+  GrStringDrawCentered(&sContext, "Goodbye", -1, GrContextDpyWidthGet(&sContext) 
+						/ 2, 30, false); // Goodbye message to OLED in red.
+  // If the user said to quit the whileLoop will NO LONGER be able to be ran		
+  whileLoop = 0; 
+  return(CMD_STOP); // Nothing after Q on the same line runs
+}
+
+int32_t cmdReverse(uint32_t argc, const int32_t *argv) { // Reverse mode
+  mode = 3;
+  return(CMD_OK);
+}
+
+int32_t cmdSpeed(uint32_t argc, const int32_t *argv) { // S stops, S <n> sets speed
+  if(argc == 0) {
+    mode = 0;
+  }
+  else {
+    setSpeed(argv[0]);
+  }
+  return(CMD_OK);
+}
+
+int32_t cmdFaster(uint32_t argc, const int32_t *argv) { // + [step], default 200
+  setSpeed(speed + ((argc != 0) ? argv[0] : 200));
+  return(CMD_OK);
+}
+
+int32_t cmdSlower(uint32_t argc, const int32_t *argv) { // - [step], default 200
+  setSpeed(speed - ((argc != 0) ? argv[0] : 200));
+  return(CMD_OK);
+}
+
+int32_t cmdDash(uint32_t argc, const int32_t *argv) { // Dashboard on/off
+  if(g_sDash.bActive) {
+    VTDashStop(&g_sDash);
+  }
+  else {
+    VTDashDraw(&g_sDash, "Lab 10 - Motor and Song");
+  }
+  return(CMD_OK);
+}
+
+int32_t cmdUpload(uint32_t argc, const int32_t *argv) { // Receive a song
+  UploadReset(&g_sUpload);
+  g_bUploading = true;
+  putString("\n\rReady for upload, Esc cancels");
+  return(CMD_STOP); // Anything after this is upload data
+}
+
+int32_t cmdBaud(uint32_t argc, const int32_t *argv) { // Baud rate change
+  tUARTBaud sBaud;
+  char str[80];
+  
+  if(argv[0] <= 0) {
+    return(CMD_INVALID_ARG);
   }
+  if(!UARTBaudCompute(SysCtlClockGet(), argv[0], &sBaud)) {
+    if(sBaud.bReachable) {
+      sprintf(str, "\n\r%lu baud is %ld ppm off at this clock, out of tolerance\n\r",
+              (unsigned long)sBaud.ui32Baud, (long)sBaud.i32ErrorPPM);
+    }
+    else {
+      sprintf(str, "\n\r%lu baud is too fast for this clock\n\r",
+              (unsigned long)sBaud.ui32Baud);
+    }
+    putString(str);
+    return(CMD_OK);
+  }
+  
+  sprintf(str, "\n\rSwitching to %lu baud (actual %lu, %ld ppm)\n\r",
+          (unsigned long)sBaud.ui32Baud, (unsigned long)sBaud.ui32Actual,
+          (long)sBaud.i32ErrorPPM);
+  putString(str);
+  UARTTxFlush(&g_sUART0Tx); // Finish sending at the old rate
+  UARTBaudSet(UART0_BASE, SysCtlClockGet(), argv[0], &sBaud);
+  return(CMD_OK);
+}
+
+//*****************************************************************************
+//
+// Command table, indexed by the first character of each command so a
+// command is found with a single lookup.
+//
+//*****************************************************************************
+const tCmdEntry g_sCmdClear = {"CLEAR", 0, 0, cmdClear};
+const tCmdEntry g_sCmdFollow = {"FOLLOW", 0, 0, cmdFollow};
+const tCmdEntry g_sCmdLED = {"LED", 0, 0, cmdLED};
+const tCmdEntry g_sCmdMenu = {"MENU", 0, 0, cmdMenu};
+const tCmdEntry g_sCmdNormal = {"NORMAL", 0, 0, cmdNormal};
+const tCmdEntry g_sCmdQuit = {"QUIT", 0, 0, cmdQuit};
+const tCmdEntry g_sCmdReverse = {"REVERSE", 0, 0, cmdReverse};
+const tCmdEntry g_sCmdSpeed = {"SPEED", 0, 1, cmdSpeed};
+const tCmdEntry g_sCmdFaster = {"+", 0, 1, cmdFaster};
+const tCmdEntry g_sCmdSlower = {"-", 0, 1, cmdSlower};
+const tCmdEntry g_sCmdBaud = {"BAUD", 1, 1, cmdBaud};
+const tCmdEntry g_sCmdDash = {"DASH", 0, 0, cmdDash};
+const tCmdEntry g_sCmdUpload = {"UPLOAD", 0, 0, cmdUpload};
+
+const tCmdEntry *const g_ppsCmdTable[CMD_TABLE_SIZE] = {
+  ['+'] = &g_sCmdFaster,
+  ['-'] = &g_sCmdSlower,
+  ['B'] = &g_sCmdBaud,
+  ['C'] = &g_sCmdClear,
+  ['D'] = &g_sCmdDash,
+  ['F'] = &g_sCmdFollow,
+  ['L'] = &g_sCmdLED,
+  ['M'] = &g_sCmdMenu,
+  ['N'] = &g_sCmdNormal,
+  ['Q'] = &g_sCmdQuit,
+  ['R'] = &g_sCmdReverse,
+  ['S'] = &g_sCmdSpeed,
+  ['U'] = &g_sCmdUpload,
+};
+
+//*****************************************************************************
+//
+// Reports a command that could not be run.
+//
+//*****************************************************************************
+void cmdError(const char *pcCmd, int32_t i32Status) {
+  putString("\n\rInvalid. Try Again: ");
 }
 
 //*********************************************************************
 //
-// If the input character is not invalid, begin the character matching
-// statment below through the switch statment and act accordingly to
-// the user input.
+// Echoes each received character and hands it to the command parser,
+// which runs the line once Enter is pressed.  During an upload the
+// bytes go to the upload receiver instead and are not echoed.
 //
 //*********************************************************************
-void menuSwitch() {
-  if (local_char != -1) { // Run only if the character in PuTTy is valid
-    UARTCharPut(UART0_BASE, local_char); // Send a character to UART.
-   
-    // Begin character input matching to menu option.
-    switch(local_char) {
-    case 'C': // Clear PuTTY window 
-      clear();
-      break;
-      
-    case 'F':
-      firstCycle = true;
-      mode = 2;
-      break;
-      
-    case 'L': //LED toggle 
-      if(blinkyHandler == 0)
-        blinkyHandler = 1;
-      else
-        blinkyHandler = 0;
-      GPIOPinWrite(GPIO_PORTG_BASE, GPIO_PIN_2, 0);
-      break;
-      
-    case 'M': // Re-print menu 
-      UARTCharPut(UART0_BASE, 5);
-      printMenu();
-      break;
-      
-    case 'N':
-        mode = 1;
-      break;
-      
-    case 'Q': // Quit program
-      IntMasterDisable();
-      putString("\n\rBYE!"); // Goodbye message to PuTTy
-      sRect.i16XMin = 0;
-      sRect.i16YMin = 0;
-      sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
-      sRect.i16YMax = GrContextDpyHeightGet(&sContext) - 1;
-      GrContextForegroundSet(&sContext, ClrBlack);
-      GrContextBackgroundSet(&sContext, ClrBlack);
-      GrRectFill(&sContext, &sRect);
-      GrContextForegroundSet(&sContext, ClrRed);
-      GrContextFontSet(&sContext, g_psFontFixed6x8);
-      GrStringDrawCentered(&sContext, "Goodbye", -1, GrContextDpyWidthGet(&sContext) 
-							/ 2, 30, false); // Goodbye message to OLED in red.
-	  // If the user said to quit the whileLoop will NO LONGER be able to be ran		
-      whileLoop = 0; 
-      break;   
-      
-    case 'R':
-        mode = 3;
-      break;
-      
-    case 'S':
-      mode = 0;
-      break;
-      
-    case '+':
-      speed += 200;
-      rpm += 60;
-      TimerLoadSet(TIMER0_BASE, TIMER_A, SysCtlClockGet()/speed);
-      break;
-    
-    case '-':
-      speed -= 200;
-      rpm -= 60;
-      if (speed <= 0) {
-        rpm = 0;
-        speed = 60;
-      }
-      TimerLoadSet(TIMER0_BASE, TIMER_A, SysCtlClockGet()/speed);
-      break;
-      
-    default:
-      char invalid[25] = "\n\rInvalid. Try Again: ";
-      char*ptr = invalid;
-      putString(ptr);
-      break;
-    } 
+void menuSwitch(int32_t local_char) {
+  if(g_bUploading) {
+    uploadInput(local_char);
+    return;
+  }
+  UARTTxPutChar(&g_sUART0Tx, local_char); // Echo the character.
+  if(CmdParserInput(&g_sCmdParser, local_char)) {
+    UARTTxPutChar(&g_sUART0Tx, '\n'); // Start a fresh line for the next
+    if(g_bUploading) {
+      UARTTxPutChar(&g_sUART0Tx, 0); // End the text before the first ack
+    }
+  }
+}
+
+//*********************************************************************
+//
+// Feeds one byte to the upload receiver and sends back any ack it
+// produces.  Escape before the first frame gives up waiting.
+//
+//*********************************************************************
+void uploadInput(uint8_t ui8Byte) {
+  uint32_t ui32Len;
+  
+  if((ui8Byte == 27) && (g_sUpload.ui32State == UPLOAD_IDLE) &&
+     (g_sUpload.ui32FrameLen == 0)) {
+    g_bUploading = false;
+    putString("\n\rUpload cancelled\n\r");
+    return;
+  }
+  
+  ui32Len = UploadInput(&g_sUpload, ui8Byte);
+  if(ui32Len != 0) {
+    UARTTxWrite(&g_sUART0Tx, g_sUpload.pui8Reply, ui32Len);
+  }
+  if(g_sUpload.ui32State == UPLOAD_DONE) {
+    g_bUploading = false;
+    putString("\n\rSong loaded\n\r");
+  }
+  else if(g_sUpload.ui32State == UPLOAD_FAILED) {
+    g_bUploading = false;
+    putString("\n\rUpload failed\n\r");
   }
 }
 
+//*********************************************************************
+//
+// Upload callbacks.  A song is a table of 32-bit PWM periods, one per
+// beat, with 0 for a rest.  It is received into a spare buffer and
+// only copied over the song playing once it has all arrived and
+// checked out.
+//
+//*********************************************************************
+uint8_t *uploadBegin(uint8_t ui8Target, uint32_t ui32Length, void *pvData) {
+  if((ui8Target != UPLOAD_TARGET_SONG) || (ui32Length == 0) ||
+     (ui32Length % sizeof(uint32_t)) ||
+     (ui32Length > sizeof(g_pui32NoteUpload))) {
+    return(0);
+  }
+  return((uint8_t *)g_pui32NoteUpload);
+}
+
+bool uploadEnd(uint8_t ui8Target, uint32_t ui32Length, void *pvData) {
+  uint32_t ui32Count = ui32Length / sizeof(uint32_t);
+  
+  for(uint32_t i = 0; i < ui32Count; i++) {
+    if(g_pui32NoteUpload[i] > MAX_NOTE_LOAD) {
+      return(false);
+    }
+  }
+  memcpy(g_ui32Notes, g_pui32NoteUpload, ui32Length);
+  g_ui32TotalNotes = ui32Count;
+  g_ui32NotePosition = 0; // Play the new song from the start
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Hands the current speed, rpm and note to the terminal dashboard, which
+// sends whichever changed at most DASH_UPDATE_HZ times a second.
+//
+//*****************************************************************************
+void updateDash(void) {
+  uint32_t ui32Note = 0; // Rest until the first note has played
+  
+  if(!g_sDash.bActive) {
+    return;
+  }
+  if(g_ui32NotePosition != 0) {
+    while((ui32Note < NUM_NOTE_NAMES) &&
+          (g_pui32NoteLoads[ui32Note] != g_ui32Notes[g_ui32NotePosition - 1])) {
+      ui32Note++;
+    }
+  }
+  VTDashSet(&g_sDash, 0, speed);
+  VTDashSet(&g_sDash, 1, rpm);
+  VTDashSet(&g_sDash, 2, ui32Note);
+  VTDashUpdate(&g_sDash, CycleCounterGet());
+}
+
 void PlayNote(void)
 {
     //
@@ -434,10 +702,21 @@ void initializations(void) {
   // Configure UART for 115200 baud rate, 8 in 1 operation
   UARTConfigSetExpClk(UART0_BASE, SysCtlClockGet(), 115200, 
 					  (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE));
+  
+  // Queue output in a ring that the TX FIFO interrupt drains
+  UARTTxInit(&g_sUART0Tx, UART0_BASE, g_pui8UART0TxBuf, sizeof(g_pui8UART0TxBuf));
     
   IntEnable(INT_UART0); // Enable the interrupt for UART 0
   UARTIntEnable(UART0_BASE, UART_INT_RX | UART_INT_RT);  // Enable specific UART interrupt usage
   
+  // Terminal dashboard, paced by the cycle counter
+  CycleCounterInit();
+  VTDashInit(&g_sDash, &g_sUART0Tx, g_psDashFields, NUM_DASH_FIELDS,
+             SysCtlClockGet() / DASH_UPDATE_HZ);
+  
+  // Song uploads arrive through the same UART as commands
+  UploadInit(&g_sUpload, uploadBegin, uploadEnd, 0);
+  
     //
     // Enable GPIO Port H
     //
@@ -530,4 +809,4 @@ void initializations(void) {
 // PuTTY window clearing function.
 //
 //*****************************************************************************
-void clear() { UARTCharPut(UART0_BASE, 12); }
\ No newline at end of file
+void clear() { UARTTxPutChar(&g_sUART0Tx, 12); }
\ No newline at end of file
@@ -53,8 +53,25 @@
 #include "drivers/cfal96x64x16.h" 	// Header file for OLED display dimension
 									// specifications
 #include "drivers/buttons.h" 		// Header file for push-buttons counter
+#include "inc/hw_ints.h"			// Header file for interrupt assignments
+#include "driverlib/interrupt.h"	// Header file for interrupt controller
+									// calls
+#include "../Common/uarttx.h"		// Interrupt-driven UART transmit ring
+#include "../Common/uartdma.h"		// uDMA bulk UART transmit
+#include "../Common/uartbench.h"	// UART throughput benchmark
+#include "driverlib/udma.h"			// uDMA channel assignments
+#include "../Common/numfmt.h"		// sprintf-free number formatting
+#include "../Common/cyccnt.h"		// Cycle counter for the text cache
+#include "../Common/strcache.h"		// Pre-rendered banner text
+#include "../Common/grstate.h"		// Caches translated colors
+#include "../Common/framebuf.h"		// Off-screen OLED framebuffer
 #define LEDon 20000                 // defines the on period of the LED in ms
 #define LEDoff 380000               // defines the off period of the LED in ms
+#define UART0_TX_BUF_SIZE 512       // size of the UART0 transmit ring, a
+									// power of two
+#define BENCH_PATTERN_SIZE 256      // bytes sent per benchmark write
+#define BENCH_DEFAULT_MS 1000       // benchmark time per backend
+#define PARTY_INDEX 15              // palette entry party mode recolors
 
 //*******************************************************************************
 //
@@ -70,6 +87,9 @@
 void printScreen(char *str);
 void clear();
 void printMenu();
+void printUARTStats(void);
+void printGraphicsStats(void);
+void runBenchmark(tContext *psContext, uint32_t ui32Ms);
 void blinky(volatile uint32_t ui32Loop);
 
 //*******************************************************************************
@@ -91,6 +111,60 @@ void __error__(char *pcFilename, uint32_t ui32Line) {
 //*******************************************************************************
 static uint8_t g_ui8ButtonStates = ALL_BUTTONS;
 
+//*******************************************************************************
+//
+// UART0 transmit ring.  Output is queued here and sent by the TX FIFO 
+// interrupt so the main loop does not wait on the serial line.
+//
+//*******************************************************************************
+static uint8_t g_pui8UART0TxBuf[UART0_TX_BUF_SIZE];
+static tUARTTx g_sUART0Tx;
+
+//*******************************************************************************
+//
+// uDMA channel for UART0 transmit and the pattern the throughput benchmark
+// sends through each backend.
+//
+//*******************************************************************************
+static tUARTDMA g_sUART0DMA;
+static uint8_t g_pui8BenchPattern[BENCH_PATTERN_SIZE];
+
+//*******************************************************************************
+//
+// Banner and goodbye text, rendered through the font engine once and then
+// drawn from runs, so party mode does not decode the banner every loop.
+//
+//*******************************************************************************
+static tStrCache g_sStrCache;
+
+//*******************************************************************************
+//
+// Colors and font of the OLED context.  The loop sets them before every
+// draw; each color is run through the display's translation only once.
+//
+//*******************************************************************************
+static tGrState g_sGrState;
+
+//*******************************************************************************
+//
+// Off-screen copy of the OLED, a 4-bit palette index per pixel.  Everything
+// is drawn here and GrFlush() sends only the regions that changed.
+//
+//*******************************************************************************
+static tFrameBuf g_sFrameBuf;
+static uint8_t g_pui8FramePixels[FRAMEBUF_INDEXED_BYTES];
+
+//*******************************************************************************
+//
+// Colors party mode cycles through.  They are swapped into palette entry
+// PARTY_INDEX in turn, so the screen is painted once and each later color
+// costs only a flush.
+//
+//*******************************************************************************
+static const uint32_t g_pui32PartyColors[3] = {
+    ClrDarkBlue, ClrRed, ClrGreen
+};
+
 //*******************************************************************************
 //
 // Initializes the GPIO pins used by the board pushbuttons with a weak 
@@ -119,15 +193,30 @@ void ButtonsInit(void) {
 
 //*******************************************************************************
 //
-// Send a string to the UART.
+// Send a buffer to the UART.  Fills the TX FIFO up to its free level and
+// queues the rest in the transmit ring, so nothing past the 16 byte FIFO is
+// silently lost.  Returns the number of bytes accepted; the shortfall, if
+// any, shows up in the dropped count of printUARTStats().
 //
 //*******************************************************************************
-void UARTSend(const uint8_t *pui8Buffer, uint32_t ui32Count) {
-    // Loop while there are more characters to send.
-    while(ui32Count--) {
-        // Write the next character to the UART.
-        UARTCharPutNonBlocking(UART0_BASE, *pui8Buffer++);
-    }
+uint32_t UARTSend(const uint8_t *pui8Buffer, uint32_t ui32Count) {
+    return(UARTTxSend(&g_sUART0Tx, pui8Buffer, ui32Count, true));
+}
+
+//*******************************************************************************
+//
+// The UART interrupt handler.  Refills the TX FIFO from the transmit ring.
+//
+//*******************************************************************************
+void UARTIntHandler(void) {
+    uint32_t ui32Status;
+    
+    ui32Status = UARTIntStatus(UART0_BASE, true);		// Get the interrupt
+														// status.
+    UARTIntClear(UART0_BASE, ui32Status);				// Clear the asserted
+														// interrupts.
+    UARTTxIntHandler(&g_sUART0Tx);
+    UARTDMAIntHandler(&g_sUART0DMA);
 }
 
 
@@ -145,18 +234,21 @@ int main(void) {
 														// recieved by the UART 
     volatile uint32_t ui32Loop;							// Blinky LED volatile	
 														// loop.
-    bool shouldFlood = false;							// "Flood" character 
-														// toggle
+    bool benchEntry = false;							// Reading a benchmark
+														// duration
+    uint32_t benchMs = 0;								// Benchmark duration
+														// typed so far
     bool shouldBlink = true;							// LED blinky toggle
 	
 	//***************************************************************************
 	// Counter variables
 	//***************************************************************************
-    int tickCount = 0;									// Clock ticks for flood
-														// character.
     int whileLoop = 1;								
     int colorSwitch = 0;								// OLED Color toggle
     int shouldCycle = 0;								// Boolean for Party Mode
+    bool partyDrawn = false;							// Screen is painted in
+														// the party palette
+														// entry
     uint32_t buttonState = 0;							// Boolean to check if a
 														// button was pressed.
     int buttonCounter = 0;								// Counting how many 
@@ -214,13 +306,18 @@ int main(void) {
     //
 	//***************************************************************************
     CFAL96x64x16Init();
+    FrameBufInitIndexed(&g_sFrameBuf, &g_sCFAL96x64x16, g_pui8FramePixels);
+    FrameBufPaletteSet(&g_sFrameBuf, PARTY_INDEX, g_pui32PartyColors[0]);
     
     //***************************************************************************
 	//
     // Initialize the OLED graphics context.
     //
 	//***************************************************************************
-    GrContextInit(&sContext, &g_sCFAL96x64x16);
+    GrContextInit(&sContext, &g_sFrameBuf.sDisplay);
+    GrStateInit(&g_sGrState, &sContext);
+    CycleCounterInit();
+    StrCacheInit(&g_sStrCache);
     
     //***************************************************************************
 	//
@@ -231,7 +328,7 @@ int main(void) {
     sRect.i16YMin = 0;									// top edge
     sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;// right edge
     sRect.i16YMax = 9;									// bottom edge
-    GrContextForegroundSet(&sContext, ClrDarkBlue);		// dark blue banner
+    GrStateForegroundSet(&g_sGrState, ClrDarkBlue);		// dark blue banner
     GrRectFill(&sContext, &sRect);						// fill the rectangle
 														// area 
     
@@ -240,16 +337,16 @@ int main(void) {
     // Change foreground for white text.
     //
 	//***************************************************************************
-    GrContextForegroundSet(&sContext, ClrWhite);
+    GrStateForegroundSet(&g_sGrState, ClrWhite);
     
     //***************************************************************************
 	//
     // Put the application name in the middle of the banner.
     //
 	//***************************************************************************
-    GrContextFontSet(&sContext, g_psFontFixed6x8);
-    GrStringDrawCentered(&sContext, "Gray & Pietz", -1,
-                         GrContextDpyWidthGet(&sContext) / 2, 4, 0);
+    GrStateFontSet(&g_sGrState, g_psFontFixed6x8);
+    StrCacheDrawCentered(&g_sStrCache, &sContext, "Gray & Pietz",
+                         GrContextDpyWidthGet(&sContext) / 2, 4, false);
     
     //***************************************************************************
 	//
@@ -289,6 +386,18 @@ int main(void) {
     UARTConfigSetExpClk(UART0_BASE, SysCtlClockGet(), 115200,
                         (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
                          UART_CONFIG_PAR_NONE));
+    
+    //***************************************************************************
+	//
+    // Queue UART output in a ring drained by the TX FIFO interrupt.
+    //
+	//***************************************************************************
+    UARTTxInit(&g_sUART0Tx, UART0_BASE, g_pui8UART0TxBuf,
+               sizeof(g_pui8UART0TxBuf));
+    UARTDMAInit(&g_sUART0DMA, &g_sUART0Tx, UDMA_CH9_UART0TX);
+    UARTBenchPatternFill(g_pui8BenchPattern, sizeof(g_pui8BenchPattern));
+    IntEnable(INT_UART0);
+    IntMasterEnable();
 
     
     //***************************************************************************
@@ -323,19 +432,6 @@ int main(void) {
 		// Variable incrementations.
         Looper++;
         whileLoop++;
-        tickCount++;
-		
-		//***********************************************************************
-		//
-		// Flood character output description and timing.
-		//
-		//***********************************************************************
-        if(tickCount == 3) {
-            tickCount = 0;
-            if(shouldFlood == 1) {
-                UARTCharPut(UART0_BASE, '@');			// Toggle catch
-            }
-        }
 		
 		//***********************************************************************
 		//
@@ -386,40 +482,30 @@ int main(void) {
                 colorSwitch = -1;						// End case catch
             }	
 			
-			// Setting OLED display as full avaliable rectangle output.
             colorSwitch++;
-            sRect.i16XMin = 0;
-            sRect.i16YMin = 0;
-            sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
-            sRect.i16YMax = GrContextDpyHeightGet(&sContext) - 1;
 			
-			// Switch case to determine the next OLED color output.
-            switch (colorSwitch) {
-                case 0:									// 0 = Dark Blue
-                    GrContextForegroundSet(&sContext, ClrDarkBlue);
-                    GrContextBackgroundSet(&sContext, ClrDarkBlue);
-                    break;
-                case 1:									// 1 = Red
-                    GrContextForegroundSet(&sContext, ClrRed);
-                    GrContextBackgroundSet(&sContext, ClrRed);
-                    break;
-                case 2:									// 2 = Green
-                    GrContextForegroundSet(&sContext, ClrGreen);
-                    GrContextBackgroundSet(&sContext, ClrGreen);
-                    break;
-                default:								// Default = Dark Blue
-                    GrContextForegroundSet(&sContext, ClrDarkBlue);
-                    GrContextBackgroundSet(&sContext, ClrDarkBlue);
-                    break;
+			// Paint the whole OLED in the party palette entry, with the banner
+			// message on top, once.
+            if(!partyDrawn) {
+                sRect.i16XMin = 0;
+                sRect.i16YMin = 0;
+                sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
+                sRect.i16YMax = GrContextDpyHeightGet(&sContext) - 1;
+                GrStateForegroundSet(&g_sGrState, FRAMEBUF_INDEX(PARTY_INDEX));
+                GrStateBackgroundSet(&g_sGrState, FRAMEBUF_INDEX(PARTY_INDEX));
+                GrRectFill(&sContext, &sRect);
+                GrStateForegroundSet(&g_sGrState, ClrWhite);
+                GrStateFontSet(&g_sGrState, g_psFontFixed6x8);
+                StrCacheDrawCentered(&g_sStrCache, &sContext, "Gray & Pietz",
+                                     GrContextDpyWidthGet(&sContext) / 2, 4,
+                                     false);
+                partyDrawn = true;
             }
 			
-			// Re-draw the OLED rectangular output with above determined color
-			// and correct banner message.
-            GrRectFill(&sContext, &sRect);
-            GrContextForegroundSet(&sContext, ClrWhite);
-            GrContextFontSet(&sContext, g_psFontFixed6x8);
-            GrStringDrawCentered(&sContext, "Gray & Pietz", -1,
-                                 GrContextDpyWidthGet(&sContext) / 2, 4, 0);
+			// Every later color is just a palette swap; the flush resends the
+			// pixels drawn in the party entry.
+            FrameBufPaletteSet(&g_sFrameBuf, PARTY_INDEX,
+                               g_pui32PartyColors[colorSwitch]);
         } 													// end shouldCycle()
         
         //***********************************************************************
@@ -444,18 +530,20 @@ int main(void) {
             sRect.i16YMin = 10;
             sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
             sRect.i16YMax = GrContextDpyHeightGet(&sContext) - 1;
-            GrContextForegroundSet(&sContext, ClrBlack);
+            GrStateForegroundSet(&g_sGrState, ClrBlack);
             GrRectFill(&sContext, &sRect);
-            GrContextForegroundSet(&sContext, ClrWhite);
-            sprintf(str,"Loop: %d",Looper);
+            GrStateForegroundSet(&g_sGrState, ClrWhite);
+            NumFmtDec(NumFmtStr(str, "Loop: "), Looper, 0, ' ');
             GrStringDrawCentered(&sContext, str, -1,
                                  GrContextDpyWidthGet(&sContext) / 2, 20, false);
-            sprintf(str,"Last Pressed: %d",lastPressed);
+            NumFmtDec(NumFmtStr(str, "Last Pressed: "), lastPressed, 0, ' ');
             GrStringDrawCentered(&sContext, str, -1,
                                  GrContextDpyWidthGet(&sContext) / 2, 30, false);
-            sprintf(str,"Press Counter: %d",buttonCounter);
+            NumFmtDec(NumFmtStr(str, "Press Counter: "), buttonCounter, 0,
+                      ' ');
             GrStringDrawCentered(&sContext, str, -1,
                                  GrContextDpyWidthGet(&sContext) / 2, 40, false);
+            partyDrawn = false;
             local_char = UARTCharGetNonBlocking(UART0_BASE);
             
             //*******************************************************************
@@ -468,10 +556,29 @@ int main(void) {
             if (local_char != -1) {
                 gNumCharRecv++; 						// Characters recieved
 														// counter incrementation
-                UARTCharPut(UART0_BASE, local_char);	// Sending a single 
+                UARTTxPutChar(&g_sUART0Tx, local_char);	// Sending a single 
 														// character through the		
 														// UART TX (transmitting)
 														// channel
+				
+				// After F, digits give the benchmark time in ms and Enter
+				// starts it.  Any other key cancels.
+                if(benchEntry) {
+                    if((local_char >= '0') && (local_char <= '9')) {
+                        benchMs = (benchMs * 10) + (local_char - '0');
+                    }
+                    else {
+                        benchEntry = false;
+                        if(local_char == '\r') {
+                            runBenchmark(&sContext,
+                                         benchMs ? benchMs : BENCH_DEFAULT_MS);
+                        }
+                        else {
+                            putString(" cancelled\n\r");
+                        }
+                    }
+                    continue;
+                }
 														
 				// Begin character input matching to menu option.
                 switch(local_char) {
@@ -490,44 +597,44 @@ int main(void) {
                         sRect.i16YMax = 9;
                         switch (colorSwitch) {
                             case 0:
-                                GrContextForegroundSet(&sContext, ClrDarkBlue);
-                                GrContextBackgroundSet(&sContext, ClrDarkBlue);
+                                GrStateForegroundSet(&g_sGrState, ClrDarkBlue);
+                                GrStateBackgroundSet(&g_sGrState, ClrDarkBlue);
                                 break;
                             case 1:
-                                GrContextForegroundSet(&sContext, ClrRed);
-                                GrContextBackgroundSet(&sContext, ClrRed);
+                                GrStateForegroundSet(&g_sGrState, ClrRed);
+                                GrStateBackgroundSet(&g_sGrState, ClrRed);
                                 break;
                             case 2:
-                                GrContextForegroundSet(&sContext, ClrGreen);
-                                GrContextBackgroundSet(&sContext, ClrGreen);
+                                GrStateForegroundSet(&g_sGrState, ClrGreen);
+                                GrStateBackgroundSet(&g_sGrState, ClrGreen);
                                 break;
                             default:
-                                GrContextForegroundSet(&sContext, ClrDarkBlue);
-                                GrContextBackgroundSet(&sContext, ClrDarkBlue);
+                                GrStateForegroundSet(&g_sGrState, ClrDarkBlue);
+                                GrStateBackgroundSet(&g_sGrState, ClrDarkBlue);
                                 break;
                         }
 						
 						// Filling in the rest of the OLED screen after banner is 
 						// updated.
                         GrRectFill(&sContext, &sRect);
-                        GrContextForegroundSet(&sContext, ClrWhite);
-                        GrContextFontSet(&sContext, g_psFontFixed6x8);
-                        GrStringDrawCentered(&sContext, "Gray & Pietz", -1,
+                        GrStateForegroundSet(&g_sGrState, ClrWhite);
+                        GrStateFontSet(&g_sGrState, g_psFontFixed6x8);
+                        StrCacheDrawCentered(&g_sStrCache, &sContext,
+                                             "Gray & Pietz",
                                              GrContextDpyWidthGet(&sContext) / 2,
-											 4, 0);
+											 4, false);
+                        partyDrawn = false;
                         break;
                         
 					case 69: 							//Clear PuTTY window - E
                         clear();
                         break;
 
-					case 70: 							// Flood toggle - F
-                        if(shouldFlood == 0) {
-                            shouldFlood = 1;
-                        }
-                        else {
-                            shouldFlood = 0;
-                        }
+					case 70: 							// Benchmark - F
+                        putString("\n\rBenchmark ms per backend "
+                                  "(Enter for 1000): ");
+                        benchEntry = true;
+                        benchMs = 0;
                         break;
 						
 					case 76: 							//LED toggle - L
@@ -549,23 +656,34 @@ int main(void) {
                         {
                             shouldCycle = 0;
                         }
+                        partyDrawn = false;
+                        break;
+						
+					case 85: 							// UART statistics - U
+                        printUARTStats();
+                        break;
+						
+					case 84: 							// Graphics statistics - T
+                        printGraphicsStats();
                         break;
 						
 					case 81: 							// Quit program - Q
                         putString("\n\rBYE!");			// Goodbye message to
 														// PuTTY window.
+                        UARTTxFlush(&g_sUART0Tx);		// Send it before
+														// exiting.
 															
 						// Re-draw OLED with goodbye statment in red font.
                         sRect.i16XMin = 0;
                         sRect.i16YMin = 0;
                         sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
                         sRect.i16YMax = GrContextDpyHeightGet(&sContext) - 1;
-                        GrContextForegroundSet(&sContext, ClrBlack);
-                        GrContextBackgroundSet(&sContext, ClrBlack);
+                        GrStateForegroundSet(&g_sGrState, ClrBlack);
+                        GrStateBackgroundSet(&g_sGrState, ClrBlack);
                         GrRectFill(&sContext, &sRect);
-                        GrContextForegroundSet(&sContext, ClrRed);
-                        GrContextFontSet(&sContext, g_psFontFixed6x8);
-                        GrStringDrawCentered(&sContext, "Goodbye", -1,
+                        GrStateForegroundSet(&g_sGrState, ClrRed);
+                        GrStateFontSet(&g_sGrState, g_psFontFixed6x8);
+                        StrCacheDrawCentered(&g_sStrCache, &sContext, "Goodbye",
                                              GrContextDpyWidthGet(&sContext) / 2,
 											 30, false);
                         whileLoop = 0;
@@ -577,6 +695,9 @@ int main(void) {
         }												// End character 
 														// detection
 														// loop.
+		
+		// Send whatever changed on the OLED this pass.
+        GrFlush(&sContext);
     } 													// End indefinite while()
 } 														// End of main()
 
@@ -586,19 +707,17 @@ int main(void) {
 //
 //*******************************************************************************
 void clear() {
-    UARTCharPut(UART0_BASE, 12);
+    UARTTxPutChar(&g_sUART0Tx, 12);
 }
 
 //*******************************************************************************
 //
-// Using the character output function as a base for a parent function
-// used to output an entire string to the OLED one character at a time.
+// Queues an entire string for the PuTTY window.  The bytes are sent by the
+// UART TX interrupt so the caller does not wait for them to go out.
 //
 //*******************************************************************************
 void putString(char *str) {
-    for(int i = 0; i < strlen(str); i++) {
-        UARTCharPut(UART0_BASE, str[i]);
-    }
+    UARTTxPutString(&g_sUART0Tx, str);
 }
 
 //*******************************************************************************
@@ -612,11 +731,110 @@ void printMenu() {
 	// string below is wrapped for printing and elongated for compiling.
     char*menu = "\rMenu Selection: \n\rP - Party Mode\n\rC - Change Background 
 					Color\n\rE - Erase Terminal Window\n\rL - Flash LED\n\rF 
-					- Flood Character\n\rM - Print the Menu\n\rQ - Quit this 
-					program\n\r";
+					- Throughput Benchmark\n\rM - Print the Menu\n\rU - UART 
+					Statistics\n\rT - Graphics Statistics\n\rQ - Quit this program\n\r";
     putString(menu, UART0_BASE);
 }
 
+//*******************************************************************************
+//
+// Prints the UART0 transmit counters: bytes sent straight to the FIFO,
+// deferred to the ring, and dropped, plus the deepest the ring has been.
+//
+//*******************************************************************************
+void printUARTStats(void) {
+    tUARTTxStats sStats;
+    char str[96];
+	
+    UARTTxStatsGet(&g_sUART0Tx, &sStats);
+    sprintf(str, "\n\rUART0 TX sent: %lu deferred: %lu dropped: %lu peak: %lu\n\r",
+            (unsigned long)sStats.ui32Accepted, (unsigned long)sStats.ui32Deferred,
+            (unsigned long)sStats.ui32Overflow, (unsigned long)sStats.ui32HighWater);
+    putString(str);
+}
+
+//*******************************************************************************
+//
+// Prints the pixels the OLED framebuffer sent by the last flush and on
+// average, how often the banner text came from the text cache and how many
+// font engine cycles that avoided, and how many context state changes were
+// skipped because the state was already set.
+//
+//*******************************************************************************
+void printGraphicsStats(void) {
+    char str[96];
+	
+    sprintf(str, "\n\rOLED px last flush: %lu avg: %lu flushes: %lu\n\r",
+            (unsigned long)g_sFrameBuf.ui32Pixels,
+            (unsigned long)(g_sFrameBuf.ui32Frames ?
+                            g_sFrameBuf.ui32Total / g_sFrameBuf.ui32Frames : 0),
+            (unsigned long)g_sFrameBuf.ui32Frames);
+    putString(str);
+    sprintf(str, "Text cache hits: %lu misses: %lu uncached: %lu\n\r",
+            (unsigned long)g_sStrCache.ui32Hits, (unsigned long)g_sStrCache.ui32Misses,
+            (unsigned long)g_sStrCache.ui32Uncached);
+    putString(str);
+    sprintf(str, "Cycles saved: %lu, %lu strings in %lu runs\n\r",
+            (unsigned long)g_sStrCache.ui32Saved,
+            (unsigned long)g_sStrCache.ui32NumEntries,
+            (unsigned long)g_sStrCache.ui32NumRuns);
+    putString(str);
+    sprintf(str, "Color translations: %lu avoided: %lu\n\r",
+            (unsigned long)g_sGrState.ui32Translated,
+            (unsigned long)g_sGrState.ui32Hits);
+    putString(str);
+}
+
+//*******************************************************************************
+//
+// Streams the benchmark pattern through the blocking, interrupt and uDMA
+// transmit backends in turn, ui32Ms each, and reports the throughput, the
+// share of the CPU each one used and how often it stalled on a full FIFO
+// or ring, on the terminal and the OLED.
+//
+//*******************************************************************************
+void runBenchmark(tContext *psContext, uint32_t ui32Ms) {
+    tUARTBenchResult psResult[UART_BENCH_NUM_BACKENDS];
+    tRectangle sRect;
+    char str[80];
+    uint32_t i;
+	
+    if(ui32Ms > UART_BENCH_MAX_MS) {
+        ui32Ms = UART_BENCH_MAX_MS;
+    }
+    sprintf(str, "\n\r%lu ms per backend...\n\r", (unsigned long)ui32Ms);
+    putString(str);
+	
+    for(i = 0; i < UART_BENCH_NUM_BACKENDS; i++) {
+        UARTBenchRun(&g_sUART0Tx, &g_sUART0DMA, i, SysCtlClockGet(), ui32Ms,
+                     g_pui8BenchPattern, sizeof(g_pui8BenchPattern),
+                     &psResult[i]);
+    }
+	
+	// Results go out after all three runs so they do not land in the middle
+	// of the flood.
+    sRect.i16XMin = 0;
+    sRect.i16YMin = 10;
+    sRect.i16XMax = GrContextDpyWidthGet(psContext) - 1;
+    sRect.i16YMax = GrContextDpyHeightGet(psContext) - 1;
+    GrContextForegroundSet(psContext, ClrBlack);
+    GrRectFill(psContext, &sRect);
+    GrContextForegroundSet(psContext, ClrWhite);
+    GrContextFontSet(psContext, g_psFontFixed6x8);
+    putString("\n\rBackend     bytes/s  CPU%  stalls\n\r");
+    for(i = 0; i < UART_BENCH_NUM_BACKENDS; i++) {
+        sprintf(str, "%-10s %8lu  %4lu  %6lu\n\r", UARTBenchName(i),
+                (unsigned long)psResult[i].ui32BytesPerSec,
+                (unsigned long)psResult[i].ui32CPUPercent,
+                (unsigned long)psResult[i].ui32Stalls);
+        putString(str);
+        sprintf(str, "%c %6lu %3lu%%", UARTBenchName(i)[0],
+                (unsigned long)psResult[i].ui32BytesPerSec,
+                (unsigned long)psResult[i].ui32CPUPercent);
+        GrStringDraw(psContext, str, -1, 4, 20 + (i * 12), false);
+    }
+}
+
 //*******************************************************************************
 //
 // Blinky LED "heartbeat" function.
@@ -38,6 +38,7 @@
 #include <string.h>				// Header file for the use and 
 						// manipulation of strings
 #include "inc/hw_memmap.h" 			// Header file for BASE call use
+#include "driverlib/pin_map.h"			// UART1 pin assignments
 #include "driverlib/debug.h"		        // TM4C123G debugging header 
                                                 // file
 #include "driverlib/gpio.h"			// Header file for all GPIO 
@@ -51,15 +52,56 @@
                                                 // dimension specifications
 #include "drivers/buttons.h" 		        // Header file for push-buttons 
                                                 // counter
+#include "inc/hw_ints.h"			// Header file for interrupt
+                                                // assignments
+#include "driverlib/interrupt.h"		// Header file for interrupt
+                                                // controller calls
+#include "../Common/uarttx.h"			// Interrupt-driven UART
+                                                // transmit ring buffer
+#include "../Common/telemetry.h"		// Binary framed telemetry
+#include "../Common/cyccnt.h"			// Cycle counter timestamps
+#include "../Common/uartdma.h"			// uDMA bulk UART transmit
+#include "../Common/uartbench.h"		// UART throughput benchmark
+#include "driverlib/udma.h"			// uDMA channel assignments
+#include "../Common/vtdash.h"			// Incremental VT100 dashboard
+#include "../Common/uartrx.h"			// Interrupt-driven UART receive
+#include "../Common/framebuf.h"			// Off-screen OLED framebuffer
+#include "../Common/bargauge.h"			// Incremental pot bar gauges
+#include "../Common/strcache.h"			// Pre-rendered banner text
+#include "../Common/framesched.h"		// Timer-paced animation frames
+#include "../Common/sprite.h"			// Framebuffer sprites
+#include "../Common/grstate.h"			// Caches translated colors
+#include "driverlib/timer.h"			// Frame scheduler timer
+#include "../Common/readout.h"			// Digit tile numeric readouts
+#include "../Common/stripchart.h"		// Sweeping pot strip chart
 #define LEDon 20000                             // defines the on period of the 
                                                 // LED in ms
 #define LEDoff 380000                           // defines the off period of the
                                                 // LED in ms
-#define refreshRate 60000			// The refresh rate for splash
-                                                // screen output
+#define SPLASH_FPS 30                           // Frame rate of the splash
+                                                // screen animation
+#define BALL_SPEED 60                           // Splash ball speed in pixels
+                                                // per second
+#define BALL_JUMP_MS 360                        // Time for one hop of the
+                                                // splash ball
+#define UART0_TX_BUF_SIZE 512                   // Size of the UART0 transmit
+                                                // ring, a power of two
+#define UART0_RX_BUF_SIZE 256                   // Size of the UART0 receive
+                                                // ring, a power of two
+#define UART1_TX_BUF_SIZE 2048                  // Size of the UART1 data port
+                                                // ring, a power of two
+#define DATA_PORT_BAUD 1000000                  // UART1 rate, exact at 16MHz
+#define ADC_CHANNELS 3                          // Pot channels in sequence 1
+#define TELEM_BATCH 8                           // Readings per telemetry frame
+#define BENCH_PATTERN_SIZE 256                  // Bytes sent per benchmark write
+#define BENCH_DEFAULT_MS 1000                   // Benchmark time per backend
+#define DASH_UPDATE_HZ 2                        // Dashboard refreshes a second
+#define CHART_SAMPLE_HZ 1000                    // Strip chart columns a second
+#define PARTY_INDEX 15                          // Palette entry party mode
+                                                // recolors
 
 // ADC data display type
-typedef enum {off, numeric, histogram, terminator} displayType;
+typedef enum {off, numeric, histogram, chart, terminator} displayType;
 
 //******************************************************************************
 //
@@ -69,6 +111,10 @@ typedef enum {off, numeric, histogram, terminator} displayType;
 void putString(char *str);
 void clear();
 void printMenu();
+void printUARTStats(void);
+void printGraphicsStats(void);
+void sendTelemetry(const uint32_t *pui32Sample);
+void runBenchmark(tContext *psContext, uint32_t ui32Ms);
 void blinky(volatile uint32_t ui32Loop);
 void InitConsole(void);
 
@@ -98,6 +144,166 @@ void __error__(char *pcFilename, uint32_t ui32Line) {
 //*****************************************************************************
 static uint8_t g_ui8ButtonStates = ALL_BUTTONS;
 
+//*****************************************************************************
+//
+// UART0 transmit ring.  Output is queued here and sent by the TX FIFO
+// interrupt so the main loop does not wait on the serial line.
+//
+//*****************************************************************************
+static uint8_t g_pui8UART0TxBuf[UART0_TX_BUF_SIZE];
+static tUARTTx g_sUART0Tx;
+
+//*****************************************************************************
+//
+// UART0 receive ring, filled by the RX interrupt.  Its counters show input
+// lost to overruns or line errors, and go out with the telemetry stream.
+//
+//*****************************************************************************
+static uint8_t g_pui8UART0RxBuf[UART0_RX_BUF_SIZE];
+static tUARTRx g_sUART0Rx;
+
+//*****************************************************************************
+//
+// UART1 data port on PC4/PC5.  It carries only framed binary data, so bulk
+// streams never queue behind, or in front of, the operator's keystrokes.
+// Telemetry goes to whichever port g_psTelemTx points at.
+//
+//*****************************************************************************
+static uint8_t g_pui8UART1TxBuf[UART1_TX_BUF_SIZE];
+static tUARTTx g_sUART1Tx;
+static tUARTTx *g_psTelemTx = &g_sUART0Tx;
+
+//*****************************************************************************
+//
+// Binary ADC telemetry.  Readings are collected TELEM_BATCH at a time so one
+// header, sequence number and timestamp covers the whole batch.
+//
+//*****************************************************************************
+static tTelemetry g_sTelemetry;
+static uint32_t g_pui32TelemBatch[TELEM_BATCH * ADC_CHANNELS];
+static uint32_t g_ui32TelemCount;
+static uint32_t g_ui32TelemStamp;
+static uint32_t g_ui32TelemSkipped;             // Frames the ring had no room for
+static uint32_t g_ui32RxStatsStamp;             // When receive stats last went out
+
+//*****************************************************************************
+//
+// uDMA channel for UART0 transmit and the pattern the throughput benchmark
+// sends through each backend.
+//
+//*****************************************************************************
+static tUARTDMA g_sUART0DMA;
+static uint8_t g_pui8BenchPattern[BENCH_PATTERN_SIZE];
+
+//*****************************************************************************
+//
+// Terminal dashboard of the loop count and the three pots.  The labels are
+// drawn once and only values that changed are rewritten.
+//
+//*****************************************************************************
+static const tVTDashField g_psDashFields[] = {
+  {2, 1, 10, 0, "Loop: ", 0, 0},
+  {3, 1, 4, 0, "ADC0: ", 0, 0},
+  {3, 14, 4, 0, "ADC1: ", 0, 0},
+  {3, 27, 4, 0, "ADC2: ", 0, 0},
+  {4, 1, 4, 0, "OLED px/flush: ", 0, 0},
+  {4, 21, 4, 0, "avg: ", 0, 0},
+};
+#define NUM_DASH_FIELDS (sizeof(g_psDashFields) / sizeof(g_psDashFields[0]))
+static tVTDash g_sDash;
+
+//*****************************************************************************
+//
+// Off-screen copy of the OLED.  Everything is drawn here and GrFlush() sends
+// only the regions that changed, so redrawing the pot rows every loop costs
+// nothing while the pots are still.  The lab draws in only a few colors, so
+// each pixel is a 4-bit palette index: 3 KB instead of 12 KB.
+//
+//*****************************************************************************
+static tFrameBuf g_sFrameBuf;
+static uint8_t g_pui8FramePixels[FRAMEBUF_INDEXED_BYTES];
+
+//*****************************************************************************
+//
+// Colors party mode cycles through.  They are swapped into palette entry
+// PARTY_INDEX in turn, so the screen is painted once and each later color
+// costs only a flush.
+//
+//*****************************************************************************
+static const uint32_t g_pui32PartyColors[3] = {
+  ClrDarkBlue, ClrRed, ClrGreen
+};
+
+//*****************************************************************************
+//
+// Histogram bars for the three pots, one 16 pixel row each.  Each gauge
+// paints only the strip between its old and new length.
+//
+//*****************************************************************************
+static tBarGauge g_psBars[ADC_CHANNELS];
+static const uint32_t g_pui32BarColors[ADC_CHANNELS] = {
+  ClrRed, ClrGreen, ClrDarkBlue
+};
+
+//*****************************************************************************
+//
+// Numeric readouts for the same rows.  Each digit cell is redrawn only when
+// its digit changes, so a steady pot costs nothing to show.
+//
+//*****************************************************************************
+static tReadout g_psReadouts[ADC_CHANNELS];
+
+//*****************************************************************************
+//
+// What each pot row currently shows.  Anything that paints over the rows
+// sets an entry to terminator so the main loop repaints that row.
+//
+//*****************************************************************************
+static displayType g_psShown[ADC_CHANNELS];
+
+//*****************************************************************************
+//
+// Strip chart shared by every pot set to chart, over all three pot rows.
+// Timer 1 triggers ADC0 sequence 2 at CHART_SAMPLE_HZ and each sample is
+// queued from its interrupt, so the chart runs at that rate whatever the
+// main loop is doing.
+//
+//*****************************************************************************
+static tStripChart g_sChart;
+
+//*****************************************************************************
+//
+// Banner and goodbye text, rendered through the font engine once and then
+// drawn from runs, so party mode does not decode the banner every loop.
+//
+//*****************************************************************************
+static tStrCache g_sStrCache;
+
+//*****************************************************************************
+//
+// Paces the splash animation.  Timer 0 marks each frame deadline and the
+// ball moves by the time that passed, so the splash runs the same at any
+// clock speed however long a frame takes to draw.
+//
+//*****************************************************************************
+static tFrameSched g_sFrameSched;
+
+//*****************************************************************************
+//
+// The splash screen ball.  Its image is built once, and each move rewrites
+// only the box it left and the box it moved to.
+//
+//*****************************************************************************
+static tSprite g_sBall;
+
+//*****************************************************************************
+//
+// Colors and font of the OLED context.  The loop sets them before every
+// draw; each color is run through the display's translation only once.
+//
+//*****************************************************************************
+static tGrState g_sGrState;
+
 //*****************************************************************************
 //
 // Initializes the GPIO pins used by the board pushbuttons with a weak 
@@ -126,19 +332,68 @@ void ButtonsInit(void) {
 
 //*****************************************************************************
 //
-// Send a string to the UART.
+// Send a buffer to the UART.  Fills the TX FIFO up to its free level and
+// queues the rest in the transmit ring, so nothing past the 16 byte FIFO is
+// silently lost.  Returns the number of bytes accepted; the shortfall, if
+// any, shows up in the dropped count of printUARTStats().
 //
 //*****************************************************************************
-void UARTSend(const uint8_t *pui8Buffer, uint32_t ui32Count) {
-  //
-  // Loop while there are more characters to send.
-  //
-  while(ui32Count--) {
-    //
-    // Write the next character to the UART.
-    //
-    UARTCharPutNonBlocking(UART0_BASE, *pui8Buffer++);
-  }
+uint32_t UARTSend(const uint8_t *pui8Buffer, uint32_t ui32Count) {
+  return(UARTTxSend(&g_sUART0Tx, pui8Buffer, ui32Count, true));
+}
+
+//*****************************************************************************
+//
+// The UART interrupt handler.  Refills the TX FIFO from the transmit ring
+// and moves received bytes into the receive ring.
+//
+//*****************************************************************************
+void UARTIntHandler(void) {
+  uint32_t ui32Status;
+  
+  ui32Status = UARTIntStatus(UART0_BASE, true);  // Get the interrupt status.
+  UARTIntClear(UART0_BASE, ui32Status);         // Clear the asserted
+                                                // interrupts.
+  UARTTxIntHandler(&g_sUART0Tx);
+  UARTDMAIntHandler(&g_sUART0DMA);
+  UARTRxIntHandler(&g_sUART0Rx);
+}
+
+//*****************************************************************************
+//
+// The UART1 interrupt handler.  Refills the data port TX FIFO from its ring.
+//
+//*****************************************************************************
+void UART1IntHandler(void) {
+  uint32_t ui32Status;
+  
+  ui32Status = UARTIntStatus(UART1_BASE, true);  // Get the interrupt status.
+  UARTIntClear(UART1_BASE, ui32Status);         // Clear the asserted
+                                                // interrupts.
+  UARTTxIntHandler(&g_sUART1Tx);
+}
+
+//*****************************************************************************
+//
+// The Timer 0 interrupt handler.  Marks a splash frame deadline.
+//
+//*****************************************************************************
+void Timer0IntHandler(void) {
+  FrameSchedIntHandler(&g_sFrameSched);
+}
+
+//*****************************************************************************
+//
+// The ADC0 sequence 2 interrupt handler.  Queues a timed pot sample for the
+// strip chart.
+//
+//*****************************************************************************
+void ADC0SS2IntHandler(void) {
+  uint32_t pui32Sample[4];
+  
+  ADCIntClear(ADC0_BASE, 2);
+  ADCSequenceDataGet(ADC0_BASE, 2, pui32Sample);
+  StripChartSample(&g_sChart, pui32Sample);
 }
 
 //*****************************************************************************
@@ -155,8 +410,14 @@ int main(void) {
 						// recieved by the UART 
   volatile uint32_t ui32Loop;		        // Blinky LED volatile	
 						// loop.
-  bool shouldFlood = false;			// "Flood" character toggle
+  bool benchEntry = false;			// Reading a benchmark duration
+  uint32_t benchMs = 0;				// Benchmark duration typed so far
   bool shouldBlink = true;			// LED blinky toggle
+  bool shouldStream = false;			// Binary telemetry toggle
+  bool consoleBusy = false;			// Telemetry is using UART0
+  uint8_t rxByte;				// Byte taken from the RX ring
+  uint32_t i;					// Index over the pot channels
+  uint32_t chartTraces = 0;			// Pots shown on the strip chart
   
   // positional information useed to animate the splash screen
   int16_t xValLast = 0;                         
@@ -166,18 +427,21 @@ int main(void) {
 
   volatile int16_t val[3];                      // volatile variable to store
                                                 // potentiometer data
-  volatile uint32_t uiLoop;			// refresh rate increment
-                                                // variable
+  int32_t xMilli = 0;                           // Ball position in 1/1000
+                                                // pixels
+  uint32_t jumpUs = 0;                          // Time into the current hop
+  uint32_t jumpMs;                              // Same, in milliseconds
+  uint32_t frameUs = 1000000 / SPLASH_FPS;      // Time since the last frame
   
   //*************************************************************************
   // Counter variables
   //*************************************************************************
-  int tickCount = 0;				// Clock ticks for flood
-						// character.
   int whileLoop = 1;				// Looping through the main
                                                 // infinite while loop
   int colorSwitch = 0;				// OLED Color toggle
   int shouldCycle = 0;				// Boolean for Party Mode
+  bool partyDrawn = false;			// Screen is painted in the
+						// party palette entry
   uint32_t buttonState = 0;			// Boolean to check if a
 						// button was pressed.
   int buttonCounter = 0;			// Counting how many times 
@@ -222,6 +486,16 @@ int main(void) {
   // Since sample sequence 1 is now configured, it must be enabled.
   ADCSequenceEnable(ADC0_BASE, 1);
   
+  // Sequence 2 samples the same channels for the strip chart, triggered by
+  // Timer 1 and read in its interrupt handler.
+  ADCSequenceConfigure(ADC0_BASE, 2, ADC_TRIGGER_TIMER, 1);
+  ADCSequenceStepConfigure(ADC0_BASE, 2, 0, ADC_CTL_CH4);
+  ADCSequenceStepConfigure(ADC0_BASE, 2, 1, ADC_CTL_CH5);
+  ADCSequenceStepConfigure(ADC0_BASE, 2, 2, ADC_CTL_CH6 | ADC_CTL_IE |
+                           ADC_CTL_END);
+  ADCSequenceEnable(ADC0_BASE, 2);
+  ADCIntEnable(ADC0_BASE, 2);
+  
   //*************************************************************************
   //
   // Set the clocking to run directly from the crystal.
@@ -261,13 +535,17 @@ int main(void) {
   //
   //*************************************************************************
   CFAL96x64x16Init();
+  FrameBufInitIndexed(&g_sFrameBuf, &g_sCFAL96x64x16, g_pui8FramePixels);
+  FrameBufPaletteSet(&g_sFrameBuf, PARTY_INDEX, g_pui32PartyColors[0]);
   
   //*************************************************************************
   //
   // Initialize the OLED graphics context.
   //
   //*************************************************************************
-  GrContextInit(&sContext, &g_sCFAL96x64x16);
+  GrContextInit(&sContext, &g_sFrameBuf.sDisplay);
+  GrStateInit(&g_sGrState, &sContext);
+  StrCacheInit(&g_sStrCache);
   
   
   //*************************************************************************
@@ -295,6 +573,44 @@ int main(void) {
                       (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
                        UART_CONFIG_PAR_NONE));
   
+  //*************************************************************************
+  //
+  // Queue UART output in a ring drained by the TX FIFO interrupt.
+  //
+  //*************************************************************************
+  UARTTxInit(&g_sUART0Tx, UART0_BASE, g_pui8UART0TxBuf,
+             sizeof(g_pui8UART0TxBuf));
+  UARTDMAInit(&g_sUART0DMA, &g_sUART0Tx, UDMA_CH9_UART0TX);
+  UARTRxInit(&g_sUART0Rx, UART0_BASE, g_pui8UART0RxBuf,
+             sizeof(g_pui8UART0RxBuf));
+  UARTBenchPatternFill(g_pui8BenchPattern, sizeof(g_pui8BenchPattern));
+  IntEnable(INT_UART0);
+  
+  //*************************************************************************
+  //
+  // UART1 data port on PC4 (RX) and PC5 (TX), transmit only, with its own
+  // ring.
+  //
+  //*************************************************************************
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_UART1);
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOC);
+  while(!SysCtlPeripheralReady(SYSCTL_PERIPH_GPIOC)) {
+  }
+  GPIOPinConfigure(GPIO_PC4_U1RX);
+  GPIOPinConfigure(GPIO_PC5_U1TX);
+  GPIOPinTypeUART(GPIO_PORTC_BASE, GPIO_PIN_4 | GPIO_PIN_5);
+  UARTConfigSetExpClk(UART1_BASE, SysCtlClockGet(), DATA_PORT_BAUD,
+                      (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
+                       UART_CONFIG_PAR_NONE));
+  UARTTxInit(&g_sUART1Tx, UART1_BASE, g_pui8UART1TxBuf,
+             sizeof(g_pui8UART1TxBuf));
+  IntEnable(INT_UART1);
+  IntMasterEnable();
+  TelemetryInit(&g_sTelemetry);
+  CycleCounterInit();
+  VTDashInit(&g_sDash, &g_sUART0Tx, g_psDashFields, NUM_DASH_FIELDS,
+             SysCtlClockGet() / DASH_UPDATE_HZ);
+  
   
   //*************************************************************************
   //
@@ -329,16 +645,31 @@ int main(void) {
   sRect.i16YMin = 0;				
   sRect.i16XMax = GrContextDpyWidthGet(&sContext);	
   sRect.i16YMax = GrContextDpyHeightGet(&sContext);
-  GrContextForegroundSet(&sContext, ClrBlack);  // Set the banner color to
+  GrStateForegroundSet(&g_sGrState, ClrBlack);  // Set the banner color to
                                                 // dark blue.
   GrRectFill(&sContext, &sRect);		// Output the dimensions and
                                                 // fill the OLED with the 
                                                 // banner.
   
-  int jumpTick = -1;                            // Keeps track of splash screen
-                                                // ball location in cycle.
   int Rad = 5;                                  // Radius of the ball in pixels.
   int color = 0;                                // Color variable for the ball.
+  int16_t xWiped = -1;                          // Last column wiped black in
+                                                // the final pass.
+  
+  SpriteInit(&g_sBall, &g_sFrameBuf);
+  SpriteCircle(&g_sBall, Rad, ClrWhite);
+  GrStateFontSet(&g_sGrState, g_psFontCm12/*g_psFontFixed6x8*/);  
+  
+  //*************************************************************************
+  //
+  // Start Timer 0 marking splash frame deadlines.
+  //
+  //*************************************************************************
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
+  while(!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER0)) {
+  }
+  FrameSchedInit(&g_sFrameSched, TIMER0_BASE, SysCtlClockGet(), SPLASH_FPS);
+  IntEnable(INT_TIMER0A);
   
   //*************************************************************************
   //
@@ -350,49 +681,57 @@ int main(void) {
     // Reading the state of the button.
     buttonState = (GPIOPinRead(BUTTONS_GPIO_BASE,ALL_BUTTONS));
     // The button codes are : 30-UP, 29-DOWN, 27-LEFT, 23-RIGHT, and 15-SELECT
-    xVal+=2;
-    if(jumpTick == -1) {
-      jumpTick = 0;
-    }
     
-    if(jumpTick != -1) {
-      yVal = 38 - (10*jumpTick-jumpTick*jumpTick);
-      jumpTick++;
-      if(jumpTick > 10) {
-        jumpTick = -1;
-      }
-    }
+    // Move the ball by the time the last frame really took, so it crosses
+    // the screen at BALL_SPEED whatever the clock.  Each hop is the same
+    // parabola as before, 25 pixels high, spread over BALL_JUMP_MS.
+    xMilli += (BALL_SPEED * (int32_t)frameUs) / 1000;
+    xVal = xMilli / 1000;
+    jumpUs = (jumpUs + frameUs) % (BALL_JUMP_MS * 1000);
+    jumpMs = jumpUs / 1000;
+    yVal = 38 - (int32_t)((100 * jumpMs * (BALL_JUMP_MS - jumpMs)) /
+                          (BALL_JUMP_MS * BALL_JUMP_MS));
 	
-    GrContextInit(&sContext, &g_sCFAL96x64x16);	// Resets OLED output context.
+    // Take the ball off the screen, putting back what it covered, so the
+    // trail can be drawn behind it.
+    SpriteHide(&g_sBall);
     
     // Switch case for the color of an output to the OLED.
     // Key: 0-Blue, 1-Red, 2-Green, 3-Black
     switch(color) {
     case 0:
-      GrContextForegroundSet(&sContext, ClrBlue);
+      GrStateForegroundSet(&g_sGrState, ClrBlue);
       break;
     case 1:
-      GrContextForegroundSet(&sContext, ClrRed);
+      GrStateForegroundSet(&g_sGrState, ClrRed);
       break;
     case 2:
-      GrContextForegroundSet(&sContext, ClrGreen);
+      GrStateForegroundSet(&g_sGrState, ClrGreen);
       break;
     case 3:
-      GrContextForegroundSet(&sContext, ClrBlack);
-      // Resetting the parameters of the OELD window
-      sRect.i16XMin = 0;			
-      sRect.i16YMin = 0;			
-      sRect.i16XMax = xVal;
-      sRect.i16YMax = GrContextDpyHeightGet(&sContext);
-      GrRectFill(&sContext, &sRect);
+      GrStateForegroundSet(&g_sGrState, ClrBlack);
+      // Wipe only the columns the ball has passed since the last frame;
+      // everything left of them is black already.
+      if(xVal > xWiped) {
+        sRect.i16XMin = xWiped + 1;
+        sRect.i16YMin = 0;
+        sRect.i16XMax = xVal;
+        sRect.i16YMax = GrContextDpyHeightGet(&sContext);
+        GrRectFill(&sContext, &sRect);
+        xWiped = xVal;
+      }
       break;
     } 
 	
-    // Filling in the splash screen ball OLED output
+    // Filling in the trail where the ball was, then putting the ball back
+    // at its new position.
     GrCircleFill(&sContext, xValLast,yValLast, Rad);
-    GrContextForegroundSet(&sContext, ClrWhite); 
-    GrCircleFill(&sContext, xVal,yVal, Rad);
-    GrContextFontSet(&sContext, g_psFontCm12/*g_psFontFixed6x8*/);  
+    SpriteShow(&g_sBall, xVal, yVal);
+    
+    // The framebuffer is the back buffer.  Wait for the frame deadline,
+    // then send the finished frame, so the panel only ever shows whole
+    // frames and gets them at a steady rate.
+    frameUs = FrameSchedWait(&g_sFrameSched);
     GrFlush(&sContext);
     xValLast = xVal;
     yValLast = yVal;
@@ -401,7 +740,7 @@ int main(void) {
                                                 // parameters, then go back to
                                                 // start of screen and change
                                                 // ball color.
-      xVal = -13;
+      xMilli = -13000;
       color++;
     }
     
@@ -409,12 +748,8 @@ int main(void) {
     if(color == 4) {
       break;
     }
-    
-    // Waiting for refresh rate to be met so that the splash screen does not 
-    // go through too fast or too slow. 
-    for(uiLoop = 0; uiLoop < refreshRate; uiLoop++) {
-    }
   }
+  FrameSchedStop(&g_sFrameSched);
   
   //*************************************************************************
   //
@@ -426,7 +761,7 @@ int main(void) {
   sRect.i16YMin = 0;						
   sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;	
   sRect.i16YMax = 9;						
-  GrContextForegroundSet(&sContext, ClrDarkBlue);		
+  GrStateForegroundSet(&g_sGrState, ClrDarkBlue);		
   GrRectFill(&sContext, &sRect);	
   
   //*************************************************************************
@@ -434,16 +769,16 @@ int main(void) {
   // Change foreground for white text.
   //
   //*************************************************************************
-  GrContextForegroundSet(&sContext, ClrWhite);
+  GrStateForegroundSet(&g_sGrState, ClrWhite);
   
   //*************************************************************************
   //
   // Put the application name in the middle of the banner.
   //
   //*************************************************************************
-  GrContextFontSet(&sContext, g_psFontFixed6x8);
-  GrStringDrawCentered(&sContext, "Gray & Pietz", -1,
-                       GrContextDpyWidthGet(&sContext) / 2, 4, 0);
+  GrStateFontSet(&g_sGrState, g_psFontFixed6x8);
+  StrCacheDrawCentered(&g_sStrCache, &sContext, "Gray & Pietz",
+                       GrContextDpyWidthGet(&sContext) / 2, 4, false);
   
   //*************************************************************************
   //
@@ -457,6 +792,38 @@ int main(void) {
   aDisp[0] = off;
   aDisp[1] = off;
   aDisp[2] = off;
+  for(i = 0; i < ADC_CHANNELS; i++) {
+    sRect.i16XMin = 0;
+    sRect.i16YMin = 16 + (i * 16);
+    sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
+    sRect.i16YMax = 31 + (i * 16);
+    BarGaugeInit(&g_psBars[i], &sRect, g_pui32BarColors[i], ClrBlack);
+    ReadoutInit(&g_psReadouts[i], &g_sFrameBuf.sDisplay,
+                (GrContextDpyWidthGet(&sContext) -
+                 (4 * READOUT_CELL_WIDTH)) / 2,
+                20 + (i * 16), 4, ClrWhite, ClrBlack);
+    g_psShown[i] = terminator;
+  }
+  sRect.i16XMin = 0;
+  sRect.i16YMin = 16;
+  sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
+  sRect.i16YMax = GrContextDpyHeightGet(&sContext) - 1;
+  StripChartInit(&g_sChart, &g_sFrameBuf.sDisplay, &sRect, ADC_CHANNELS,
+                 g_pui32BarColors, ClrBlack, ClrDimGray, 4095);
+  
+  //*************************************************************************
+  //
+  // Timer 1 paces the strip chart samples.  It only runs while the chart
+  // is on the screen.
+  //
+  //*************************************************************************
+  SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER1);
+  while(!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER1)) {
+  }
+  TimerConfigure(TIMER1_BASE, TIMER_CFG_PERIODIC);
+  TimerLoadSet(TIMER1_BASE, TIMER_A, (SysCtlClockGet() / CHART_SAMPLE_HZ) - 1);
+  TimerControlTrigger(TIMER1_BASE, TIMER_A, true);
+  IntEnable(INT_ADC0SS2);
   
   //*************************************************************************
   //
@@ -471,11 +838,14 @@ int main(void) {
     ADCIntClear(ADC0_BASE,1);                   // Clear the input port.
     // Getting the values from the port.
     ADCSequenceDataGet(ADC0_BASE, 1, pui32ADC0Value);
+    if(shouldStream) {
+      sendTelemetry(pui32ADC0Value);
+    }
+    consoleBusy = shouldStream && (g_psTelemTx == &g_sUART0Tx);
     
     // Variable incrementations for every loop iteration.
     Looper++;
     whileLoop++;
-    tickCount++;
     
     //*************************************************************************
     //
@@ -489,22 +859,31 @@ int main(void) {
     
     //*************************************************************************
     //
-    // Flood character output character and timing.
+    // Terminal dashboard.  Only the values that changed go out, at most
+    // DASH_UPDATE_HZ times a second, and never into the middle of a
+    // telemetry stream on the console.
     //
     //*************************************************************************
-    if(tickCount == 3) {
-      tickCount = 0;
-      if(shouldFlood == 1) {
-        UARTCharPut(UART0_BASE, '@');
-      }
+    if(g_sDash.bActive && !consoleBusy) {
+      VTDashSet(&g_sDash, 0, Looper);
+      VTDashSet(&g_sDash, 1, pui32ADC0Value[0]);
+      VTDashSet(&g_sDash, 2, pui32ADC0Value[1]);
+      VTDashSet(&g_sDash, 3, pui32ADC0Value[2]);
+      VTDashSet(&g_sDash, 4, g_sFrameBuf.ui32Pixels);
+      VTDashSet(&g_sDash, 5, g_sFrameBuf.ui32Frames ?
+                g_sFrameBuf.ui32Total / g_sFrameBuf.ui32Frames : 0);
+      VTDashUpdate(&g_sDash, CycleCounterGet());
     }
     
     //*************************************************************************
     //
-    // Blinky function toggle.
+    // Blinky function toggle.  The blink delay is skipped while streaming
+    // so the ADC is sampled as fast as the loop can go, and while the strip
+    // chart is up, as its samples would pile up in the queue for the whole
+    // 150-250 ms of the delay.  chartTraces is from the last pass.
     //
     //*************************************************************************
-    if(shouldBlink) {
+    if(shouldBlink && !shouldStream && (chartTraces == 0)) {
       blinky(ui32Loop);
     }
     
@@ -548,40 +927,32 @@ int main(void) {
         colorSwitch = -1;	
       }
       
-      // Setting OLED display as full avaliable rectangle output.
       colorSwitch++;
-      sRect.i16XMin = 0;
-      sRect.i16YMin = 0;
-      sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
-      sRect.i16YMax = GrContextDpyHeightGet(&sContext) - 1;
       
-      // Switch case to determine the next OLED color output.
-      switch (colorSwitch) {
-      case 0:								
-        GrContextForegroundSet(&sContext, ClrDarkBlue);
-        GrContextBackgroundSet(&sContext, ClrDarkBlue);
-        break;
-      case 1:								
-        GrContextForegroundSet(&sContext, ClrRed);
-        GrContextBackgroundSet(&sContext, ClrRed);
-        break;
-      case 2:							
-        GrContextForegroundSet(&sContext, ClrGreen);
-        GrContextBackgroundSet(&sContext, ClrGreen);
-        break;
-      default:								
-        GrContextForegroundSet(&sContext, ClrDarkBlue);
-        GrContextBackgroundSet(&sContext, ClrDarkBlue);
-        break;
+      // Paint the whole OLED in the party palette entry, with the banner
+      // message on top, once.  The pot rows have to be drawn again too.
+      if(!partyDrawn) {
+        sRect.i16XMin = 0;
+        sRect.i16YMin = 0;
+        sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
+        sRect.i16YMax = GrContextDpyHeightGet(&sContext) - 1;
+        GrStateForegroundSet(&g_sGrState, FRAMEBUF_INDEX(PARTY_INDEX));
+        GrStateBackgroundSet(&g_sGrState, FRAMEBUF_INDEX(PARTY_INDEX));
+        GrRectFill(&sContext, &sRect);
+        for(i = 0; i < ADC_CHANNELS; i++) {
+          g_psShown[i] = terminator;
+        }
+        GrStateForegroundSet(&g_sGrState, ClrWhite);
+        GrStateFontSet(&g_sGrState, g_psFontFixed6x8);
+        StrCacheDrawCentered(&g_sStrCache, &sContext, "Gray & Pietz",
+                             GrContextDpyWidthGet(&sContext) / 2, 4, false);
+        partyDrawn = true;
       }
       
-      // Re-draw the OLED rectangular output with above determined color
-      // and correct banner message.
-      GrRectFill(&sContext, &sRect);
-      GrContextForegroundSet(&sContext, ClrWhite);
-      GrContextFontSet(&sContext, g_psFontFixed6x8);
-      GrStringDrawCentered(&sContext, "Gray & Pietz", -1,
-                           GrContextDpyWidthGet(&sContext) / 2, 4, 0);
+      // Every later color is just a palette swap; the flush resends the
+      // pixels drawn in the party entry.
+      FrameBufPaletteSet(&g_sFrameBuf, PARTY_INDEX,
+                         g_pui32PartyColors[colorSwitch]);
     }                                           // end shouldCycle()
     
     //*************************************************************************
@@ -589,7 +960,7 @@ int main(void) {
     // While loop when a character is inputted in the PuTTY window.
     //
     //*************************************************************************
-    while(UARTCharsAvail(UART0_BASE)) {
+    while(UARTRxRead(&g_sUART0Rx, &rxByte, 1) != 0) {
       char str[50];				// Empty string declaration for
                                                 // sprintf functions.
       int32_t local_char;			// Setting the input character
@@ -600,7 +971,7 @@ int main(void) {
       // Re-draw the OLED with updated statistics
       //
       //*********************************************************************
-      local_char = UARTCharGetNonBlocking(UART0_BASE);
+      local_char = rxByte;
       
       //*********************************************************************
       //
@@ -608,16 +979,41 @@ int main(void) {
       // statment below through the switch statment and act accordingly to
       // the user input.
       // 
-      // Key: 67 'C' - Banner Color Switch, 69 'E' - Clear Interface Window,
-      //      70 'F' - Flood Character Toggle, 76 'L' - LED Toggle,
+      // Key: 67 'C' - Banner Color Switch, 68 'D' - Terminal Dashboard,
+      //      69 'E' - Clear Interface Window,
+      //      70 'F' - Throughput Benchmark, 71 'G' - Graphics Statistics,
+      //      76 'L' - LED Toggle,
       //      77 'M' - Reprint Menu, 80 'P' - Party Mode, 81 'Q' - Quit Program
+      //      82 'R' - Route Telemetry, 84 'T' - Binary Telemetry Toggle,
+      //      85 'U' - UART Statistics
       //
       //*********************************************************************
       if (local_char != -1) {
         gNumCharRecv++; 		        // Character input counter
-        UARTCharPut(UART0_BASE, local_char);	// Sending a single character
+        if(!consoleBusy) {
+          UARTTxPutChar(&g_sUART0Tx, local_char); // Sending a single character
                                                 // through the UART_TX 	
                                                 // (transmitting)channel
+        }
+        
+        // After 'F', digits give the benchmark time in ms and Enter starts
+        // it.  Any other key cancels.
+        if(benchEntry) {
+          if((local_char >= '0') && (local_char <= '9')) {
+            benchMs = (benchMs * 10) + (local_char - '0');
+          }
+          else {
+            benchEntry = false;
+            if(local_char == '\r') {
+              runBenchmark(&sContext, benchMs ? benchMs : BENCH_DEFAULT_MS);
+              partyDrawn = false;
+            }
+            else {
+              putString(" cancelled\n\r");
+            }
+          }
+          continue;
+        }
 
         switch(local_char) {
         case 67: 					
@@ -634,30 +1030,41 @@ int main(void) {
           sRect.i16YMax = 9;
           switch (colorSwitch) {
           case 0:
-            GrContextForegroundSet(&sContext, ClrDarkBlue);
-            GrContextBackgroundSet(&sContext, ClrDarkBlue);
+            GrStateForegroundSet(&g_sGrState, ClrDarkBlue);
+            GrStateBackgroundSet(&g_sGrState, ClrDarkBlue);
             break;
           case 1:
-            GrContextForegroundSet(&sContext, ClrRed);
-            GrContextBackgroundSet(&sContext, ClrRed);
+            GrStateForegroundSet(&g_sGrState, ClrRed);
+            GrStateBackgroundSet(&g_sGrState, ClrRed);
             break;
           case 2:
-            GrContextForegroundSet(&sContext, ClrGreen);
-            GrContextBackgroundSet(&sContext, ClrGreen);
+            GrStateForegroundSet(&g_sGrState, ClrGreen);
+            GrStateBackgroundSet(&g_sGrState, ClrGreen);
             break;
           default:
-            GrContextForegroundSet(&sContext, ClrDarkBlue);
-            GrContextBackgroundSet(&sContext, ClrDarkBlue);
+            GrStateForegroundSet(&g_sGrState, ClrDarkBlue);
+            GrStateBackgroundSet(&g_sGrState, ClrDarkBlue);
             break;
           }
           
           // Filling in the rest of the OLED screen after banner is 
           // updated.
           GrRectFill(&sContext, &sRect);
-          GrContextForegroundSet(&sContext, ClrWhite);
-          GrContextFontSet(&sContext, g_psFontFixed6x8);
-          GrStringDrawCentered(&sContext, "Gray & Pietz", -1,
-                               GrContextDpyWidthGet(&sContext) / 2, 4, 0);
+          GrStateForegroundSet(&g_sGrState, ClrWhite);
+          GrStateFontSet(&g_sGrState, g_psFontFixed6x8);
+          StrCacheDrawCentered(&g_sStrCache, &sContext, "Gray & Pietz",
+                               GrContextDpyWidthGet(&sContext) / 2, 4, false);
+          partyDrawn = false;
+          break;
+          
+        case 68:
+          if(g_sDash.bActive) {
+            VTDashStop(&g_sDash);
+            printMenu();
+          }
+          else {
+            VTDashDraw(&g_sDash, "Lab 3 - Gray & Pietz");
+          }
           break;
           
         case 69: 			
@@ -665,12 +1072,9 @@ int main(void) {
           break;
           
         case 70: 						
-          if(shouldFlood == 0) {
-            shouldFlood = 1;
-          }
-          else {
-            shouldFlood = 0;
-          }
+          putString("\n\rBenchmark ms per backend (Enter for 1000): ");
+          benchEntry = true;
+          benchMs = 0;
           break;
           
         case 76: 				
@@ -692,25 +1096,51 @@ int main(void) {
           {
             shouldCycle = 0;
           }
+          partyDrawn = false;
           break;
           
         case 81:
           putString("\n\rBYE!");		// Goodbye message to CPU 
                                                 // window.
+          UARTTxFlush(&g_sUART0Tx);             // Send it before exiting.
           
           // Re-draw OLED with goodbye statment in red font.
           sRect.i16XMin = 0;
           sRect.i16YMin = 0;
           sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
           sRect.i16YMax = GrContextDpyHeightGet(&sContext) - 1;
-          GrContextForegroundSet(&sContext, ClrBlack);
-          GrContextBackgroundSet(&sContext, ClrBlack);
+          GrStateForegroundSet(&g_sGrState, ClrBlack);
+          GrStateBackgroundSet(&g_sGrState, ClrBlack);
           GrRectFill(&sContext, &sRect);
-          GrContextForegroundSet(&sContext, ClrRed);
-          GrContextFontSet(&sContext, g_psFontFixed6x8);
-          GrStringDrawCentered(&sContext, "Goodbye", -1, GrContextDpyWidthGet(&sContext) / 2, 30, false);
+          GrStateForegroundSet(&g_sGrState, ClrRed);
+          GrStateFontSet(&g_sGrState, g_psFontFixed6x8);
+          StrCacheDrawCentered(&g_sStrCache, &sContext, "Goodbye", GrContextDpyWidthGet(&sContext) / 2, 30, false);
+          GrFlush(&sContext);
           whileLoop = 0;
           break;         
+        case 82:
+          // Switch telemetry between the console and the data port.  The
+          // batch restarts so no frame straddles the two.
+          if(g_psTelemTx == &g_sUART0Tx) {
+            g_psTelemTx = &g_sUART1Tx;
+            putString("\n\rTelemetry on UART1 data port\n\r");
+          }
+          else {
+            g_psTelemTx = &g_sUART0Tx;
+            putString("\n\rTelemetry on UART0 console\n\r");
+          }
+          g_ui32TelemCount = 0;
+          break;
+        case 84:
+          shouldStream = !shouldStream;
+          g_ui32TelemCount = 0;
+          break;
+        case 85:
+          printUARTStats();
+          break;
+        case 71:
+          printGraphicsStats();
+          break;
         case 49:
           aDisp[0]++;
           break;
@@ -729,116 +1159,60 @@ int main(void) {
     if(aDisp[0] == terminator) aDisp[0] = off;
     if(aDisp[1] == terminator) aDisp[1] = off;
     if(aDisp[2] == terminator) aDisp[2] = off;
-    char tempStr[5];
     
-    // Switch statement for ADC output 0 as a number, graph, or not displayed.
-    switch(aDisp[0]) {
-    case off:
-      sRect.i16XMin = 0;						
-      sRect.i16YMin = 16;						
-      sRect.i16XMax = GrContextDpyWidthGet(&sContext);	
-      sRect.i16YMax = 32;						
-      GrContextForegroundSet(&sContext, ClrBlack);	
-      GrRectFill(&sContext, &sRect);
-      break;    
-    case numeric:
-      sRect.i16XMin = 0;					
-      sRect.i16YMin = 16;				
-      sRect.i16XMax = GrContextDpyWidthGet(&sContext);
-      sRect.i16YMax = 32;						
-      GrContextForegroundSet(&sContext, ClrBlack);			
-      GrRectFill(&sContext, &sRect);
-      GrContextForegroundSet(&sContext, ClrWhite);
-      sprintf(tempStr,"%i",pui32ADC0Value[0]);
-      GrStringDrawCentered(&sContext, tempStr, -1,
-                           GrContextDpyWidthGet(&sContext) / 2, 24, 16);       
-      break;
-    case histogram:
-      sRect.i16XMin = 0;				
-      sRect.i16YMin = 16;					
-      sRect.i16XMax = val[0];	
-      sRect.i16YMax = 32;	
-      GrContextForegroundSet(&sContext, ClrRed);	
-      GrRectFill(&sContext, &sRect);
-      sRect.i16XMin = val[0];	
-      sRect.i16XMax = 96;					
-      GrContextForegroundSet(&sContext, ClrBlack);	
-      GrRectFill(&sContext, &sRect);
-      break;  
+    // While any pot is set to chart, the strip chart takes all three pot
+    // rows and traces every such pot in its bar color.  Each queued sample
+    // adds one column.
+    chartTraces = 0;
+    for(i = 0; i < ADC_CHANNELS; i++) {
+      if(aDisp[i] == chart) {
+        chartTraces |= 1 << i;
+      }
     }
-    
-    // Switch statment for ADC output 1 as a number, graph, or not displayed.
-    switch(aDisp[1]) {
-    case off:
-      sRect.i16XMin = 0;								
-      sRect.i16YMin = 32;
-      sRect.i16XMax = GrContextDpyWidthGet(&sContext);	
-      sRect.i16YMax = 48;						
-      GrContextForegroundSet(&sContext, ClrBlack);		
-      GrRectFill(&sContext, &sRect);
-      break;    
-    case numeric:
-      sRect.i16XMin = 0;			
-      sRect.i16YMin = 32;					
-      sRect.i16XMax = GrContextDpyWidthGet(&sContext);	
-      sRect.i16YMax = 48;						
-      GrContextForegroundSet(&sContext, ClrBlack);		
-      GrRectFill(&sContext, &sRect);
-      GrContextForegroundSet(&sContext, ClrWhite);
-      sprintf(tempStr,"%i",pui32ADC0Value[1]);
-      GrStringDrawCentered(&sContext, tempStr, -1,
-                           GrContextDpyWidthGet(&sContext) / 2, 40, 16);       
-      break;
-    case histogram:
-      sRect.i16XMin = 0;					
-      sRect.i16YMin = 32;						
-      sRect.i16XMax = val[1];
-      sRect.i16YMax = 48;						
-      GrContextForegroundSet(&sContext, ClrGreen);			
-      GrRectFill(&sContext, &sRect);
-      sRect.i16XMin = val[1];
-      sRect.i16XMax = 96;
-      GrContextForegroundSet(&sContext, ClrBlack);		
-      GrRectFill(&sContext, &sRect);
+    if(chartTraces != 0) {
+      if(g_psShown[0] != chart) {
+        StripChartClear(&g_sChart);
+        TimerEnable(TIMER1_BASE, TIMER_A);
+        for(i = 0; i < ADC_CHANNELS; i++) {
+          g_psShown[i] = chart;
+        }
+      }
+      StripChartTracesSet(&g_sChart, chartTraces);
+      StripChartUpdate(&g_sChart);
+    }
+    else {
+      TimerDisable(TIMER1_BASE, TIMER_A);
       
-      break;  
+      // Show each pot as a number, a bar, or not at all.  A row
+      // is cleared only when its display type changes; after that the gauge
+      // or readout repaints just what its new value changes.
+      for(i = 0; i < ADC_CHANNELS; i++) {
+        if(g_psShown[i] != aDisp[i]) {
+          sRect.i16XMin = 0;
+          sRect.i16YMin = 16 + (i * 16);
+          sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
+          sRect.i16YMax = 31 + (i * 16);
+          GrStateForegroundSet(&g_sGrState, ClrBlack);
+          GrRectFill(&sContext, &sRect);
+          BarGaugeInvalidate(&g_psBars[i]);
+          ReadoutInvalidate(&g_psReadouts[i]);
+          g_psShown[i] = aDisp[i];
+        }
+        switch(aDisp[i]) {
+        case numeric:
+          ReadoutSetUnsigned(&g_psReadouts[i], pui32ADC0Value[i]);
+          break;
+        case histogram:
+          BarGaugeDraw(&g_psBars[i], &sContext, val[i]);
+          break;
+        default:
+          break;
+        }
+      }
     }
     
-    // Switch statment for ADC output 2 as a number, graph, or not displayed.
-    switch(aDisp[2]) {
-    case off:
-      sRect.i16XMin = 0;			
-      sRect.i16YMin = 48;					
-      sRect.i16XMax = GrContextDpyWidthGet(&sContext);	
-      sRect.i16YMax = 64;					
-      GrContextForegroundSet(&sContext, ClrBlack);	
-      GrRectFill(&sContext, &sRect);
-      break;    
-    case numeric:
-      sRect.i16XMin = 0;						
-      sRect.i16YMin = 48;					
-      sRect.i16XMax = GrContextDpyWidthGet(&sContext);
-      sRect.i16YMax = 64;						
-      GrContextForegroundSet(&sContext, ClrBlack);			
-      GrRectFill(&sContext, &sRect);
-      GrContextForegroundSet(&sContext, ClrWhite);
-      sprintf(tempStr,"%i",pui32ADC0Value[2]);
-      GrStringDrawCentered(&sContext, tempStr, -1,
-                           GrContextDpyWidthGet(&sContext) / 2, 56, 16);       
-      break;
-    case histogram:
-      sRect.i16XMin = 0;						
-      sRect.i16YMin = 48;				
-      sRect.i16XMax = val[2];
-      sRect.i16YMax = 64;					
-      GrContextForegroundSet(&sContext, ClrDarkBlue);	
-      GrRectFill(&sContext, &sRect);
-      sRect.i16XMin = val[2];	
-      sRect.i16XMax = 96;						
-      GrContextForegroundSet(&sContext, ClrBlack);		
-      GrRectFill(&sContext, &sRect);
-      break;  
-    }
+    // Send whatever changed on the OLED this pass.
+    GrFlush(&sContext);
   }                                             // End indefinite while()
 } 						// End of main()
 
@@ -848,19 +1222,17 @@ int main(void) {
 //
 //*****************************************************************************
 void clear() {
-  UARTCharPut(UART0_BASE, 12);
+  UARTTxPutChar(&g_sUART0Tx, 12);
 }
 
 //*****************************************************************************
 //
-// Using the character output function as a base for a parent function
-// used to output an entire string to the OLED one character at a time.
+// Queues an entire string for the PuTTY window.  The bytes are sent by the
+// UART TX interrupt so the caller does not wait for them to go out.
 //
 //*****************************************************************************
 void putString(char *str) {
-  for(int i = 0; i < strlen(str); i++) {
-    UARTCharPut(UART0_BASE, str[i]);
-  }
+  UARTTxPutString(&g_sUART0Tx, str);
 }
 
 //*****************************************************************************
@@ -871,10 +1243,221 @@ void putString(char *str) {
 //
 //*****************************************************************************
 void printMenu() {
-  char*menu = "\rMenu Selection: \n\rP - Party Mode\n\rC - Change Background Color\n\rE - Erase Terminal Window\n\rL - Flash LED\n\rF - Flood Character\n\rM - Print the Menu\n\r1- Toggle Display Mode for First Potentiometer\n\r2- Toggle Display Mode for Second Potentiometer\n\r3- Toggle Display Mode for Third Potentiometer\n\rQ - Quit this program\n\r";
+  char*menu = "\rMenu Selection: \n\rP - Party Mode\n\rC - Change Background Color\n\rE - Erase Terminal Window\n\rL - Flash LED\n\rF - Throughput Benchmark\n\rM - Print the Menu\n\rD - Live Dashboard On/Off\n\r1- Toggle Display Mode for First Potentiometer\n\r2- Toggle Display Mode for Second Potentiometer\n\r3- Toggle Display Mode for Third Potentiometer\n\r   (off, number, bar, chart; charted pots share the screen)\n\rT - Binary Telemetry On/Off\n\rR - Route Telemetry to Console/Data Port\n\rU - UART Statistics\n\rG - Graphics Statistics\n\rQ - Quit this program\n\r";
   putString(menu);
 }
 
+//*****************************************************************************
+//
+// Prints the UART0 transmit counters: bytes sent straight to the FIFO,
+// deferred to the ring, and dropped, plus the deepest the ring has been.
+// Then the receive counters: line errors, overruns and how full the FIFO
+// and ring have been.  For the UART1 data port it prints what is queued,
+// the telemetry frames built and how many of those were skipped for lack
+// of room.
+//
+//*****************************************************************************
+void printUARTStats(void) {
+  tUARTTxStats sStats;
+  tUARTRxStats sRxStats;
+  char str[96];
+  
+  UARTTxStatsGet(&g_sUART0Tx, &sStats);
+  sprintf(str, "\n\rUART0 TX sent: %lu deferred: %lu dropped: %lu peak: %lu\n\r",
+          (unsigned long)sStats.ui32Accepted, (unsigned long)sStats.ui32Deferred,
+          (unsigned long)sStats.ui32Overflow, (unsigned long)sStats.ui32HighWater);
+  putString(str);
+  UARTRxStatsGet(&g_sUART0Rx, &sRxStats);
+  sprintf(str, "UART0 RX irqs: %lu bytes: %lu FIFO peak: %lu/16\n\r",
+          (unsigned long)sRxStats.ui32Interrupts,
+          (unsigned long)sRxStats.ui32Bytes,
+          (unsigned long)sRxStats.ui32FIFOPeak);
+  putString(str);
+  sprintf(str, "UART0 RX overrun: %lu framing: %lu parity: %lu break: %lu\n\r",
+          (unsigned long)sRxStats.ui32Overrun, (unsigned long)sRxStats.ui32Framing,
+          (unsigned long)sRxStats.ui32Parity, (unsigned long)sRxStats.ui32Break);
+  putString(str);
+  sprintf(str, "UART0 RX queue peak: %lu dropped: %lu\n\r",
+          (unsigned long)sRxStats.ui32QueuePeak,
+          (unsigned long)sRxStats.ui32Dropped);
+  putString(str);
+  UARTTxStatsGet(&g_sUART1Tx, &sStats);
+  sprintf(str, "UART1 data queued: %lu frames: %lu skipped: %lu peak: %lu\n\r",
+          (unsigned long)sStats.ui32Queued, (unsigned long)g_sTelemetry.ui32Frames,
+          (unsigned long)g_ui32TelemSkipped, (unsigned long)sStats.ui32HighWater);
+  putString(str);
+}
+
+//*****************************************************************************
+//
+// Prints what the OLED costs: pixels sent to the panel by the last flush and
+// on average, how full the framebuffer palette is, how often the banner
+// text came from the text cache with the font engine cycles that avoided,
+// how many context state changes were skipped, how well the splash
+// animation kept to its frame rate, and how many strip chart samples were
+// plotted or lost.
+//
+//*****************************************************************************
+void printGraphicsStats(void) {
+  char str[96];
+  uint32_t i, used;
+  
+  sprintf(str, "\n\rOLED px last flush: %lu avg: %lu flushes: %lu\n\r",
+          (unsigned long)g_sFrameBuf.ui32Pixels,
+          (unsigned long)(g_sFrameBuf.ui32Frames ?
+                          g_sFrameBuf.ui32Total / g_sFrameBuf.ui32Frames : 0),
+          (unsigned long)g_sFrameBuf.ui32Frames);
+  putString(str);
+  used = 0;
+  for(i = 0; i < FRAMEBUF_PALETTE_SIZE; i++) {
+    if(g_sFrameBuf.ui32PaletteUsed & (1 << i)) {
+      used++;
+    }
+  }
+  sprintf(str, "Palette entries used: %lu/%d, colors approximated: %lu\n\r",
+          (unsigned long)used, FRAMEBUF_PALETTE_SIZE,
+          (unsigned long)g_sFrameBuf.ui32PaletteMisses);
+  putString(str);
+  sprintf(str, "Text cache hits: %lu misses: %lu uncached: %lu\n\r",
+          (unsigned long)g_sStrCache.ui32Hits, (unsigned long)g_sStrCache.ui32Misses,
+          (unsigned long)g_sStrCache.ui32Uncached);
+  putString(str);
+  sprintf(str, "Cycles saved: %lu, %lu strings in %lu runs\n\r",
+          (unsigned long)g_sStrCache.ui32Saved,
+          (unsigned long)g_sStrCache.ui32NumEntries,
+          (unsigned long)g_sStrCache.ui32NumRuns);
+  putString(str);
+  sprintf(str, "Color translations: %lu avoided: %lu\n\r",
+          (unsigned long)g_sGrState.ui32Translated,
+          (unsigned long)g_sGrState.ui32Hits);
+  putString(str);
+  sprintf(str, "Splash frames: %lu at %lu fps, missed: %lu\n\r",
+          (unsigned long)g_sFrameSched.ui32Frames,
+          (unsigned long)g_sFrameSched.ui32FPS,
+          (unsigned long)g_sFrameSched.ui32Missed);
+  putString(str);
+  sprintf(str, "Frame us min: %lu avg: %lu max: %lu\n\r",
+          (unsigned long)(g_sFrameSched.ui32Frames ?
+                          g_sFrameSched.ui32MinUs : 0),
+          (unsigned long)(g_sFrameSched.ui32Frames ?
+                          g_sFrameSched.ui32TotalUs / g_sFrameSched.ui32Frames : 0),
+          (unsigned long)g_sFrameSched.ui32MaxUs);
+  putString(str);
+  sprintf(str, "Chart columns: %lu at %d Hz, dropped: %lu\n\r",
+          (unsigned long)g_sChart.ui32Columns, CHART_SAMPLE_HZ,
+          (unsigned long)g_sChart.ui32Dropped);
+  putString(str);
+}
+
+//*****************************************************************************
+//
+// Streams the benchmark pattern through the blocking, interrupt and uDMA
+// transmit backends in turn, ui32Ms each, and reports the throughput, the
+// share of the CPU each one used and how often it stalled on a full FIFO
+// or ring, on the terminal and the OLED.
+//
+//*****************************************************************************
+void runBenchmark(tContext *psContext, uint32_t ui32Ms) {
+  tUARTBenchResult psResult[UART_BENCH_NUM_BACKENDS];
+  tRectangle sRect;
+  char str[80];
+  uint32_t i;
+  
+  if(ui32Ms > UART_BENCH_MAX_MS) {
+    ui32Ms = UART_BENCH_MAX_MS;
+  }
+  
+  // The main loop stops for seconds, so stop the strip chart rather than
+  // let its queue overflow.  The chart starts again clean when the main
+  // loop redraws it.
+  TimerDisable(TIMER1_BASE, TIMER_A);
+  sprintf(str, "\n\r%lu ms per backend...\n\r", (unsigned long)ui32Ms);
+  putString(str);
+  
+  for(i = 0; i < UART_BENCH_NUM_BACKENDS; i++) {
+    UARTBenchRun(&g_sUART0Tx, &g_sUART0DMA, i, SysCtlClockGet(), ui32Ms,
+                 g_pui8BenchPattern, sizeof(g_pui8BenchPattern),
+                 &psResult[i]);
+  }
+  
+  // Results go out after all three runs so they do not land in the middle
+  // of the flood.
+  sRect.i16XMin = 0;
+  sRect.i16YMin = 16;
+  sRect.i16XMax = GrContextDpyWidthGet(psContext) - 1;
+  sRect.i16YMax = GrContextDpyHeightGet(psContext) - 1;
+  GrContextForegroundSet(psContext, ClrBlack);
+  GrRectFill(psContext, &sRect);
+  GrContextForegroundSet(psContext, ClrWhite);
+  GrContextFontSet(psContext, g_psFontFixed6x8);
+  putString("\n\rBackend     bytes/s  CPU%  stalls\n\r");
+  for(i = 0; i < UART_BENCH_NUM_BACKENDS; i++) {
+    sprintf(str, "%-10s %8lu  %4lu  %6lu\n\r", UARTBenchName(i),
+            (unsigned long)psResult[i].ui32BytesPerSec,
+            (unsigned long)psResult[i].ui32CPUPercent,
+            (unsigned long)psResult[i].ui32Stalls);
+    putString(str);
+    sprintf(str, "%c %6lu %3lu%%", UARTBenchName(i)[0],
+            (unsigned long)psResult[i].ui32BytesPerSec,
+            (unsigned long)psResult[i].ui32CPUPercent);
+    GrStringDraw(psContext, str, -1, 4, 20 + (i * 12), false);
+  }
+  
+  // Hold the results on the OLED before the main loop redraws it.
+  GrFlush(psContext);
+  SysCtlDelay(SysCtlClockGet());
+  for(i = 0; i < ADC_CHANNELS; i++) {
+    g_psShown[i] = terminator;
+  }
+}
+
+//*****************************************************************************
+//
+// Adds one reading of the three pots to the telemetry batch and, once the
+// batch is full, sends it as a single COBS framed packet.  A frame that does
+// not fit in the transmit ring is skipped whole rather than sent truncated;
+// the decoder sees the gap in the sequence numbers.
+//
+//*****************************************************************************
+void sendTelemetry(const uint32_t *pui32Sample) {
+  static uint8_t pui8Frame[TELEMETRY_MAX_ENCODED];
+  tUARTRxStats sRxStats;
+  uint32_t ui32Len;
+  
+  if(g_ui32TelemCount == 0) {
+    g_ui32TelemStamp = CycleCounterGet();       // Time of the first reading.
+  }
+  memcpy(&g_pui32TelemBatch[g_ui32TelemCount * ADC_CHANNELS], pui32Sample,
+         ADC_CHANNELS * sizeof(uint32_t));
+  if(++g_ui32TelemCount < TELEM_BATCH) {
+    return;
+  }
+  g_ui32TelemCount = 0;
+  
+  ui32Len = TelemetryADCFrame(&g_sTelemetry, g_ui32TelemStamp,
+                              g_pui32TelemBatch, ADC_CHANNELS, TELEM_BATCH,
+                              pui8Frame);
+  if(UARTTxSpace(g_psTelemTx) >= ui32Len) {
+    UARTTxWrite(g_psTelemTx, pui8Frame, ui32Len);
+  }
+  else {
+    g_ui32TelemSkipped++;
+  }
+  
+  // Once a second the receive counters follow, so a capture shows whether
+  // console input was being lost while it was taken.
+  if((g_ui32TelemStamp - g_ui32RxStatsStamp) >= SysCtlClockGet()) {
+    UARTRxStatsGet(&g_sUART0Rx, &sRxStats);
+    ui32Len = TelemetryWordsFrame(&g_sTelemetry, TELEMETRY_TYPE_UART_RX,
+                                  g_ui32TelemStamp, (uint32_t *)&sRxStats,
+                                  UART_RX_STATS_WORDS, pui8Frame);
+    if(UARTTxSpace(g_psTelemTx) >= ui32Len) {
+      UARTTxWrite(g_psTelemTx, pui8Frame, ui32Len);
+      g_ui32RxStatsStamp = g_ui32TelemStamp;
+    }
+  }
+}
+
 //*****************************************************************************
 //
 // Blinky LED "heartbeat" function.
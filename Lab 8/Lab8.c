@@ -30,13 +30,25 @@
 #include "driverlib/timer.h" // Header file inclusion for timing usage
 #include "driverlib/adc.h"
 #include "driverlib/uart.h" // Allows for ease of use of UART
+#include "driverlib/udma.h" // Allows for use of the uDMA channels
 
 #include "grlib/grlib.h" // Header file inclusion for the graphics library
 
 #include "drivers/cfal96x64x16.h" // Header file for OLED display
 
+#include "../Common/uarttx.h" // Interrupt-driven UART transmit ring buffer
+#include "../Common/uartdma.h" // uDMA bulk transmit for menus and banners
+#include "../Common/uartrx.h" // Interrupt-filled UART receive ring buffer
+#include "../Common/uartbaud.h" // Checked baud rate changes
+#include "../Common/cmdparse.h" // Table-driven command line parser
+#include "../Common/lathist.h" // Log2 latency histogram
+#include "../Common/cyccnt.h" // Cycle counter for latency timestamps
+#include "../Common/strcache.h" // Pre-rendered banner and splash text
+
 #define blinkyOnPeriod 100000 // defines how long the LED will stay lit
 #define blinkyOffPeriod 100000 // defines how long the LED will remain off
+#define UART0_TX_BUF_SIZE 512 // size of the UART 0 transmit ring (power of 2)
+#define UART0_RX_BUF_SIZE 1024 // size of the UART 0 receive ring (power of 2)
 
 //******************************************************************************
 //
@@ -45,7 +57,21 @@
 //******************************************************************************
 int whileLoop = 1;// Maintains indefinite while loop unless program exits
 int32_t blinkyHandler = 1;// Maintains LED 'heartbeat' unless specified otherwise 
-int32_t local_char; // Keeps the character input into PuTTy 
+
+uint8_t g_pui8UART0TxBuf[UART0_TX_BUF_SIZE]; // Storage for queued UART output
+tUARTTx g_sUART0Tx; // UART 0 transmit ring drained by the TX interrupt
+tUARTDMA g_sUART0DMA; // uDMA channel feeding whole blocks to UART 0
+uint8_t g_pui8UART0RxBuf[UART0_RX_BUF_SIZE]; // Storage for received input
+tUARTRx g_sUART0Rx; // UART 0 receive ring filled by the RX interrupt
+uint32_t g_pui32UART0RxStamps[UART0_RX_BUF_SIZE]; // Arrival time of each byte in the ring
+tCmdParser g_sCmdParser; // Assembles received characters into command lines
+tLatHist g_sEchoHist; // Arrival to echo latency, in cycles
+bool g_bEchoInISR = false; // Echo from the receive interrupt, not the main loop
+tStrCache g_sStrCache; // Banner and splash text, rasterized once
+
+// Constant strings so they can be handed to the uDMA as is
+const char g_pcBye[] = "\n\rBYE!";
+const char g_pcInvalid[] = "\n\rInvalid. Try Again: ";
 
 tContext sContext; // OLED drawing contextual structuring
 tRectangle sRect; // Rectangle parameters for banner structuring
@@ -61,9 +87,19 @@ void clear(void); // clear the PuTTy window
 void initializations(void); // Sets-up the software and hardware for usage
 void printMenu(void); // re-prints the menu options to PuTTy
 void putString(char *str); // prints a string to the OLED
-void menuSwitch(void); // Switches between menu options depending on the input
+void putBlock(const char *str); // sends a constant string by uDMA
+void menuSwitch(int32_t local_char, uint32_t arrival); // Feeds input to the command parser
+void cmdError(const char *pcCmd, int32_t i32Status); // Reports a failed command
+void printEchoHist(void); // Dumps the echo latency histogram
+void printRxStats(void); // Prints the UART receive error counters
+void printTextCache(void); // Prints the text cache counters
+extern const tCmdEntry *const g_ppsCmdTable[CMD_TABLE_SIZE]; // Command dispatch table
 
 int main(void) {
+  uint8_t pui8Input[16]; // Batch of received characters for the menu
+  uint32_t pui32Arrival[16]; // When each character in the batch came in
+  uint32_t ui32Count; // Number of characters in the batch
+  
   //
   // Enable lazy stacking for interrupt handlers.  This allows floating-point
   // instructions to be used within interrupt handlers, but at the expense of
@@ -79,6 +115,7 @@ int main(void) {
   // OLED and clear PuTTy window for menu output.
   //
   initializations();
+  CmdParserInit(&g_sCmdParser, g_ppsCmdTable, cmdError);
   splash(); // Prints out the splash screen to OLED.
   clear(); // Clears the PuTTy window for neatness.
   printMenu(); // Prints the UART menu for user IO.
@@ -91,8 +128,8 @@ int main(void) {
   GrContextForegroundSet(&sContext, ClrOrange);	
   GrRectFill(&sContext, &sRect); 
   GrContextForegroundSet(&sContext, ClrWhite);
-  GrStringDrawCentered(&sContext, "Round & Round", -1, GrContextDpyWidthGet(&sContext)
-						/ 2, 4, 0);
+  StrCacheDrawCentered(&g_sStrCache, &sContext, "Round & Round",
+                       GrContextDpyWidthGet(&sContext) / 2, 4, false);
   
   IntMasterEnable(); // Enables Interrupts
   
@@ -109,11 +146,11 @@ int main(void) {
     whileLoop++;
     
     //
-    // Checking to see if the user has input a character through UART and 
-    // if so acting accordingly.
-    while(UARTCharsAvail(UART0_BASE)) {
-      local_char = UARTCharGetNonBlocking(UART0_BASE);
-      menuSwitch();
+    // Hand everything the UART interrupt has received since the last pass
+    // to the menu, a batch at a time.
+    ui32Count = UARTRxReadStamped(&g_sUART0Rx, pui8Input, pui32Arrival, sizeof(pui8Input));
+    for(uint32_t i = 0; (i < ui32Count) && (whileLoop != 0); i++) {
+      menuSwitch(pui8Input[i], pui32Arrival[i]);
     }		
  
 	}
@@ -138,12 +175,9 @@ void UARTIntHandler(void){
   uint32_t ui32Status;
   ui32Status = UARTIntStatus(UART0_BASE, true); // Get the interrupt status.
   UARTIntClear(UART0_BASE, ui32Status); // Clear the interrupt for UART
-  // Loop while there are characters in the receive FIFO.
-  while(UARTCharsAvail(UART0_BASE)) {
-    // Read the next character from the UART and write it back to the UART.
-    local_char = UARTCharGetNonBlocking(UART0_BASE);
-    menuSwitch();
-  }
+  UARTTxIntHandler(&g_sUART0Tx); // Refill the TX FIFO from the ring
+  UARTDMAIntHandler(&g_sUART0DMA); // Retire a finished uDMA block
+  UARTRxIntHandler(&g_sUART0Rx); // Move received bytes into the ring
 }
 
 //*****************************************************************************
@@ -184,9 +218,19 @@ void initializations(void) {
   // Configure UART for 115200 baud rate, 8 in 1 operation
   UARTConfigSetExpClk(UART0_BASE, SysCtlClockGet(), 115200, 
 					  (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE));
+  
+  // Queue output in a ring that the TX FIFO interrupt drains
+  UARTTxInit(&g_sUART0Tx, UART0_BASE, g_pui8UART0TxBuf, sizeof(g_pui8UART0TxBuf));
+  UARTDMAInit(&g_sUART0DMA, &g_sUART0Tx, UDMA_CH9_UART0TX); // Bulk blocks by uDMA
+  
+  // Collect input in a ring filled by the RX and receive timeout interrupts
+  UARTRxInit(&g_sUART0Rx, UART0_BASE, g_pui8UART0RxBuf, sizeof(g_pui8UART0RxBuf));
+  CycleCounterInit(); // Timestamps for the echo latency histogram
+  UARTRxStampsSet(&g_sUART0Rx, g_pui32UART0RxStamps); // Stamp each byte as it arrives
+  LatHistInit(&g_sEchoHist);
+  StrCacheInit(&g_sStrCache); // Timed with the cycle counter as well
     
   IntEnable(INT_UART0); // Enable the interrupt for UART 0
-  UARTIntEnable(UART0_BASE, UART_INT_RX | UART_INT_RT);  // Enable specific UART interrupt usage
   
   //****************************************************************************
   //                                  ADC
@@ -229,17 +273,28 @@ void initializations(void) {
 // PuTTY window clearing function.
 //
 //*****************************************************************************
-void clear() { UARTCharPut(UART0_BASE, 12); }
+void clear() { UARTTxPutChar(&g_sUART0Tx, 12); }
 
 //*****************************************************************************
 //
-// Using the character output function as a base for a parent function
-// used to output an entire string to the OLED one character at a time.
+// Queues an entire string for the PuTTY window.  The bytes are sent by the
+// UART TX interrupt so the caller does not wait for them to go out.
 //
 //*****************************************************************************
 void putString(char *str) {
-  for(int i = 0; i < strlen(str); i++) {
-    UARTCharPut(UART0_BASE, str[i]);
+  UARTTxPutString(&g_sUART0Tx, str);
+}
+
+//*****************************************************************************
+//
+// Hands a constant string to the uDMA so the CPU returns immediately instead
+// of copying it into the ring.  Falls back to the ring if a block is already
+// in flight.
+//
+//*****************************************************************************
+void putBlock(const char *str) {
+  if(!UARTDMASend(&g_sUART0DMA, str, strlen(str), 0, 0)) {
+    putString((char *)str);
   }
 }
 
@@ -251,76 +306,275 @@ void putString(char *str) {
 //
 //*****************************************************************************
 void printMenu() {
-  char*menu = "\rMenu Selection: \n\rC - Erase Terminal Window\n\rF - Follow Mode\n\rL 
-			   - Flash LED\n\rM - Print the Menu\n\rN - Normal Mode\n\rQ - Quit this 
-			   program\n\rR - Reverse Mode\n\rS - Stop Mode\n\n\r+ - Increase Speed\n\r-
-			   - Decrease Speed\n\r";
-  putString(menu);
+  char*menu = "\rMenu Selection (end with Enter, separate with ;):\n\rC - Erase Terminal Window\n\rF - Follow Mode\n\rL - Flash LED\n\rM - Print the Menu\n\rN - Normal Mode\n\rQ - Quit this program\n\rR - Reverse Mode\n\rS - Stop Mode\n\rB <rate> - Change Baud Rate\n\rE [0|1] - Echo From Interrupt\n\rH - Echo Latency Histogram\n\rU - UART Receive Statistics\n\rT - Text Cache Statistics\n\r";
+  putBlock(menu);
+}
+
+//*****************************************************************************
+//
+// Command handlers.  Each is called from the dispatch table below with the
+// numeric arguments that followed it on the line.
+//
+//*****************************************************************************
+int32_t cmdClear(uint32_t argc, const int32_t *argv) { // Clear PuTTY window
+  clear();
+  return(CMD_OK);
+}
+
+int32_t cmdFollow(uint32_t argc, const int32_t *argv) { // Follow mode
+  firstCycle = true;
+  mode = 2;
+  return(CMD_OK);
+}
+
+int32_t cmdLED(uint32_t argc, const int32_t *argv) { // LED toggle
+  if(blinkyHandler == 0)
+    blinkyHandler = 1;
+  else
+    blinkyHandler = 0;
+  GPIOPinWrite(GPIO_PORTG_BASE, GPIO_PIN_2, 0);
+  return(CMD_OK);
+}
+
+int32_t cmdMenu(uint32_t argc, const int32_t *argv) { // Re-print menu
+  UARTTxPutChar(&g_sUART0Tx, 5);
+  printMenu();
+  return(CMD_OK);
+}
+
+int32_t cmdNormal(uint32_t argc, const int32_t *argv) { // Normal mode
+  mode = 1;
+  return(CMD_OK);
+}
+
+int32_t cmdQuit(uint32_t argc, const int32_t *argv) { // Quit program
+  IntMasterDisable();
+  putBlock(g_pcBye); // Goodbye message to PuTTy
+  UARTDMAFlush(&g_sUART0DMA); // Interrupts are off, so send it out now
+  UARTTxFlush(&g_sUART0Tx);
+  sRect.i16XMin = 0;
+  sRect.i16YMin = 0;
+  sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
+  sRect.i16YMax = GrContextDpyHeightGet(&sContext) - 1;
+  GrContextForegroundSet(&sContext, ClrBlack);
+  GrContextBackgroundSet(&sContext, ClrBlack);
+  GrRectFill(&sContext, &sRect);
+  GrContextForegroundSet(&sContext, ClrRed);
+  GrContextFontSet(&sContext, g_psFontFixed6x8);
+  StrCacheDrawCentered(&g_sStrCache, &sContext, "Goodbye",
+                       GrContextDpyWidthGet(&sContext) / 2, 30,
+                       false); // Goodbye message to OLED in red.
+  // If the user said to quit the whileLoop will NO LONGER be able to be ran		
+  whileLoop = 0; 
+  return(CMD_STOP); // Nothing after Q on the same line runs
+}
+
+int32_t cmdReverse(uint32_t argc, const int32_t *argv) { // Reverse mode
+  mode = 3;
+  return(CMD_OK);
+}
+
+int32_t cmdStop(uint32_t argc, const int32_t *argv) { // Stop mode
+  mode = 0;
+  return(CMD_OK);
+}
+
+int32_t cmdEcho(uint32_t argc, const int32_t *argv) { // E toggles, E 0/1 sets
+  g_bEchoInISR = (argc != 0) ? (argv[0] != 0) : !g_bEchoInISR;
+  LatHistInit(&g_sEchoHist); // Start a fresh histogram for the new mode
+  UARTRxEchoSet(&g_sUART0Rx, g_bEchoInISR ? &g_sUART0Tx : 0, &g_sEchoHist);
+  putString(g_bEchoInISR ? "\n\rEcho from interrupt\n\r" :
+                           "\n\rEcho from main loop\n\r");
+  return(CMD_OK);
+}
+
+int32_t cmdHist(uint32_t argc, const int32_t *argv) { // Echo latency histogram
+  printEchoHist();
+  return(CMD_OK);
+}
+
+int32_t cmdUART(uint32_t argc, const int32_t *argv) { // Receive statistics
+  printRxStats();
+  return(CMD_OK);
+}
+
+int32_t cmdText(uint32_t argc, const int32_t *argv) { // Text cache statistics
+  printTextCache();
+  return(CMD_OK);
+}
+
+int32_t cmdBaud(uint32_t argc, const int32_t *argv) { // Baud rate change
+  tUARTBaud sBaud;
+  char str[80];
+  
+  if(argv[0] <= 0) {
+    return(CMD_INVALID_ARG);
+  }
+  if(!UARTBaudCompute(SysCtlClockGet(), argv[0], &sBaud)) {
+    if(sBaud.bReachable) {
+      sprintf(str, "\n\r%lu baud is %ld ppm off at this clock, out of tolerance\n\r",
+              (unsigned long)sBaud.ui32Baud, (long)sBaud.i32ErrorPPM);
+    }
+    else {
+      sprintf(str, "\n\r%lu baud is too fast for this clock\n\r",
+              (unsigned long)sBaud.ui32Baud);
+    }
+    putString(str);
+    return(CMD_OK);
+  }
+  
+  sprintf(str, "\n\rSwitching to %lu baud (actual %lu, %ld ppm)\n\r",
+          (unsigned long)sBaud.ui32Baud, (unsigned long)sBaud.ui32Actual,
+          (long)sBaud.i32ErrorPPM);
+  putString(str);
+  UARTDMAFlush(&g_sUART0DMA); // Finish sending at the old rate
+  UARTBaudSet(UART0_BASE, SysCtlClockGet(), argv[0], &sBaud);
+  return(CMD_OK);
+}
+
+//*****************************************************************************
+//
+// Command table, indexed by the first character of each command so a
+// command is found with a single lookup.
+//
+//*****************************************************************************
+const tCmdEntry g_sCmdClear = {"CLEAR", 0, 0, cmdClear};
+const tCmdEntry g_sCmdFollow = {"FOLLOW", 0, 0, cmdFollow};
+const tCmdEntry g_sCmdLED = {"LED", 0, 0, cmdLED};
+const tCmdEntry g_sCmdMenu = {"MENU", 0, 0, cmdMenu};
+const tCmdEntry g_sCmdNormal = {"NORMAL", 0, 0, cmdNormal};
+const tCmdEntry g_sCmdQuit = {"QUIT", 0, 0, cmdQuit};
+const tCmdEntry g_sCmdReverse = {"REVERSE", 0, 0, cmdReverse};
+const tCmdEntry g_sCmdStop = {"STOP", 0, 0, cmdStop};
+const tCmdEntry g_sCmdBaud = {"BAUD", 1, 1, cmdBaud};
+const tCmdEntry g_sCmdEcho = {"ECHO", 0, 1, cmdEcho};
+const tCmdEntry g_sCmdHist = {"HIST", 0, 0, cmdHist};
+const tCmdEntry g_sCmdUART = {"UART", 0, 0, cmdUART};
+const tCmdEntry g_sCmdText = {"TEXT", 0, 0, cmdText};
+
+const tCmdEntry *const g_ppsCmdTable[CMD_TABLE_SIZE] = {
+  ['B'] = &g_sCmdBaud,
+  ['C'] = &g_sCmdClear,
+  ['E'] = &g_sCmdEcho,
+  ['F'] = &g_sCmdFollow,
+  ['H'] = &g_sCmdHist,
+  ['L'] = &g_sCmdLED,
+  ['M'] = &g_sCmdMenu,
+  ['N'] = &g_sCmdNormal,
+  ['Q'] = &g_sCmdQuit,
+  ['R'] = &g_sCmdReverse,
+  ['S'] = &g_sCmdStop,
+  ['T'] = &g_sCmdText,
+  ['U'] = &g_sCmdUART,
+};
+
+//*****************************************************************************
+//
+// Reports a command that could not be run.
+//
+//*****************************************************************************
+void cmdError(const char *pcCmd, int32_t i32Status) {
+  putBlock(g_pcInvalid);
+}
+
+//*****************************************************************************
+//
+// Prints the echo latency histogram: how long after it finished arriving
+// each byte was handed back to the transmitter, in log2 buckets.  Lines
+// that do not fit in the transmit ring are left off rather than waiting for
+// it to drain; a trailing "..." shows the dump was cut short.
+//
+//*****************************************************************************
+void printEchoHist(void) {
+  char str[64];
+  uint32_t i, upper;
+  bool truncated = false;
+  uint32_t cyclesPerUs = SysCtlClockGet() / 1000000;
+  
+  sprintf(str, "\n\r%s echo, %lu samples, %lu-%lu cycles\n\r",
+          g_bEchoInISR ? "Interrupt" : "Main loop",
+          (unsigned long)g_sEchoHist.ui32Samples,
+          (unsigned long)(g_sEchoHist.ui32Samples ? g_sEchoHist.ui32Min : 0),
+          (unsigned long)g_sEchoHist.ui32Max);
+  putString(str);
+  for(i = 0; i < LAT_HIST_BUCKETS; i++) {
+    if(g_sEchoHist.pui32Count[i] != 0) {
+      upper = (i < 32) ? (1UL << i) : 0xFFFFFFFF; // Bucket holds < 2^i
+      sprintf(str, "< %10lu cycles (%8lu us): %lu\n\r", (unsigned long)upper,
+              (unsigned long)(upper / cyclesPerUs),
+              (unsigned long)g_sEchoHist.pui32Count[i]);
+      if(UARTTxSpace(&g_sUART0Tx) < strlen(str) + 5) { // Room for "...\n\r" too
+        truncated = true;
+        break;
+      }
+      putString(str);
+    }
+  }
+  if(truncated) {
+    putString("...\n\r");
+  }
+}
+
+//*****************************************************************************
+//
+// Prints the UART 0 receive counters.  Overruns, or a FIFO peak of 16,
+// mean the receive interrupt is held off too long; framing errors and
+// breaks usually mean the baud rates do not match.
+//
+//*****************************************************************************
+void printRxStats(void) {
+  tUARTRxStats sStats;
+  char str[96];
+  
+  UARTRxStatsGet(&g_sUART0Rx, &sStats);
+  sprintf(str, "\n\rUART0 RX irqs: %lu bytes: %lu FIFO peak: %lu/16\n\r",
+          (unsigned long)sStats.ui32Interrupts, (unsigned long)sStats.ui32Bytes,
+          (unsigned long)sStats.ui32FIFOPeak);
+  putString(str);
+  sprintf(str, "overrun: %lu framing: %lu parity: %lu break: %lu\n\r",
+          (unsigned long)sStats.ui32Overrun, (unsigned long)sStats.ui32Framing,
+          (unsigned long)sStats.ui32Parity, (unsigned long)sStats.ui32Break);
+  putString(str);
+  sprintf(str, "queue peak: %lu dropped: %lu\n\r",
+          (unsigned long)sStats.ui32QueuePeak, (unsigned long)sStats.ui32Dropped);
+  putString(str);
+}
+
+//*****************************************************************************
+//
+// Prints how often banner and splash text came from the text cache and how
+// many font engine cycles that avoided.
+//
+//*****************************************************************************
+void printTextCache(void) {
+  char str[96];
+  
+  sprintf(str, "\n\rText cache hits: %lu misses: %lu uncached: %lu\n\r",
+          (unsigned long)g_sStrCache.ui32Hits, (unsigned long)g_sStrCache.ui32Misses,
+          (unsigned long)g_sStrCache.ui32Uncached);
+  putString(str);
+  sprintf(str, "Cycles saved: %lu, %lu strings in %lu runs\n\r",
+          (unsigned long)g_sStrCache.ui32Saved,
+          (unsigned long)g_sStrCache.ui32NumEntries,
+          (unsigned long)g_sStrCache.ui32NumRuns);
+  putString(str);
 }
 
 //*********************************************************************
 //
-// If the input character is not invalid, begin the character matching
-// statment below through the switch statment and act accordingly to
-// the user input.
+// Echoes each received character and hands it to the command parser,
+// which runs the line once Enter is pressed.  With echo from the
+// interrupt on, the character has already gone back.  Otherwise the
+// time since the character arrived goes into the latency histogram.
 //
 //*********************************************************************
-void menuSwitch() {
-  if (local_char != -1) { // Run only if the character in PuTTy is valid
-    UARTCharPut(UART0_BASE, local_char); // Send a character to UART.
-   
-    // Begin character input matching to menu option.
-    switch(local_char) {
-    case 'C': // Clear PuTTY window 
-      clear();
-      break;
-      
-    case 'F':
-      firstCycle = true;
-      mode = 2;
-      break;
-      
-    case 'L': //LED toggle 
-      if(blinkyHandler == 0)
-        blinkyHandler = 1;
-      else
-        blinkyHandler = 0;
-      GPIOPinWrite(GPIO_PORTG_BASE, GPIO_PIN_2, 0);
-      break;
-      
-    case 'M': // Re-print menu 
-      UARTCharPut(UART0_BASE, 5);
-      printMenu();
-      break;
-      
-    case 'N':
-        mode = 1;
-      break;
-      
-    case 'Q': // Quit program
-      IntMasterDisable();
-      putString("\n\rBYE!"); // Goodbye message to PuTTy
-      sRect.i16XMin = 0;
-      sRect.i16YMin = 0;
-      sRect.i16XMax = GrContextDpyWidthGet(&sContext) - 1;
-      sRect.i16YMax = GrContextDpyHeightGet(&sContext) - 1;
-      GrContextForegroundSet(&sContext, ClrBlack);
-      GrContextBackgroundSet(&sContext, ClrBlack);
-      GrRectFill(&sContext, &sRect);
-      GrContextForegroundSet(&sContext, ClrRed);
-      GrContextFontSet(&sContext, g_psFontFixed6x8);
-      GrStringDrawCentered(&sContext, "Goodbye", -1, GrContextDpyWidthGet(&sContext) 
-							/ 2, 30, false); // Goodbye message to OLED in red.
-	  // If the user said to quit the whileLoop will NO LONGER be able to be ran		
-      whileLoop = 0; 
-      break;   
-      
-    default:
-      char invalid[25] = "\n\rInvalid. Try Again: ";
-      char*ptr = invalid;
-      putString(ptr);
-      break;
-    } 
+void menuSwitch(int32_t local_char, uint32_t arrival) {
+  if(!g_bEchoInISR) {
+    UARTTxPutChar(&g_sUART0Tx, local_char); // Echo the character.
+    LatHistAdd(&g_sEchoHist, CycleCounterGet() - arrival);
+  }
+  if(CmdParserInput(&g_sCmdParser, local_char)) {
+    UARTTxPutChar(&g_sUART0Tx, '\n'); // Start a fresh line for the next
   }
 }
 
@@ -367,16 +621,16 @@ void splash() {
     loading.i16YMax = 39;
     GrContextForegroundSet(&sContext, ClrSalmon);
     if (length%10 == 0) {
-      GrStringDrawCentered(&sContext, "Loading.  ", 11, 48, 20, true);
+      StrCacheDrawCentered(&g_sStrCache, &sContext, "Loading.  ", 48, 20, true);
     }
     else if (length%10 == 1) {
-      GrStringDrawCentered(&sContext, "Loading.. ", 11, 48, 20, true);
+      StrCacheDrawCentered(&g_sStrCache, &sContext, "Loading.. ", 48, 20, true);
     }
     else if (length%10 == 2) {
-      GrStringDrawCentered(&sContext, "Loading...", 11, 48, 20, true);
+      StrCacheDrawCentered(&g_sStrCache, &sContext, "Loading...", 48, 20, true);
     }
     else {
-      GrStringDrawCentered(&sContext, "Loading   ", 11, 48, 20, true);
+      StrCacheDrawCentered(&g_sStrCache, &sContext, "Loading   ", 48, 20, true);
     }
     SysCtlDelay(150000);
     GrContextForegroundSet(&sContext, ClrDeepSkyBlue);
@@ -19,6 +19,8 @@
 #include "drivers/cfal96x64x16.h"
 
 #include "driverlib/uart.h"
+#include "driverlib/udma.h"
+#include "driverlib/ssi.h"
 #include "driverlib/adc.h"
 #include "driverlib/gpio.h"
 #include "driverlib/fpu.h"
@@ -27,8 +29,21 @@
 #include "driverlib/timer.h"
 #include "driverlib/debug.h"
 
+#include "../Common/uarttx.h"
+#include "../Common/uartdma.h"
+#include "../Common/uartrx.h"
+#include "../Common/uartbaud.h"
+#include "../Common/vtdash.h"
+#include "../Common/cyccnt.h"
+#include "../Common/strcache.h"
+#include "../Common/framebuf.h"
+#include "../Common/readout.h"
+
 #define LEDOn 100000 // defines how long the LED will stay lit
 #define LEDOff 100000 // defines how long the LED will remain off
+#define UART0_TX_BUF_SIZE 512 // size of the UART 0 transmit ring (power of 2)
+#define UART0_RX_BUF_SIZE 1024 // size of the UART 0 receive ring (power of 2)
+#define DASH_UPDATE_HZ 2 // terminal dashboard refreshes a second
 
 //******************************************************************************
 //
@@ -39,14 +54,52 @@ int whileLoop = 1;// Maintains indefinite while loop unless program exits
 int actualVal;
 int ADCLoadValue;
 int ServicedCount = 0;
+int ServicedLast = 0; // Serviced count for the last whole second
 
 int32_t BlinkyToggle = 1;// Maintains LED 'heartbeat' unless specified otherwise 
-int32_t CharacterInput; // Keeps the character input into PuTTy 
 
 uint32_t ADCValue[3];
 
-char ServicedValue[50];
-char PeriodValue[50];
+
+uint8_t g_pui8UART0TxBuf[UART0_TX_BUF_SIZE]; // Storage for queued UART output
+tUARTTx g_sUART0Tx; // UART 0 transmit ring drained by the TX interrupt
+tUARTDMA g_sUART0DMA; // uDMA channel feeding whole blocks to UART 0
+uint8_t g_pui8UART0RxBuf[UART0_RX_BUF_SIZE]; // Storage for received input
+tUARTRx g_sUART0Rx; // UART 0 receive ring filled by the RX interrupt
+tStrCache g_sStrCache; // Banner and splash text, rasterized once
+tFrameBuf g_sFrameBuf; // RAM copy of the OLED, sent to the panel by uDMA
+uint16_t g_pui16FramePixels[FRAMEBUF_PIXELS]; // Full color, so whole rows go out per transfer
+volatile bool g_bReadoutStale = false; // Timer 0 has new values to draw
+uint32_t g_ui32FlushStart; // Cycle count when the last flush was queued
+volatile uint32_t g_ui32FlushCycles; // Cycles from queueing to completion
+
+// OLED values after the "Req:", "Srv:" and "Per:" labels.  Each keeps the
+// digit in every cell and redraws only the cells that change.
+#define READOUT_REQ 0
+#define READOUT_SRV 1
+#define READOUT_PER 2
+#define NUM_READOUTS 3
+tReadout g_psReadouts[NUM_READOUTS];
+const char *g_ppcReadoutLabels[NUM_READOUTS] = {"Req:", "Srv:", "Per:"};
+
+// Constant strings so they can be handed to the uDMA as is
+const char g_pcBye[] = "\n\rBYE!";
+const char g_pcInvalid[] = "\n\rInvalid. Try Again: ";
+
+// Baud rates offered by the 'B' command, picked by number
+const uint32_t g_pui32BaudRates[] = {115200, 460800, 921600, 2000000, 3000000};
+#define NUM_BAUD_RATES (sizeof(g_pui32BaudRates) / sizeof(g_pui32BaudRates[0]))
+bool g_bBaudSelect = false; // The next character picks a baud rate
+
+// Terminal dashboard of the requested, serviced and period values; the
+// labels are drawn once and only values that changed are rewritten
+const tVTDashField g_psDashFields[] = {
+  {2, 1, 8, 0, "Req: ", 0, 0},
+  {2, 16, 8, 0, "Srv: ", 0, 0},
+  {2, 31, 8, 0, "Per: ", 0, 0},
+};
+#define NUM_DASH_FIELDS (sizeof(g_psDashFields) / sizeof(g_psDashFields[0]))
+tVTDash g_sDash;
 
 tContext Context; // OLED drawing contextual structuring
 tRectangle sRect; // Rectangle parameters for banner structuring
@@ -62,8 +115,16 @@ void clear(void); // clear the PuTTy window
 void initializations(void); // Sets-up the software and hardware for usage
 void printMenu(void); // re-prints the menu options to PuTTy
 void putString(char *str); // prints a string to the OLED
-void menuSwitch(void); // Switches between menu options depending on the input
+void putBlock(const char *str); // sends a constant string by uDMA
+void menuSwitch(int32_t CharacterInput); // Switches between menu options depending on the input
 void getADC(void); // Reading the value from the ADC
+void printBaudRates(void); // Lists the baud rates and their divisor error
+void changeBaud(uint32_t ui32Baud); // Switches UART 0 to a new baud rate
+void printRxStats(void); // Prints the UART receive error counters
+void printTextCache(void); // Prints the text cache counters
+void drawReadout(void); // Draws the timer values into the framebuffer
+void flushDone(void *pvData); // Called when the uDMA has sent a flush
+void printOLEDStats(void); // Prints the OLED flush counters
 
 //*****************************************************************************
 //
@@ -86,18 +147,11 @@ void Timer0IntHandler(void) {
   // setting the load value
   TimerLoadSet(TIMER1_BASE, TIMER_A, (SysCtlClockGet()/ ADCLoadValue));
   
-  // Printing out the values that have been serviced.
-  sprintf(ServicedValue,"Srv: %d         ", ServicedCount);
-  GrContextBackgroundSet(&Context, ClrBlack);
-  GrStringDraw(&Context, ServicedValue, 20, 5, 38, 1);
-  
-    
-  // Printing out the ADC requested value if called for.
-  GrContextBackgroundSet(&Context, ClrBlack);
-  sprintf(PeriodValue,"Per: %d         ", SysCtlClockGet()/ADCLoadValue);
-  GrStringDraw(&Context, PeriodValue, 20, 5, 50, 1);
-  
+  // The OLED is drawn by the main loop.  Drawing it here held Timer 1 off
+  // for the whole SSI transfer, which skewed the very count being measured.
+  ServicedLast = ServicedCount; // Kept for the OLED and terminal dashboard
   ServicedCount = 0;
+  g_bReadoutStale = true;
 }
 
 //*****************************************************************************
@@ -121,12 +175,28 @@ void getADC(){
   while(! (ADCIntStatus(ADC0_BASE, 3, false))); //Wait for an ADC reading.
   ADCSequenceDataGet(ADC0_BASE, 3, ADCValue); // Put the reading into a var.
   ADCLoadValue = (ADCValue[0]* (SysCtlClockGet() / 80000) +1);
-  
-  // Printing the value being requested by the ADC peripheral.
-  char RequestedString[50];
-  sprintf(RequestedString,"Req: %d        ", ADCLoadValue);
-  GrContextBackgroundSet(&Context, ClrBlack);
-  GrStringDraw(&Context, RequestedString, 20, 5, 26, 1); 
+}
+
+//*****************************************************************************
+//
+// Draws the requested, serviced and period values into the framebuffer.
+// Only the digit cells that changed are drawn, and only they end up in the
+// next flush.
+//
+//*****************************************************************************
+void drawReadout(void) {
+  ReadoutSetSigned(&g_psReadouts[READOUT_REQ], ADCLoadValue); // Value requested by the ADC
+  ReadoutSetSigned(&g_psReadouts[READOUT_SRV], ServicedLast); // Interrupts serviced
+  ReadoutSetUnsigned(&g_psReadouts[READOUT_PER], SysCtlClockGet()/ADCLoadValue); // Period of the serviced interrupt
+}
+
+//*****************************************************************************
+//
+// Called from the SSI interrupt once the uDMA has sent a flush.
+//
+//*****************************************************************************
+void flushDone(void *pvData) {
+  g_ui32FlushCycles = CycleCounterGet() - g_ui32FlushStart;
 }
 
 //*****************************************************************************
@@ -138,10 +208,20 @@ void UARTIntHandler(void){
   uint32_t ui32Status; // Holds the interrupt status
   ui32Status = UARTIntStatus(UART0_BASE, true); // Get the interrupt status.
   UARTIntClear(UART0_BASE, ui32Status); // Clear the interrupt for UART
-  while(UARTCharsAvail(UART0_BASE)) { // Loop while there are characters in the receive FIFO.
-    CharacterInput = UARTCharGetNonBlocking(UART0_BASE); // Read the next char from UART and write it back
-    menuSwitch(); // Act accordingly via user request
-  }
+  UARTTxIntHandler(&g_sUART0Tx); // Refill the TX FIFO from the ring
+  UARTDMAIntHandler(&g_sUART0DMA); // Retire a finished uDMA block
+  UARTRxIntHandler(&g_sUART0Rx); // Move received bytes into the ring; the main loop acts on them
+}
+
+//*****************************************************************************
+//
+// The SSI 2 interrupt handler.  The uDMA raises it at the end of each OLED
+// transfer.
+//
+//*****************************************************************************
+void SSI2IntHandler(void){
+  SSIIntClear(SSI2_BASE, SSIIntStatus(SSI2_BASE, true)); // Clear the interrupt for SSI 2
+  FrameBufIntHandler(&g_sFrameBuf); // Queue the next region or finish the flush
 }
 
 //*****************************************************************************
@@ -163,9 +243,18 @@ void initializations(void) {
   //                                 OLED
   //****************************************************************************
   CFAL96x64x16Init(); // Initialize the OLED display driver.
-  GrContextInit(&Context, &g_sCFAL96x64x16); // Initialize OLED graphics
+  FrameBufInit(&g_sFrameBuf, &g_sCFAL96x64x16, g_pui16FramePixels); // Draw into RAM first
+  FrameBufDMAInit(&g_sFrameBuf, UDMA_CH13_SSI2TX); // Flushes sent by uDMA
+  IntPrioritySet(INT_SSI2, 0x40); // Below the timers and the UART
+  IntEnable(INT_SSI2); // Enable the interrupt for SSI 2
+  GrContextInit(&Context, &g_sFrameBuf.sDisplay); // Initialize OLED graphics
   GrContextFontSet(&Context, g_psFontFixed6x8); // Fix the font type
   
+  // Eight digit readouts, white on black, after their labels
+  for(uint32_t i = 0; i < NUM_READOUTS; i++) {
+    ReadoutInit(&g_psReadouts[i], &g_sFrameBuf.sDisplay, 35, 26 + (i * 12), 8, ClrWhite, ClrBlack);
+  }
+  
   //****************************************************************************
   //                                 UART
   //****************************************************************************
@@ -178,6 +267,21 @@ void initializations(void) {
   // Configure UART for 115200 baud rate, 8 in 1 operation
   UARTConfigSetExpClk(UART0_BASE, SysCtlClockGet(), 115200, (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE));
   
+  // Queue output in a ring that the TX FIFO interrupt drains
+  UARTTxInit(&g_sUART0Tx, UART0_BASE, g_pui8UART0TxBuf, sizeof(g_pui8UART0TxBuf));
+  UARTDMAInit(&g_sUART0DMA, &g_sUART0Tx, UDMA_CH9_UART0TX); // Bulk blocks by uDMA
+  
+  // Collect input in a ring filled by the RX and receive timeout interrupts
+  UARTRxInit(&g_sUART0Rx, UART0_BASE, g_pui8UART0RxBuf, sizeof(g_pui8UART0RxBuf));
+  IntPrioritySet(INT_UART0, 0x20); // Below the timers so they can preempt it
+  IntEnable(INT_UART0); // Enable the interrupt for UART 0
+  
+  // Terminal dashboard, paced by the cycle counter
+  CycleCounterInit();
+  StrCacheInit(&g_sStrCache); // Timed with the cycle counter as well
+  VTDashInit(&g_sDash, &g_sUART0Tx, g_psDashFields, NUM_DASH_FIELDS,
+             SysCtlClockGet() / DASH_UPDATE_HZ);
+  
   //****************************************************************************
   //                               ADC
   //
@@ -233,17 +337,28 @@ void initializations(void) {
 // PuTTY window clearing function.
 //
 //*****************************************************************************
-void clear() { UARTCharPut(UART0_BASE, 12); }
+void clear() { UARTTxPutChar(&g_sUART0Tx, 12); }
 
 //*****************************************************************************
 //
-// Using the character output function as a base for a parent function
-// used to output an entire string to the OLED one character at a time.
+// Queues an entire string for the PuTTY window.  The bytes are sent by the
+// UART TX interrupt so the caller does not wait for them to go out.
 //
 //*****************************************************************************
 void putString(char *str) {
-  for(int i = 0; i < strlen(str); i++) { // Loop through the string
-    UARTCharPut(UART0_BASE, str[i]); // print each individual character
+  UARTTxPutString(&g_sUART0Tx, str); // queue the string for the TX interrupt
+}
+
+//*****************************************************************************
+//
+// Hands a constant string to the uDMA so the CPU returns immediately instead
+// of copying it into the ring.  Falls back to the ring if a block is already
+// in flight.
+//
+//*****************************************************************************
+void putBlock(const char *str) {
+  if(!UARTDMASend(&g_sUART0DMA, str, strlen(str), 0, 0)) {
+    putString((char *)str);
   }
 }
 
@@ -256,8 +371,8 @@ void putString(char *str) {
 //*****************************************************************************
 void 
 printMenu() {
-  char*menu = "\rMenu Selection: \n\rC - Erase Terminal Window\n\rL - Flash LED\n\rM - Print the Menu\n\rQ - Quit this program\n\r";
-  putString(menu);
+  char*menu = "\rMenu Selection: \n\rC - Erase Terminal Window\n\rL - Flash LED\n\rM - Print the Menu\n\rB - Change Baud Rate\n\rD - Live Dashboard On/Off\n\rU - UART Receive Statistics\n\rT - Text Cache Statistics\n\rO - OLED Flush Statistics\n\rQ - Quit this program\n\r";
+  putBlock(menu);
 }
 
 //*********************************************************************
@@ -267,9 +382,21 @@ printMenu() {
 // the user input.
 //
 //*********************************************************************
-void menuSwitch() {
+void menuSwitch(int32_t CharacterInput) {
   if (CharacterInput != -1) { // Run only if the character in PuTTy is valid
-    UARTCharPut(UART0_BASE, CharacterInput); // Send a character to UART.
+    UARTTxPutChar(&g_sUART0Tx, CharacterInput); // Echo the character.
+    
+    // A digit after 'B' picks the new baud rate; anything else cancels.
+    if(g_bBaudSelect) {
+      g_bBaudSelect = false;
+      if((CharacterInput >= '1') && (CharacterInput < ('1' + NUM_BAUD_RATES))) {
+        changeBaud(g_pui32BaudRates[CharacterInput - '1']);
+      }
+      else {
+        putString("\n\rBaud rate unchanged\n\r");
+      }
+      return;
+    }
     
     switch(CharacterInput) { // Begin character input matching to menu option.
       
@@ -286,13 +413,42 @@ void menuSwitch() {
       break;
       
     case 'M': // Re-print menu 
-      UARTCharPut(UART0_BASE, 5);
+      UARTTxPutChar(&g_sUART0Tx, 5);
       printMenu();
       break;
       
+    case 'D': // Terminal dashboard on/off
+      if(g_sDash.bActive) {
+        VTDashStop(&g_sDash);
+        printMenu();
+      }
+      else {
+        VTDashDraw(&g_sDash, "Lab 9 - Timer Service");
+      }
+      break;
+      
+    case 'U': // Receive statistics
+      printRxStats();
+      break;
+      
+    case 'T': // Text cache statistics
+      printTextCache();
+      break;
+      
+    case 'O': // OLED flush statistics
+      printOLEDStats();
+      break;
+      
+    case 'B': // Baud rate selection
+      printBaudRates();
+      g_bBaudSelect = true;
+      break;
+      
     case 'Q': // Quit program
       IntMasterDisable();
-      putString("\n\rBYE!"); // Goodbye message to PuTTy
+      putBlock(g_pcBye); // Goodbye message to PuTTy
+      UARTDMAFlush(&g_sUART0DMA); // Interrupts are off, so send it out now
+      UARTTxFlush(&g_sUART0Tx);
       sRect.i16XMin = 0;
       sRect.i16YMin = 0;
       sRect.i16XMax = GrContextDpyWidthGet(&Context) - 1;
@@ -302,20 +458,137 @@ void menuSwitch() {
       GrRectFill(&Context, &sRect);
       GrContextForegroundSet(&Context, ClrRed);
       GrContextFontSet(&Context, g_psFontFixed6x8);
-      GrStringDrawCentered(&Context, "Goodbye", -1, GrContextDpyWidthGet(&Context) / 2, 30, false); // Goodbye message to OLED in red.
+      StrCacheDrawCentered(&g_sStrCache, &Context, "Goodbye", GrContextDpyWidthGet(&Context) / 2, 30, false); // Goodbye message to OLED in red.
+      GrFlush(&Context); // Interrupts are off, so send it out now
      	
       whileLoop = 0; // If the user said to quit the whileLoop will NO LONGER be able to be ran	
       break;   
     
     default:
-      char invalid[25] = "\n\rInvalid. Try Again: ";
-      char*ptr = invalid;
-      putString(ptr);
+      putBlock(g_pcInvalid);
       break;
     } 
   }
 }
 
+//*****************************************************************************
+//
+// Lists the selectable baud rates with the rate the divisor really gives at
+// the current system clock and its error.  Rates that cannot be reached, or
+// only outside tolerance, are marked and will be refused.
+//
+//*****************************************************************************
+void printBaudRates(void) {
+  tUARTBaud sBaud;
+  char str[64];
+  uint32_t i;
+  
+  putString("\n\rBaud rates:\n\r");
+  for(i = 0; i < NUM_BAUD_RATES; i++) {
+    if(UARTBaudCompute(SysCtlClockGet(), g_pui32BaudRates[i], &sBaud)) {
+      sprintf(str, "%lu - %lu (actual %lu, %ld ppm)\n\r", (unsigned long)(i + 1),
+              (unsigned long)sBaud.ui32Baud, (unsigned long)sBaud.ui32Actual,
+              (long)sBaud.i32ErrorPPM);
+    }
+    else if(sBaud.bReachable) {
+      sprintf(str, "%lu - %lu (%ld ppm, out of tolerance)\n\r", (unsigned long)(i + 1),
+              (unsigned long)sBaud.ui32Baud, (long)sBaud.i32ErrorPPM);
+    }
+    else {
+      sprintf(str, "%lu - %lu (too fast for this clock)\n\r", (unsigned long)(i + 1),
+              (unsigned long)sBaud.ui32Baud);
+    }
+    putString(str);
+  }
+  putString("Select a rate: ");
+}
+
+//*****************************************************************************
+//
+// Switches UART 0 to a new baud rate.  All queued output is sent at the old
+// rate first; the terminal then has to be switched to match.
+//
+//*****************************************************************************
+void changeBaud(uint32_t ui32Baud) {
+  tUARTBaud sBaud;
+  char str[64];
+  
+  if(!UARTBaudCompute(SysCtlClockGet(), ui32Baud, &sBaud)) {
+    putString("\n\rThat rate is refused at this clock\n\r");
+    return;
+  }
+  
+  sprintf(str, "\n\rSwitching to %lu baud\n\r", (unsigned long)ui32Baud);
+  putString(str);
+  UARTDMAFlush(&g_sUART0DMA); // Drain the ring and any uDMA block at the old rate
+  UARTBaudSet(UART0_BASE, SysCtlClockGet(), ui32Baud, &sBaud);
+  printMenu();
+}
+
+//*****************************************************************************
+//
+// Prints the UART 0 receive counters.  Framing errors and breaks pile up
+// while the terminal is still at the old baud rate; overruns, or a FIFO
+// peak of 16, mean the receive interrupt was held off too long.
+//
+//*****************************************************************************
+void printRxStats(void) {
+  tUARTRxStats sStats;
+  char str[96];
+  
+  UARTRxStatsGet(&g_sUART0Rx, &sStats);
+  sprintf(str, "\n\rUART0 RX irqs: %lu bytes: %lu FIFO peak: %lu/16\n\r",
+          (unsigned long)sStats.ui32Interrupts, (unsigned long)sStats.ui32Bytes,
+          (unsigned long)sStats.ui32FIFOPeak);
+  putString(str);
+  sprintf(str, "overrun: %lu framing: %lu parity: %lu break: %lu\n\r",
+          (unsigned long)sStats.ui32Overrun, (unsigned long)sStats.ui32Framing,
+          (unsigned long)sStats.ui32Parity, (unsigned long)sStats.ui32Break);
+  putString(str);
+  sprintf(str, "queue peak: %lu dropped: %lu\n\r",
+          (unsigned long)sStats.ui32QueuePeak, (unsigned long)sStats.ui32Dropped);
+  putString(str);
+}
+
+//*****************************************************************************
+//
+// Prints how often banner and splash text came from the text cache and how
+// many font engine cycles that avoided.
+//
+//*****************************************************************************
+void printTextCache(void) {
+  char str[96];
+  
+  sprintf(str, "\n\rText cache hits: %lu misses: %lu uncached: %lu\n\r",
+          (unsigned long)g_sStrCache.ui32Hits, (unsigned long)g_sStrCache.ui32Misses,
+          (unsigned long)g_sStrCache.ui32Uncached);
+  putString(str);
+  sprintf(str, "Cycles saved: %lu, %lu strings in %lu runs\n\r",
+          (unsigned long)g_sStrCache.ui32Saved,
+          (unsigned long)g_sStrCache.ui32NumEntries,
+          (unsigned long)g_sStrCache.ui32NumRuns);
+  putString(str);
+}
+
+//*****************************************************************************
+//
+// Prints how much of the OLED the flushes have sent and how often drawing
+// had to wait for pixels the uDMA had not sent yet.
+//
+//*****************************************************************************
+void printOLEDStats(void) {
+  char str[96];
+  
+  sprintf(str, "\n\rOLED flushes: %lu pixels: %lu stalls: %lu\n\r",
+          (unsigned long)g_sFrameBuf.ui32Frames, (unsigned long)g_sFrameBuf.ui32Total,
+          (unsigned long)g_sFrameBuf.ui32Stalls);
+  putString(str);
+  sprintf(str, "Last flush: %lu pixels in %lu windows, %lu cycles\n\r",
+          (unsigned long)g_sFrameBuf.ui32Pixels, (unsigned long)g_sFrameBuf.ui32Windows,
+          (unsigned long)g_ui32FlushCycles);
+  putString(str);
+}
+
 //*****************************************************************************
 //
 // Blinky LED "heartbeat" function.
@@ -359,17 +632,18 @@ void splash() {
     loading.i16YMax = 39;
     GrContextForegroundSet(&Context, ClrSalmon);
     if (length%10 == 0) {
-      GrStringDrawCentered(&Context, "Loading.  ", 11, 48, 20, true);
+      StrCacheDrawCentered(&g_sStrCache, &Context, "Loading.  ", 48, 20, true);
     }
     else if (length%10 == 1) {
-      GrStringDrawCentered(&Context, "Loading.. ", 11, 48, 20, true);
+      StrCacheDrawCentered(&g_sStrCache, &Context, "Loading.. ", 48, 20, true);
     }
     else if (length%10 == 2) {
-      GrStringDrawCentered(&Context, "Loading...", 11, 48, 20, true);
+      StrCacheDrawCentered(&g_sStrCache, &Context, "Loading...", 48, 20, true);
     }
     else {
-      GrStringDrawCentered(&Context, "Loading   ", 11, 48, 20, true);
+      StrCacheDrawCentered(&g_sStrCache, &Context, "Loading   ", 48, 20, true);
     }
+    GrFlush(&Context); // Send this step to the OLED
     SysCtlDelay(150000);
     GrContextForegroundSet(&Context, ClrDeepSkyBlue);
     GrRectFill(&Context, &loading);
@@ -378,6 +652,7 @@ void splash() {
   // clear the screen so that it is set for the main screen
   GrContextForegroundSet(&Context, ClrBlack);
   GrRectFill(&Context, &screen);
+  GrFlush(&Context);
 }
 
 
@@ -388,6 +663,9 @@ void splash() {
 //
 //******************************************************************************
 int main(void) {
+  uint8_t pui8Input[16]; // Batch of received characters for the menu
+  uint32_t ui32Count; // Number of characters in the batch
+  
   // Enable lazy stacking for interrupt handlers.  This allows floating-point
   // instructions to be used within interrupt handlers, but at the expense of
   // extra stack usage.
@@ -428,7 +706,14 @@ int main(void) {
   GrContextForegroundSet(&Context, ClrSlateGray);	
   GrRectFill(&Context, &sRect); 
   GrContextForegroundSet(&Context, ClrWhite);
-  GrStringDrawCentered(&Context, "00010000 01000000", -1, GrContextDpyWidthGet(&Context) / 2, 4, 0);
+  StrCacheDrawCentered(&g_sStrCache, &Context, "00010000 01000000", GrContextDpyWidthGet(&Context) / 2, 4, false);
+  
+  // The labels are drawn once; the readouts fill in the values.
+  GrContextBackgroundSet(&Context, ClrBlack);
+  for(uint32_t i = 0; i < NUM_READOUTS; i++) {
+    GrStringDraw(&Context, g_ppcReadoutLabels[i], -1, 5, 26 + (i * 12), 1);
+  }
+  GrFlush(&Context);
   
   IntMasterEnable(); // Enables Interrupts
   
@@ -445,10 +730,32 @@ int main(void) {
       BlinkyToggle++;
     }
   
-    // Checking to see if the user has input a character and acting accordingly.
-    while(UARTCharsAvail(UART0_BASE)) {
-      CharacterInput = UARTCharGetNonBlocking(UART0_BASE);
-      menuSwitch();
+    // Hand everything the UART interrupt has received since the last pass
+    // to the menu, a batch at a time.
+    ui32Count = UARTRxRead(&g_sUART0Rx, pui8Input, sizeof(pui8Input));
+    for(uint32_t i = 0; (i < ui32Count) && (whileLoop != 0); i++) {
+      menuSwitch(pui8Input[i]);
+    }
+    
+    // Rewrite whichever dashboard values changed, at most DASH_UPDATE_HZ
+    // times a second.
+    if(g_sDash.bActive && (ADCLoadValue != 0)) {
+      VTDashSet(&g_sDash, 0, ADCLoadValue);
+      VTDashSet(&g_sDash, 1, ServicedLast);
+      VTDashSet(&g_sDash, 2, SysCtlClockGet() / ADCLoadValue);
+      VTDashUpdate(&g_sDash, CycleCounterGet());
+    }
+    
+    // Draw the latest timer values into RAM and hand whatever changed to
+    // the uDMA.  A flush still in flight just leaves the damage for the
+    // next pass.
+    if(g_bReadoutStale) {
+      g_bReadoutStale = false;
+      drawReadout();
+    }
+    if((whileLoop != 0) && !FrameBufBusy(&g_sFrameBuf)) {
+      g_ui32FlushStart = CycleCounterGet();
+      FrameBufFlushAsync(&g_sFrameBuf, flushDone, 0);
     }
   }
 } 
\ No newline at end of file
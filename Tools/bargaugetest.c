@@ -0,0 +1,202 @@
+//*****************************************************************************
+//
+// bargaugetest.c - Host check of the bar gauge in Common/bargauge.c.
+//
+// Draws the gauge on a model screen through a run of lengths, including
+// repeats and values outside the gauge, and after each draw checks that
+// the screen shows exactly the bar asked for and that only the columns
+// between the old and new lengths were painted.
+//
+// Build and run on the host:
+//
+//     cc -O2 -Istubs -I../Common -o bargaugetest bargaugetest.c ../Common/bargauge.c
+//     ./bargaugetest
+//
+// Prints each failed check and exits non-zero if there were any.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "grlib/grlib.h"
+#include "bargauge.h"
+
+#define CHECK(x)                Check((x), #x, __LINE__)
+
+//*****************************************************************************
+//
+// Size of the model screen and the colors used.  The screen starts in a
+// third color so an unpainted pixel shows.
+//
+//*****************************************************************************
+#define SCREEN_WIDTH            96
+#define SCREEN_HEIGHT           16
+#define COLOR_FILL              0x00FF00
+#define COLOR_BACK              0x000040
+#define COLOR_UNSET             0xFFFFFF
+
+//*****************************************************************************
+//
+// The model screen and the pixels painted since the last Reset().
+//
+//*****************************************************************************
+static uint32_t g_ppui32Screen[SCREEN_HEIGHT][SCREEN_WIDTH];
+static uint32_t g_ui32Painted;
+static uint32_t g_ui32Failures;
+
+//*****************************************************************************
+//
+// Model of grlib: colors translate to themselves and a fill paints the
+// model screen.
+//
+//*****************************************************************************
+static uint32_t
+ColorTranslate(void *pvDisplayData, uint32_t ui32Value)
+{
+  (void)pvDisplayData;
+  return(ui32Value);
+}
+
+void
+GrRectFill(const tContext *psContext, const tRectangle *psRect)
+{
+  int32_t i32X, i32Y;
+
+  for(i32Y = psRect->i16YMin; i32Y <= psRect->i16YMax; i32Y++) {
+    for(i32X = psRect->i16XMin; i32X <= psRect->i16XMax; i32X++) {
+      g_ppui32Screen[i32Y][i32X] = psContext->ui32Foreground;
+      g_ui32Painted++;
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// Records a failed check.
+//
+//*****************************************************************************
+static void
+Check(bool bOK, const char *pcWhat, int iLine)
+{
+  if(!bOK) {
+    printf("line %d: %s\n", iLine, pcWhat);
+    g_ui32Failures++;
+  }
+}
+
+//*****************************************************************************
+//
+// Returns true if the gauge area shows a bar i32Length long and nothing
+// outside it was touched.
+//
+//*****************************************************************************
+static bool
+Shows(const tRectangle *psRect, int32_t i32Length)
+{
+  uint32_t ui32Want;
+  int32_t i32X, i32Y;
+  bool bInside;
+
+  for(i32Y = 0; i32Y < SCREEN_HEIGHT; i32Y++) {
+    for(i32X = 0; i32X < SCREEN_WIDTH; i32X++) {
+      bInside = (i32X >= psRect->i16XMin) && (i32X <= psRect->i16XMax) &&
+                (i32Y >= psRect->i16YMin) && (i32Y <= psRect->i16YMax);
+      if(!bInside) {
+        ui32Want = COLOR_UNSET;
+      }
+      else if((i32X - psRect->i16XMin) < i32Length) {
+        ui32Want = COLOR_FILL;
+      }
+      else {
+        ui32Want = COLOR_BACK;
+      }
+      if(g_ppui32Screen[i32Y][i32X] != ui32Want) {
+        return(false);
+      }
+    }
+  }
+
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Draws a run of lengths and checks each step.
+//
+//*****************************************************************************
+int
+main(void)
+{
+  static const int32_t pi32Lengths[] =
+  {
+    30, 30, 31, 10, 0, 0, -5, 80, 81, 200, 79, 1, 80, 40
+  };
+  tDisplay sDisplay;
+  tContext sContext;
+  tRectangle sRect;
+  tBarGauge sGauge;
+  uint32_t ui32Idx, ui32Height, ui32Want;
+  int32_t i32X, i32Y, i32Width, i32Length, i32Shown;
+  bool bDrew;
+
+  for(i32Y = 0; i32Y < SCREEN_HEIGHT; i32Y++) {
+    for(i32X = 0; i32X < SCREEN_WIDTH; i32X++) {
+      g_ppui32Screen[i32Y][i32X] = COLOR_UNSET;
+    }
+  }
+  memset(&sDisplay, 0, sizeof(sDisplay));
+  sDisplay.pfnColorTranslate = ColorTranslate;
+  memset(&sContext, 0, sizeof(sContext));
+  sContext.psDisplay = &sDisplay;
+
+  sRect.i16XMin = 8;
+  sRect.i16YMin = 4;
+  sRect.i16XMax = 87;
+  sRect.i16YMax = 9;
+  i32Width = sRect.i16XMax - sRect.i16XMin + 1;
+  ui32Height = sRect.i16YMax - sRect.i16YMin + 1;
+  BarGaugeInit(&sGauge, &sRect, COLOR_FILL, COLOR_BACK);
+
+  // The first draw paints the whole gauge, every later one only the strip
+  // between the lengths.
+  i32Shown = -1;
+  for(ui32Idx = 0; ui32Idx < (sizeof(pi32Lengths) / sizeof(pi32Lengths[0]));
+      ui32Idx++) {
+    i32Length = pi32Lengths[ui32Idx];
+    i32Length = (i32Length < 0) ? 0 :
+                (i32Length > i32Width) ? i32Width : i32Length;
+    if(i32Shown < 0) {
+      ui32Want = i32Width * ui32Height;
+    }
+    else if(i32Length > i32Shown) {
+      ui32Want = (i32Length - i32Shown) * ui32Height;
+    }
+    else {
+      ui32Want = (i32Shown - i32Length) * ui32Height;
+    }
+
+    g_ui32Painted = 0;
+    bDrew = BarGaugeDraw(&sGauge, &sContext, pi32Lengths[ui32Idx]);
+    if(!Shows(&sRect, i32Length) || (g_ui32Painted != ui32Want) ||
+       (sGauge.ui32Pixels != ui32Want) || (bDrew != (ui32Want != 0))) {
+      printf("draw %d after %d: painted %u (gauge says %u), expected %u\n",
+             pi32Lengths[ui32Idx], i32Shown, g_ui32Painted,
+             sGauge.ui32Pixels, ui32Want);
+      g_ui32Failures++;
+    }
+    i32Shown = i32Length;
+  }
+
+  // After an invalidate the next draw repaints it all, even unchanged.
+  BarGaugeInvalidate(&sGauge);
+  g_ui32Painted = 0;
+  CHECK(BarGaugeDraw(&sGauge, &sContext, i32Shown));
+  CHECK(g_ui32Painted == (i32Width * ui32Height));
+  CHECK(Shows(&sRect, i32Shown));
+
+  printf("bargauge: %s\n", g_ui32Failures ? "FAILED" : "passed");
+  return(g_ui32Failures ? 1 : 0);
+}
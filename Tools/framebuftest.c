@@ -0,0 +1,513 @@
+//*****************************************************************************
+//
+// framebuftest.c - Host check of the framebuffer in Common/framebuf.c.
+//
+// Links the framebuffer against a model SSD1332 panel that decodes the
+// window commands and pixel data written to the SSI, so after every flush
+// the panel can be compared with what was drawn.  Checks that a redraw of
+// unchanged pixels sends nothing, that touching regions merge into one
+// window, that the dirty list never holds more than FRAMEBUF_MAX_DIRTY
+// windows yet still covers every change, and that the indexed palette
+// gives out free entries, falls back to the nearest color when full, keeps
+// entries set by FrameBufPaletteSet() to themselves and recolors their
+// pixels at the next flush.  Once an entry is set, changing its color again
+// must resend only the area drawn with it, and setting the color it
+// already has must resend nothing.
+//
+// Build and run on the host:
+//
+//     cc -O2 -Istubs -I../Common -o framebuftest framebuftest.c ../Common/framebuf.c
+//     ./framebuftest
+//
+// Prints each failed check and exits non-zero if there were any.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "inc/hw_memmap.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/ssi.h"
+#include "driverlib/udma.h"
+#include "grlib/grlib.h"
+#include "udmactl.h"
+#include "framebuf.h"
+
+#define CHECK(x)                Check((x), #x, __LINE__)
+
+//*****************************************************************************
+//
+// Model panel: the pixels it shows, the window being written and the bytes
+// of the command or pixel in progress.
+//
+//*****************************************************************************
+static uint16_t g_ppui16Panel[FRAMEBUF_HEIGHT][FRAMEBUF_WIDTH];
+static bool g_bData;
+static uint8_t g_pui8Cmd[6];
+static uint32_t g_ui32CmdLen;
+static int32_t g_i32X1, g_i32X2, g_i32Y2, g_i32X, g_i32Y;
+static uint32_t g_ui32Byte;
+static bool g_bHigh;
+static uint32_t g_ui32Bad;
+
+static uint32_t g_ui32Failures;
+
+//*****************************************************************************
+//
+// Model driverlib: the D/C pin and the SSI feed the model panel.  Nothing
+// here uses the uDMA.
+//
+//*****************************************************************************
+void
+GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+  if((ui32Port == GPIO_PORTH_BASE) && (ui8Pins == GPIO_PIN_6)) {
+    g_bData = (ui8Val != 0);
+    g_ui32CmdLen = 0;
+    g_bHigh = true;
+  }
+}
+
+void
+SSIDataPut(uint32_t ui32Base, uint32_t ui32Data)
+{
+  (void)ui32Base;
+
+  if(!g_bData) {
+    if(g_ui32CmdLen < sizeof(g_pui8Cmd)) {
+      g_pui8Cmd[g_ui32CmdLen++] = ui32Data;
+    }
+    if((g_ui32CmdLen == 6) && (g_pui8Cmd[0] == 0x15) &&
+       (g_pui8Cmd[3] == 0x75)) {
+      g_i32X1 = g_pui8Cmd[1];
+      g_i32X2 = g_pui8Cmd[2];
+      g_i32Y2 = g_pui8Cmd[5];
+      g_i32X = g_i32X1;
+      g_i32Y = g_pui8Cmd[4];
+    }
+    return;
+  }
+
+  // Pixels arrive high byte first and fill the window row by row.
+  if(g_bHigh) {
+    g_ui32Byte = ui32Data << 8;
+    g_bHigh = false;
+    return;
+  }
+  g_bHigh = true;
+  if((g_i32Y > g_i32Y2) || (g_i32X >= FRAMEBUF_WIDTH) ||
+     (g_i32Y >= FRAMEBUF_HEIGHT)) {
+    g_ui32Bad++;
+    return;
+  }
+  g_ppui16Panel[g_i32Y][g_i32X] = g_ui32Byte | (ui32Data & 0xFF);
+  if(++g_i32X > g_i32X2) {
+    g_i32X = g_i32X1;
+    g_i32Y++;
+  }
+}
+
+bool
+SSIBusy(uint32_t ui32Base)
+{
+  (void)ui32Base;
+  return(false);
+}
+
+void SSIDMAEnable(uint32_t ui32Base, uint32_t ui32Flags)
+{
+  (void)ui32Base;
+  (void)ui32Flags;
+}
+
+void SSIDMADisable(uint32_t ui32Base, uint32_t ui32Flags)
+{
+  (void)ui32Base;
+  (void)ui32Flags;
+}
+
+bool
+IntMasterDisable(void)
+{
+  return(false);
+}
+
+bool
+IntMasterEnable(void)
+{
+  return(false);
+}
+
+void uDMAControlInit(void) { }
+void uDMAChannelAssign(uint32_t ui32Mapping) { (void)ui32Mapping; }
+void uDMAChannelAttributeDisable(uint32_t ui32Channel, uint32_t ui32Attr)
+{
+  (void)ui32Channel;
+  (void)ui32Attr;
+}
+void uDMAChannelControlSet(uint32_t ui32Channel, uint32_t ui32Control)
+{
+  (void)ui32Channel;
+  (void)ui32Control;
+}
+void uDMAChannelTransferSet(uint32_t ui32Channel, uint32_t ui32Mode,
+                            void *pvSrc, void *pvDst, uint32_t ui32Size)
+{
+  (void)ui32Channel;
+  (void)ui32Mode;
+  (void)pvSrc;
+  (void)pvDst;
+  (void)ui32Size;
+}
+void uDMAChannelEnable(uint32_t ui32Channel) { (void)ui32Channel; }
+bool uDMAChannelIsEnabled(uint32_t ui32Channel)
+{
+  (void)ui32Channel;
+  return(false);
+}
+
+//*****************************************************************************
+//
+// Model panel driver: only its color translation is used, which packs
+// 24-bit RGB to 5-6-5 as the CFAL96x64x16 driver does.
+//
+//*****************************************************************************
+static uint32_t
+PanelColorTranslate(void *pvDisplayData, uint32_t ui32Value)
+{
+  (void)pvDisplayData;
+  return(((ui32Value >> 8) & 0xF800) | ((ui32Value >> 5) & 0x07E0) |
+         ((ui32Value >> 3) & 0x001F));
+}
+
+static tDisplay g_sPanel;
+
+//*****************************************************************************
+//
+// Records a failed check.
+//
+//*****************************************************************************
+static void
+Check(bool bOK, const char *pcWhat, int iLine)
+{
+  if(!bOK) {
+    printf("line %d: %s\n", iLine, pcWhat);
+    g_ui32Failures++;
+  }
+}
+
+//*****************************************************************************
+//
+// Fills the model panel with a color nothing draws, so a pixel the flush
+// should have sent and did not shows up.
+//
+//*****************************************************************************
+static void
+PanelReset(void)
+{
+  int32_t i32X, i32Y;
+
+  for(i32Y = 0; i32Y < FRAMEBUF_HEIGHT; i32Y++) {
+    for(i32X = 0; i32X < FRAMEBUF_WIDTH; i32X++) {
+      g_ppui16Panel[i32Y][i32X] = 0x1234;
+    }
+  }
+  g_ui32Bad = 0;
+  memset(&g_sPanel, 0, sizeof(g_sPanel));
+  g_sPanel.pfnColorTranslate = PanelColorTranslate;
+}
+
+//*****************************************************************************
+//
+// Returns true if the model panel shows what the framebuffer holds.
+//
+//*****************************************************************************
+static bool
+PanelMatches(const tFrameBuf *psFB)
+{
+  uint32_t ui32Pos, ui32Pixel;
+  int32_t i32X, i32Y;
+
+  if(g_ui32Bad) {
+    return(false);
+  }
+  for(i32Y = 0; i32Y < FRAMEBUF_HEIGHT; i32Y++) {
+    for(i32X = 0; i32X < FRAMEBUF_WIDTH; i32X++) {
+      ui32Pos = (i32Y * FRAMEBUF_WIDTH) + i32X;
+      if(psFB->pui8Indices) {
+        ui32Pixel = psFB->pui16Expand[(psFB->pui8Indices[ui32Pos / 2] >>
+                                       ((ui32Pos & 1) ? 0 : 4)) & 15];
+      }
+      else {
+        ui32Pixel = psFB->pui16Pixels[ui32Pos];
+      }
+      if(g_ppui16Panel[i32Y][i32X] !=
+         (((ui32Pixel & 0xFF) << 8) | (ui32Pixel >> 8))) {
+        return(false);
+      }
+    }
+  }
+
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Fills a rectangle through the framebuffer's grlib interface, clipped to
+// the screen first as grlib would.
+//
+//*****************************************************************************
+static void
+Fill(tFrameBuf *psFB, int32_t i32X1, int32_t i32Y1, int32_t i32X2,
+     int32_t i32Y2, uint32_t ui32Color)
+{
+  const tDisplay *psDisplay = &psFB->sDisplay;
+  tRectangle sRect;
+
+  sRect.i16XMin = i32X1;
+  sRect.i16YMin = i32Y1;
+  sRect.i16XMax = (i32X2 < FRAMEBUF_WIDTH) ? i32X2 : (FRAMEBUF_WIDTH - 1);
+  sRect.i16YMax = (i32Y2 < FRAMEBUF_HEIGHT) ? i32Y2 : (FRAMEBUF_HEIGHT - 1);
+  psDisplay->pfnRectFill(psDisplay->pvDisplayData, &sRect,
+                         psDisplay->pfnColorTranslate(psDisplay->pvDisplayData,
+                                                      ui32Color));
+}
+
+//*****************************************************************************
+//
+// The storage of the framebuffers under test.
+//
+//*****************************************************************************
+static tFrameBuf g_sFB;
+static uint16_t g_pui16Pixels[FRAMEBUF_PIXELS];
+static uint8_t g_pui8Indices[FRAMEBUF_INDEXED_BYTES];
+
+//*****************************************************************************
+//
+// Dirty tracking and region merging on a full color framebuffer.
+//
+//*****************************************************************************
+static void
+CheckDamage(void)
+{
+  uint32_t ui32Pass, ui32Rect, ui32Most;
+  int32_t i32X, i32Y;
+
+  PanelReset();
+  FrameBufInit(&g_sFB, &g_sPanel, g_pui16Pixels);
+
+  // The first flush sends the whole screen, the next nothing.
+  CHECK(FrameBufFlush(&g_sFB) == FRAMEBUF_PIXELS);
+  CHECK(g_sFB.ui32Windows == 1);
+  CHECK(PanelMatches(&g_sFB));
+  CHECK(FrameBufFlush(&g_sFB) == 0);
+
+  // Drawing what is already there marks nothing.
+  Fill(&g_sFB, 0, 0, 95, 63, ClrBlack);
+  CHECK(g_sFB.ui32NumDirty == 0);
+
+  // Two squares sharing an edge go out as one window of their union.
+  Fill(&g_sFB, 5, 5, 14, 14, 0xFF0000);
+  Fill(&g_sFB, 15, 5, 24, 14, 0x00FF00);
+  CHECK(g_sFB.ui32NumDirty == 1);
+  CHECK(FrameBufFlush(&g_sFB) == 200);
+  CHECK(PanelMatches(&g_sFB));
+
+  // Apart, they stay as two windows.
+  Fill(&g_sFB, 0, 40, 3, 43, 0x0000FF);
+  Fill(&g_sFB, 90, 60, 95, 63, 0x0000FF);
+  CHECK(FrameBufFlush(&g_sFB) == (16 + 24));
+  CHECK(g_sFB.ui32Windows == 2);
+  CHECK(PanelMatches(&g_sFB));
+
+  // Redrawing a square with one line changed sends just the line.
+  Fill(&g_sFB, 5, 5, 14, 14, 0xFF0000);
+  Fill(&g_sFB, 7, 9, 12, 9, 0xFFFFFF);
+  CHECK(FrameBufFlush(&g_sFB) == 6);
+  CHECK(PanelMatches(&g_sFB));
+
+  // Five regions apart from each other still fit the dirty list, merged.
+  for(ui32Rect = 0; ui32Rect < 5; ui32Rect++) {
+    i32X = ui32Rect * 19;
+    i32Y = (ui32Rect & 1) ? 50 : 20;
+    Fill(&g_sFB, i32X, i32Y, i32X + 1, i32Y + 1, 0xFFFF00);
+  }
+  CHECK(g_sFB.ui32NumDirty == FRAMEBUF_MAX_DIRTY);
+  CHECK(FrameBufFlush(&g_sFB) >= 20);
+  CHECK(PanelMatches(&g_sFB));
+
+  // Random drawing: every flush must leave the panel in step, with no more
+  // than FRAMEBUF_MAX_DIRTY windows.
+  srand(1);
+  ui32Most = 0;
+  for(ui32Pass = 0; ui32Pass < 500; ui32Pass++) {
+    for(ui32Rect = rand() % 8; ui32Rect != 0; ui32Rect--) {
+      i32X = rand() % FRAMEBUF_WIDTH;
+      i32Y = rand() % FRAMEBUF_HEIGHT;
+      Fill(&g_sFB, i32X, i32Y, i32X + (rand() % 12), i32Y + (rand() % 12),
+           (rand() & 1) ? 0x808080 : 0x00FFFF);
+    }
+    FrameBufFlush(&g_sFB);
+    if(g_sFB.ui32Windows > ui32Most) {
+      ui32Most = g_sFB.ui32Windows;
+    }
+    if(!PanelMatches(&g_sFB)) {
+      printf("pass %u: panel out of step after the flush\n", ui32Pass);
+      g_ui32Failures++;
+      break;
+    }
+  }
+  CHECK(ui32Most <= FRAMEBUF_MAX_DIRTY);
+}
+
+//*****************************************************************************
+//
+// The palette of an indexed framebuffer.
+//
+//*****************************************************************************
+static void
+CheckPalette(void)
+{
+  const tDisplay *psDisplay = &g_sFB.sDisplay;
+  uint32_t ui32Idx, ui32Index;
+
+  PanelReset();
+  FrameBufInitIndexed(&g_sFB, &g_sPanel, g_pui8Indices);
+  CHECK(FrameBufFlush(&g_sFB) == FRAMEBUF_PIXELS);
+  CHECK(PanelMatches(&g_sFB));
+
+  // Black is entry 0; fifteen more colors take the free entries, and the
+  // same color again reuses its entry.
+  CHECK(psDisplay->pfnColorTranslate(g_sFB.sDisplay.pvDisplayData,
+                                     ClrBlack) == 0);
+  for(ui32Idx = 1; ui32Idx < FRAMEBUF_PALETTE_SIZE; ui32Idx++) {
+    Fill(&g_sFB, ui32Idx * 6, 0, (ui32Idx * 6) + 5, 7, ui32Idx * 0x111111);
+  }
+  CHECK(g_sFB.ui32PaletteUsed == 0xFFFF);
+  CHECK(g_sFB.ui32PaletteMisses == 0);
+  CHECK(psDisplay->pfnColorTranslate(g_sFB.sDisplay.pvDisplayData,
+                                     0x333333) == 3);
+  CHECK(FrameBufFlush(&g_sFB) == (15 * 6 * 8));
+  CHECK(PanelMatches(&g_sFB));
+
+  // With the palette full a new color is drawn as the nearest one held.
+  CHECK(psDisplay->pfnColorTranslate(g_sFB.sDisplay.pvDisplayData,
+                                     0x343434) == 3);
+  CHECK(g_sFB.ui32PaletteMisses == 1);
+
+  // An entry the application sets is its own: drawing by FRAMEBUF_INDEX()
+  // uses it, the same color drawn by value does not.
+  PanelReset();
+  FrameBufInitIndexed(&g_sFB, &g_sPanel, g_pui8Indices);
+  FrameBufFlush(&g_sFB);
+  FrameBufPaletteSet(&g_sFB, 5, 0xFF0000);
+  CHECK(g_sFB.ui32NumDirty == 0);
+  Fill(&g_sFB, 10, 10, 19, 19, FRAMEBUF_INDEX(5));
+  Fill(&g_sFB, 30, 30, 31, 31, FRAMEBUF_INDEX(5));
+  ui32Index = psDisplay->pfnColorTranslate(g_sFB.sDisplay.pvDisplayData,
+                                           0xFF0000);
+  CHECK(ui32Index != 5);
+  Fill(&g_sFB, 50, 10, 59, 19, 0xFF0000);
+  CHECK(FrameBufFlush(&g_sFB) == (100 + 4 + 100));
+  CHECK(PanelMatches(&g_sFB));
+
+  // Changing the entry recolors its pixels at the next flush, sending only
+  // the area they cover.
+  FrameBufPaletteSet(&g_sFB, 5, 0x00FF00);
+  CHECK(FrameBufFlush(&g_sFB) == (22 * 22));
+  CHECK(PanelMatches(&g_sFB));
+  CHECK(g_ppui16Panel[31][31] == PanelColorTranslate(0, 0x00FF00));
+  CHECK(g_ppui16Panel[15][55] == PanelColorTranslate(0, 0xFF0000));
+
+  // The same color again resends nothing.
+  FrameBufPaletteSet(&g_sFB, 5, 0x00FF00);
+  CHECK(g_sFB.ui32NumDirty == 0);
+  CHECK(FrameBufFlush(&g_sFB) == 0);
+}
+
+//*****************************************************************************
+//
+// The cost of a palette swap once the entry is set: only the area drawn
+// with it since, however it was drawn.
+//
+//*****************************************************************************
+static void
+CheckPaletteSwap(void)
+{
+  uint16_t pui16Block[16];
+  tRectangle sRect;
+  uint32_t ui32Pass;
+
+  PanelReset();
+  FrameBufInitIndexed(&g_sFB, &g_sPanel, g_pui8Indices);
+  FrameBufFlush(&g_sFB);
+
+  // Set while nothing is drawn with it: nothing to resend.  A square drawn
+  // afterwards is all a swap resends.
+  FrameBufPaletteSet(&g_sFB, 7, 0xFF00FF);
+  CHECK(FrameBufFlush(&g_sFB) == 0);
+  Fill(&g_sFB, 40, 40, 43, 43, FRAMEBUF_INDEX(7));
+  FrameBufFlush(&g_sFB);
+  FrameBufPaletteSet(&g_sFB, 7, 0x00FFFF);
+  CHECK(FrameBufFlush(&g_sFB) == 16);
+  CHECK(PanelMatches(&g_sFB));
+
+  // Pixels copied with FrameBufBlit(), as a sprite restores what it
+  // covered, count as drawn with the entry too.
+  sRect.i16XMin = 40;
+  sRect.i16YMin = 40;
+  sRect.i16XMax = 43;
+  sRect.i16YMax = 43;
+  FrameBufRead(&g_sFB, &sRect, pui16Block);
+  sRect.i16XMin = 60;
+  sRect.i16YMin = 10;
+  sRect.i16XMax = 63;
+  sRect.i16YMax = 13;
+  FrameBufBlit(&g_sFB, &sRect, pui16Block, 0);
+  FrameBufFlush(&g_sFB);
+  FrameBufPaletteSet(&g_sFB, 7, 0xFFFF00);
+  CHECK(FrameBufFlush(&g_sFB) == ((63 - 40 + 1) * (43 - 10 + 1)));
+  CHECK(PanelMatches(&g_sFB));
+
+  // Party mode: the screen painted in the entry once, text over it, then a
+  // new color every pass.  Each pass resends the screen and no more.
+  Fill(&g_sFB, 0, 0, 95, 63, FRAMEBUF_INDEX(15));
+  FrameBufPaletteSet(&g_sFB, 15, 0x00008B);
+  Fill(&g_sFB, 20, 2, 75, 9, 0xFFFFFF);
+  FrameBufFlush(&g_sFB);
+  for(ui32Pass = 0; ui32Pass < 6; ui32Pass++) {
+    FrameBufPaletteSet(&g_sFB, 15,
+                       (ui32Pass % 3) == 0 ? 0xFF0000 :
+                       (ui32Pass % 3) == 1 ? 0x008000 : 0x00008B);
+    CHECK(FrameBufFlush(&g_sFB) == FRAMEBUF_PIXELS);
+    CHECK(PanelMatches(&g_sFB));
+  }
+
+  // A full color framebuffer has no palette to change.
+  PanelReset();
+  FrameBufInit(&g_sFB, &g_sPanel, g_pui16Pixels);
+  FrameBufFlush(&g_sFB);
+  FrameBufPaletteSet(&g_sFB, 0, 0xFFFFFF);
+  CHECK(g_sFB.ui32NumDirty == 0);
+}
+
+//*****************************************************************************
+//
+// Runs the checks.
+//
+//*****************************************************************************
+int
+main(void)
+{
+  CheckDamage();
+  CheckPalette();
+  CheckPaletteSwap();
+
+  printf("framebuf: %s\n", g_ui32Failures ? "FAILED" : "passed");
+  return(g_ui32Failures ? 1 : 0);
+}
@@ -0,0 +1,427 @@
+//*****************************************************************************
+//
+// numfmtbench.c - Host microbenchmark of Common/numfmt.c against sprintf().
+//
+// Formats the exact strings the labs build on their hot paths, once with
+// sprintf() as the labs used to and once with the NumFmt calls that replaced
+// it, and reports for each:
+//
+//     time      average per call, in nanoseconds and, on x86, TSC cycles
+//     stack     peak stack the call used, measured by running it on a
+//               painted stack of its own and seeing how much was touched
+//
+// Every pair must produce identical text; a mismatch fails the run.  The
+// host C library is not newlib and the host is not a Cortex-M4, so the
+// absolute figures only show the ratio to expect on the board.
+//
+// Build and run on the host:
+//
+//     cc -O2 -pthread -I../Common -o numfmtbench numfmtbench.c ../Common/numfmt.c
+//     ./numfmtbench [iterations]
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "numfmt.h"
+
+//*****************************************************************************
+//
+// Default iterations per format, the stack given to each stack measurement
+// and the pattern it is painted with.
+//
+//*****************************************************************************
+#define DEFAULT_ITERATIONS      1000000
+#define PROBE_STACK             (64 * 1024)
+#define PAINT                   0xA5
+
+//*****************************************************************************
+//
+// One format: a sprintf() version and a NumFmt version of the same line,
+// and the range of values the lab feeds it.
+//
+//*****************************************************************************
+typedef struct
+{
+  const char *pcName;
+  void (*pfnPrintf)(char *pcBuf, int32_t i32Value);
+  void (*pfnNumFmt)(char *pcBuf, int32_t i32Value);
+  int32_t i32Min;
+  int32_t i32Max;
+} tFormat;
+
+//*****************************************************************************
+//
+// Lab2Cleaned.c status lines, redrawn on every received character.
+//
+//*****************************************************************************
+static void
+Lab2LoopPrintf(char *pcBuf, int32_t i32Value)
+{
+  sprintf(pcBuf, "Loop: %d", (int)i32Value);
+}
+
+static void
+Lab2LoopNumFmt(char *pcBuf, int32_t i32Value)
+{
+  NumFmtDec(NumFmtStr(pcBuf, "Loop: "), i32Value, 0, ' ');
+}
+
+static void
+Lab2CountPrintf(char *pcBuf, int32_t i32Value)
+{
+  sprintf(pcBuf, "Press Counter: %d", (int)i32Value);
+}
+
+static void
+Lab2CountNumFmt(char *pcBuf, int32_t i32Value)
+{
+  NumFmtDec(NumFmtStr(pcBuf, "Press Counter: "), i32Value, 0, ' ');
+}
+
+//*****************************************************************************
+//
+// Lab9_Final.c readout lines, formatted in the Timer0 interrupt.
+//
+//*****************************************************************************
+static void
+Lab9SrvPrintf(char *pcBuf, int32_t i32Value)
+{
+  sprintf(pcBuf, "Srv: %d         ", (int)i32Value);
+}
+
+static void
+Lab9SrvNumFmt(char *pcBuf, int32_t i32Value)
+{
+  NumFmtStr(NumFmtDec(NumFmtStr(pcBuf, "Srv: "), i32Value, 0, ' '),
+            "         ");
+}
+
+static void
+Lab9PerPrintf(char *pcBuf, int32_t i32Value)
+{
+  sprintf(pcBuf, "Per: %u         ", (unsigned)i32Value);
+}
+
+static void
+Lab9PerNumFmt(char *pcBuf, int32_t i32Value)
+{
+  NumFmtStr(NumFmtUDec(NumFmtStr(pcBuf, "Per: "), i32Value, 0, ' '),
+            "         ");
+}
+
+//*****************************************************************************
+//
+// Lab3.c numeric pot readout, every loop.
+//
+//*****************************************************************************
+static void
+Lab3ADCPrintf(char *pcBuf, int32_t i32Value)
+{
+  sprintf(pcBuf, "%i", (int)i32Value);
+}
+
+static void
+Lab3ADCNumFmt(char *pcBuf, int32_t i32Value)
+{
+  NumFmtUDec(pcBuf, i32Value, 0, ' ');
+}
+
+//*****************************************************************************
+//
+// vtdash.c cursor move and a width 6 field, for every dashboard value that
+// changes.
+//
+//*****************************************************************************
+static void
+DashCursorPrintf(char *pcBuf, int32_t i32Value)
+{
+  sprintf(pcBuf, "\033[%u;%uH", (unsigned)(i32Value & 15) + 1,
+          (unsigned)(i32Value % 80) + 1);
+}
+
+static void
+DashCursorNumFmt(char *pcBuf, int32_t i32Value)
+{
+  pcBuf = NumFmtStr(pcBuf, "\033[");
+  pcBuf = NumFmtUDec(pcBuf, (i32Value & 15) + 1, 0, ' ');
+  pcBuf = NumFmtStr(pcBuf, ";");
+  pcBuf = NumFmtUDec(pcBuf, (i32Value % 80) + 1, 0, ' ');
+  NumFmtStr(pcBuf, "H");
+}
+
+static void
+DashFieldPrintf(char *pcBuf, int32_t i32Value)
+{
+  sprintf(pcBuf, "%6d", (int)i32Value);
+}
+
+static void
+DashFieldNumFmt(char *pcBuf, int32_t i32Value)
+{
+  NumFmtDec(pcBuf, i32Value, 6, ' ');
+}
+
+static const tFormat g_psFormats[] =
+{
+  {"Lab 2 \"Loop: %d\"", Lab2LoopPrintf, Lab2LoopNumFmt, 0, 2000000000},
+  {"Lab 2 \"Press Counter: %d\"", Lab2CountPrintf, Lab2CountNumFmt, 0, 99999},
+  {"Lab 9 \"Srv: %d         \"", Lab9SrvPrintf, Lab9SrvNumFmt, 0, 100000},
+  {"Lab 9 \"Per: %u         \"", Lab9PerPrintf, Lab9PerNumFmt, 1, 16000000},
+  {"Lab 3 \"%i\" (ADC)", Lab3ADCPrintf, Lab3ADCNumFmt, 0, 4095},
+  {"vtdash \"\\033[%u;%uH\"", DashCursorPrintf, DashCursorNumFmt, 0, 9999},
+  {"vtdash \"%6d\"", DashFieldPrintf, DashFieldNumFmt, -99999, 999999},
+};
+
+#define NUM_FORMATS             (sizeof(g_psFormats) / sizeof(g_psFormats[0]))
+
+//*****************************************************************************
+//
+// The values fed to every format, fixed so both versions see the same ones.
+//
+//*****************************************************************************
+#define NUM_VALUES              1024
+static uint32_t g_pui32Random[NUM_VALUES];
+
+//*****************************************************************************
+//
+// Keeps the compiler from discarding the formatted text.
+//
+//*****************************************************************************
+static volatile char g_cSink;
+
+//*****************************************************************************
+//
+// Reads a cycle counter, or 0 where there is none.
+//
+//*****************************************************************************
+static uint64_t
+Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return(__rdtsc());
+#else
+  return(0);
+#endif
+}
+
+//*****************************************************************************
+//
+// Returns nanoseconds on a monotonic clock.
+//
+//*****************************************************************************
+static uint64_t
+Nanoseconds(void)
+{
+  struct timespec sNow;
+
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return(((uint64_t)sNow.tv_sec * 1000000000) + sNow.tv_nsec);
+}
+
+//*****************************************************************************
+//
+// Maps a random word into a format's range of values.
+//
+//*****************************************************************************
+static int32_t
+Value(const tFormat *psFormat, uint32_t ui32Idx)
+{
+  uint32_t ui32Span = (uint32_t)(psFormat->i32Max - psFormat->i32Min) + 1;
+
+  return(psFormat->i32Min +
+         (int32_t)(g_pui32Random[ui32Idx % NUM_VALUES] % ui32Span));
+}
+
+//*****************************************************************************
+//
+// Times ui32Iterations calls of pfnFormat over the value table.  Returns the
+// average nanoseconds a call and stores the average cycles in *pdCycles.
+//
+//*****************************************************************************
+static double
+Time(const tFormat *psFormat, void (*pfnFormat)(char *, int32_t),
+     uint32_t ui32Iterations, double *pdCycles)
+{
+  char pcBuf[64];
+  uint64_t ui64Start, ui64Cycles;
+  uint32_t ui32Idx;
+
+  ui64Start = Nanoseconds();
+  ui64Cycles = Cycles();
+  for(ui32Idx = 0; ui32Idx < ui32Iterations; ui32Idx++) {
+    pfnFormat(pcBuf, Value(psFormat, ui32Idx));
+    g_cSink = pcBuf[0];
+  }
+  ui64Cycles = Cycles() - ui64Cycles;
+  *pdCycles = (double)ui64Cycles / ui32Iterations;
+
+  return((double)(Nanoseconds() - ui64Start) / ui32Iterations);
+}
+
+//*****************************************************************************
+//
+// Stack measurement.  The probe thread runs one formatter over every value on
+// a stack painted with PAINT; whatever is no longer PAINT was used.  The
+// same run with an empty function gives the thread's own overhead, which is
+// taken off.
+//
+//*****************************************************************************
+typedef struct
+{
+  const tFormat *psFormat;
+  void (*pfnFormat)(char *, int32_t);
+} tProbe;
+
+static void
+Nothing(char *pcBuf, int32_t i32Value)
+{
+  (void)pcBuf;
+  (void)i32Value;
+}
+
+static void *
+ProbeThread(void *pvArg)
+{
+  tProbe *psProbe = (tProbe *)pvArg;
+  char pcBuf[64];
+  uint32_t ui32Idx;
+
+  for(ui32Idx = 0; ui32Idx < NUM_VALUES; ui32Idx++) {
+    psProbe->pfnFormat(pcBuf, Value(psProbe->psFormat, ui32Idx));
+    g_cSink = pcBuf[0];
+  }
+
+  return(0);
+}
+
+static uint32_t
+StackUsed(const tFormat *psFormat, void (*pfnFormat)(char *, int32_t))
+{
+  static uint8_t pui8Stack[PROBE_STACK] __attribute__((aligned(4096)));
+  pthread_attr_t sAttr;
+  pthread_t sThread;
+  tProbe sProbe;
+  uint32_t ui32Idx;
+
+  memset(pui8Stack, PAINT, sizeof(pui8Stack));
+  sProbe.psFormat = psFormat;
+  sProbe.pfnFormat = pfnFormat;
+  pthread_attr_init(&sAttr);
+  pthread_attr_setstack(&sAttr, pui8Stack, sizeof(pui8Stack));
+  if(pthread_create(&sThread, &sAttr, ProbeThread, &sProbe) != 0) {
+    return(0);
+  }
+  pthread_join(sThread, 0);
+  pthread_attr_destroy(&sAttr);
+
+  // The stack grows down, so the first touched byte from the bottom marks
+  // the deepest point reached.
+  for(ui32Idx = 0; ui32Idx < sizeof(pui8Stack); ui32Idx++) {
+    if(pui8Stack[ui32Idx] != PAINT) {
+      break;
+    }
+  }
+
+  return(sizeof(pui8Stack) - ui32Idx);
+}
+
+//*****************************************************************************
+//
+// Checks both versions of a format agree on every value.  Returns the number
+// of mismatches.
+//
+//*****************************************************************************
+static uint32_t
+Compare(const tFormat *psFormat)
+{
+  char pcPrintf[64], pcNumFmt[64];
+  uint32_t ui32Idx, ui32Bad;
+  int32_t i32Value;
+
+  ui32Bad = 0;
+  for(ui32Idx = 0; ui32Idx < NUM_VALUES + 2; ui32Idx++) {
+    // Try both ends of the range as well.
+    if(ui32Idx == NUM_VALUES) {
+      i32Value = psFormat->i32Min;
+    }
+    else if(ui32Idx == NUM_VALUES + 1) {
+      i32Value = psFormat->i32Max;
+    }
+    else {
+      i32Value = Value(psFormat, ui32Idx);
+    }
+    psFormat->pfnPrintf(pcPrintf, i32Value);
+    psFormat->pfnNumFmt(pcNumFmt, i32Value);
+    if(strcmp(pcPrintf, pcNumFmt) != 0) {
+      if(ui32Bad == 0) {
+        printf("%s: %ld gives \"%s\" and \"%s\"\n", psFormat->pcName,
+               (long)i32Value, pcPrintf, pcNumFmt);
+      }
+      ui32Bad++;
+    }
+  }
+
+  return(ui32Bad);
+}
+
+//*****************************************************************************
+//
+// Runs every format and prints the comparison.
+//
+//*****************************************************************************
+int
+main(int argc, char *argv[])
+{
+  const tFormat *psFormat;
+  uint32_t ui32Iterations, ui32Idx, ui32Bad, ui32Base;
+  uint32_t ui32StackPrintf, ui32StackNumFmt;
+  double dPrintf, dNumFmt, dCyclesPrintf, dCyclesNumFmt;
+
+  ui32Iterations = (argc > 1) ? strtoul(argv[1], 0, 0) : DEFAULT_ITERATIONS;
+  srand(1);
+  for(ui32Idx = 0; ui32Idx < NUM_VALUES; ui32Idx++) {
+    g_pui32Random[ui32Idx] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+  }
+
+  ui32Base = StackUsed(&g_psFormats[0], Nothing);
+  ui32Bad = 0;
+
+  printf("%-28s %14s %14s %8s %14s\n", "", "sprintf", "NumFmt", "speedup",
+         "stack bytes");
+  printf("%-28s %14s %14s %8s %14s\n", "format", "ns (cycles)", "ns (cycles)",
+         "", "sprintf/NumFmt");
+  for(ui32Idx = 0; ui32Idx < NUM_FORMATS; ui32Idx++) {
+    psFormat = &g_psFormats[ui32Idx];
+    ui32Bad += Compare(psFormat);
+
+    dPrintf = Time(psFormat, psFormat->pfnPrintf, ui32Iterations,
+                   &dCyclesPrintf);
+    dNumFmt = Time(psFormat, psFormat->pfnNumFmt, ui32Iterations,
+                   &dCyclesNumFmt);
+    ui32StackPrintf = StackUsed(psFormat, psFormat->pfnPrintf) - ui32Base;
+    ui32StackNumFmt = StackUsed(psFormat, psFormat->pfnNumFmt) - ui32Base;
+
+    printf("%-28s %5.1f (%6.1f) %5.1f (%6.1f) %7.1fx %7lu/%-6lu\n",
+           psFormat->pcName, dPrintf, dCyclesPrintf, dNumFmt, dCyclesNumFmt,
+           dPrintf / dNumFmt, (unsigned long)ui32StackPrintf,
+           (unsigned long)ui32StackNumFmt);
+  }
+
+  if(ui32Bad) {
+    printf("numfmt: %lu outputs differ from sprintf\n", (unsigned long)ui32Bad);
+    return(1);
+  }
+  printf("numfmt: every output matches sprintf\n");
+
+  return(0);
+}
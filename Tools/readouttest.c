@@ -0,0 +1,208 @@
+//*****************************************************************************
+//
+// readouttest.c - Host check of the digit tile readout in Common/readout.c.
+//
+// Drives a readout on a model screen through a run of values and checks
+// the number of cells each update draws: 999 to 1000 is four cells, an
+// unchanged value none, a value too wide shows as dashes.  After each
+// update the screen must match a second readout drawn from scratch with
+// the same value, so a cell skipped by mistake shows up as a difference.
+//
+// Build and run on the host:
+//
+//     cc -O2 -Istubs -I../Common -o readouttest readouttest.c ../Common/readout.c
+//     ./readouttest
+//
+// Prints each failed check and exits non-zero if there were any.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "grlib/grlib.h"
+#include "readout.h"
+
+//*****************************************************************************
+//
+// Size of the model screens and where the readout goes on them.
+//
+//*****************************************************************************
+#define SCREEN_WIDTH            48
+#define SCREEN_HEIGHT           12
+#define READOUT_X               3
+#define READOUT_Y               2
+#define READOUT_CELLS           5
+
+//*****************************************************************************
+//
+// A model screen, which a tDisplay points at.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint32_t ppui32Pixels[SCREEN_HEIGHT][SCREEN_WIDTH];
+} tScreen;
+
+static uint32_t g_ui32Failures;
+
+//*****************************************************************************
+//
+// Model display driver: colors translate to themselves and rows of 1 bpp
+// pixels are drawn through their palette.
+//
+//*****************************************************************************
+static uint32_t
+ColorTranslate(void *pvDisplayData, uint32_t ui32Value)
+{
+  (void)pvDisplayData;
+  return(ui32Value);
+}
+
+static void
+PixelDrawMultiple(void *pvDisplayData, int32_t i32X, int32_t i32Y,
+                  int32_t i32X0, int32_t i32Count, int32_t i32BPP,
+                  const uint8_t *pui8Data, const uint8_t *pui8Palette)
+{
+  tScreen *psScreen = (tScreen *)pvDisplayData;
+  uint32_t ui32Pos;
+  int32_t i32Idx;
+
+  if((i32BPP != 1) || (i32Y < 0) || (i32Y >= SCREEN_HEIGHT)) {
+    printf("bad draw at row %d, %d bpp\n", i32Y, i32BPP);
+    g_ui32Failures++;
+    return;
+  }
+  for(i32Idx = 0; i32Idx < i32Count; i32Idx++) {
+    ui32Pos = i32X0 + i32Idx;
+    if(((i32X + i32Idx) < 0) || ((i32X + i32Idx) >= SCREEN_WIDTH)) {
+      continue;
+    }
+    psScreen->ppui32Pixels[i32Y][i32X + i32Idx] =
+      ((const uint32_t *)pui8Palette)[(pui8Data[ui32Pos >> 3] >>
+                                       (7 - (ui32Pos & 7))) & 1];
+  }
+}
+
+//*****************************************************************************
+//
+// Sets up a model screen, filled with a color the readout never uses, and
+// a display driver for it.
+//
+//*****************************************************************************
+static void
+ScreenInit(tScreen *psScreen, tDisplay *psDisplay)
+{
+  int32_t i32X, i32Y;
+
+  for(i32Y = 0; i32Y < SCREEN_HEIGHT; i32Y++) {
+    for(i32X = 0; i32X < SCREEN_WIDTH; i32X++) {
+      psScreen->ppui32Pixels[i32Y][i32X] = 0x808080;
+    }
+  }
+  memset(psDisplay, 0, sizeof(*psDisplay));
+  psDisplay->pvDisplayData = psScreen;
+  psDisplay->ui16Width = SCREEN_WIDTH;
+  psDisplay->ui16Height = SCREEN_HEIGHT;
+  psDisplay->pfnPixelDrawMultiple = PixelDrawMultiple;
+  psDisplay->pfnColorTranslate = ColorTranslate;
+}
+
+//*****************************************************************************
+//
+// The readout under test, updated value after value, and a reference drawn
+// from scratch for each value.
+//
+//*****************************************************************************
+static tScreen g_sScreen, g_sReference;
+static tDisplay g_sDisplay, g_sRefDisplay;
+static tReadout g_sReadout;
+
+//*****************************************************************************
+//
+// Shows a value and checks the cells drawn and the resulting screen.
+//
+//*****************************************************************************
+static void
+Step(int32_t i32Value, uint32_t ui32WantCells, int iLine)
+{
+  tReadout sRef;
+  uint32_t ui32Cells;
+
+  ui32Cells = ReadoutSetSigned(&g_sReadout, i32Value);
+  if(ui32Cells != ui32WantCells) {
+    printf("line %d: %d drew %u cells, expected %u\n", iLine, i32Value,
+           ui32Cells, ui32WantCells);
+    g_ui32Failures++;
+  }
+
+  ScreenInit(&g_sReference, &g_sRefDisplay);
+  ReadoutInit(&sRef, &g_sRefDisplay, READOUT_X, READOUT_Y, READOUT_CELLS,
+              0xFFFFFF, 0x000000);
+  if(ReadoutSetSigned(&sRef, i32Value) != READOUT_CELLS) {
+    printf("line %d: a fresh readout did not draw every cell\n", iLine);
+    g_ui32Failures++;
+  }
+  if(memcmp(&g_sScreen, &g_sReference, sizeof(tScreen))) {
+    printf("line %d: screen after %d differs from a fresh draw\n", iLine,
+           i32Value);
+    g_ui32Failures++;
+  }
+}
+
+#define STEP(v, n)              Step((v), (n), __LINE__)
+
+//*****************************************************************************
+//
+// Runs the checks.
+//
+//*****************************************************************************
+int
+main(void)
+{
+  tReadout sWide;
+
+  ScreenInit(&g_sScreen, &g_sDisplay);
+  ReadoutInit(&g_sReadout, &g_sDisplay, READOUT_X, READOUT_Y, READOUT_CELLS,
+              0xFFFFFF, 0x000000);
+
+  STEP(999, 5);                 // First draw: every cell
+  STEP(999, 0);                 // Unchanged: nothing
+  STEP(1000, 4);                // "  999" to " 1000"
+  STEP(1001, 1);
+  STEP(-42, 4);                 // " 1001" to "  -42"
+  STEP(-43, 1);
+  STEP(42, 2);                  // The sign cell goes blank
+  STEP(0, 2);
+  STEP(99999, 5);
+  STEP(100000, 5);              // Too wide: "-----"
+  STEP(123456, 0);              // Still too wide
+  STEP(-1234, 4);               // Fits, and the first dash stays
+  STEP(-12345, 4);              // Sign does not fit: dashes again
+  STEP(7, 5);
+
+  // An invalidate forgets the cells, so the next update draws them all.
+  ReadoutInvalidate(&g_sReadout);
+  STEP(7, 5);
+  if(g_sReadout.ui32Total != 47) {
+    printf("total %u cells, expected 47\n", g_sReadout.ui32Total);
+    g_ui32Failures++;
+  }
+
+  // Unsigned values beyond INT32_MAX and more cells than the readout may
+  // have.
+  ScreenInit(&g_sScreen, &g_sDisplay);
+  ReadoutInit(&sWide, &g_sDisplay, 0, 0, READOUT_MAX_CELLS + 4, 0xFFFFFF, 0);
+  if((sWide.ui32NumCells != READOUT_MAX_CELLS) ||
+     (ReadoutSetUnsigned(&sWide, 4294967295u) != READOUT_MAX_CELLS) ||
+     (ReadoutSetUnsigned(&sWide, 4294967294u) != 1) ||
+     (ReadoutSetSigned(&sWide, -2147483647 - 1) != 11)) {
+    printf("wide readout drew the wrong cells\n");
+    g_ui32Failures++;
+  }
+
+  printf("readout: %s\n", g_ui32Failures ? "FAILED" : "passed");
+  return(g_ui32Failures ? 1 : 0);
+}
@@ -0,0 +1,221 @@
+//*****************************************************************************
+//
+// spscqtest.c - Host stress test of the SPSC queue in Common/spscq.c.
+//
+// Runs a producer and a consumer on two threads, as the UART interrupt and
+// the main loop use the queue on the board.  Each element carries a
+// sequence number and its complement, so a torn or reordered copy shows up
+// at once.  Two runs are made:
+//
+//     lossless  the producer retries until each push is taken; every
+//               element must arrive, in order
+//     lossy     the producer never retries; the consumer must see a strictly
+//               rising sequence whose gaps add up to the elements given up
+//
+// In both, the queue's drop count must equal the pushes the producer saw
+// refused, and the high-water mark must lie between the largest batch the
+// consumer popped and the capacity.
+//
+// Build and run on the host:
+//
+//     cc -O2 -pthread -I../Common -o spscqtest spscqtest.c ../Common/spscq.c
+//     ./spscqtest [elements]
+//
+// Prints the counters of each run and exits non-zero if any check failed.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "spscq.h"
+
+//*****************************************************************************
+//
+// Queue size, the largest batch the consumer asks for and the default
+// number of elements pushed per run.
+//
+//*****************************************************************************
+#define QUEUE_CAPACITY          64
+#define POP_MAX                 24
+#define DEFAULT_ELEMENTS        2000000
+
+//*****************************************************************************
+//
+// One element, larger than a byte so the multi-byte copy path is used.
+//
+//*****************************************************************************
+typedef struct
+{
+  uint32_t ui32Seq;
+  uint32_t ui32Check;
+} tElem;
+
+//*****************************************************************************
+//
+// Shared state of one run.
+//
+//*****************************************************************************
+static tSPSCQueue g_sQueue;
+static tElem g_psStorage[QUEUE_CAPACITY];
+static uint32_t g_ui32Elements;
+static bool g_bRetry;
+static volatile bool g_bDone;
+static uint32_t g_ui32Refused;
+static uint32_t g_ui32Lost;
+
+//*****************************************************************************
+//
+// Producer thread: pushes sequence numbers 0 to g_ui32Elements - 1, now and
+// then pausing so the consumer can catch up and the queue runs both empty
+// and full.
+//
+//*****************************************************************************
+static void *
+Producer(void *pvArg)
+{
+  tElem sElem;
+  uint32_t ui32Seq;
+
+  (void)pvArg;
+  g_ui32Refused = 0;
+  g_ui32Lost = 0;
+  for(ui32Seq = 0; ui32Seq < g_ui32Elements; ui32Seq++) {
+    sElem.ui32Seq = ui32Seq;
+    sElem.ui32Check = ~ui32Seq;
+    while(!SPSCQueuePush(&g_sQueue, &sElem)) {
+      g_ui32Refused++;
+      if(!g_bRetry) {
+        g_ui32Lost++;
+        break;
+      }
+      sched_yield();
+    }
+    if((ui32Seq % 256) == 0) {
+      sched_yield();
+    }
+  }
+  g_bDone = true;
+
+  return(0);
+}
+
+//*****************************************************************************
+//
+// Runs one producer against a consumer on this thread and checks what
+// arrived.  Returns the number of failed checks.
+//
+//*****************************************************************************
+static uint32_t
+Run(const char *pcName, bool bRetry)
+{
+  pthread_t sThread;
+  tElem psBatch[POP_MAX];
+  uint32_t ui32Got, ui32Idx, ui32Received, ui32Expect, ui32Gaps;
+  uint32_t ui32MaxBatch, ui32Max, ui32Failures;
+  bool bDone;
+
+  SPSCQueueInit(&g_sQueue, g_psStorage, sizeof(tElem), QUEUE_CAPACITY);
+  g_bRetry = bRetry;
+  g_bDone = false;
+  ui32Received = 0;
+  ui32Expect = 0;
+  ui32Gaps = 0;
+  ui32MaxBatch = 0;
+  ui32Failures = 0;
+
+  if(pthread_create(&sThread, 0, Producer, 0) != 0) {
+    printf("%s: cannot start the producer\n", pcName);
+    return(1);
+  }
+
+  do {
+    // Read the flag first, so a queue found empty after it was set really
+    // is the end of the run.
+    bDone = g_bDone;
+    __sync_synchronize();
+
+    // Vary the batch size, and sometimes stall, so the consumer runs both
+    // ahead of and behind the producer.
+    ui32Max = 1 + (ui32Received % POP_MAX);
+    ui32Got = SPSCQueuePopBatch(&g_sQueue, psBatch, ui32Max);
+    if(ui32Got > ui32MaxBatch) {
+      ui32MaxBatch = ui32Got;
+    }
+    for(ui32Idx = 0; ui32Idx < ui32Got; ui32Idx++) {
+      if(psBatch[ui32Idx].ui32Check != ~psBatch[ui32Idx].ui32Seq) {
+        printf("%s: element %u torn\n", pcName, ui32Received);
+        ui32Failures++;
+      }
+      if(psBatch[ui32Idx].ui32Seq < ui32Expect) {
+        printf("%s: element %u out of order\n", pcName, ui32Received);
+        ui32Failures++;
+      }
+      else {
+        ui32Gaps += psBatch[ui32Idx].ui32Seq - ui32Expect;
+      }
+      ui32Expect = psBatch[ui32Idx].ui32Seq + 1;
+      ui32Received++;
+    }
+    if((ui32Got == 0) || ((ui32Received % 1000) == 999)) {
+      sched_yield();
+    }
+  }
+  while(!bDone || (ui32Got != 0));
+
+  pthread_join(sThread, 0);
+  ui32Gaps += g_ui32Elements - ui32Expect;
+
+  printf("%s: received %u of %u, dropped %u, high water %u, largest "
+         "batch %u\n", pcName, ui32Received, g_ui32Elements,
+         g_sQueue.ui32Dropped, g_sQueue.ui32HighWater, ui32MaxBatch);
+
+  if(ui32Received + g_ui32Lost != g_ui32Elements) {
+    printf("%s: received plus lost is not the elements pushed\n", pcName);
+    ui32Failures++;
+  }
+  if(g_sQueue.ui32Dropped != g_ui32Refused) {
+    printf("%s: drop count %u, producer saw %u refused\n", pcName,
+           g_sQueue.ui32Dropped, g_ui32Refused);
+    ui32Failures++;
+  }
+  if(ui32Gaps != g_ui32Lost) {
+    printf("%s: sequence gaps %u, lost %u\n", pcName, ui32Gaps, g_ui32Lost);
+    ui32Failures++;
+  }
+  if((g_sQueue.ui32HighWater > QUEUE_CAPACITY) ||
+     (g_sQueue.ui32HighWater < ui32MaxBatch)) {
+    printf("%s: high water %u outside %u to %u\n", pcName,
+           g_sQueue.ui32HighWater, ui32MaxBatch, QUEUE_CAPACITY);
+    ui32Failures++;
+  }
+  if(SPSCQueueCount(&g_sQueue) != 0) {
+    printf("%s: queue not empty at the end\n", pcName);
+    ui32Failures++;
+  }
+
+  return(ui32Failures);
+}
+
+//*****************************************************************************
+//
+// Runs the lossless and the lossy test.
+//
+//*****************************************************************************
+int
+main(int argc, char *argv[])
+{
+  uint32_t ui32Failures;
+
+  g_ui32Elements = (argc > 1) ? strtoul(argv[1], 0, 0) : DEFAULT_ELEMENTS;
+
+  ui32Failures = Run("lossless", true);
+  ui32Failures += Run("lossy", false);
+
+  printf("spscq: %s\n", ui32Failures ? "FAILED" : "passed");
+  return(ui32Failures ? 1 : 0);
+}
@@ -0,0 +1,310 @@
+//*****************************************************************************
+//
+// stripcharttest.c - Host check of the strip chart in Common/stripchart.c.
+//
+// Draws the chart on a model screen and checks the column ring: each
+// sample changes only the column it is plotted in and the cursor column
+// after it, the sweep wraps at the right edge, and a trace is joined to
+// its previous row.  It then replays Lab 3's chart at CHART_SAMPLE_HZ
+// against main loop passes of up to WORST_PASS_MS and checks that no
+// sample is dropped, and that a pass longer than the queue loses exactly
+// the samples that did not fit.
+//
+// Build and run on the host:
+//
+//     cc -O2 -Istubs -I../Common -o stripcharttest stripcharttest.c ../Common/stripchart.c
+//     ./stripcharttest
+//
+// Prints the counters of the replay and exits non-zero if any check failed.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "grlib/grlib.h"
+#include "stripchart.h"
+
+#define CHECK(x)                Check((x), #x, __LINE__)
+
+//*****************************************************************************
+//
+// Lab 3's chart: 96 columns by 48 rows under the title bar, three traces,
+// sampled at 1 kHz.  The slowest pass of its main loop while the chart is
+// up is a full frame sent to the panel, about 25-40 ms.
+//
+//*****************************************************************************
+#define SCREEN_WIDTH            96
+#define SCREEN_HEIGHT           64
+#define CHART_TOP               16
+#define CHART_SAMPLE_HZ         1000
+#define WORST_PASS_MS           40
+#define REPLAY_SAMPLES          1000000
+
+//*****************************************************************************
+//
+// Colors, which the model display keeps as they are.
+//
+//*****************************************************************************
+#define COLOR_BACK              0x000000
+#define COLOR_CURSOR            0x696969
+#define COLOR_UNSET             0x123456
+
+static const uint32_t g_pui32Colors[3] = { 0xFF0000, 0x00FF00, 0x0000FF };
+
+//*****************************************************************************
+//
+// The model screen.
+//
+//*****************************************************************************
+static uint32_t g_ppui32Screen[SCREEN_HEIGHT][SCREEN_WIDTH];
+static uint32_t g_ui32Failures;
+
+//*****************************************************************************
+//
+// Model display driver.
+//
+//*****************************************************************************
+static uint32_t
+ColorTranslate(void *pvDisplayData, uint32_t ui32Value)
+{
+  (void)pvDisplayData;
+  return(ui32Value);
+}
+
+static void
+LineDrawV(void *pvDisplayData, int32_t i32X, int32_t i32Y1, int32_t i32Y2,
+          uint32_t ui32Value)
+{
+  int32_t i32Y;
+
+  (void)pvDisplayData;
+  for(i32Y = i32Y1; i32Y <= i32Y2; i32Y++) {
+    g_ppui32Screen[i32Y][i32X] = ui32Value;
+  }
+}
+
+static void
+RectFill(void *pvDisplayData, const tRectangle *psRect, uint32_t ui32Value)
+{
+  int32_t i32X;
+
+  for(i32X = psRect->i16XMin; i32X <= psRect->i16XMax; i32X++) {
+    LineDrawV(pvDisplayData, i32X, psRect->i16YMin, psRect->i16YMax,
+              ui32Value);
+  }
+}
+
+//*****************************************************************************
+//
+// Records a failed check.
+//
+//*****************************************************************************
+static void
+Check(bool bOK, const char *pcWhat, int iLine)
+{
+  if(!bOK) {
+    printf("line %d: %s\n", iLine, pcWhat);
+    g_ui32Failures++;
+  }
+}
+
+//*****************************************************************************
+//
+// The chart under test.
+//
+//*****************************************************************************
+static tDisplay g_sDisplay;
+static tStripChart g_sChart;
+static tRectangle g_sRect;
+
+static void
+ChartInit(void)
+{
+  int32_t i32X, i32Y;
+
+  for(i32Y = 0; i32Y < SCREEN_HEIGHT; i32Y++) {
+    for(i32X = 0; i32X < SCREEN_WIDTH; i32X++) {
+      g_ppui32Screen[i32Y][i32X] = COLOR_UNSET;
+    }
+  }
+  memset(&g_sDisplay, 0, sizeof(g_sDisplay));
+  g_sDisplay.ui16Width = SCREEN_WIDTH;
+  g_sDisplay.ui16Height = SCREEN_HEIGHT;
+  g_sDisplay.pfnLineDrawV = LineDrawV;
+  g_sDisplay.pfnRectFill = RectFill;
+  g_sDisplay.pfnColorTranslate = ColorTranslate;
+  g_sRect.i16XMin = 0;
+  g_sRect.i16YMin = CHART_TOP;
+  g_sRect.i16XMax = SCREEN_WIDTH - 1;
+  g_sRect.i16YMax = SCREEN_HEIGHT - 1;
+  StripChartInit(&g_sChart, &g_sDisplay, &g_sRect, 3, g_pui32Colors,
+                 COLOR_BACK, COLOR_CURSOR, 4095);
+}
+
+//*****************************************************************************
+//
+// Returns true if column i32X of the chart is wholly ui32Color.
+//
+//*****************************************************************************
+static bool
+ColumnIs(int32_t i32X, uint32_t ui32Color)
+{
+  int32_t i32Y;
+
+  for(i32Y = CHART_TOP; i32Y < SCREEN_HEIGHT; i32Y++) {
+    if(g_ppui32Screen[i32Y][i32X] != ui32Color) {
+      return(false);
+    }
+  }
+
+  return(true);
+}
+
+//*****************************************************************************
+//
+// The column ring: what each sample draws and where.
+//
+//*****************************************************************************
+static void
+CheckRing(void)
+{
+  static uint32_t ppui32Before[SCREEN_HEIGHT][SCREEN_WIDTH];
+  uint32_t pui32Sample[3], ui32Sample, ui32Height;
+  int32_t i32X, i32Y, i32Col, i32Row;
+  bool bStray;
+
+  ChartInit();
+  StripChartClear(&g_sChart);
+  CHECK(ColumnIs(0, COLOR_CURSOR));
+  CHECK(ColumnIs(1, COLOR_BACK) && ColumnIs(SCREEN_WIDTH - 1, COLOR_BACK));
+  CHECK(g_ppui32Screen[CHART_TOP - 1][0] == COLOR_UNSET);
+
+  // Trace 0 steps up and down, trace 1 is flat, trace 2 is off.
+  StripChartTracesSet(&g_sChart, 3);
+  ui32Height = SCREEN_HEIGHT - 1 - CHART_TOP;
+  bStray = false;
+  for(ui32Sample = 0; ui32Sample < (SCREEN_WIDTH * 2) + 5; ui32Sample++) {
+    pui32Sample[0] = (ui32Sample & 8) ? 4095 : 0;
+    pui32Sample[1] = 2048;
+    pui32Sample[2] = 4095;
+    memcpy(ppui32Before, g_ppui32Screen, sizeof(ppui32Before));
+    CHECK(StripChartSample(&g_sChart, pui32Sample));
+    CHECK(StripChartUpdate(&g_sChart) == 1);
+
+    // Only the plotted column and the cursor after it may change.
+    i32Col = ui32Sample % SCREEN_WIDTH;
+    for(i32Y = 0; i32Y < SCREEN_HEIGHT; i32Y++) {
+      for(i32X = 0; i32X < SCREEN_WIDTH; i32X++) {
+        if((i32X != i32Col) && (i32X != ((i32Col + 1) % SCREEN_WIDTH)) &&
+           (g_ppui32Screen[i32Y][i32X] != ppui32Before[i32Y][i32X])) {
+          bStray = true;
+        }
+      }
+    }
+    CHECK(ColumnIs((i32Col + 1) % SCREEN_WIDTH, COLOR_CURSOR));
+
+    // Trace 1 sits mid-height; trace 0 is on its row and, on a step, the
+    // whole column is joined from the previous row.
+    i32Row = SCREEN_HEIGHT - 1 - ((2048 * ui32Height + 2047) / 4095);
+    CHECK(g_ppui32Screen[i32Row][i32Col] == g_pui32Colors[1]);
+    i32Row = pui32Sample[0] ? CHART_TOP : (SCREEN_HEIGHT - 1);
+    CHECK(g_ppui32Screen[i32Row][i32Col] == g_pui32Colors[0]);
+    if((ui32Sample & 7) == 0 && ui32Sample) {
+      CHECK(g_ppui32Screen[(CHART_TOP + SCREEN_HEIGHT) / 2 + 3][i32Col] ==
+            g_pui32Colors[0]);
+    }
+    for(i32Y = CHART_TOP; i32Y < SCREEN_HEIGHT; i32Y++) {
+      CHECK(g_ppui32Screen[i32Y][i32Col] != g_pui32Colors[2]);
+    }
+  }
+  CHECK(!bStray);
+  CHECK(g_sChart.ui32Columns == (SCREEN_WIDTH * 2) + 5);
+  CHECK(g_ppui32Screen[CHART_TOP - 1][5] == COLOR_UNSET);
+}
+
+//*****************************************************************************
+//
+// Lab 3's sampling against main loop passes.
+//
+//*****************************************************************************
+static void
+CheckReplay(void)
+{
+  uint32_t pui32Sample[3], ui32Sample, ui32PassMs, ui32Taken, ui32Refused;
+  uint32_t ui32Deepest, ui32Longest, ui32Idx;
+
+  ChartInit();
+  StripChartClear(&g_sChart);
+
+  // Each pass of the loop runs a random time of up to WORST_PASS_MS, with
+  // one pass in sixteen taking the worst case, and the interrupt queues a
+  // sample every millisecond of it.  The pass ends by plotting them.
+  srand(1);
+  ui32Sample = 0;
+  ui32Refused = 0;
+  ui32Deepest = 0;
+  ui32Longest = 0;
+  while(ui32Sample < REPLAY_SAMPLES) {
+    ui32PassMs = (rand() & 15) ? (1 + (rand() % WORST_PASS_MS)) :
+                 WORST_PASS_MS;
+    ui32PassMs = (ui32PassMs * CHART_SAMPLE_HZ) / 1000;
+    if(ui32PassMs > ui32Longest) {
+      ui32Longest = ui32PassMs;
+    }
+    for(ui32Idx = 0; ui32Idx < ui32PassMs; ui32Idx++) {
+      pui32Sample[0] = ui32Sample & 4095;
+      pui32Sample[1] = (ui32Sample * 7) & 4095;
+      pui32Sample[2] = 4095 - (ui32Sample & 4095);
+      if(!StripChartSample(&g_sChart, pui32Sample)) {
+        ui32Refused++;
+      }
+      ui32Sample++;
+    }
+    if((g_sChart.ui32Head - g_sChart.ui32Tail) > ui32Deepest) {
+      ui32Deepest = g_sChart.ui32Head - g_sChart.ui32Tail;
+    }
+    StripChartUpdate(&g_sChart);
+  }
+  printf("replay: %u samples, longest pass %u ms, deepest queue %u of %u, "
+         "dropped %u\n", ui32Sample, ui32Longest, ui32Deepest,
+         STRIP_CHART_QUEUE, g_sChart.ui32Dropped);
+  CHECK(g_sChart.ui32Dropped == 0);
+  CHECK(ui32Refused == 0);
+  CHECK(g_sChart.ui32Columns == ui32Sample);
+
+  // A pass longer than the queue, such as the 150-250 ms blink delay Lab 3
+  // no longer runs with the chart up, loses what does not fit and no more.
+  ui32Taken = 0;
+  for(ui32Idx = 0; ui32Idx < 200; ui32Idx++) {
+    if(StripChartSample(&g_sChart, pui32Sample)) {
+      ui32Taken++;
+    }
+  }
+  CHECK(ui32Taken == STRIP_CHART_QUEUE);
+  CHECK(g_sChart.ui32Dropped == (200 - STRIP_CHART_QUEUE));
+  CHECK(StripChartUpdate(&g_sChart) == STRIP_CHART_QUEUE);
+
+  // A clear discards anything queued.
+  CHECK(StripChartSample(&g_sChart, pui32Sample));
+  StripChartClear(&g_sChart);
+  CHECK(StripChartUpdate(&g_sChart) == 0);
+}
+
+//*****************************************************************************
+//
+// Runs the checks.
+//
+//*****************************************************************************
+int
+main(void)
+{
+  CheckRing();
+  CheckReplay();
+
+  printf("stripchart: %s\n", g_ui32Failures ? "FAILED" : "passed");
+  return(g_ui32Failures ? 1 : 0);
+}
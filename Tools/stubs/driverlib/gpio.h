@@ -0,0 +1,20 @@
+//*****************************************************************************
+//
+// gpio.h - Host stand-in for the TivaWare driverlib GPIO API.
+//
+// Declares just the calls and constants the Common modules use.  Each check
+// program in Tools supplies its own model behind these functions.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_GPIO_H__
+#define __DRIVERLIB_GPIO_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GPIO_PIN_6              0x00000040
+
+extern void GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val);
+
+#endif // __DRIVERLIB_GPIO_H__
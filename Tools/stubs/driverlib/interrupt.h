@@ -0,0 +1,18 @@
+//*****************************************************************************
+//
+// interrupt.h - Host stand-in for the TivaWare driverlib interrupt API.
+//
+// The host checks have no interrupts to mask; their stubs just track
+// whether the caller believes them masked.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_INTERRUPT_H__
+#define __DRIVERLIB_INTERRUPT_H__
+
+#include <stdbool.h>
+
+extern bool IntMasterEnable(void);
+extern bool IntMasterDisable(void);
+
+#endif // __DRIVERLIB_INTERRUPT_H__
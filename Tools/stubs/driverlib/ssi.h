@@ -0,0 +1,23 @@
+//*****************************************************************************
+//
+// ssi.h - Host stand-in for the TivaWare driverlib SSI API.
+//
+// Declares just the calls and constants the Common modules use.  Each check
+// program in Tools supplies its own model behind these functions.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_SSI_H__
+#define __DRIVERLIB_SSI_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SSI_DMA_TX              0x00000002
+
+extern void SSIDataPut(uint32_t ui32Base, uint32_t ui32Data);
+extern bool SSIBusy(uint32_t ui32Base);
+extern void SSIDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags);
+extern void SSIDMADisable(uint32_t ui32Base, uint32_t ui32DMAFlags);
+
+#endif // __DRIVERLIB_SSI_H__
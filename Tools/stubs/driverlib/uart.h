@@ -0,0 +1,35 @@
+//*****************************************************************************
+//
+// uart.h - Host stand-in for the TivaWare driverlib UART API.
+//
+// Declares just the calls and constants the Common modules use, so their
+// logic can be built and checked on the host.  Each check program in Tools
+// supplies its own model of the UART behind these functions.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_UART_H__
+#define __DRIVERLIB_UART_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define UART_INT_RT             0x040
+#define UART_INT_TX             0x020
+#define UART_INT_RX             0x010
+#define UART_FIFO_TX4_8         0x00000002
+#define UART_FIFO_RX1_8         0x00000000
+#define UART_FIFO_RX4_8         0x00000010
+#define UART_TXINT_MODE_FIFO    0x00000000
+
+extern bool UARTSpaceAvail(uint32_t ui32Base);
+extern bool UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData);
+extern bool UARTBusy(uint32_t ui32Base);
+extern bool UARTCharsAvail(uint32_t ui32Base);
+extern int32_t UARTCharGetNonBlocking(uint32_t ui32Base);
+extern void UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel,
+                             uint32_t ui32RxLevel);
+extern void UARTTxIntModeSet(uint32_t ui32Base, uint32_t ui32Mode);
+extern void UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags);
+
+#endif // __DRIVERLIB_UART_H__
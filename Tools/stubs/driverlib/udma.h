@@ -0,0 +1,39 @@
+//*****************************************************************************
+//
+// udma.h - Host stand-in for the TivaWare driverlib uDMA API.
+//
+// Declares just the calls and constants the Common modules use.  Each check
+// program in Tools supplies its own model behind these functions.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_UDMA_H__
+#define __DRIVERLIB_UDMA_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define UDMA_CH13_SSI2TX        0x0000000D
+#define UDMA_PRI_SELECT         0x00000000
+#define UDMA_ATTR_USEBURST      0x00000001
+#define UDMA_ATTR_ALTSELECT     0x00000002
+#define UDMA_ATTR_HIGH_PRIORITY 0x00000004
+#define UDMA_ATTR_REQMASK       0x00000008
+#define UDMA_SIZE_8             0x00000000
+#define UDMA_SRC_INC_8          0x00000000
+#define UDMA_DST_INC_NONE       0xC0000000
+#define UDMA_ARB_4              0x00008000
+#define UDMA_MODE_BASIC         0x00000001
+
+extern void uDMAChannelAssign(uint32_t ui32Mapping);
+extern void uDMAChannelAttributeDisable(uint32_t ui32ChannelNum,
+                                        uint32_t ui32Attr);
+extern void uDMAChannelControlSet(uint32_t ui32ChannelStructIndex,
+                                  uint32_t ui32Control);
+extern void uDMAChannelTransferSet(uint32_t ui32ChannelStructIndex,
+                                   uint32_t ui32Mode, void *pvSrcAddr,
+                                   void *pvDstAddr, uint32_t ui32TransferSize);
+extern void uDMAChannelEnable(uint32_t ui32ChannelNum);
+extern bool uDMAChannelIsEnabled(uint32_t ui32ChannelNum);
+
+#endif // __DRIVERLIB_UDMA_H__
@@ -0,0 +1,76 @@
+//*****************************************************************************
+//
+// grlib.h - Host stand-in for the TivaWare graphics library.
+//
+// Declares just the types and calls the Common display modules use, laid
+// out as in grlib, so their logic can be built and checked on the host.
+// Each check program in Tools supplies GrRectFill() if it needs it.
+//
+//*****************************************************************************
+
+#ifndef __GRLIB_H__
+#define __GRLIB_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+  int16_t i16XMin;
+  int16_t i16YMin;
+  int16_t i16XMax;
+  int16_t i16YMax;
+} tRectangle;
+
+typedef struct
+{
+  int32_t i32Size;
+  void *pvDisplayData;
+  uint16_t ui16Width;
+  uint16_t ui16Height;
+  void (*pfnPixelDraw)(void *pvDisplayData, int32_t i32X, int32_t i32Y,
+                       uint32_t ui32Value);
+  void (*pfnPixelDrawMultiple)(void *pvDisplayData, int32_t i32X,
+                               int32_t i32Y, int32_t i32X0, int32_t i32Count,
+                               int32_t i32BPP, const uint8_t *pui8Data,
+                               const uint8_t *pui8Palette);
+  void (*pfnLineDrawH)(void *pvDisplayData, int32_t i32X1, int32_t i32X2,
+                       int32_t i32Y, uint32_t ui32Value);
+  void (*pfnLineDrawV)(void *pvDisplayData, int32_t i32X, int32_t i32Y1,
+                       int32_t i32Y2, uint32_t ui32Value);
+  void (*pfnRectFill)(void *pvDisplayData, const tRectangle *psRect,
+                      uint32_t ui32Value);
+  uint32_t (*pfnColorTranslate)(void *pvDisplayData, uint32_t ui32Value);
+  void (*pfnFlush)(void *pvDisplayData);
+} tDisplay;
+
+typedef struct
+{
+  uint8_t ui8Format;
+} tFont;
+
+typedef struct
+{
+  int32_t i32Size;
+  const tDisplay *psDisplay;
+  tRectangle sClipRegion;
+  uint32_t ui32Foreground;
+  uint32_t ui32Background;
+  const tFont *psFont;
+} tContext;
+
+#define ClrBlack                0x00000000
+
+#define GrContextForegroundSet(psContext, ui32Value)                          \
+        do                                                                    \
+        {                                                                     \
+          tContext *psC = psContext;                                          \
+          psC->ui32Foreground =                                               \
+            psC->psDisplay->pfnColorTranslate(psC->psDisplay->pvDisplayData,  \
+                                              ui32Value);                     \
+        }                                                                     \
+        while(0)
+
+extern void GrRectFill(const tContext *psContext, const tRectangle *psRect);
+
+#endif // __GRLIB_H__
@@ -0,0 +1,16 @@
+//*****************************************************************************
+//
+// hw_memmap.h - Host stand-in for the TivaWare peripheral base addresses.
+//
+// Only the bases the Common modules name.  The host models never touch
+// these addresses; they only pass them back to the stub driverlib calls.
+//
+//*****************************************************************************
+
+#ifndef __HW_MEMMAP_H__
+#define __HW_MEMMAP_H__
+
+#define SSI2_BASE               0x4000A000
+#define GPIO_PORTH_BASE         0x40027000
+
+#endif // __HW_MEMMAP_H__
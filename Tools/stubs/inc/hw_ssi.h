@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// hw_ssi.h - Host stand-in for the TivaWare SSI register offsets.
+//
+//*****************************************************************************
+
+#ifndef __HW_SSI_H__
+#define __HW_SSI_H__
+
+#define SSI_O_DR                0x00000008
+
+#endif // __HW_SSI_H__
@@ -0,0 +1,20 @@
+//*****************************************************************************
+//
+// hw_types.h - Host stand-in for the TivaWare register access macros.
+//
+// HWREG() goes through HostRegister(), which each check program that reads
+// registers supplies, so a model can answer for the addresses it cares
+// about.
+//
+//*****************************************************************************
+
+#ifndef __HW_TYPES_H__
+#define __HW_TYPES_H__
+
+#include <stdint.h>
+
+extern volatile uint32_t *HostRegister(uint32_t ui32Addr);
+
+#define HWREG(x)                (*HostRegister((uint32_t)(x)))
+
+#endif // __HW_TYPES_H__
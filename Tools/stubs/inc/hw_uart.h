@@ -0,0 +1,25 @@
+//*****************************************************************************
+//
+// hw_uart.h - Host stand-in for the TivaWare UART register definitions.
+//
+// Only the offsets and bits the Common modules name, with the values from
+// the TM4C123 data sheet.
+//
+//*****************************************************************************
+
+#ifndef __HW_UART_H__
+#define __HW_UART_H__
+
+#define UART_O_IBRD             0x00000024  // Integer Baud-Rate Divisor
+#define UART_O_FBRD             0x00000028  // Fractional Baud-Rate Divisor
+#define UART_O_CTL              0x00000030  // Control
+
+#define UART_CTL_HSE            0x00000020  // High-Speed Enable
+
+#define UART_DR_OE              0x00000800  // Overrun Error
+#define UART_DR_BE              0x00000400  // Break Error
+#define UART_DR_PE              0x00000200  // Parity Error
+#define UART_DR_FE              0x00000100  // Framing Error
+#define UART_DR_DATA_M          0x000000FF  // Data Transmitted or Received
+
+#endif // __HW_UART_H__
@@ -0,0 +1,193 @@
+//*****************************************************************************
+//
+// teledecode.c - Host-side decoder for the binary ADC telemetry stream.
+//
+// Reads the raw byte stream from a file or serial device (or stdin) and
+// prints one CSV line per reading:
+//
+//     seq,time_us,ch0,ch1,...
+//
+// Frames that fail their CRC, and gaps in the sequence numbers, are counted
+// and reported on stderr at the end so a lossy link is obvious.  The board's
+// UART receive counters, when it sends them, are shown on stderr as well.
+//
+// Build and run on the host, with the serial port already set to the
+// board's baud rate (e.g. "stty -F /dev/ttyACM0 115200 raw"):
+//
+//     cc -O2 -I../Common -o teledecode teledecode.c ../Common/telemetry.c
+//     ./teledecode -c 16000000 /dev/ttyACM0 > pots.csv
+//
+// -c gives the board's system clock so timestamps, which are core cycles,
+// can be shown in microseconds.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "telemetry.h"
+
+//*****************************************************************************
+//
+// Running totals for the summary.
+//
+//*****************************************************************************
+static uint32_t g_ui32Frames;
+static uint32_t g_ui32Bad;
+static uint32_t g_ui32Lost;
+static uint32_t g_ui32Readings;
+
+//*****************************************************************************
+//
+// Prints the readings in an ADC frame.  The frame carries one timestamp, so
+// readings after the first are shown at the same time.
+//
+//*****************************************************************************
+static void
+PrintADC(const tTelemetryFrame *psFrame, double dTime)
+{
+  uint16_t pui16Samples[TELEMETRY_ADC_MAX_SAMPLES];
+  uint32_t ui32Channels, ui32Samples, ui32Idx;
+
+  if(psFrame->ui32PayloadLen < 1) {
+    g_ui32Bad++;
+    return;
+  }
+  ui32Channels = psFrame->pui8Payload[0];
+  if(ui32Channels == 0) {
+    g_ui32Bad++;
+    return;
+  }
+
+  // Every pair of samples takes three bytes, and an odd one two.
+  ui32Samples = ((psFrame->ui32PayloadLen - 1) / 3) * 2;
+  if(((psFrame->ui32PayloadLen - 1) % 3) == 2) {
+    ui32Samples++;
+  }
+  ui32Samples -= ui32Samples % ui32Channels;
+  TelemetryUnpack12(psFrame->pui8Payload + 1, ui32Samples, pui16Samples);
+
+  for(ui32Idx = 0; ui32Idx < ui32Samples; ui32Idx++) {
+    if((ui32Idx % ui32Channels) == 0) {
+      printf("%u,%.1f", psFrame->ui8Seq, dTime);
+    }
+    printf(",%u", pui16Samples[ui32Idx]);
+    if((ui32Idx % ui32Channels) == (ui32Channels - 1)) {
+      printf("\n");
+      g_ui32Readings++;
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// Prints a UART receive statistics frame.  The names follow the order of the
+// fields in tUARTRxStats.
+//
+//*****************************************************************************
+static void
+PrintUARTRx(const tTelemetryFrame *psFrame, double dTime)
+{
+  static const char *const ppcNames[] =
+  {
+    "irqs", "bytes", "overrun", "framing", "parity", "break", "fifo_peak",
+    "queue_peak", "dropped"
+  };
+  uint32_t ui32Idx, ui32Value;
+  const uint8_t *pui8Word;
+
+  fprintf(stderr, "uart rx at %.1f us:", dTime);
+  for(ui32Idx = 0; ((ui32Idx + 1) * 4) <= psFrame->ui32PayloadLen; ui32Idx++) {
+    pui8Word = psFrame->pui8Payload + (ui32Idx * 4);
+    ui32Value = pui8Word[0] | (pui8Word[1] << 8) | (pui8Word[2] << 16) |
+                ((uint32_t)pui8Word[3] << 24);
+    fprintf(stderr, " %s=%u",
+            (ui32Idx < (sizeof(ppcNames) / sizeof(ppcNames[0]))) ?
+            ppcNames[ui32Idx] : "?", ui32Value);
+  }
+  fprintf(stderr, "\n");
+}
+
+int
+main(int argc, char **argv)
+{
+  uint8_t pui8Frame[TELEMETRY_MAX_ENCODED];
+  tTelemetryFrame sFrame;
+  uint32_t ui32Len = 0;
+  uint32_t ui32Clock = 16000000;
+  uint32_t ui32LastStamp = 0;
+  double dTime = 0.0;
+  bool bHaveSeq = false;
+  bool bOverrun = false;
+  uint8_t ui8NextSeq = 0;
+  FILE *psIn = stdin;
+  int iArg, iChar;
+
+  for(iArg = 1; iArg < argc; iArg++) {
+    if(!strcmp(argv[iArg], "-c") && ((iArg + 1) < argc)) {
+      ui32Clock = strtoul(argv[++iArg], NULL, 0);
+    }
+    else if((psIn = fopen(argv[iArg], "rb")) == NULL) {
+      perror(argv[iArg]);
+      return(1);
+    }
+  }
+  if(ui32Clock == 0) {
+    fprintf(stderr, "usage: %s [-c clock_hz] [device]\n", argv[0]);
+    return(1);
+  }
+
+  while((iChar = fgetc(psIn)) != EOF) {
+    if(iChar != 0) {
+      if(ui32Len < sizeof(pui8Frame)) {
+        pui8Frame[ui32Len++] = iChar;
+      }
+      else {
+        bOverrun = true;
+      }
+      continue;
+    }
+
+    // A zero ends a frame.  Empty frames are just back-to-back delimiters.
+    if(ui32Len == 0) {
+      continue;
+    }
+    if(bOverrun || !TelemetryFrameDecode(pui8Frame, ui32Len, &sFrame)) {
+      g_ui32Bad++;
+      ui32Len = 0;
+      bOverrun = false;
+      continue;
+    }
+    ui32Len = 0;
+    g_ui32Frames++;
+
+    if(bHaveSeq && (sFrame.ui8Seq != ui8NextSeq)) {
+      g_ui32Lost += (uint8_t)(sFrame.ui8Seq - ui8NextSeq);
+    }
+
+    // Timestamps are a wrapping cycle count; accumulate the differences.
+    if(bHaveSeq) {
+      dTime += (double)(uint32_t)(sFrame.ui32Timestamp - ui32LastStamp) *
+               1e6 / ui32Clock;
+    }
+    ui32LastStamp = sFrame.ui32Timestamp;
+    ui8NextSeq = sFrame.ui8Seq + 1;
+    bHaveSeq = true;
+
+    if(sFrame.ui8Type == TELEMETRY_TYPE_ADC) {
+      PrintADC(&sFrame, dTime);
+    }
+    else if(sFrame.ui8Type == TELEMETRY_TYPE_UART_RX) {
+      PrintUARTRx(&sFrame, dTime);
+    }
+    fflush(stdout);
+  }
+
+  fprintf(stderr, "%u frames, %u readings, %u corrupt, %u lost\n",
+          g_ui32Frames, g_ui32Readings, g_ui32Bad, g_ui32Lost);
+
+  return(0);
+}
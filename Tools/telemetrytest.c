@@ -0,0 +1,236 @@
+//*****************************************************************************
+//
+// telemetrytest.c - Host check of the telemetry framing in
+// Common/telemetry.c.
+//
+// Checks the CRC against the CRC-16/CCITT-FALSE check value, COBS round
+// trips over the awkward cases (empty, all zeros, runs of exactly 253, 254
+// and 255 non-zero bytes, a zero after a full run), 12-bit packing with an
+// odd final sample, and whole frames: built, decoded, and refused once a
+// single bit is flipped.
+//
+// Build and run on the host:
+//
+//     cc -O2 -I../Common -o telemetrytest telemetrytest.c ../Common/telemetry.c
+//     ./telemetrytest
+//
+// Prints each failed check and exits non-zero if there were any.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry.h"
+
+#define CHECK(x)                Check((x), #x, __LINE__)
+
+//*****************************************************************************
+//
+// Number of failed checks.
+//
+//*****************************************************************************
+static uint32_t g_ui32Failures;
+
+//*****************************************************************************
+//
+// Records a failed check.
+//
+//*****************************************************************************
+static void
+Check(bool bOK, const char *pcWhat, int iLine)
+{
+  if(!bOK) {
+    printf("line %d: %s\n", iLine, pcWhat);
+    g_ui32Failures++;
+  }
+}
+
+//*****************************************************************************
+//
+// Encodes a block, checks the encoding holds no zero and is no longer than
+// promised, and that it decodes back to the block.
+//
+//*****************************************************************************
+static void
+CheckCOBS(const uint8_t *pui8Data, uint32_t ui32Count)
+{
+  uint8_t pui8Enc[600], pui8Dec[600];
+  uint32_t ui32Enc, ui32Dec, ui32Idx;
+
+  ui32Enc = TelemetryCOBSEncode(pui8Data, ui32Count, pui8Enc);
+  CHECK(ui32Enc <= (ui32Count + (ui32Count / 254) + 1));
+  for(ui32Idx = 0; ui32Idx < ui32Enc; ui32Idx++) {
+    if(pui8Enc[ui32Idx] == 0) {
+      printf("length %u: zero at %u\n", ui32Count, ui32Idx);
+      g_ui32Failures++;
+      break;
+    }
+  }
+  ui32Dec = TelemetryCOBSDecode(pui8Enc, ui32Enc, pui8Dec);
+  if((ui32Dec != ui32Count) || memcmp(pui8Dec, pui8Data, ui32Count)) {
+    printf("length %u: decoded to %u bytes, not the input\n", ui32Count,
+           ui32Dec);
+    g_ui32Failures++;
+  }
+}
+
+//*****************************************************************************
+//
+// CRC check value and COBS edge cases.
+//
+//*****************************************************************************
+static void
+CheckCodes(void)
+{
+  uint8_t pui8Data[600], pui8Enc[8];
+  uint32_t ui32Len, ui32Idx;
+
+  CHECK(TelemetryCRC16((const uint8_t *)"123456789", 9) == 0x29B1);
+  CHECK(TelemetryCRC16(pui8Data, 0) == 0xFFFF);
+
+  // The textbook examples.
+  pui8Data[0] = 0x00;
+  CHECK(TelemetryCOBSEncode(pui8Data, 1, pui8Enc) == 2);
+  CHECK((pui8Enc[0] == 0x01) && (pui8Enc[1] == 0x01));
+  pui8Data[0] = 0x11;
+  pui8Data[1] = 0x22;
+  pui8Data[2] = 0x00;
+  pui8Data[3] = 0x33;
+  CHECK(TelemetryCOBSEncode(pui8Data, 4, pui8Enc) == 5);
+  CHECK((pui8Enc[0] == 0x03) && (pui8Enc[3] == 0x02) && (pui8Enc[4] == 0x33));
+
+  // Zeros only, of several lengths.
+  memset(pui8Data, 0, sizeof(pui8Data));
+  for(ui32Len = 1; ui32Len < 8; ui32Len++) {
+    CheckCOBS(pui8Data, ui32Len);
+  }
+
+  // Non-zero runs around the 254 byte block limit, alone, followed by a
+  // zero and followed by more data.
+  for(ui32Idx = 0; ui32Idx < sizeof(pui8Data); ui32Idx++) {
+    pui8Data[ui32Idx] = (ui32Idx % 255) + 1;
+  }
+  for(ui32Len = 252; ui32Len <= 256; ui32Len++) {
+    CheckCOBS(pui8Data, ui32Len);
+    pui8Data[ui32Len] = 0;
+    CheckCOBS(pui8Data, ui32Len + 1);
+    CheckCOBS(pui8Data, ui32Len + 5);
+    pui8Data[ui32Len] = (ui32Len % 255) + 1;
+  }
+  CheckCOBS(pui8Data, 254 * 2);
+  CheckCOBS(pui8Data, 1);
+}
+
+//*****************************************************************************
+//
+// 12-bit packing, including an odd final sample.
+//
+//*****************************************************************************
+static void
+CheckPack(void)
+{
+  uint32_t pui32Samples[7] = { 0x000, 0xFFF, 0x123, 0xABC, 0x800, 0x001,
+                               0x7FE };
+  uint16_t pui16Back[7];
+  uint8_t pui8Packed[16];
+  uint32_t ui32Idx;
+
+  CHECK(TelemetryPack12(pui32Samples, 7, pui8Packed) == 11);
+  CHECK(TelemetryUnpack12(pui8Packed, 7, pui16Back) == 11);
+  for(ui32Idx = 0; ui32Idx < 7; ui32Idx++) {
+    CHECK(pui16Back[ui32Idx] == pui32Samples[ui32Idx]);
+  }
+  CHECK(TelemetryPack12(pui32Samples, 6, pui8Packed) == 9);
+}
+
+//*****************************************************************************
+//
+// Whole frames: build, strip the delimiter, decode, and corrupt.
+//
+//*****************************************************************************
+static void
+CheckFrames(void)
+{
+  tTelemetry sTelem;
+  tTelemetryFrame sFrame;
+  uint8_t pui8Frame[TELEMETRY_MAX_ENCODED], pui8Copy[TELEMETRY_MAX_ENCODED];
+  uint8_t pui8Payload[TELEMETRY_MAX_PAYLOAD + 1];
+  uint32_t pui32Samples[TELEMETRY_ADC_MAX_SAMPLES];
+  uint32_t ui32Len, ui32Idx, ui32Bit, ui32Missed;
+  uint16_t pui16Back[TELEMETRY_ADC_MAX_SAMPLES];
+
+  TelemetryInit(&sTelem);
+  for(ui32Idx = 0; ui32Idx < sizeof(pui8Payload); ui32Idx++) {
+    pui8Payload[ui32Idx] = (ui32Idx & 3) ? ui32Idx : 0;
+  }
+  CHECK(TelemetryFrameBuild(&sTelem, 7, 0, pui8Payload,
+                            TELEMETRY_MAX_PAYLOAD + 1, pui8Frame) == 0);
+
+  ui32Len = TelemetryFrameBuild(&sTelem, 7, 0x12003400, pui8Payload,
+                                TELEMETRY_MAX_PAYLOAD, pui8Frame);
+  CHECK((ui32Len > 0) && (ui32Len <= TELEMETRY_MAX_ENCODED));
+  CHECK(pui8Frame[ui32Len - 1] == 0);
+  CHECK(memchr(pui8Frame, 0, ui32Len - 1) == 0);
+  memcpy(pui8Copy, pui8Frame, ui32Len);
+  CHECK(TelemetryFrameDecode(pui8Copy, ui32Len - 1, &sFrame));
+  CHECK(sFrame.ui8Type == 7);
+  CHECK(sFrame.ui8Seq == 0);
+  CHECK(sFrame.ui32Timestamp == 0x12003400);
+  CHECK(sFrame.ui32PayloadLen == TELEMETRY_MAX_PAYLOAD);
+  CHECK(memcmp(sFrame.pui8Payload, pui8Payload, TELEMETRY_MAX_PAYLOAD) == 0);
+
+  // Every single-bit error must be refused, whether COBS or the CRC
+  // catches it.
+  ui32Missed = 0;
+  for(ui32Bit = 0; ui32Bit < ((ui32Len - 1) * 8); ui32Bit++) {
+    memcpy(pui8Copy, pui8Frame, ui32Len);
+    pui8Copy[ui32Bit / 8] ^= 1 << (ui32Bit & 7);
+    if(TelemetryFrameDecode(pui8Copy, ui32Len - 1, &sFrame)) {
+      ui32Missed++;
+    }
+  }
+  CHECK(ui32Missed == 0);
+
+  // The largest ADC frame round trips and the next size up is refused.
+  for(ui32Idx = 0; ui32Idx < TELEMETRY_ADC_MAX_SAMPLES; ui32Idx++) {
+    pui32Samples[ui32Idx] = (ui32Idx * 0x9E5) & 0xFFF;
+  }
+  CHECK(TelemetryADCFrame(&sTelem, 0, pui32Samples, 3,
+                          (TELEMETRY_ADC_MAX_SAMPLES / 3) + 1,
+                          pui8Frame) == 0);
+  ui32Len = TelemetryADCFrame(&sTelem, 99, pui32Samples, 3,
+                              TELEMETRY_ADC_MAX_SAMPLES / 3, pui8Frame);
+  CHECK(ui32Len > 0);
+  CHECK(TelemetryFrameDecode(pui8Frame, ui32Len - 1, &sFrame));
+  CHECK((sFrame.ui8Type == TELEMETRY_TYPE_ADC) && (sFrame.ui8Seq == 1));
+  CHECK(sFrame.pui8Payload[0] == 3);
+  TelemetryUnpack12(sFrame.pui8Payload + 1,
+                    (TELEMETRY_ADC_MAX_SAMPLES / 3) * 3, pui16Back);
+  for(ui32Idx = 0; ui32Idx < ((TELEMETRY_ADC_MAX_SAMPLES / 3) * 3);
+      ui32Idx++) {
+    if(pui16Back[ui32Idx] != pui32Samples[ui32Idx]) {
+      CHECK(pui16Back[ui32Idx] == pui32Samples[ui32Idx]);
+      break;
+    }
+  }
+  CHECK(sTelem.ui32Frames == 2);
+}
+
+//*****************************************************************************
+//
+// Runs the checks.
+//
+//*****************************************************************************
+int
+main(void)
+{
+  CheckCodes();
+  CheckPack();
+  CheckFrames();
+
+  printf("telemetry: %s\n", g_ui32Failures ? "FAILED" : "passed");
+  return(g_ui32Failures ? 1 : 0);
+}
@@ -0,0 +1,398 @@
+//*****************************************************************************
+//
+// uartrxtest.c - Host check of the UART receive ring in Common/uartrx.c.
+//
+// Links the receive handler against a model UART whose RX FIFO holds data
+// register values, error flags and all, then checks that each kind of bad
+// byte is counted and kept out of the queue, that an overrun byte is kept,
+// and that the FIFO peak, queue peak and drop counters add up.  Also checks
+// the arrival time worked out for each byte from the batch size and the
+// baud divisor.
+//
+// Build and run on the host:
+//
+//     cc -O2 -Istubs -I../Common -o uartrxtest uartrxtest.c ../Common/uartrx.c ../Common/spscq.c ../Common/uarttx.c ../Common/lathist.c
+//     ./uartrxtest
+//
+// Prints each failed check and exits non-zero if there were any.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "inc/hw_types.h"
+#include "inc/hw_uart.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/uart.h"
+#include "uartrx.h"
+
+//*****************************************************************************
+//
+// Sizes of the model FIFO, the input waiting behind it and the ring under
+// test.
+//
+//*****************************************************************************
+#define FIFO_SIZE               16
+#define LINE_SIZE               64
+#define RING_SIZE               8
+
+//*****************************************************************************
+//
+// Where the model's registers land in its scratch bank, and a baud divisor
+// giving 100 clocks per bit (64 * 6 + 16 = 400 sixty-fourths of 16 clocks).
+//
+//*****************************************************************************
+#define REG_CYCCNT              1
+#define REG_IBRD                9
+#define REG_FBRD                10
+#define REG_CTL                 12
+#define BIT                     100
+
+#define CHECK(x)                Check((x), #x, __LINE__)
+
+//*****************************************************************************
+//
+// The model UART.  The line holds data register values in the order they
+// reach the FIFO; the hardware FIFO is the first FIFO_SIZE of them.
+//
+//*****************************************************************************
+static uint32_t g_pui32Line[LINE_SIZE];
+static uint32_t g_ui32LineLen;
+static uint32_t g_ui32LinePos;
+static volatile uint32_t g_pui32Regs[16];
+static uint32_t g_ui32RxLevel;
+static bool g_bMasked;
+static uint32_t g_ui32Failures;
+
+//*****************************************************************************
+//
+// The ring under test.
+//
+//*****************************************************************************
+static tUARTRx g_sRx;
+static uint8_t g_pui8Ring[RING_SIZE];
+static uint32_t g_pui32Stamps[RING_SIZE];
+static tUARTTx g_sEchoTx;
+static uint8_t g_pui8EchoRing[RING_SIZE];
+static tLatHist g_sEchoHist;
+
+//*****************************************************************************
+//
+// Register and driverlib stubs.  The handler only reads the baud divisor
+// and the cycle counter, which all land in one scratch bank.
+//
+//*****************************************************************************
+volatile uint32_t *
+HostRegister(uint32_t ui32Addr)
+{
+  return(&g_pui32Regs[(ui32Addr >> 2) & 15]);
+}
+
+bool
+IntMasterDisable(void)
+{
+  bool bWas = g_bMasked;
+
+  g_bMasked = true;
+  return(bWas);
+}
+
+bool
+IntMasterEnable(void)
+{
+  bool bWas = g_bMasked;
+
+  g_bMasked = false;
+  return(bWas);
+}
+
+bool
+UARTCharsAvail(uint32_t ui32Base)
+{
+  (void)ui32Base;
+  return(g_ui32LinePos < g_ui32LineLen);
+}
+
+int32_t
+UARTCharGetNonBlocking(uint32_t ui32Base)
+{
+  (void)ui32Base;
+  if(g_ui32LinePos == g_ui32LineLen) {
+    return(-1);
+  }
+  return((int32_t)g_pui32Line[g_ui32LinePos++]);
+}
+
+bool
+UARTSpaceAvail(uint32_t ui32Base)
+{
+  (void)ui32Base;
+  return(true);
+}
+
+bool
+UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData)
+{
+  (void)ui32Base;
+  (void)ucData;
+  return(true);
+}
+
+bool
+UARTBusy(uint32_t ui32Base)
+{
+  (void)ui32Base;
+  return(false);
+}
+
+void
+UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32Tx, uint32_t ui32Rx)
+{
+  (void)ui32Base;
+  (void)ui32Tx;
+  g_ui32RxLevel = ui32Rx;
+}
+
+void
+UARTTxIntModeSet(uint32_t ui32Base, uint32_t ui32Mode)
+{
+  (void)ui32Base;
+  (void)ui32Mode;
+}
+
+void
+UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+  (void)ui32Base;
+  (void)ui32IntFlags;
+}
+
+//*****************************************************************************
+//
+// Records a failed check.
+//
+//*****************************************************************************
+static void
+Check(bool bOK, const char *pcWhat, int iLine)
+{
+  if(!bOK) {
+    printf("line %d: %s\n", iLine, pcWhat);
+    g_ui32Failures++;
+  }
+}
+
+//*****************************************************************************
+//
+// Empties the model and starts a new ring.
+//
+//*****************************************************************************
+static void
+Reset(void)
+{
+  g_ui32LineLen = 0;
+  g_ui32LinePos = 0;
+  g_bMasked = false;
+  memset((void *)g_pui32Regs, 0, sizeof(g_pui32Regs));
+  UARTRxInit(&g_sRx, 0, g_pui8Ring, RING_SIZE);
+}
+
+//*****************************************************************************
+//
+// Puts a data register value on the line.
+//
+//*****************************************************************************
+static void
+Receive(uint32_t ui32Data)
+{
+  g_pui32Line[g_ui32LineLen++] = ui32Data;
+}
+
+//*****************************************************************************
+//
+// Each receive error is counted once and its byte kept out of the queue;
+// an overrun is counted but the byte that carries it is good.
+//
+//*****************************************************************************
+static void
+CheckErrors(void)
+{
+  uint8_t pui8Data[RING_SIZE];
+  tUARTRxStats sStats;
+
+  Reset();
+  Receive('a');
+  Receive(UART_DR_OE | 'b');
+  Receive(UART_DR_FE | 'c');
+  Receive(UART_DR_PE | 'd');
+  Receive(UART_DR_BE | UART_DR_FE);
+  Receive(UART_DR_FE | UART_DR_PE | 'e');
+  Receive('f');
+  UARTRxIntHandler(&g_sRx);
+
+  UARTRxStatsGet(&g_sRx, &sStats);
+  CHECK(sStats.ui32Interrupts == 1);
+  CHECK(sStats.ui32Bytes == 7);
+  CHECK(sStats.ui32Overrun == 1);
+  CHECK(sStats.ui32Framing == 2);
+  CHECK(sStats.ui32Parity == 1);
+  CHECK(sStats.ui32Break == 1);
+  CHECK(sStats.ui32FIFOPeak == 7);
+  CHECK(sStats.ui32Dropped == 0);
+
+  CHECK(UARTRxAvail(&g_sRx) == 3);
+  CHECK(UARTRxRead(&g_sRx, pui8Data, sizeof(pui8Data)) == 3);
+  CHECK(memcmp(pui8Data, "abf", 3) == 0);
+}
+
+//*****************************************************************************
+//
+// One call takes at most a FIFO's worth, so the FIFO peak never passes the
+// hardware depth; input the queue has no room for is counted as dropped.
+//
+//*****************************************************************************
+static void
+CheckPeaks(void)
+{
+  uint8_t pui8Data[RING_SIZE];
+  tUARTRxStats sStats;
+  uint32_t ui32Idx;
+
+  Reset();
+  for(ui32Idx = 0; ui32Idx < 20; ui32Idx++) {
+    Receive('A' + ui32Idx);
+  }
+  UARTRxIntHandler(&g_sRx);
+  UARTRxStatsGet(&g_sRx, &sStats);
+  CHECK(sStats.ui32Bytes == FIFO_SIZE);
+  CHECK(sStats.ui32FIFOPeak == FIFO_SIZE);
+  CHECK(sStats.ui32QueuePeak == RING_SIZE);
+  CHECK(sStats.ui32Dropped == FIFO_SIZE - RING_SIZE);
+
+  // The oldest bytes are the ones kept.
+  CHECK(UARTRxRead(&g_sRx, pui8Data, sizeof(pui8Data)) == RING_SIZE);
+  CHECK(memcmp(pui8Data, "ABCDEFGH", RING_SIZE) == 0);
+
+  // The rest raise another interrupt.  Peaks are high-water marks and stay.
+  UARTRxIntHandler(&g_sRx);
+  UARTRxStatsGet(&g_sRx, &sStats);
+  CHECK(sStats.ui32Interrupts == 2);
+  CHECK(sStats.ui32Bytes == 20);
+  CHECK(sStats.ui32FIFOPeak == FIFO_SIZE);
+  CHECK(sStats.ui32QueuePeak == RING_SIZE);
+  CHECK(sStats.ui32Dropped == FIFO_SIZE - RING_SIZE);
+  CHECK(UARTRxRead(&g_sRx, pui8Data, sizeof(pui8Data)) == 4);
+  CHECK(memcmp(pui8Data, "QRST", 4) == 0);
+
+  // An interrupt with nothing to read still counts as one.
+  UARTRxIntHandler(&g_sRx);
+  UARTRxStatsGet(&g_sRx, &sStats);
+  CHECK(sStats.ui32Interrupts == 3);
+  CHECK(sStats.ui32Bytes == 20);
+}
+
+//*****************************************************************************
+//
+// Reads one byte and its arrival stamp.
+//
+//*****************************************************************************
+static uint32_t
+ReadStamp(void)
+{
+  uint8_t ui8Char;
+  uint32_t ui32Stamp = 0;
+
+  CHECK(UARTRxReadStamped(&g_sRx, &ui8Char, &ui32Stamp, 1) == 1);
+  return(ui32Stamp);
+}
+
+//*****************************************************************************
+//
+// Arrival stamps.  A batch short of the trigger level came from the
+// receive timeout, 32 bits after its last byte; otherwise the byte that
+// reached the trigger level arrived as the handler was entered.
+//
+//*****************************************************************************
+static void
+CheckStamps(void)
+{
+  uint32_t ui32Idx;
+
+  Reset();
+  g_pui32Regs[REG_IBRD] = 6;
+  g_pui32Regs[REG_FBRD] = 16;
+  g_pui32Regs[REG_CYCCNT] = 100000;
+  UARTRxStampsSet(&g_sRx, g_pui32Stamps);
+  CHECK(g_ui32RxLevel == UART_FIFO_RX1_8);
+
+  // A lone byte waits for the timeout.
+  Receive('a');
+  UARTRxIntHandler(&g_sRx);
+  CHECK(ReadStamp() == 100000 - (32 * BIT));
+
+  // Two bytes raise the interrupt; the first arrived a frame before, and
+  // the third came in while the handler ran.
+  Receive('b');
+  Receive('c');
+  Receive('d');
+  UARTRxIntHandler(&g_sRx);
+  CHECK(ReadStamp() == 100000 - (10 * BIT));
+  CHECK(ReadStamp() == 100000);
+  CHECK(ReadStamp() == 100000);
+
+  // High-speed mode halves the clocks per bit.
+  g_pui32Regs[REG_CTL] = UART_CTL_HSE;
+  Receive('e');
+  UARTRxIntHandler(&g_sRx);
+  CHECK(ReadStamp() == 100000 - (16 * BIT));
+  g_pui32Regs[REG_CTL] = 0;
+
+  // A byte dropped from a full queue must not overwrite the stamp of the
+  // unread byte in the slot it would have used.
+  g_pui32Regs[REG_CYCCNT] = 200000;
+  for(ui32Idx = 0; ui32Idx < RING_SIZE; ui32Idx++) {
+    Receive('f');
+  }
+  UARTRxIntHandler(&g_sRx);
+  g_pui32Regs[REG_CYCCNT] = 300000;
+  Receive('g');
+  UARTRxIntHandler(&g_sRx);
+  CHECK(g_sRx.sQueue.ui32Dropped == 1);
+  CHECK(ReadStamp() == 200000 - (10 * BIT));
+  for(ui32Idx = 1; ui32Idx < RING_SIZE; ui32Idx++) {
+    CHECK(ReadStamp() == 200000);
+  }
+
+  // Without stamps the trigger goes back to half full, and echo latency
+  // from the interrupt still counts the wait in the FIFO.
+  UARTRxStampsSet(&g_sRx, 0);
+  CHECK(g_ui32RxLevel == UART_FIFO_RX4_8);
+  UARTTxInit(&g_sEchoTx, 0, g_pui8EchoRing, RING_SIZE);
+  LatHistInit(&g_sEchoHist);
+  UARTRxEchoSet(&g_sRx, &g_sEchoTx, &g_sEchoHist);
+  for(ui32Idx = 0; ui32Idx < 3; ui32Idx++) {
+    Receive('h');
+  }
+  UARTRxIntHandler(&g_sRx);
+  CHECK(g_sEchoHist.ui32Samples == 3);
+  CHECK(g_sEchoHist.ui32Max == (32 * BIT) + (20 * BIT));
+  CHECK(g_sEchoHist.ui32Min == 32 * BIT);
+}
+
+//*****************************************************************************
+//
+// Runs the checks.
+//
+//*****************************************************************************
+int
+main(void)
+{
+  CheckErrors();
+  CheckPeaks();
+  CheckStamps();
+
+  printf("uartrx: %s\n", g_ui32Failures ? "FAILED" : "passed");
+  return(g_ui32Failures ? 1 : 0);
+}
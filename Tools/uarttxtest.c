@@ -0,0 +1,411 @@
+//*****************************************************************************
+//
+// uarttxtest.c - Host check of the UART transmit ring in Common/uarttx.c.
+//
+// Links the ring against a model UART with a 16 byte TX FIFO and a "wire"
+// that records every byte shifted out, then checks the free space count,
+// wrap-around, the high-water and overflow counters, UARTTxSend()'s
+// back-pressure and the barrier used to hand the FIFO to the uDMA.
+//
+// Build and run on the host:
+//
+//     cc -O2 -Istubs -I../Common -o uarttxtest uarttxtest.c ../Common/uarttx.c
+//     ./uarttxtest
+//
+// Prints each failed check and exits non-zero if there were any.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "driverlib/interrupt.h"
+#include "driverlib/uart.h"
+#include "uarttx.h"
+
+//*****************************************************************************
+//
+// Sizes of the model FIFO, the ring under test and the wire log.
+//
+//*****************************************************************************
+#define FIFO_SIZE               16
+#define RING_SIZE               64
+#define WIRE_SIZE               4096
+
+#define CHECK(x)                Check((x), #x, __LINE__)
+
+//*****************************************************************************
+//
+// The model UART.
+//
+//*****************************************************************************
+static uint8_t g_pui8Fifo[FIFO_SIZE];
+static uint32_t g_ui32FifoLevel;
+static uint8_t g_pui8Wire[WIRE_SIZE];
+static uint32_t g_ui32WireLen;
+static bool g_bMasked;
+static bool g_bPolledFull;
+static uint32_t g_ui32Failures;
+
+//*****************************************************************************
+//
+// The ring under test and what its barrier callback saw.
+//
+//*****************************************************************************
+static tUARTTx g_sTx;
+static uint8_t g_pui8Ring[RING_SIZE];
+static uint32_t g_ui32BarrierCalls;
+static uint32_t g_ui32BarrierFifo;
+
+//*****************************************************************************
+//
+// Driverlib stubs.
+//
+//*****************************************************************************
+bool
+IntMasterDisable(void)
+{
+  bool bWas = g_bMasked;
+
+  g_bMasked = true;
+  return(bWas);
+}
+
+bool
+IntMasterEnable(void)
+{
+  bool bWas = g_bMasked;
+
+  g_bMasked = false;
+  return(bWas);
+}
+
+//*****************************************************************************
+//
+// Moves the byte at the front of the model FIFO onto the wire.
+//
+//*****************************************************************************
+static void
+ShiftOne(void)
+{
+  g_pui8Wire[g_ui32WireLen++ % WIRE_SIZE] = g_pui8Fifo[0];
+  memmove(g_pui8Fifo, g_pui8Fifo + 1, --g_ui32FifoLevel);
+}
+
+//*****************************************************************************
+//
+// Reports room in the model FIFO.  A caller that polls a full FIFO again
+// straight away is busy-waiting, as UARTTxFlush() does, so time passes and
+// a byte shifts out.
+//
+//*****************************************************************************
+bool
+UARTSpaceAvail(uint32_t ui32Base)
+{
+  (void)ui32Base;
+  if(g_ui32FifoLevel < FIFO_SIZE) {
+    g_bPolledFull = false;
+    return(true);
+  }
+  if(g_bPolledFull) {
+    ShiftOne();
+  }
+  g_bPolledFull = true;
+  return(false);
+}
+
+bool
+UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData)
+{
+  (void)ui32Base;
+  if(g_ui32FifoLevel == FIFO_SIZE) {
+    return(false);
+  }
+  g_pui8Fifo[g_ui32FifoLevel++] = ucData;
+  return(true);
+}
+
+void
+UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32Tx, uint32_t ui32Rx)
+{
+  (void)ui32Base;
+  (void)ui32Tx;
+  (void)ui32Rx;
+}
+
+void
+UARTTxIntModeSet(uint32_t ui32Base, uint32_t ui32Mode)
+{
+  (void)ui32Base;
+  (void)ui32Mode;
+}
+
+void
+UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+  (void)ui32Base;
+  (void)ui32IntFlags;
+}
+
+//*****************************************************************************
+//
+// Shifts ui32Count bytes out of the model FIFO onto the wire.  Once the FIFO
+// drops below half and interrupts are not masked, the TX interrupt runs.
+//
+//*****************************************************************************
+static void
+Shift(uint32_t ui32Count)
+{
+  while(ui32Count-- && g_ui32FifoLevel) {
+    ShiftOne();
+    if((g_ui32FifoLevel < (FIFO_SIZE / 2)) && !g_bMasked) {
+      UARTTxIntHandler(&g_sTx);
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// UARTTxFlush() polls UARTBusy(), so the model shifts a byte each time it is
+// asked and the flush makes progress without any interrupt.
+//
+//*****************************************************************************
+bool
+UARTBusy(uint32_t ui32Base)
+{
+  (void)ui32Base;
+  if(g_ui32FifoLevel == 0) {
+    return(false);
+  }
+  ShiftOne();
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Records a failed check.
+//
+//*****************************************************************************
+static void
+Check(bool bOK, const char *pcWhat, int iLine)
+{
+  if(!bOK) {
+    printf("line %d: %s\n", iLine, pcWhat);
+    g_ui32Failures++;
+  }
+}
+
+//*****************************************************************************
+//
+// Empties the model and starts a new ring.
+//
+//*****************************************************************************
+static void
+Reset(void)
+{
+  g_ui32FifoLevel = 0;
+  g_ui32WireLen = 0;
+  g_bMasked = false;
+  g_bPolledFull = false;
+  UARTTxInit(&g_sTx, 0, g_pui8Ring, RING_SIZE);
+}
+
+//*****************************************************************************
+//
+// Barrier callback.  Notes how full the FIFO was when it was handed over.
+//
+//*****************************************************************************
+static void
+BarrierReached(void *pvData)
+{
+  (void)pvData;
+  g_ui32BarrierCalls++;
+  g_ui32BarrierFifo = g_ui32FifoLevel;
+}
+
+//*****************************************************************************
+//
+// Free space, high-water and overflow counting.
+//
+//*****************************************************************************
+static void
+CheckCounters(void)
+{
+  uint8_t pui8Data[100];
+  tUARTTxStats sStats;
+
+  Reset();
+  memset(pui8Data, 'x', sizeof(pui8Data));
+  CHECK(UARTTxSpace(&g_sTx) == RING_SIZE);
+
+  // The first FIFO's worth goes straight to the hardware.
+  CHECK(UARTTxWrite(&g_sTx, pui8Data, 20) == 20);
+  UARTTxStatsGet(&g_sTx, &sStats);
+  CHECK(g_ui32FifoLevel == FIFO_SIZE);
+  CHECK(sStats.ui32Queued == 20 - FIFO_SIZE);
+  CHECK(sStats.ui32Space == RING_SIZE - (20 - FIFO_SIZE));
+  CHECK(sStats.ui32HighWater == 20);
+  CHECK(sStats.ui32Overflow == 0);
+
+  // Asking for more than fits takes what fits and counts the rest.
+  CHECK(UARTTxWrite(&g_sTx, pui8Data, 100) == RING_SIZE - 4);
+  UARTTxStatsGet(&g_sTx, &sStats);
+  CHECK(sStats.ui32Space == 0);
+  CHECK(sStats.ui32Overflow == 100 - (RING_SIZE - 4));
+  CHECK(sStats.ui32HighWater == RING_SIZE);
+  CHECK(UARTTxPutChar(&g_sTx, 'y') == 0);
+  CHECK(g_sTx.ui32Overflow == 100 - (RING_SIZE - 4) + 1);
+
+  // Draining does not lower the high-water mark.
+  Shift(WIRE_SIZE);
+  UARTTxStatsGet(&g_sTx, &sStats);
+  CHECK(sStats.ui32Queued == 0);
+  CHECK(sStats.ui32Space == RING_SIZE);
+  CHECK(sStats.ui32HighWater == RING_SIZE);
+  CHECK(g_ui32WireLen == 20 + RING_SIZE - 4);
+}
+
+//*****************************************************************************
+//
+// Order across many trips round the ring, with writes of odd lengths
+// interleaved with the interrupt.
+//
+//*****************************************************************************
+static void
+CheckWrap(void)
+{
+  uint8_t pui8Data[23];
+  uint32_t ui32Next, ui32Len, ui32Idx;
+  bool bInOrder;
+
+  Reset();
+  ui32Next = 0;
+  while(ui32Next < 3000) {
+    ui32Len = 1 + (ui32Next % sizeof(pui8Data));
+    if(ui32Len > UARTTxSpace(&g_sTx)) {
+      ui32Len = UARTTxSpace(&g_sTx);
+    }
+    for(ui32Idx = 0; ui32Idx < ui32Len; ui32Idx++) {
+      pui8Data[ui32Idx] = (uint8_t)(ui32Next + ui32Idx);
+    }
+    CHECK(UARTTxWrite(&g_sTx, pui8Data, ui32Len) == ui32Len);
+    ui32Next += ui32Len;
+    Shift(1 + (ui32Next % 11));
+  }
+  UARTTxFlush(&g_sTx);
+
+  bInOrder = (g_ui32WireLen == ui32Next);
+  for(ui32Idx = 0; ui32Idx < g_ui32WireLen; ui32Idx++) {
+    if(g_pui8Wire[ui32Idx] != (uint8_t)ui32Idx) {
+      bInOrder = false;
+    }
+  }
+  CHECK(bInOrder);
+  CHECK(g_sTx.ui32Overflow == 0);
+  CHECK(g_sTx.ui32Head > 40 * RING_SIZE);
+}
+
+//*****************************************************************************
+//
+// UARTTxSend() uses the FIFO first, then the ring only if asked to defer,
+// and never lets new bytes overtake ones already queued.
+//
+//*****************************************************************************
+static void
+CheckSend(void)
+{
+  uint8_t pui8Data[40];
+  uint32_t ui32Idx;
+
+  Reset();
+  for(ui32Idx = 0; ui32Idx < sizeof(pui8Data); ui32Idx++) {
+    pui8Data[ui32Idx] = (uint8_t)ui32Idx;
+  }
+
+  CHECK(UARTTxSend(&g_sTx, pui8Data, 20, false) == FIFO_SIZE);
+  CHECK(g_sTx.ui32Accepted == FIFO_SIZE);
+  CHECK(g_sTx.ui32Head == 0);
+
+  Shift(4);
+  CHECK(UARTTxSend(&g_sTx, pui8Data + FIFO_SIZE, 24, true) == 24);
+  CHECK(g_sTx.ui32Accepted == FIFO_SIZE + 4);
+  CHECK(g_sTx.ui32Deferred == 20);
+
+  // With bytes in the ring, a send goes behind them, not into the FIFO.
+  CHECK(UARTTxSend(&g_sTx, pui8Data, 5, false) == 0);
+  CHECK(g_sTx.ui32Accepted == FIFO_SIZE + 4);
+
+  UARTTxFlush(&g_sTx);
+  CHECK(g_ui32WireLen == 40);
+  CHECK(memcmp(g_pui8Wire, pui8Data, 40) == 0);
+}
+
+//*****************************************************************************
+//
+// A barrier holds back bytes queued after it, calls back once the bytes
+// ahead of it are in the FIFO, and releases the rest when cleared.
+//
+//*****************************************************************************
+static void
+CheckBarrier(void)
+{
+  uint8_t pui8Data[30];
+
+  Reset();
+  g_ui32BarrierCalls = 0;
+  memset(pui8Data, 'a', 30);
+  UARTTxWrite(&g_sTx, pui8Data, 30);
+
+  IntMasterDisable();
+  UARTTxBarrierSet(&g_sTx, BarrierReached, 0);
+  IntMasterEnable();
+  CHECK(g_ui32BarrierCalls == 0);
+
+  memset(pui8Data, 'b', 10);
+  UARTTxWrite(&g_sTx, pui8Data, 10);
+
+  // Flush stops at the barrier; the callback fires once, when the last 'a'
+  // went into the FIFO.
+  UARTTxFlush(&g_sTx);
+  CHECK(g_ui32BarrierCalls == 1);
+  CHECK(g_ui32BarrierFifo > 0);
+  CHECK(g_ui32WireLen == 30);
+  CHECK(g_sTx.ui32Head - g_sTx.ui32Tail == 10);
+  Shift(WIRE_SIZE);
+  UARTTxIntHandler(&g_sTx);
+  CHECK(g_ui32BarrierCalls == 1);
+  CHECK(g_ui32WireLen == 30);
+
+  UARTTxBarrierClear(&g_sTx);
+  UARTTxFlush(&g_sTx);
+  CHECK(g_ui32WireLen == 40);
+  CHECK(g_pui8Wire[29] == 'a');
+  CHECK(g_pui8Wire[30] == 'b');
+  CHECK(g_sTx.ui32Head == g_sTx.ui32Tail);
+
+  // A barrier set on an empty ring is reached at once.
+  IntMasterDisable();
+  UARTTxBarrierSet(&g_sTx, BarrierReached, 0);
+  IntMasterEnable();
+  CHECK(g_ui32BarrierCalls == 2);
+  UARTTxBarrierClear(&g_sTx);
+}
+
+//*****************************************************************************
+//
+// Runs the checks.
+//
+//*****************************************************************************
+int
+main(void)
+{
+  CheckCounters();
+  CheckWrap();
+  CheckSend();
+  CheckBarrier();
+
+  printf("uarttx: %s\n", g_ui32Failures ? "FAILED" : "passed");
+  return(g_ui32Failures ? 1 : 0);
+}
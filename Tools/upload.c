@@ -0,0 +1,288 @@
+//*****************************************************************************
+//
+// upload.c - Host-side sender for the windowed bulk upload protocol.
+//
+// Sends a file to the board over its serial port, keeping up to
+// UPLOAD_WINDOW frames in flight so the line stays busy while acks come
+// back.  A NAK or a silence of half a second sends it back to the first
+// frame not yet acknowledged.
+//
+// The protocol itself is in uploadsend.c; this file only drives it over a
+// serial port.
+//
+// Build and run on the host:
+//
+//     cc -O2 -I../Common -o upload upload.c uploadsend.c ../Common/telemetry.c
+//     ./upload -b 115200 -c U -t 1 -n /dev/ttyACM0 song.txt
+//
+// -c sends a command line first, e.g. the board's upload command, and
+// discards whatever the board prints in reply.  -t gives the target id the
+// board expects.  With -n the file is text, one number per line, and is
+// sent as 32-bit little-endian words, which is how note tables and motion
+// profiles are stored; otherwise it is sent byte for byte.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <sys/time.h>
+
+#include "telemetry.h"
+#include "upload.h"
+#include "uploadsend.h"
+
+//*****************************************************************************
+//
+// Largest image the tool will send, and how long to wait for an answer.
+//
+//*****************************************************************************
+#define MAX_IMAGE               (1024 * 1024)
+#define REPLY_TIMEOUT_MS        500
+#define MAX_RETRIES             10
+
+//*****************************************************************************
+//
+// The image being sent.
+//
+//*****************************************************************************
+static uint8_t g_pui8Image[MAX_IMAGE];
+static uint32_t g_ui32Length;
+
+//*****************************************************************************
+//
+// Serial rates the tool knows how to set.
+//
+//*****************************************************************************
+static const struct
+{
+  uint32_t ui32Baud;
+  speed_t sSpeed;
+}
+g_psRates[] =
+{
+  {9600, B9600}, {19200, B19200}, {38400, B38400}, {57600, B57600},
+  {115200, B115200}, {230400, B230400},
+#ifdef B460800
+  {460800, B460800},
+#endif
+#ifdef B921600
+  {921600, B921600},
+#endif
+#ifdef B1000000
+  {1000000, B1000000},
+#endif
+#ifdef B2000000
+  {2000000, B2000000},
+#endif
+};
+
+//*****************************************************************************
+//
+// Opens the serial port raw at the given rate.  Returns -1 on failure.
+//
+//*****************************************************************************
+static int
+OpenPort(const char *pcDevice, uint32_t ui32Baud)
+{
+  struct termios sTerm;
+  uint32_t ui32Idx;
+  int iFd;
+
+  for(ui32Idx = 0; ui32Idx < (sizeof(g_psRates) / sizeof(g_psRates[0]));
+      ui32Idx++) {
+    if(g_psRates[ui32Idx].ui32Baud == ui32Baud) {
+      break;
+    }
+  }
+  if(ui32Idx == (sizeof(g_psRates) / sizeof(g_psRates[0]))) {
+    fprintf(stderr, "unsupported baud rate %u\n", ui32Baud);
+    return(-1);
+  }
+
+  if((iFd = open(pcDevice, O_RDWR | O_NOCTTY)) < 0) {
+    perror(pcDevice);
+    return(-1);
+  }
+  if(tcgetattr(iFd, &sTerm) == 0) {
+    cfmakeraw(&sTerm);
+    cfsetispeed(&sTerm, g_psRates[ui32Idx].sSpeed);
+    cfsetospeed(&sTerm, g_psRates[ui32Idx].sSpeed);
+    sTerm.c_cc[VMIN] = 0;
+    sTerm.c_cc[VTIME] = 0;
+    tcsetattr(iFd, TCSANOW, &sTerm);
+  }
+
+  return(iFd);
+}
+
+//*****************************************************************************
+//
+// Reads the file into g_pui8Image, as numbers if bNumbers is set.  Returns
+// false if it cannot be read or is too big.
+//
+//*****************************************************************************
+static bool
+LoadImage(const char *pcFile, bool bNumbers)
+{
+  FILE *psIn;
+  long lValue;
+
+  if((psIn = fopen(pcFile, bNumbers ? "r" : "rb")) == NULL) {
+    perror(pcFile);
+    return(false);
+  }
+  if(!bNumbers) {
+    g_ui32Length = fread(g_pui8Image, 1, sizeof(g_pui8Image), psIn);
+  }
+  else {
+    g_ui32Length = 0;
+    while((g_ui32Length <= (sizeof(g_pui8Image) - 4)) &&
+          (fscanf(psIn, "%li", &lValue) == 1)) {
+      g_pui8Image[g_ui32Length++] = lValue;
+      g_pui8Image[g_ui32Length++] = lValue >> 8;
+      g_pui8Image[g_ui32Length++] = lValue >> 16;
+      g_pui8Image[g_ui32Length++] = lValue >> 24;
+    }
+  }
+  if(!feof(psIn) && !bNumbers) {
+    fprintf(stderr, "%s: larger than %u bytes\n", pcFile, MAX_IMAGE);
+    fclose(psIn);
+    return(false);
+  }
+  fclose(psIn);
+
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Link callbacks for the sender: the serial port is the file descriptor
+// passed as pvData.
+//
+//*****************************************************************************
+static bool
+SerialWrite(const uint8_t *pui8Data, uint32_t ui32Count, void *pvData)
+{
+  return(write(*(int *)pvData, pui8Data, ui32Count) == (ssize_t)ui32Count);
+}
+
+static uint32_t
+SerialRead(uint8_t *pui8Data, uint32_t ui32Max, void *pvData)
+{
+  int iFd = *(int *)pvData;
+  struct timeval sTimeout;
+  fd_set sRead;
+  ssize_t iLen;
+
+  FD_ZERO(&sRead);
+  FD_SET(iFd, &sRead);
+  sTimeout.tv_sec = 0;
+  sTimeout.tv_usec = REPLY_TIMEOUT_MS * 1000;
+  if(select(iFd + 1, &sRead, NULL, NULL, &sTimeout) <= 0) {
+    return(0);
+  }
+  iLen = read(iFd, pui8Data, ui32Max);
+
+  return((iLen > 0) ? iLen : 0);
+}
+
+//*****************************************************************************
+//
+// Returns the time in seconds, for the throughput report.
+//
+//*****************************************************************************
+static double
+Now(void)
+{
+  struct timeval sTime;
+
+  gettimeofday(&sTime, NULL);
+  return(sTime.tv_sec + (sTime.tv_usec / 1e6));
+}
+
+int
+main(int argc, char **argv)
+{
+  tUploadSender sSender;
+  uint32_t ui32Baud = 115200;
+  uint32_t ui32Result;
+  const char *pcCommand = NULL;
+  bool bNumbers = false;
+  double dStart, dTime;
+  int iArg, iFd;
+
+  sSender.ui8Target = 0;
+  for(iArg = 1; iArg < argc; iArg++) {
+    if(!strcmp(argv[iArg], "-b") && ((iArg + 1) < argc)) {
+      ui32Baud = strtoul(argv[++iArg], NULL, 0);
+    }
+    else if(!strcmp(argv[iArg], "-c") && ((iArg + 1) < argc)) {
+      pcCommand = argv[++iArg];
+    }
+    else if(!strcmp(argv[iArg], "-t") && ((iArg + 1) < argc)) {
+      sSender.ui8Target = strtoul(argv[++iArg], NULL, 0);
+    }
+    else if(!strcmp(argv[iArg], "-n")) {
+      bNumbers = true;
+    }
+    else {
+      break;
+    }
+  }
+  if((argc - iArg) != 2) {
+    fprintf(stderr, "usage: %s [-b baud] [-c command] [-t target] [-n] "
+            "device file\n", argv[0]);
+    return(1);
+  }
+  if(!LoadImage(argv[iArg + 1], bNumbers) ||
+     ((iFd = OpenPort(argv[iArg], ui32Baud)) < 0)) {
+    return(1);
+  }
+
+  // Put the board into upload mode and throw away its echo and banner.
+  if(pcCommand) {
+    if((write(iFd, pcCommand, strlen(pcCommand)) < 0) ||
+       (write(iFd, "\r", 1) < 0)) {
+      perror(argv[iArg]);
+      return(1);
+    }
+    usleep(200000);
+    tcflush(iFd, TCIFLUSH);
+  }
+
+  sSender.pui8Image = g_pui8Image;
+  sSender.ui32Length = g_ui32Length;
+  sSender.pfnWrite = SerialWrite;
+  sSender.pfnRead = SerialRead;
+  sSender.pvData = &iFd;
+  sSender.ui32MaxRetries = MAX_RETRIES;
+  dStart = Now();
+  ui32Result = UploadSend(&sSender);
+  dTime = Now() - dStart;
+  close(iFd);
+
+  switch(ui32Result) {
+  case UPLOAD_SEND_REFUSED:
+    fprintf(stderr, "upload refused, reason %u\n", sSender.ui8Reason);
+    return(1);
+  case UPLOAD_SEND_NO_ANSWER:
+    fprintf(stderr, "no answer from the board\n");
+    return(1);
+  case UPLOAD_SEND_IO:
+    perror(argv[iArg]);
+    return(1);
+  }
+
+  printf("%u bytes in %.2f s, %.0f bytes/s (%.0f%% of the line), "
+         "%u frames resent\n", g_ui32Length, dTime, g_ui32Length / dTime,
+         (100.0 * g_ui32Length * 10) / (dTime * ui32Baud), sSender.ui32Resent);
+
+  return(0);
+}
@@ -0,0 +1,178 @@
+//*****************************************************************************
+//
+// uploadsend.c - Host side of the windowed upload in Common/upload.c.
+//
+// Sends an image to the board go-back-N style: up to UPLOAD_WINDOW frames
+// are kept in flight, each ack slides the window on, and a gap NAK or a
+// silence sends everything from the first unacknowledged frame again.  The
+// link is reached only through the two callbacks in tUploadSender, so the
+// same code drives a serial port in Tools/upload.c and an in-memory lossy
+// link in Tools/uploadtest.c.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "telemetry.h"
+#include "upload.h"
+#include "uploadsend.h"
+
+//*****************************************************************************
+//
+// Builds frame ui32Frame of the upload, encoded and delimited, in pui8Out.
+// Frame 0 is START, frames 1 to ui32Frames - 2 carry data and the last one
+// is END.  Returns its length.
+//
+//*****************************************************************************
+static uint32_t
+UploadSendFrame(tUploadSender *psSender, uint32_t ui32Frame, uint8_t *pui8Out)
+{
+  tTelemetry sTelem;
+  uint32_t ui32Offset, ui32Len;
+  uint16_t ui16CRC;
+  uint8_t pui8CRC[2];
+
+  TelemetryInit(&sTelem);
+  sTelem.ui8Seq = ui32Frame;
+
+  if(ui32Frame == 0) {
+    return(TelemetryFrameBuild(&sTelem, UPLOAD_TYPE_START,
+                               psSender->ui32Length, &psSender->ui8Target, 1,
+                               pui8Out));
+  }
+  if(ui32Frame == (psSender->ui32Frames - 1)) {
+    ui16CRC = TelemetryCRC16(psSender->pui8Image, psSender->ui32Length);
+    pui8CRC[0] = ui16CRC;
+    pui8CRC[1] = ui16CRC >> 8;
+    return(TelemetryFrameBuild(&sTelem, UPLOAD_TYPE_END, psSender->ui32Length,
+                               pui8CRC, 2, pui8Out));
+  }
+
+  ui32Offset = (ui32Frame - 1) * UPLOAD_CHUNK_SIZE;
+  ui32Len = psSender->ui32Length - ui32Offset;
+  if(ui32Len > UPLOAD_CHUNK_SIZE) {
+    ui32Len = UPLOAD_CHUNK_SIZE;
+  }
+  return(TelemetryFrameBuild(&sTelem, UPLOAD_TYPE_DATA, ui32Offset,
+                             psSender->pui8Image + ui32Offset, ui32Len,
+                             pui8Out));
+}
+
+//*****************************************************************************
+//
+// Waits for the next good ACK or NAK.  Corrupt frames and stray console
+// text are skipped.  Returns false if the link falls silent first.
+//
+//*****************************************************************************
+static bool
+UploadSendReply(tUploadSender *psSender, tTelemetryFrame *psFrame)
+{
+  uint8_t ui8Byte;
+
+  for(;;) {
+    if(psSender->ui32InputPos == psSender->ui32InputLen) {
+      psSender->ui32InputPos = 0;
+      psSender->ui32InputLen =
+        psSender->pfnRead(psSender->pui8Input, sizeof(psSender->pui8Input),
+                          psSender->pvData);
+      if(psSender->ui32InputLen == 0) {
+        return(false);
+      }
+    }
+
+    ui8Byte = psSender->pui8Input[psSender->ui32InputPos++];
+    if(ui8Byte != 0) {
+      if(psSender->ui32ReplyLen < sizeof(psSender->pui8Reply)) {
+        psSender->pui8Reply[psSender->ui32ReplyLen++] = ui8Byte;
+      }
+      continue;
+    }
+    if((psSender->ui32ReplyLen != 0) &&
+       (psSender->ui32ReplyLen < sizeof(psSender->pui8Reply)) &&
+       TelemetryFrameDecode(psSender->pui8Reply, psSender->ui32ReplyLen,
+                            psFrame) &&
+       ((psFrame->ui8Type == UPLOAD_TYPE_ACK) ||
+        (psFrame->ui8Type == UPLOAD_TYPE_NAK))) {
+      psSender->ui32ReplyLen = 0;
+      return(true);
+    }
+    psSender->ui32ReplyLen = 0;
+  }
+}
+
+//*****************************************************************************
+//
+// Sends the whole image and returns one of the UPLOAD_SEND_ results.
+//
+//*****************************************************************************
+uint32_t
+UploadSend(tUploadSender *psSender)
+{
+  uint8_t pui8Frame[TELEMETRY_MAX_ENCODED];
+  tTelemetryFrame sReply;
+  uint32_t ui32Base, ui32Next, ui32Len, ui32Step, ui32Retries;
+
+  psSender->ui32Frames = ((psSender->ui32Length + UPLOAD_CHUNK_SIZE - 1) /
+                          UPLOAD_CHUNK_SIZE) + 2;
+  psSender->ui32Sent = 0;
+  psSender->ui32Resent = 0;
+  psSender->ui32Naks = 0;
+  psSender->ui32Timeouts = 0;
+  psSender->ui8Reason = 0;
+  psSender->ui32ReplyLen = 0;
+  psSender->ui32InputLen = 0;
+  psSender->ui32InputPos = 0;
+  ui32Base = 0;
+  ui32Next = 0;
+  ui32Retries = 0;
+
+  // Keep the window full, slide it on each ack, and rewind to the first
+  // unacknowledged frame on a gap or a silence.
+  while(ui32Base < psSender->ui32Frames) {
+    while((ui32Next < psSender->ui32Frames) &&
+          (ui32Next < (ui32Base + UPLOAD_WINDOW))) {
+      ui32Len = UploadSendFrame(psSender, ui32Next, pui8Frame);
+      if(!psSender->pfnWrite(pui8Frame, ui32Len, psSender->pvData)) {
+        return(UPLOAD_SEND_IO);
+      }
+      psSender->ui32Sent++;
+      ui32Next++;
+    }
+
+    if(!UploadSendReply(psSender, &sReply)) {
+      if(++ui32Retries > psSender->ui32MaxRetries) {
+        return(UPLOAD_SEND_NO_ANSWER);
+      }
+      psSender->ui32Timeouts++;
+      psSender->ui32Resent += ui32Next - ui32Base;
+      ui32Next = ui32Base;
+      continue;
+    }
+
+    if((sReply.ui8Type == UPLOAD_TYPE_NAK) &&
+       ((sReply.ui32PayloadLen < 1) ||
+        (sReply.pui8Payload[0] != UPLOAD_NAK_GAP))) {
+      psSender->ui8Reason = sReply.ui32PayloadLen ? sReply.pui8Payload[0] : 0;
+      return(UPLOAD_SEND_REFUSED);
+    }
+
+    // Sequence numbers are 8 bits; anything outside the frames in flight
+    // is a stale reply.
+    ui32Step = (uint8_t)(sReply.ui8Seq - (uint8_t)ui32Base);
+    if(ui32Step > (ui32Next - ui32Base)) {
+      continue;
+    }
+    if(ui32Step) {
+      ui32Retries = 0;
+    }
+    ui32Base += ui32Step;
+    if(sReply.ui8Type == UPLOAD_TYPE_NAK) {
+      psSender->ui32Naks++;
+      psSender->ui32Resent += ui32Next - ui32Base;
+      ui32Next = ui32Base;
+    }
+  }
+
+  return(UPLOAD_SEND_OK);
+}
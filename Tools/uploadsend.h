@@ -0,0 +1,87 @@
+//*****************************************************************************
+//
+// uploadsend.h - Prototypes for the host side of the windowed upload.
+//
+//*****************************************************************************
+
+#ifndef __UPLOADSEND_H__
+#define __UPLOADSEND_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "telemetry.h"
+#include "upload.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Results of UploadSend().
+//
+//*****************************************************************************
+#define UPLOAD_SEND_OK          0       // The board acknowledged the END frame
+#define UPLOAD_SEND_REFUSED     1       // A NAK other than a gap; see ui8Reason
+#define UPLOAD_SEND_NO_ANSWER   2       // Too many silences in a row
+#define UPLOAD_SEND_IO          3       // pfnWrite failed
+
+//*****************************************************************************
+//
+// Sends ui32Count bytes to the board.  Returns false on an I/O error.
+//
+//*****************************************************************************
+typedef bool (*tUploadWriteFn)(const uint8_t *pui8Data, uint32_t ui32Count,
+                               void *pvData);
+
+//*****************************************************************************
+//
+// Waits for bytes from the board and returns up to ui32Max of them, or 0 if
+// none came within the reply timeout.
+//
+//*****************************************************************************
+typedef uint32_t (*tUploadReadFn)(uint8_t *pui8Data, uint32_t ui32Max,
+                                  void *pvData);
+
+//*****************************************************************************
+//
+// Sender state.  The caller fills in the image, target, link and retry
+// limit; UploadSend() fills in the counters.
+//
+//*****************************************************************************
+typedef struct
+{
+  const uint8_t *pui8Image;     // Image to send
+  uint32_t ui32Length;          // Its length in bytes
+  uint8_t ui8Target;            // Target id the board expects
+  tUploadWriteFn pfnWrite;      // Link to the board
+  tUploadReadFn pfnRead;
+  void *pvData;                 // Argument passed to both
+  uint32_t ui32MaxRetries;      // Silences in a row before giving up
+  uint32_t ui32Frames;          // Frames in the upload, START to END
+  uint32_t ui32Sent;            // Frames written, first tries and resends
+  uint32_t ui32Resent;          // Frames written again after a NAK or silence
+  uint32_t ui32Naks;            // Gap NAKs received
+  uint32_t ui32Timeouts;        // Silences that sent the window again
+  uint8_t ui8Reason;            // NAK reason when UPLOAD_SEND_REFUSED
+  uint8_t pui8Reply[TELEMETRY_MAX_ENCODED];     // Reply being received
+  uint32_t ui32ReplyLen;        // Bytes of it so far
+  uint8_t pui8Input[256];       // Bytes read but not yet looked at
+  uint32_t ui32InputLen;
+  uint32_t ui32InputPos;
+} tUploadSender;
+
+//*****************************************************************************
+//
+// Prototypes.
+//
+//*****************************************************************************
+extern uint32_t UploadSend(tUploadSender *psSender);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UPLOADSEND_H__
@@ -0,0 +1,362 @@
+//*****************************************************************************
+//
+// uploadtest.c - Loopback test of the windowed upload protocol.
+//
+// Runs the host sender in uploadsend.c against the board's receiver in
+// Common/upload.c, back to back over an in-memory link that can corrupt
+// bytes, drop whole frames in either direction and mangle chosen frames.
+// A read that finds no reply waiting counts as the sender's reply timeout,
+// so recovery by silence is exercised as well as recovery by NAK.
+//
+// Each scenario must end with the receiver done, the image committed once
+// and byte for byte intact, and the recovery it was meant to provoke seen
+// in the sender's counters.
+//
+// Build and run on the host:
+//
+//     cc -O2 -I../Common -o uploadtest uploadtest.c uploadsend.c ../Common/upload.c ../Common/telemetry.c
+//     ./uploadtest
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry.h"
+#include "upload.h"
+#include "uploadsend.h"
+
+//*****************************************************************************
+//
+// Size of the test image, enough frames for the 8-bit sequence numbers to
+// wrap twice, and the target id the receiver accepts.
+//
+//*****************************************************************************
+#define IMAGE_SIZE              (50 * 1024)
+#define TARGET                  1
+#define REPLY_BUF_SIZE          (64 * 1024)
+
+//*****************************************************************************
+//
+// Faults a scenario injects.  Rates are one in N, 0 for never.
+//
+//*****************************************************************************
+typedef struct
+{
+  const char *pcName;
+  uint32_t ui32ByteCorrupt;     // Bytes to the board flipped
+  uint32_t ui32FrameDrop;       // Frames to the board lost
+  uint32_t ui32ReplyDrop;       // Replies from the board lost
+  uint32_t ui32CorruptEnd;      // First END frames corrupted
+  uint32_t ui32DropEndAck;      // First acks of an END frame lost
+  uint32_t ui32DropStart;       // First START frames lost
+  uint32_t ui32CorruptFrame;    // Data frame, by number, corrupted once
+  uint32_t ui32MinNaks;         // Recovery the scenario must provoke
+  uint32_t ui32MinTimeouts;
+} tScenario;
+
+static const tScenario g_psScenarios[] =
+{
+  {"clean link",              0,  0,  0, 0, 0, 0,  0, 0, 0},
+  {"one corrupt data frame",  0,  0,  0, 0, 0, 0, 37, 1, 0},
+  {"1/3000 byte corruption", 3000, 0, 0, 0, 0, 0,  0, 1, 0},
+  {"1/500 byte corruption", 500,  0,  0, 0, 0, 0,  0, 1, 0},
+  {"1/40 frames dropped",     0, 40,  0, 0, 0, 0,  0, 1, 0},
+  {"1/10 acks dropped",       0,  0, 10, 0, 0, 0,  0, 0, 0},
+  {"corrupt END frame",       0,  0,  0, 1, 0, 0,  0, 0, 1},
+  {"END corrupted 3 times",   0,  0,  0, 3, 0, 0,  0, 0, 3},
+  {"lost ack of END",         0,  0,  0, 0, 1, 0,  0, 0, 1},
+  {"lost START frame",        0,  0,  0, 0, 0, 1,  0, 0, 1},
+  {"everything at once",    700, 60,  8, 2, 1, 1,  0, 1, 1},
+};
+
+#define NUM_SCENARIOS           (sizeof(g_psScenarios) / sizeof(g_psScenarios[0]))
+
+//*****************************************************************************
+//
+// The link and both ends of it.
+//
+//*****************************************************************************
+static const tScenario *g_psScenario;
+static uint32_t g_ui32Random;
+static uint32_t g_ui32EndsCorrupted;
+static uint32_t g_ui32EndAcksDropped;
+static uint32_t g_ui32StartsDropped;
+static uint32_t g_ui32DataFrames;
+
+static tUpload g_sUpload;
+static uint8_t g_pui8Image[IMAGE_SIZE];
+static uint8_t g_pui8Received[IMAGE_SIZE];
+static uint32_t g_ui32Commits;
+
+static uint8_t g_pui8Replies[REPLY_BUF_SIZE];
+static uint32_t g_ui32ReplyLen;
+static uint32_t g_ui32ReplyPos;
+
+//*****************************************************************************
+//
+// A small fixed-seed generator, so every run injects the same faults.
+// Returns true one time in ui32Rate, never for 0.
+//
+//*****************************************************************************
+static uint32_t
+Random(void)
+{
+  g_ui32Random = (g_ui32Random * 1664525) + 1013904223;
+  return(g_ui32Random >> 8);
+}
+
+static bool
+OneIn(uint32_t ui32Rate)
+{
+  return(ui32Rate && ((Random() % ui32Rate) == 0));
+}
+
+//*****************************************************************************
+//
+// Receiver callbacks, as Lab 10 provides them.
+//
+//*****************************************************************************
+static uint8_t *
+Begin(uint8_t ui8Target, uint32_t ui32Length, void *pvData)
+{
+  (void)pvData;
+  if((ui8Target != TARGET) || (ui32Length > sizeof(g_pui8Received))) {
+    return(0);
+  }
+  memset(g_pui8Received, 0, sizeof(g_pui8Received));
+  return(g_pui8Received);
+}
+
+static bool
+End(uint8_t ui8Target, uint32_t ui32Length, void *pvData)
+{
+  (void)ui8Target;
+  (void)ui32Length;
+  (void)pvData;
+  g_ui32Commits++;
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Returns the type of an encoded frame, or 0 if it does not decode.
+//
+//*****************************************************************************
+static uint8_t
+FrameType(const uint8_t *pui8Data, uint32_t ui32Count)
+{
+  uint8_t pui8Copy[TELEMETRY_MAX_ENCODED];
+  tTelemetryFrame sFrame;
+
+  if((ui32Count < 2) || (ui32Count > sizeof(pui8Copy))) {
+    return(0);
+  }
+  memcpy(pui8Copy, pui8Data, ui32Count - 1);
+  if(!TelemetryFrameDecode(pui8Copy, ui32Count - 1, &sFrame)) {
+    return(0);
+  }
+
+  return(sFrame.ui8Type);
+}
+
+//*****************************************************************************
+//
+// Sender to board.  The sender writes one whole frame a call, so frame
+// faults are decided here; the bytes, damaged or not, then go through the
+// receiver one at a time and its replies are queued for the sender.
+//
+//*****************************************************************************
+static bool
+LinkWrite(const uint8_t *pui8Data, uint32_t ui32Count, void *pvData)
+{
+  uint8_t pui8Frame[TELEMETRY_MAX_ENCODED];
+  uint32_t ui32Idx, ui32Len;
+  uint8_t ui8Type;
+  bool bDropReply;
+
+  (void)pvData;
+  memcpy(pui8Frame, pui8Data, ui32Count);
+  ui8Type = FrameType(pui8Data, ui32Count);
+
+  if((ui8Type == UPLOAD_TYPE_START) &&
+     (g_ui32StartsDropped < g_psScenario->ui32DropStart)) {
+    g_ui32StartsDropped++;
+    return(true);
+  }
+  if((ui8Type == UPLOAD_TYPE_END) &&
+     (g_ui32EndsCorrupted < g_psScenario->ui32CorruptEnd)) {
+    g_ui32EndsCorrupted++;
+    pui8Frame[ui32Count / 2] ^= 0x5A;
+  }
+  if(ui8Type == UPLOAD_TYPE_DATA) {
+    if(++g_ui32DataFrames == g_psScenario->ui32CorruptFrame) {
+      pui8Frame[3] ^= 0x01;
+    }
+  }
+  bDropReply = false;
+  if((ui8Type == UPLOAD_TYPE_END) &&
+     (g_ui32EndAcksDropped < g_psScenario->ui32DropEndAck)) {
+    g_ui32EndAcksDropped++;
+    bDropReply = true;
+  }
+  if(OneIn(g_psScenario->ui32FrameDrop)) {
+    return(true);
+  }
+
+  for(ui32Idx = 0; ui32Idx < ui32Count; ui32Idx++) {
+    if(OneIn(g_psScenario->ui32ByteCorrupt)) {
+      pui8Frame[ui32Idx] ^= 1 + (Random() % 255);
+    }
+    ui32Len = UploadInput(&g_sUpload, pui8Frame[ui32Idx]);
+    if((ui32Len != 0) && !bDropReply && !OneIn(g_psScenario->ui32ReplyDrop) &&
+       ((g_ui32ReplyLen + ui32Len) <= sizeof(g_pui8Replies))) {
+      memcpy(g_pui8Replies + g_ui32ReplyLen, g_sUpload.pui8Reply, ui32Len);
+      g_ui32ReplyLen += ui32Len;
+    }
+  }
+
+  return(true);
+}
+
+//*****************************************************************************
+//
+// Board to sender.  Nothing queued means the board has gone quiet, which
+// the sender takes as its reply timeout.
+//
+//*****************************************************************************
+static uint32_t
+LinkRead(uint8_t *pui8Data, uint32_t ui32Max, void *pvData)
+{
+  uint32_t ui32Len;
+
+  (void)pvData;
+  ui32Len = g_ui32ReplyLen - g_ui32ReplyPos;
+  if(ui32Len > ui32Max) {
+    ui32Len = ui32Max;
+  }
+  memcpy(pui8Data, g_pui8Replies + g_ui32ReplyPos, ui32Len);
+  g_ui32ReplyPos += ui32Len;
+  if(g_ui32ReplyPos == g_ui32ReplyLen) {
+    g_ui32ReplyPos = 0;
+    g_ui32ReplyLen = 0;
+  }
+
+  return(ui32Len);
+}
+
+//*****************************************************************************
+//
+// Runs one scenario.  Returns the number of failed checks.
+//
+//*****************************************************************************
+static uint32_t
+Run(const tScenario *psScenario)
+{
+  tUploadSender sSender;
+  uint32_t ui32Result, ui32Failures;
+
+  g_psScenario = psScenario;
+  g_ui32Random = 12345;
+  g_ui32EndsCorrupted = 0;
+  g_ui32EndAcksDropped = 0;
+  g_ui32StartsDropped = 0;
+  g_ui32DataFrames = 0;
+  g_ui32Commits = 0;
+  g_ui32ReplyLen = 0;
+  g_ui32ReplyPos = 0;
+  UploadInit(&g_sUpload, Begin, End, 0);
+
+  sSender.pui8Image = g_pui8Image;
+  sSender.ui32Length = sizeof(g_pui8Image);
+  sSender.ui8Target = TARGET;
+  sSender.pfnWrite = LinkWrite;
+  sSender.pfnRead = LinkRead;
+  sSender.pvData = 0;
+  sSender.ui32MaxRetries = 10;
+  ui32Result = UploadSend(&sSender);
+
+  printf("%-24s %4u frames, %5u sent, %5u resent, %3u NAKs, %2u timeouts, "
+         "%3u bad\n", psScenario->pcName, sSender.ui32Frames, sSender.ui32Sent,
+         sSender.ui32Resent, sSender.ui32Naks, sSender.ui32Timeouts,
+         g_sUpload.ui32Bad);
+
+  ui32Failures = 0;
+  if(ui32Result != UPLOAD_SEND_OK) {
+    printf("  sender gave up, result %u\n", ui32Result);
+    ui32Failures++;
+  }
+  if(g_sUpload.ui32State != UPLOAD_DONE) {
+    printf("  receiver state %u, not done\n", g_sUpload.ui32State);
+    ui32Failures++;
+  }
+  if(g_ui32Commits != 1) {
+    printf("  image committed %u times\n", g_ui32Commits);
+    ui32Failures++;
+  }
+  if(memcmp(g_pui8Image, g_pui8Received, sizeof(g_pui8Image)) != 0) {
+    printf("  image differs\n");
+    ui32Failures++;
+  }
+  if(sSender.ui32Naks < psScenario->ui32MinNaks) {
+    printf("  expected go-back-N by NAK\n");
+    ui32Failures++;
+  }
+  if(sSender.ui32Timeouts < psScenario->ui32MinTimeouts) {
+    printf("  expected recovery by timeout\n");
+    ui32Failures++;
+  }
+  if((psScenario->ui32CorruptEnd &&
+      (g_ui32EndsCorrupted != psScenario->ui32CorruptEnd)) ||
+     (psScenario->ui32CorruptFrame &&
+      (g_ui32DataFrames < psScenario->ui32CorruptFrame))) {
+    printf("  fault was not injected\n");
+    ui32Failures++;
+  }
+
+  return(ui32Failures);
+}
+
+//*****************************************************************************
+//
+// Runs every scenario, then checks a refused upload is reported as such.
+//
+//*****************************************************************************
+int
+main(void)
+{
+  tUploadSender sSender;
+  uint32_t ui32Idx, ui32Failures;
+
+  for(ui32Idx = 0; ui32Idx < sizeof(g_pui8Image); ui32Idx++) {
+    g_pui8Image[ui32Idx] = Random();
+  }
+
+  ui32Failures = 0;
+  for(ui32Idx = 0; ui32Idx < NUM_SCENARIOS; ui32Idx++) {
+    ui32Failures += Run(&g_psScenarios[ui32Idx]);
+  }
+
+  // A target the board does not know is refused, not retried.
+  g_psScenario = &g_psScenarios[0];
+  g_ui32ReplyLen = 0;
+  g_ui32ReplyPos = 0;
+  UploadInit(&g_sUpload, Begin, End, 0);
+  sSender.pui8Image = g_pui8Image;
+  sSender.ui32Length = sizeof(g_pui8Image);
+  sSender.ui8Target = TARGET + 1;
+  sSender.pfnWrite = LinkWrite;
+  sSender.pfnRead = LinkRead;
+  sSender.pvData = 0;
+  sSender.ui32MaxRetries = 10;
+  if((UploadSend(&sSender) != UPLOAD_SEND_REFUSED) ||
+     (sSender.ui8Reason != UPLOAD_NAK_REFUSED)) {
+    printf("unknown target was not refused\n");
+    ui32Failures++;
+  }
+
+  printf("upload: %s\n", ui32Failures ? "FAILED" : "passed");
+  return(ui32Failures ? 1 : 0);
+}